@@ -0,0 +1,431 @@
+//
+//  AssetChunkStore.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetChunkStore.h"
+
+#include <algorithm>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSet>
+
+#include <udt/PacketList.h>
+
+static const QString CHUNKS_SUBDIR = "chunks";
+static const QString INDEX_FILE_SUFFIX = ".chunks";
+static const quint32 INDEX_FILE_VERSION = 1;
+
+static AssetChunkIndexPointer readIndexFile(const QString& filePath) {
+    QFile file { filePath };
+    if (!file.open(QIODevice::ReadOnly)) {
+        return AssetChunkIndexPointer();
+    }
+
+    QDataStream stream { &file };
+
+    quint32 version;
+    quint32 numChunks;
+    auto index = std::make_shared<AssetChunkIndex>();
+    stream >> version >> index->size >> numChunks;
+
+    if (stream.status() != QDataStream::Ok || version != INDEX_FILE_VERSION) {
+        return AssetChunkIndexPointer();
+    }
+
+    qint64 offset = 0;
+    for (quint32 i = 0; i < numChunks; ++i) {
+        QByteArray hash(SHA256_HASH_LENGTH, Qt::Uninitialized);
+        quint32 size;
+
+        stream.readRawData(hash.data(), SHA256_HASH_LENGTH);
+        stream >> size;
+
+        if (stream.status() != QDataStream::Ok) {
+            return AssetChunkIndexPointer();
+        }
+
+        index->chunks.push_back({ hash, offset, size });
+        offset += size;
+    }
+
+    if (offset != index->size) {
+        return AssetChunkIndexPointer();
+    }
+
+    return index;
+}
+
+static bool writeIndexFile(const QString& filePath, const AssetChunkIndex& index) {
+    QSaveFile file { filePath };
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    QDataStream stream { &file };
+    stream << INDEX_FILE_VERSION << index.size << quint32(index.chunks.size());
+
+    for (auto& chunk : index.chunks) {
+        stream.writeRawData(chunk.hash.constData(), SHA256_HASH_LENGTH);
+        stream << quint32(chunk.size);
+    }
+
+    return stream.status() == QDataStream::Ok && file.commit();
+}
+
+AssetChunkIndexPointer readAssetChunkIndex(ReceivedMessage& message) {
+    static const qint64 CHUNK_ENTRY_SIZE = SHA256_HASH_LENGTH + sizeof(uint32_t);
+
+    uint64_t size;
+    uint32_t numChunks;
+    if (message.getBytesLeftToRead() < (qint64)(sizeof(size) + sizeof(numChunks))) {
+        return AssetChunkIndexPointer();
+    }
+    message.readPrimitive(&size);
+    message.readPrimitive(&numChunks);
+
+    if (message.getBytesLeftToRead() < numChunks * CHUNK_ENTRY_SIZE) {
+        return AssetChunkIndexPointer();
+    }
+
+    auto index = std::make_shared<AssetChunkIndex>();
+    index->size = size;
+
+    qint64 offset = 0;
+    for (uint32_t i = 0; i < numChunks; ++i) {
+        auto hash = message.read(SHA256_HASH_LENGTH);
+
+        uint32_t chunkSize;
+        message.readPrimitive(&chunkSize);
+
+        index->chunks.push_back({ hash, offset, chunkSize });
+        offset += chunkSize;
+    }
+
+    if (index->chunks.empty() || offset != index->size) {
+        return AssetChunkIndexPointer();
+    }
+
+    return index;
+}
+
+bool AssetChunkStore::load(const QDir& filesDirectory) {
+    _filesDirectory = filesDirectory;
+    _chunksDirectory = filesDirectory;
+
+    if (!_filesDirectory.mkpath(CHUNKS_SUBDIR) || !_chunksDirectory.cd(CHUNKS_SUBDIR)) {
+        qCritical() << "Unable to create chunk directory for asset-server files.";
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // count the assets that use each chunk
+    auto indexFiles = _filesDirectory.entryInfoList({ "*" + INDEX_FILE_SUFFIX }, QDir::Files);
+    for (const auto& fileInfo : indexFiles) {
+        auto hash = fileInfo.completeBaseName();
+        auto index = readIndexFile(fileInfo.absoluteFilePath());
+
+        if (!isValidHash(hash) || !index) {
+            qWarning() << "Ignoring chunk index" << fileInfo.fileName() << "since it could not be read.";
+            continue;
+        }
+
+        _assets.insert(hash, index);
+        _numAssetBytes += index->size;
+
+        QSet<QByteArray> usedChunks;
+        for (auto& chunk : index->chunks) {
+            if (!usedChunks.contains(chunk.hash)) {
+                usedChunks.insert(chunk.hash);
+
+                auto& storedChunk = _chunks[chunk.hash];
+                storedChunk.size = chunk.size;
+                ++storedChunk.numAssets;
+            }
+        }
+    }
+
+    // find which chunks are on disk, and remove the ones that no asset uses
+    QSet<QByteArray> chunksOnDisk;
+    auto chunkFiles = _chunksDirectory.entryInfoList(QDir::Files);
+    for (const auto& fileInfo : chunkFiles) {
+        auto chunkHash = QByteArray::fromHex(fileInfo.fileName().toLatin1());
+
+        if (_chunks.contains(chunkHash) && _chunks[chunkHash].size == fileInfo.size()) {
+            chunksOnDisk.insert(chunkHash);
+            _numStoredBytes += fileInfo.size();
+        } else if (QFile::remove(fileInfo.absoluteFilePath())) {
+            qDebug() << "\tDeleted" << fileInfo.fileName() << "from asset chunks directory since it is unused.";
+        }
+    }
+
+    // and drop the assets missing chunks, so they're reported as missing instead of being served incomplete
+    auto it = _assets.begin();
+    while (it != _assets.end()) {
+        auto& index = it.value();
+        bool isComplete = std::all_of(index->chunks.begin(), index->chunks.end(), [&](const AssetChunk& chunk) {
+            return chunksOnDisk.contains(chunk.hash);
+        });
+
+        if (isComplete) {
+            ++it;
+            continue;
+        }
+
+        qWarning() << "Removing asset" << it.key() << "since some of its chunks are missing.";
+
+        QSet<QByteArray> usedChunks;
+        for (auto& chunk : index->chunks) {
+            if (!usedChunks.contains(chunk.hash)) {
+                usedChunks.insert(chunk.hash);
+                --_chunks[chunk.hash].numAssets;
+            }
+        }
+
+        _numAssetBytes -= index->size;
+        QFile::remove(getIndexFilePath(it.key()));
+        it = _assets.erase(it);
+    }
+
+    QList<QByteArray> unusedChunks;
+    auto chunkIt = _chunks.begin();
+    while (chunkIt != _chunks.end()) {
+        if (!chunksOnDisk.contains(chunkIt.key())) {
+            chunkIt = _chunks.erase(chunkIt);
+        } else {
+            if (chunkIt->numAssets == 0) {
+                unusedChunks.push_back(chunkIt.key());
+            }
+            ++chunkIt;
+        }
+    }
+
+    for (auto& chunkHash : unusedChunks) {
+        removeChunk(chunkHash);
+    }
+
+    qInfo() << "There are" << _assets.size() << "assets stored as" << _chunks.size() << "chunks.";
+    return true;
+}
+
+bool AssetChunkStore::hasChunk(const QByteArray& chunkHash) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _chunks.contains(chunkHash);
+}
+
+bool AssetChunkStore::hasChunk(const AssetChunk& chunk) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _chunks.find(chunk.hash);
+    return it != _chunks.end() && it->size == chunk.size;
+}
+
+MappedFilePointer AssetChunkStore::mapChunk(const AssetChunk& chunk, bool* isCached) const {
+    return _mappedFiles.get(getChunkFilePath(chunk.hash), isCached);
+}
+
+bool AssetChunkStore::writeChunk(const QByteArray& chunkHash, const char* data, qint64 size) {
+    if (hasChunk(chunkHash)) {
+        return true;
+    }
+
+    // written to a temporary file that is renamed once complete, so that a chunk is never read half written
+    QSaveFile file { getChunkFilePath(chunkHash) };
+    if (!file.open(QIODevice::WriteOnly) || file.write(data, size) != size || !file.commit()) {
+        qWarning() << "Failed to write chunk" << chunkHash.toHex();
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_chunks.contains(chunkHash)) {
+        _chunks.insert(chunkHash, { size, 0 });
+        _numStoredBytes += size;
+    }
+    return true;
+}
+
+bool AssetChunkStore::writeAsset(const AssetHash& hash, const AssetChunkIndexPointer& index) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (_assets.contains(hash)) {
+        return true;
+    }
+
+    // a chunk the upload didn't send may have been removed along with the last asset using it since
+    for (auto& chunk : index->chunks) {
+        if (!_chunks.contains(chunk.hash)) {
+            qWarning() << "Cannot store asset" << hash << "since its chunk" << chunk.hash.toHex() << "is missing.";
+            return false;
+        }
+    }
+
+    if (!writeIndexFile(getIndexFilePath(hash), *index)) {
+        qWarning() << "Failed to write the chunk index of" << hash;
+        return false;
+    }
+
+    _assets.insert(hash, index);
+    _numAssetBytes += index->size;
+
+    QSet<QByteArray> usedChunks;
+    for (auto& chunk : index->chunks) {
+        if (!usedChunks.contains(chunk.hash)) {
+            usedChunks.insert(chunk.hash);
+            ++_chunks[chunk.hash].numAssets;
+        }
+    }
+
+    return true;
+}
+
+AssetChunkIndexPointer AssetChunkStore::getAsset(const AssetHash& hash) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _assets.value(hash);
+}
+
+QStringList AssetChunkStore::getAssetHashes() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _assets.keys();
+}
+
+void AssetChunkStore::removeAsset(const AssetHash& hash) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto index = _assets.take(hash);
+    if (!index) {
+        return;
+    }
+
+    _numAssetBytes -= index->size;
+
+    if (QFile::remove(getIndexFilePath(hash))) {
+        qDebug() << "\tDeleted the chunk index of" << hash;
+    } else {
+        qDebug() << "\tAttempt to delete the chunk index of" << hash << "failed";
+    }
+
+    QSet<QByteArray> usedChunks;
+    for (auto& chunk : index->chunks) {
+        if (!usedChunks.contains(chunk.hash)) {
+            usedChunks.insert(chunk.hash);
+
+            auto it = _chunks.find(chunk.hash);
+            if (it != _chunks.end() && --it->numAssets == 0) {
+                removeChunk(chunk.hash);
+            }
+        }
+    }
+}
+
+int AssetChunkStore::getNumAssets() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _assets.size();
+}
+
+int AssetChunkStore::getNumChunks() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _chunks.size();
+}
+
+QString AssetChunkStore::getChunkFilePath(const QByteArray& chunkHash) const {
+    return _chunksDirectory.absoluteFilePath(QString(chunkHash.toHex()));
+}
+
+QString AssetChunkStore::getIndexFilePath(const AssetHash& hash) const {
+    return _filesDirectory.absoluteFilePath(hash + INDEX_FILE_SUFFIX);
+}
+
+void AssetChunkStore::removeChunk(const QByteArray& chunkHash) {
+    auto filePath = getChunkFilePath(chunkHash);
+
+    // remove the chunk after its mapping for sends
+    _mappedFiles.remove(filePath);
+    QFile::remove(filePath);
+
+    _numStoredBytes -= _chunks.take(chunkHash).size;
+}
+
+AssetChunkReader::AssetChunkReader(const AssetChunkStore& chunkStore, MappedFileCache& mappedFiles,
+                                   AssetChunkIndexPointer index, qint64 offset, qint64 size) :
+    _chunkStore(chunkStore),
+    _mappedFiles(mappedFiles),
+    _index(index),
+    _bytesRemaining(size)
+{
+    // find the chunk the range starts in
+    auto it = std::upper_bound(_index->chunks.begin(), _index->chunks.end(), offset,
+                               [](qint64 offset, const AssetChunk& chunk) {
+        return offset < chunk.offset;
+    });
+
+    _firstChunkIndex = std::distance(_index->chunks.begin(), it) - 1;
+    _chunkIndex = _firstChunkIndex;
+    _offsetInChunk = offset - _index->chunks[_chunkIndex].offset;
+}
+
+bool AssetChunkReader::open() const {
+    auto rangeEnd = _index->chunks[_firstChunkIndex].offset + _offsetInChunk + _bytesRemaining;
+
+    for (auto i = _firstChunkIndex; i < _index->chunks.size() && _index->chunks[i].offset < rangeEnd; ++i) {
+        auto& chunk = _index->chunks[i];
+        if (!_chunkStore.hasChunk(chunk)) {
+            qWarning() << "Chunk" << chunk.hash.toHex() << "is missing, so it can't be sent.";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool AssetChunkReader::mapChunk(const AssetChunk& chunk) {
+    _isChunkCached = false;
+    _mappedChunk = _chunkStore.mapChunk(chunk, &_isChunkCached);
+
+    if (!_mappedChunk || _mappedChunk->size() != chunk.size) {
+        qWarning() << "Chunk" << chunk.hash.toHex() << "could not be read to send it.";
+        _mappedChunk.reset();
+        return false;
+    }
+    return true;
+}
+
+bool AssetChunkReader::read(udt::PacketList& packetList, qint64 maxBytes) {
+    auto bytesToWrite = std::min(_bytesRemaining, maxBytes);
+
+    while (bytesToWrite > 0) {
+        auto& chunk = _index->chunks[_chunkIndex];
+
+        if (!_mappedChunk && !mapChunk(chunk)) {
+            _bytesRemaining = 0;
+            return false;
+        }
+
+        auto bytesFromChunk = std::min(bytesToWrite, chunk.size - _offsetInChunk);
+        packetList.write(_mappedChunk->data() + _offsetInChunk, bytesFromChunk);
+
+        if (_isChunkCached) {
+            _mappedFiles.addBytesServedFromMemory(bytesFromChunk);
+        }
+
+        bytesToWrite -= bytesFromChunk;
+        _bytesRemaining -= bytesFromChunk;
+        _offsetInChunk += bytesFromChunk;
+
+        if (_offsetInChunk == chunk.size) {
+            // the chunks already sent don't need to stay mapped
+            _mappedChunk.reset();
+            ++_chunkIndex;
+            _offsetInChunk = 0;
+        }
+    }
+
+    return _bytesRemaining > 0;
+}
@@ -0,0 +1,132 @@
+//
+//  AssetChunkStore.h
+//  assignment-client/src/assets
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_AssetChunkStore_h
+#define hifi_AssetChunkStore_h
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QDir>
+#include <QtCore/QHash>
+#include <QtCore/QStringList>
+
+#include <AssetUtils.h>
+#include <ReceivedMessage.h>
+
+#include "MappedFileCache.h"
+
+namespace udt {
+    class PacketList;
+}
+
+struct AssetChunkIndex {
+    qint64 size { 0 };
+    AssetChunkList chunks;
+};
+
+using AssetChunkIndexPointer = std::shared_ptr<const AssetChunkIndex>;
+
+// reads the index an upload sends ahead of its chunks, returning nullptr if it is malformed
+AssetChunkIndexPointer readAssetChunkIndex(ReceivedMessage& message);
+
+// Stores assets as the content-defined chunks they are cut into, keeping one copy of the chunks assets share
+//   Each asset has an index of its chunks, <hash>.chunks, next to the whole asset files, and the chunks are files
+//   named by their own hash in the chunks directory. The indices are kept in memory, along with how many assets use
+//   each chunk, so that chunks are removed with the last asset that uses them.
+class AssetChunkStore {
+public:
+    AssetChunkStore(MappedFileCache& mappedFiles) : _mappedFiles(mappedFiles) {}
+
+    // reads the indices of the assets in the files directory, and removes the chunks that no asset uses
+    //   must be called before anything else
+    bool load(const QDir& filesDirectory);
+
+    bool hasChunk(const QByteArray& chunkHash) const;
+    bool hasChunk(const AssetChunk& chunk) const; // and it is the size the index says it is
+    MappedFilePointer mapChunk(const AssetChunk& chunk, bool* isCached = nullptr) const;
+
+    // writes a chunk that isn't stored already - the caller checks that the data matches the hash
+    bool writeChunk(const QByteArray& chunkHash, const char* data, qint64 size);
+
+    // writes the index of an asset whose chunks are all stored, once the hash of the asset has been checked
+    // returns false if a chunk is missing or the index can't be written
+    bool writeAsset(const AssetHash& hash, const AssetChunkIndexPointer& index);
+
+    // returns nullptr if the asset isn't stored as chunks
+    AssetChunkIndexPointer getAsset(const AssetHash& hash) const;
+    QStringList getAssetHashes() const;
+
+    // removes the index of an asset, and its chunks that no other asset uses
+    void removeAsset(const AssetHash& hash);
+
+    int getNumAssets() const;
+    int getNumChunks() const;
+    qint64 getNumAssetBytes() const { return _numAssetBytes; }
+    qint64 getNumStoredBytes() const { return _numStoredBytes; }
+
+private:
+    struct StoredChunk {
+        qint64 size;
+        int numAssets;
+    };
+
+    QString getChunkFilePath(const QByteArray& chunkHash) const;
+    QString getIndexFilePath(const AssetHash& hash) const;
+
+    void removeChunk(const QByteArray& chunkHash); // must be called with the lock held
+
+    QDir _filesDirectory;
+    QDir _chunksDirectory;
+    MappedFileCache& _mappedFiles;
+
+    mutable std::mutex _mutex;
+    QHash<AssetHash, AssetChunkIndexPointer> _assets;
+    QHash<QByteArray, StoredChunk> _chunks; // keyed by the hash of the chunk, including chunks no asset uses yet
+
+    std::atomic<qint64> _numAssetBytes { 0 };
+    std::atomic<qint64> _numStoredBytes { 0 };
+};
+
+// Reads a range of an asset stored as chunks, mapping one chunk at a time as the range is written
+class AssetChunkReader {
+public:
+    AssetChunkReader(const AssetChunkStore& chunkStore, MappedFileCache& mappedFiles, AssetChunkIndexPointer index,
+                     qint64 offset, qint64 size);
+
+    // checks that the chunks of the range are stored, returning false if one of them isn't
+    //   must be called before read, so that a missing chunk fails the request before any of the reply is written
+    bool open() const;
+
+    // writes up to maxBytes of the range to the packet list, and returns whether any of the range is left
+    //   a chunk removed since open cuts the range short, which fails the hash check of the requester
+    bool read(udt::PacketList& packetList, qint64 maxBytes);
+
+private:
+    bool mapChunk(const AssetChunk& chunk);
+
+    const AssetChunkStore& _chunkStore;
+    MappedFileCache& _mappedFiles;
+    AssetChunkIndexPointer _index;
+
+    size_t _firstChunkIndex { 0 };
+    size_t _chunkIndex { 0 };
+    qint64 _offsetInChunk { 0 };
+    qint64 _bytesRemaining;
+
+    MappedFilePointer _mappedChunk; // the chunk being written, released once it is all written
+    bool _isChunkCached { false };
+};
+
+#endif // hifi_AssetChunkStore_h
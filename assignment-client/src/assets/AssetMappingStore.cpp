@@ -0,0 +1,244 @@
+//
+//  AssetMappingStore.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetMappingStore.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
+
+#include <NumericalConstants.h>
+#include <RecordLog.h>
+#include <SharedUtil.h>
+
+static const QString MAP_FILE_NAME = "map.json";
+static const QString MAP_LOG_FILE_NAME = "map.log";
+
+// the log is compacted once it is larger than the snapshot, but not while it is this small
+static const qint64 MIN_LOG_SIZE_TO_COMPACT = 1024 * 1024;
+
+static QByteArray writeChanges(const AssetMappingStore::Changes& changes) {
+    QByteArray payload;
+    QDataStream payloadStream(&payload, QIODevice::WriteOnly);
+
+    payloadStream << (quint32)changes.size();
+    for (auto& change : changes) {
+        payloadStream << change.first << change.second;
+    }
+
+    return payload;
+}
+
+static bool readChanges(const QByteArray& payload, AssetMappingStore::Changes& changes) {
+    QDataStream stream(payload);
+
+    quint32 numChanges;
+    stream >> numChanges;
+
+    for (quint32 i = 0; i < numChanges && stream.status() == QDataStream::Ok; ++i) {
+        AssetMappingStore::Change change;
+        stream >> change.first >> change.second;
+        changes.push_back(change);
+    }
+
+    return stream.status() == QDataStream::Ok;
+}
+
+bool AssetMappingStore::load(const QDir& resourcesDirectory) {
+    _snapshotPath = resourcesDirectory.absoluteFilePath(MAP_FILE_NAME);
+    _logFile.setFileName(resourcesDirectory.absoluteFilePath(MAP_LOG_FILE_NAME));
+
+    return readSnapshot() && readLog();
+}
+
+bool AssetMappingStore::readSnapshot() {
+    QFile mapFile { _snapshotPath };
+
+    if (!mapFile.exists()) {
+        qInfo() << "No existing mappings loaded from file since no file was found at" << _snapshotPath;
+        return true;
+    }
+
+    if (mapFile.open(QIODevice::ReadOnly)) {
+        QJsonParseError error;
+
+        auto jsonDocument = QJsonDocument::fromJson(mapFile.readAll(), &error);
+
+        if (error.error == QJsonParseError::NoError) {
+            auto jsonObject = jsonDocument.object();
+
+            for (auto it = jsonObject.constBegin(); it != jsonObject.constEnd(); ++it) {
+                // drop any mappings that don't match the expected format
+                auto hash = it.value().toString();
+
+                if (!isValidFilePath(it.key())) {
+                    qWarning() << "Will not keep mapping for" << it.key() << "since it is not a valid path.";
+                } else if (!isValidHash(hash)) {
+                    qWarning() << "Will not keep mapping for" << it.key() << "since it does not have a valid hash.";
+                } else {
+                    applyChange({ it.key(), hash });
+                }
+            }
+
+            _snapshotSize = mapFile.size();
+
+            qInfo() << "Loaded" << _mappings.size() << "mappings from map file at" << _snapshotPath;
+            return true;
+        }
+    }
+
+    qCritical() << "Failed to read mapping file at" << _snapshotPath;
+    return false;
+}
+
+bool AssetMappingStore::readLog() {
+    if (!_logFile.open(QIODevice::ReadWrite)) {
+        qCritical() << "Failed to open mapping log at" << _logFile.fileName();
+        return false;
+    }
+
+    auto data = _logFile.readAll();
+
+    int numRecords = 0;
+    auto position = readLogRecords(data, [&](const char* payload, int payloadSize) {
+        Changes changes;
+        if (!readChanges(QByteArray::fromRawData(payload, payloadSize), changes)) {
+            return false;
+        }
+
+        for (auto& change : changes) {
+            applyChange(change);
+        }
+        return true;
+    }, numRecords);
+
+    if (position < data.size()) {
+        // the last change was cut short as it was written, so it never happened - drop it before appending others
+        qWarning() << "Dropping" << data.size() - position << "bytes from the end of the mapping log at"
+            << _logFile.fileName() << "since they were not completely written.";
+        _logFile.resize(position);
+    }
+
+    if (numRecords > 0) {
+        qInfo() << "Replayed" << numRecords << "changes from mapping log, for" << _mappings.size() << "mappings.";
+    }
+
+    return true;
+}
+
+AssetHash AssetMappingStore::getMapping(const AssetPath& path) const {
+    auto it = _mappings.find(path);
+    return it != _mappings.end() ? it->second : AssetHash();
+}
+
+AssetMapping AssetMappingStore::getMappingsInFolder(const AssetPath& folderPath) const {
+    AssetMapping folderMappings;
+
+    // the paths in the folder are sorted together, right from where the folder path would be
+    for (auto it = _mappings.lower_bound(folderPath); it != _mappings.end() && it->first.startsWith(folderPath); ++it) {
+        folderMappings.insert(folderMappings.end(), *it);
+    }
+
+    return folderMappings;
+}
+
+bool AssetMappingStore::apply(const Changes& changes) {
+    if (changes.empty()) {
+        return true;
+    }
+
+    auto startTime = usecTimestampNow();
+
+    if (!appendToLog(changes)) {
+        return false;
+    }
+
+    auto writeUsecs = usecTimestampNow() - startTime;
+    ++_numWrites;
+    _totalWriteUsecs += writeUsecs;
+    _maxWriteUsecs = std::max(_maxWriteUsecs, writeUsecs);
+
+    for (auto& change : changes) {
+        applyChange(change);
+    }
+
+    if (_logFile.size() > std::max(MIN_LOG_SIZE_TO_COMPACT, _snapshotSize)) {
+        // the changes are in the log either way, so they are kept even if this fails
+        compact();
+    }
+
+    return true;
+}
+
+bool AssetMappingStore::appendToLog(const Changes& changes) {
+    if (appendLogRecord(_logFile, writeChanges(changes))) {
+        return true;
+    }
+
+    qWarning() << "Failed to write to mapping log at" << _logFile.fileName();
+    return false;
+}
+
+bool AssetMappingStore::compact() {
+    auto startTime = usecTimestampNow();
+
+    // the mappings are inserted in order, which keeps the inserts at the end of the object
+    QJsonObject jsonObject;
+    for (auto& mapping : _mappings) {
+        jsonObject.insert(mapping.first, mapping.second);
+    }
+
+    auto json = QJsonDocument(jsonObject).toJson();
+
+    QSaveFile mapFile { _snapshotPath };
+    if (!mapFile.open(QIODevice::WriteOnly) || mapFile.write(json) != json.size() || !mapFile.commit()) {
+        qWarning() << "Failed to write JSON mappings to file at" << _snapshotPath;
+        return false;
+    }
+
+    _snapshotSize = json.size();
+
+    // the new snapshot has all the changes in the log, so replaying the log over it is harmless if this fails
+    if (!_logFile.resize(0)) {
+        qWarning() << "Failed to empty mapping log at" << _logFile.fileName();
+    }
+
+    ++_numCompactions;
+    _lastCompactionUsecs = usecTimestampNow() - startTime;
+
+    qDebug() << "Wrote" << _mappings.size() << "JSON mappings to file at" << _snapshotPath << "in"
+        << _lastCompactionUsecs / USECS_PER_MSEC << "ms";
+    return true;
+}
+
+void AssetMappingStore::applyChange(const Change& change) {
+    auto it = _mappings.find(change.first);
+
+    if (it != _mappings.end()) {
+        auto numMappingsIt = _numMappingsOfHashes.find(it->second);
+        if (numMappingsIt != _numMappingsOfHashes.end() && --numMappingsIt.value() == 0) {
+            _numMappingsOfHashes.erase(numMappingsIt);
+        }
+
+        if (change.second.isEmpty()) {
+            _mappings.erase(it);
+            return;
+        }
+
+        it->second = change.second;
+    } else if (change.second.isEmpty()) {
+        return;
+    } else {
+        _mappings.emplace(change.first, change.second);
+    }
+
+    ++_numMappingsOfHashes[change.second];
+}
@@ -0,0 +1,85 @@
+//
+//  AssetMappingStore.h
+//  assignment-client/src/assets
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_AssetMappingStore_h
+#define hifi_AssetMappingStore_h
+
+#include <vector>
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+
+#include <AssetUtils.h>
+
+// Keeps the asset mappings, persisted as a snapshot of all of them plus a log of the changes made since
+//   Each change is appended to the log as one record, so that it costs a write of its own size rather than a
+//   rewrite of every mapping. Once the log outgrows the snapshot it is compacted into a new snapshot. The snapshot
+//   is the map.json the asset server has always written. The mappings are kept sorted by path, so that the
+//   mappings in a folder are found without going through the others.
+class AssetMappingStore {
+public:
+    // maps a path to a hash, or removes the mapping of the path if the hash is empty
+    using Change = std::pair<AssetPath, AssetHash>;
+    using Changes = std::vector<Change>;
+
+    // reads the snapshot and replays the log over it - must be called before anything else
+    bool load(const QDir& resourcesDirectory);
+
+    const AssetMapping& getMappings() const { return _mappings; }
+    int getNumMappings() const { return (int)_mappings.size(); }
+
+    // returns an empty hash if the path isn't mapped
+    AssetHash getMapping(const AssetPath& path) const;
+
+    // returns the mappings of the paths that start with folderPath
+    AssetMapping getMappingsInFolder(const AssetPath& folderPath) const;
+
+    bool isMapped(const AssetHash& hash) const { return _numMappingsOfHashes.contains(hash); }
+
+    // persists the changes as one, then applies them in order
+    // returns false, leaving the mappings as they were, if the changes can't be persisted
+    bool apply(const Changes& changes);
+
+    // writes all of the mappings as a new snapshot, and starts a new log
+    bool compact();
+
+    int getNumWrites() const { return _numWrites; }
+    quint64 getAverageWriteUsecs() const { return _numWrites > 0 ? _totalWriteUsecs / _numWrites : 0; }
+    quint64 getMaxWriteUsecs() const { return _maxWriteUsecs; }
+    int getNumCompactions() const { return _numCompactions; }
+    quint64 getLastCompactionUsecs() const { return _lastCompactionUsecs; }
+    qint64 getLogSize() const { return _logFile.size(); }
+    qint64 getSnapshotSize() const { return _snapshotSize; }
+
+private:
+    bool readSnapshot();
+    bool readLog();
+    bool appendToLog(const Changes& changes);
+
+    void applyChange(const Change& change);
+
+    QString _snapshotPath;
+    QFile _logFile;
+    qint64 _snapshotSize { 0 };
+
+    AssetMapping _mappings;
+    QHash<AssetHash, int> _numMappingsOfHashes; // how many paths map to each hash
+
+    int _numWrites { 0 };
+    quint64 _totalWriteUsecs { 0 };
+    quint64 _maxWriteUsecs { 0 };
+    int _numCompactions { 0 };
+    quint64 _lastCompactionUsecs { 0 };
+};
+
+#endif // hifi_AssetMappingStore_h
@@ -23,6 +23,7 @@
 #include <QtCore/QJsonDocument>
 #include <QtCore/QString>
 
+#include <NumericalConstants.h>
 #include <SharedUtil.h>
 #include <PathUtils.h>
 
@@ -86,6 +87,8 @@ AssetServer::AssetServer(ReceivedMessage& message) :
     packetReceiver.registerListener(PacketType::AssetGet, this, "handleAssetGet");
     packetReceiver.registerListener(PacketType::AssetGetInfo, this, "handleAssetGetInfo");
     packetReceiver.registerListener(PacketType::AssetUpload, this, "handleAssetUpload");
+    packetReceiver.registerListener(PacketType::AssetChunkQuery, this, "handleAssetChunkQuery");
+    packetReceiver.registerListener(PacketType::AssetChunkUpload, this, "handleAssetUpload");
     packetReceiver.registerListener(PacketType::AssetMappingOperation, this, "handleAssetMappingOperation");
     
 #ifdef Q_OS_WIN
@@ -116,6 +119,8 @@ void AssetServer::run() {
 }
 
 static const QString ASSET_FILES_SUBDIR = "files";
+static const qint64 BYTES_PER_KILOBYTE = 1024;
+static const qint64 BYTES_PER_MEGABYTE = 1024 * 1024;
 
 void AssetServer::completeSetup() {
     auto nodeList = DependencyManager::get<NodeList>();
@@ -145,6 +150,22 @@ void AssetServer::completeSetup() {
                     " (" << maxBandwidth << "bits/s)";
     }
 
+    static const QString HOT_ASSET_CACHE_SIZE_OPTION = "hot_asset_cache_size";
+    auto hotAssetCacheSizeValue = assetServerObject[HOT_ASSET_CACHE_SIZE_OPTION];
+
+    if (hotAssetCacheSizeValue.isDouble()) {
+        qint64 maxBytes = hotAssetCacheSizeValue.toDouble() * BYTES_PER_MEGABYTE;
+        _mappedFiles.setMaxBytes(maxBytes);
+        qInfo() << "Set the hot asset cache size to" << hotAssetCacheSizeValue.toDouble() << "MB.";
+    }
+
+    static const QString CHUNKED_STORAGE_OPTION = "chunked_storage";
+    _storeUploadsAsChunks = assetServerObject[CHUNKED_STORAGE_OPTION].toBool(false);
+
+    if (_storeUploadsAsChunks) {
+        qInfo() << "Storing uploaded assets as deduplicated chunks.";
+    }
+
     // get the path to the asset folder from the domain server settings
     static const QString ASSETS_PATH_OPTION = "assets_path";
     auto assetsJSONValue = assetServerObject[ASSETS_PATH_OPTION];
@@ -177,8 +198,15 @@ void AssetServer::completeSetup() {
         return;
     }
 
-    // load whatever mappings we currently have from the local file
-    if (loadMappingsFromFile()) {
+    // assets stored as chunks are served whether or not new uploads are, so that the setting can be turned off
+    if (!_chunkStore.load(_filesDirectory)) {
+        qCritical() << "Unable to load the asset chunks. Stopping assignment.";
+        setFinished(true);
+        return;
+    }
+
+    // load whatever mappings we currently have from the local files
+    if (_fileMappings.load(_resourcesDirectory)) {
         qInfo() << "Serving files from: " << _filesDirectory.path();
 
         // Check the asset directory to output some information about what we have
@@ -187,9 +215,10 @@ void AssetServer::completeSetup() {
         QRegExp hashFileRegex { ASSET_HASH_REGEX_STRING };
         auto hashedFiles = files.filter(hashFileRegex);
 
-        qInfo() << "There are" << hashedFiles.size() << "asset files in the asset directory.";
+        qInfo() << "There are" << hashedFiles.size() << "asset files and" << _chunkStore.getNumAssets()
+            << "assets stored as chunks in the asset directory.";
 
-        if (_fileMappings.count() > 0) {
+        if (_fileMappings.getNumMappings() > 0) {
             cleanupUnmappedFiles();
         }
 
@@ -206,15 +235,13 @@ void AssetServer::cleanupUnmappedFiles() {
 
     auto files = _filesDirectory.entryInfoList(QDir::Files);
 
-    // grab the currently mapped hashes
-    auto mappedHashes = _fileMappings.values();
-
     qInfo() << "Performing unmapped asset cleanup.";
 
     for (const auto& fileInfo : files) {
         if (hashFileRegex.exactMatch(fileInfo.fileName())) {
-            if (!mappedHashes.contains(fileInfo.fileName())) {
-                // remove the unmapped file
+            if (!_fileMappings.isMapped(fileInfo.fileName())) {
+                // remove the unmapped file, after its mapping for sends
+                _mappedFiles.remove(fileInfo.absoluteFilePath());
                 QFile removeableFile { fileInfo.absoluteFilePath() };
 
                 if (removeableFile.remove()) {
@@ -225,6 +252,12 @@ void AssetServer::cleanupUnmappedFiles() {
             }
         }
     }
+
+    for (const auto& hash : _chunkStore.getAssetHashes()) {
+        if (!_fileMappings.isMapped(hash)) {
+            _chunkStore.removeAsset(hash);
+        }
+    }
 }
 
 void AssetServer::handleAssetMappingOperation(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
@@ -267,9 +300,8 @@ void AssetServer::handleAssetMappingOperation(QSharedPointer<ReceivedMessage> me
 void AssetServer::handleGetMappingOperation(ReceivedMessage& message, SharedNodePointer senderNode, NLPacketList& replyPacket) {
     QString assetPath = message.readString();
 
-    auto it = _fileMappings.find(assetPath);
-    if (it != _fileMappings.end()) {
-        auto assetHash = it->toString();
+    auto assetHash = _fileMappings.getMapping(assetPath);
+    if (!assetHash.isEmpty()) {
         replyPacket.writePrimitive(AssetServerError::NoError);
         replyPacket.write(QByteArray::fromHex(assetHash.toUtf8()));
     } else {
@@ -280,14 +312,22 @@ void AssetServer::handleGetMappingOperation(ReceivedMessage& message, SharedNode
 void AssetServer::handleGetAllMappingOperation(ReceivedMessage& message, SharedNodePointer senderNode, NLPacketList& replyPacket) {
     replyPacket.writePrimitive(AssetServerError::NoError);
 
-    auto count = _fileMappings.size();
+    if (_serializedMappings.isEmpty()) {
+        // write the mappings the way the packet list would, and keep them written until they change
+        auto count = _fileMappings.getNumMappings();
+        _serializedMappings.append(reinterpret_cast<const char*>(&count), sizeof(count));
 
-    replyPacket.writePrimitive(count);
+        for (auto& mapping : _fileMappings.getMappings()) {
+            auto path = mapping.first.toUtf8();
+            uint32_t pathLength = path.length();
 
-    for (auto it = _fileMappings.cbegin(); it != _fileMappings.cend(); ++ it) {
-        replyPacket.writeString(it.key());
-        replyPacket.write(QByteArray::fromHex(it.value().toString().toUtf8()));
+            _serializedMappings.append(reinterpret_cast<const char*>(&pathLength), sizeof(pathLength));
+            _serializedMappings.append(path);
+            _serializedMappings.append(QByteArray::fromHex(mapping.second.toUtf8()));
+        }
     }
+
+    replyPacket.write(_serializedMappings);
 }
 
 void AssetServer::handleSetMappingOperation(ReceivedMessage& message, SharedNodePointer senderNode, NLPacketList& replyPacket) {
@@ -365,10 +405,16 @@ void AssetServer::handleAssetGetInfo(QSharedPointer<ReceivedMessage> message, Sh
     QString fileName = QString(hexHash);
     QFileInfo fileInfo { _filesDirectory.filePath(fileName) };
 
+    AssetChunkIndexPointer chunkIndex;
+
     if (fileInfo.exists() && fileInfo.isReadable()) {
         qDebug() << "Opening file: " << fileInfo.filePath();
         replyPacket->writePrimitive(AssetServerError::NoError);
         replyPacket->writePrimitive(fileInfo.size());
+    } else if ((chunkIndex = _chunkStore.getAsset(fileName))) {
+        qDebug() << "Asset stored as chunks: " << fileName;
+        replyPacket->writePrimitive(AssetServerError::NoError);
+        replyPacket->writePrimitive(chunkIndex->size);
     } else {
         qDebug() << "Asset not found: " << QString(hexHash);
         replyPacket->writePrimitive(AssetServerError::AssetNotFound);
@@ -388,7 +434,7 @@ void AssetServer::handleAssetGet(QSharedPointer<ReceivedMessage> message, Shared
     }
 
     // Queue task
-    auto task = new SendAssetTask(message, senderNode, _filesDirectory);
+    auto task = new SendAssetTask(message, senderNode, _filesDirectory, _mappedFiles, _chunkStore);
     _taskPool.start(task);
 }
 
@@ -397,7 +443,8 @@ void AssetServer::handleAssetUpload(QSharedPointer<ReceivedMessage> message, Sha
     if (senderNode->getCanWriteToAssetServer()) {
         qDebug() << "Starting an UploadAssetTask for upload from" << uuidStringWithoutCurlyBraces(senderNode->getUUID());
 
-        auto task = new UploadAssetTask(message, senderNode, _filesDirectory);
+        auto task = new UploadAssetTask(message, senderNode, _filesDirectory,
+                                        _storeUploadsAsChunks ? &_chunkStore : nullptr);
         _taskPool.start(task);
     } else {
         // this is a node the domain told us is not allowed to rez entities
@@ -419,6 +466,53 @@ void AssetServer::handleAssetUpload(QSharedPointer<ReceivedMessage> message, Sha
     }
 }
 
+void AssetServer::handleAssetChunkQuery(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
+    MessageID messageID;
+    message->readPrimitive(&messageID);
+
+    auto replyPacket = NLPacketList::create(PacketType::AssetChunkQueryReply, QByteArray(), true, true);
+    replyPacket->writePrimitive(messageID);
+
+    if (!senderNode->getCanWriteToAssetServer()) {
+        replyPacket->writePrimitive(AssetServerError::PermissionDenied);
+    } else {
+        auto index = readAssetChunkIndex(*message);
+
+        if (!index) {
+            replyPacket->writePrimitive(AssetServerError::FileOperationFailed);
+        } else if ((uint64_t)index->size > MAX_UPLOAD_SIZE) {
+            replyPacket->writePrimitive(AssetServerError::AssetTooLarge);
+        } else {
+            // ask for the first copy of each chunk we don't have - or for all of them, to store the asset whole
+            std::vector<uint32_t> missingChunks;
+            QSet<QByteArray> askedForChunks;
+
+            for (size_t i = 0; i < index->chunks.size(); ++i) {
+                auto& chunkHash = index->chunks[i].hash;
+
+                if (!_storeUploadsAsChunks) {
+                    missingChunks.push_back((uint32_t)i);
+                } else if (!_chunkStore.hasChunk(chunkHash) && !askedForChunks.contains(chunkHash)) {
+                    askedForChunks.insert(chunkHash);
+                    missingChunks.push_back((uint32_t)i);
+                }
+            }
+
+            qDebug() << "Asking" << uuidStringWithoutCurlyBraces(senderNode->getUUID()) << "for" << missingChunks.size()
+                << "of the" << index->chunks.size() << "chunks of an upload.";
+
+            replyPacket->writePrimitive(AssetServerError::NoError);
+            replyPacket->writePrimitive((uint32_t)missingChunks.size());
+            for (auto chunkIndex : missingChunks) {
+                replyPacket->writePrimitive(chunkIndex);
+            }
+        }
+    }
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    nodeList->sendPacketList(std::move(replyPacket), *senderNode);
+}
+
 void AssetServer::sendStatsPacket() {
     QJsonObject serverStats;
 
@@ -484,78 +578,48 @@ void AssetServer::sendStatsPacket() {
         serverStats[uuid] = nodeStats;
     }
 
+    // requests coalesced with the load of the file they asked for count as hits, since they didn't read the disk
+    int numCacheHits = _mappedFiles.getNumHits() + _mappedFiles.getNumCoalesced();
+    int numCacheRequests = numCacheHits + _mappedFiles.getNumMisses();
+
+    QJsonObject cacheStats;
+    cacheStats["1. Hit Ratio"] = numCacheRequests > 0 ? (double)numCacheHits / numCacheRequests : 0.0;
+    cacheStats["2. Hits"] = _mappedFiles.getNumHits();
+    cacheStats["3. Coalesced"] = _mappedFiles.getNumCoalesced();
+    cacheStats["4. Misses"] = _mappedFiles.getNumMisses();
+    cacheStats["5. Served from Memory (MB)"] = (double)_mappedFiles.getBytesServedFromMemory() / BYTES_PER_MEGABYTE;
+    cacheStats["6. Cached (MB)"] = (double)_mappedFiles.getNumCachedBytes() / BYTES_PER_MEGABYTE;
+    cacheStats["7. Locked (MB)"] = (double)_mappedFiles.getNumLockedBytes() / BYTES_PER_MEGABYTE;
+    serverStats["hot_asset_cache"] = cacheStats;
+
+    QJsonObject chunkStats;
+    chunkStats["1. Assets"] = _chunkStore.getNumAssets();
+    chunkStats["2. Chunks"] = _chunkStore.getNumChunks();
+    chunkStats["3. Asset Size (MB)"] = (double)_chunkStore.getNumAssetBytes() / BYTES_PER_MEGABYTE;
+    chunkStats["4. Stored (MB)"] = (double)_chunkStore.getNumStoredBytes() / BYTES_PER_MEGABYTE;
+    chunkStats["5. Deduplicated (MB)"] =
+        (double)(_chunkStore.getNumAssetBytes() - _chunkStore.getNumStoredBytes()) / BYTES_PER_MEGABYTE;
+    serverStats["chunked_storage"] = chunkStats;
+
+    QJsonObject mappingStats;
+    mappingStats["1. Mappings"] = _fileMappings.getNumMappings();
+    mappingStats["2. Writes"] = _fileMappings.getNumWrites();
+    mappingStats["3. Avg Write (ms)"] = (double)_fileMappings.getAverageWriteUsecs() / USECS_PER_MSEC;
+    mappingStats["4. Max Write (ms)"] = (double)_fileMappings.getMaxWriteUsecs() / USECS_PER_MSEC;
+    mappingStats["5. Log Size (KB)"] = (double)_fileMappings.getLogSize() / BYTES_PER_KILOBYTE;
+    mappingStats["6. Snapshot Size (KB)"] = (double)_fileMappings.getSnapshotSize() / BYTES_PER_KILOBYTE;
+    mappingStats["7. Compactions"] = _fileMappings.getNumCompactions();
+    mappingStats["8. Last Compaction (ms)"] = (double)_fileMappings.getLastCompactionUsecs() / USECS_PER_MSEC;
+    serverStats["mapping_store"] = mappingStats;
+
     // send off the stats packets
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(serverStats);
 }
 
-static const QString MAP_FILE_NAME = "map.json";
-
-bool AssetServer::loadMappingsFromFile() {
-
-    auto mapFilePath = _resourcesDirectory.absoluteFilePath(MAP_FILE_NAME);
-
-    QFile mapFile { mapFilePath };
-    if (mapFile.exists()) {
-        if (mapFile.open(QIODevice::ReadOnly)) {
-            QJsonParseError error;
-
-            auto jsonDocument = QJsonDocument::fromJson(mapFile.readAll(), &error);
-
-            if (error.error == QJsonParseError::NoError) {
-                _fileMappings = jsonDocument.object().toVariantHash();
-
-                // remove any mappings that don't match the expected format
-                auto it = _fileMappings.begin();
-                while (it != _fileMappings.end()) {
-                    bool shouldDrop = false;
-
-                    if (!isValidFilePath(it.key())) {
-                        qWarning() << "Will not keep mapping for" << it.key() << "since it is not a valid path.";
-                        shouldDrop = true;
-                    }
-
-                    if (!isValidHash(it.value().toString())) {
-                        qWarning() << "Will not keep mapping for" << it.key() << "since it does not have a valid hash.";
-                        shouldDrop = true;
-                    }
-
-                    if (shouldDrop) {
-                        it = _fileMappings.erase(it);
-                    } else {
-                        ++it;
-                    }
-                }
-
-                qInfo() << "Loaded" << _fileMappings.count() << "mappings from map file at" << mapFilePath;
-                return true;
-            }
-        }
-
-        qCritical() << "Failed to read mapping file at" << mapFilePath;
-        return false;
-    } else {
-        qInfo() << "No existing mappings loaded from file since no file was found at" << mapFilePath;
-    }
-
-    return true;
-}
-
-bool AssetServer::writeMappingsToFile() {
-    auto mapFilePath = _resourcesDirectory.absoluteFilePath(MAP_FILE_NAME);
-
-    QFile mapFile { mapFilePath };
-    if (mapFile.open(QIODevice::WriteOnly)) {
-        auto jsonObject = QJsonObject::fromVariantHash(_fileMappings);
-        QJsonDocument jsonDocument { jsonObject };
-
-        if (mapFile.write(jsonDocument.toJson()) != -1) {
-            qDebug() << "Wrote JSON mappings to file at" << mapFilePath;
-            return true;
-        } else {
-            qWarning() << "Failed to write JSON mappings to file at" << mapFilePath;
-        }
-    } else {
-        qWarning() << "Failed to open map file at" << mapFilePath;
+bool AssetServer::applyMappingChanges(const AssetMappingStore::Changes& changes) {
+    if (_fileMappings.apply(changes)) {
+        _serializedMappings.clear();
+        return true;
     }
 
     return false;
@@ -574,27 +638,12 @@ bool AssetServer::setMapping(AssetPath path, AssetHash hash) {
         return false;
     }
 
-    // remember what the old mapping was in case persistence fails
-    auto oldMapping = _fileMappings.value(path).toString();
-
-    // update the in memory QHash
-    _fileMappings[path] = hash;
-
-    // attempt to write to file
-    if (writeMappingsToFile()) {
-        // persistence succeeded, we are good to go
+    // the mapping is only changed once it is persisted
+    if (applyMappingChanges({ { path, hash } })) {
         qDebug() << "Set mapping:" << path << "=>" << hash;
         return true;
     } else {
-        // failed to persist this mapping to file - put back the old one in our in-memory representation
-        if (oldMapping.isEmpty()) {
-            _fileMappings.remove(path);
-        } else {
-            _fileMappings[path] = oldMapping;
-        }
-
         qWarning() << "Failed to persist mapping:" << path << "=>" << hash;
-
         return false;
     }
 }
@@ -604,8 +653,7 @@ bool pathIsFolder(const AssetPath& path) {
 }
 
 bool AssetServer::deleteMappings(AssetPathList& paths) {
-    // take a copy of the current mappings in case persistence of these deletes fails
-    auto oldMappings = _fileMappings;
+    AssetMappingStore::Changes changes;
 
     QSet<QString> hashesToCheckForDeletion;
 
@@ -616,59 +664,49 @@ bool AssetServer::deleteMappings(AssetPathList& paths) {
 
         // figure out if this path will delete a file or folder
         if (pathIsFolder(path)) {
-            // enumerate the in memory file mappings and remove anything that matches
-            auto it = _fileMappings.begin();
-            auto sizeBefore = _fileMappings.size();
+            // remove every mapping in the folder
+            auto folderMappings = _fileMappings.getMappingsInFolder(path);
 
-            while (it != _fileMappings.end()) {
-                if (it.key().startsWith(path)) {
-                    // add this hash to the list we need to check for asset removal from the server
-                    hashesToCheckForDeletion << it.value().toString();
+            for (auto& mapping : folderMappings) {
+                // add this hash to the list we need to check for asset removal from the server
+                hashesToCheckForDeletion << mapping.second;
 
-                    it = _fileMappings.erase(it);
-                } else {
-                    ++it;
-                }
+                changes.emplace_back(mapping.first, AssetHash());
             }
 
-            auto sizeNow = _fileMappings.size();
-            if (sizeBefore != sizeNow) {
-                qDebug() << "Deleted" << sizeBefore - sizeNow << "mappings in folder: " << path;
+            if (!folderMappings.empty()) {
+                qDebug() << "Deleted" << folderMappings.size() << "mappings in folder: " << path;
             } else {
                 qDebug() << "Did not find any mappings to delete in folder:" << path;
             }
 
         } else {
-            auto oldMapping = _fileMappings.take(path);
-            if (!oldMapping.isNull()) {
+            auto oldMapping = _fileMappings.getMapping(path);
+            if (!oldMapping.isEmpty()) {
                 // add this hash to the list we need to check for asset removal from server
-                hashesToCheckForDeletion << oldMapping.toString();
+                hashesToCheckForDeletion << oldMapping;
 
-                qDebug() << "Deleted a mapping:" << path << "=>" << oldMapping.toString();
+                changes.emplace_back(path, AssetHash());
+
+                qDebug() << "Deleted a mapping:" << path << "=>" << oldMapping;
             } else {
                 qDebug() << "Unable to delete a mapping that was not found:" << path;
             }
         }
     }
 
-    // deleted the old mappings, attempt to persist to file
-    if (writeMappingsToFile()) {
+    // the mappings are only deleted once the deletes are persisted
+    if (applyMappingChanges(changes)) {
         // persistence succeeded we are good to go
 
-        // grab the current mapped hashes
-        auto mappedHashes = _fileMappings.values();
-
-        // enumerate the mapped hashes and clear the list of hashes to check for anything that's present
-        for (auto& hashVariant : mappedHashes) {
-            auto it = hashesToCheckForDeletion.find(hashVariant.toString());
-            if (it != hashesToCheckForDeletion.end()) {
-                hashesToCheckForDeletion.erase(it);
+        // delete the asset files of the hashes that are now unmapped
+        for (auto& hash : hashesToCheckForDeletion) {
+            if (_fileMappings.isMapped(hash)) {
+                continue;
             }
-        }
 
-        // we now have a set of hashes that are unmapped - we will delete those asset files
-        for (auto& hash : hashesToCheckForDeletion) {
-            // remove the unmapped file
+            // remove the unmapped file, after its mapping for sends
+            _mappedFiles.remove(_filesDirectory.absoluteFilePath(hash));
             QFile removeableFile { _filesDirectory.absoluteFilePath(hash) };
 
             if (removeableFile.remove()) {
@@ -676,14 +714,13 @@ bool AssetServer::deleteMappings(AssetPathList& paths) {
             } else {
                 qDebug() << "\tAttempt to delete unmapped file" << hash << "failed";
             }
+
+            _chunkStore.removeAsset(hash);
         }
 
         return true;
     } else {
-        qWarning() << "Failed to persist deleted mappings, rolling back";
-
-        // we didn't delete the previous mapping, put it back in our in-memory representation
-        _fileMappings = oldMappings;
+        qWarning() << "Failed to persist deleted mappings, keeping them";
 
         return false;
     }
@@ -709,34 +746,28 @@ bool AssetServer::renameMapping(AssetPath oldPath, AssetPath newPath) {
             return false;
         }
 
-        // take a copy of the old mappings
-        auto oldMappings = _fileMappings;
+        auto folderMappings = _fileMappings.getMappingsInFolder(oldPath);
 
-        // iterate the current mappings and adjust any that matches the renamed folder
-        auto it = oldMappings.begin();
+        // remove all of the old paths before adding any of the new ones, since they can overlap
+        AssetMappingStore::Changes changes;
 
-        while (it != oldMappings.end()) {
-            if (it.key().startsWith(oldPath)) {
-                auto newKey = it.key();
-                newKey.replace(0, oldPath.size(), newPath);
+        for (auto& mapping : folderMappings) {
+            changes.emplace_back(mapping.first, AssetHash());
+        }
 
-                // remove the old version from the in memory file mappings
-                _fileMappings.remove(it.key());
-                _fileMappings.insert(newKey, it.value());
-            }
+        for (auto& mapping : folderMappings) {
+            auto newKey = mapping.first;
+            newKey.replace(0, oldPath.size(), newPath);
 
-            ++it;
+            changes.emplace_back(newKey, mapping.second);
         }
 
-        if (writeMappingsToFile()) {
+        if (applyMappingChanges(changes)) {
             // persisted the changed mappings, return success
             qDebug() << "Renamed folder mapping:" << oldPath << "=>" << newPath;
 
             return true;
         } else {
-            // couldn't persist the renamed paths, rollback and return failure
-            _fileMappings = oldMappings;
-
             qWarning() << "Failed to persist renamed folder mapping:" << oldPath << "=>" << newPath;
 
             return false;
@@ -749,32 +780,16 @@ bool AssetServer::renameMapping(AssetPath oldPath, AssetPath newPath) {
             return false;
         }
 
-        // take the old hash to remove the old mapping
-        auto oldSourceMapping = _fileMappings.take(oldPath).toString();
-
-        // in case we're overwriting, keep the current destination mapping for potential rollback
-        auto oldDestinationMapping = _fileMappings.value(newPath);
+        auto oldSourceMapping = _fileMappings.getMapping(oldPath);
 
         if (!oldSourceMapping.isEmpty()) {
-            _fileMappings[newPath] = oldSourceMapping;
-
-            if (writeMappingsToFile()) {
+            // the mapping replaces whatever the new path was mapped to
+            if (applyMappingChanges({ { oldPath, AssetHash() }, { newPath, oldSourceMapping } })) {
                 // persisted the renamed mapping, return success
                 qDebug() << "Renamed mapping:" << oldPath << "=>" << newPath;
 
                 return true;
             } else {
-                // we couldn't persist the renamed mapping, rollback and return failure
-                _fileMappings[oldPath] = oldSourceMapping;
-
-                if (!oldDestinationMapping.isNull()) {
-                    // put back the overwritten mapping for the destination path
-                    _fileMappings[newPath] = oldDestinationMapping.toString();
-                } else {
-                    // clear the new mapping
-                    _fileMappings.remove(newPath);
-                }
-
                 qDebug() << "Failed to persist renamed mapping:" << oldPath << "=>" << newPath;
 
                 return false;
@@ -17,7 +17,10 @@
 
 #include <ThreadedAssignment.h>
 
+#include "AssetChunkStore.h"
+#include "AssetMappingStore.h"
 #include "AssetUtils.h"
+#include "MappedFileCache.h"
 #include "ReceivedMessage.h"
 
 class AssetServer : public ThreadedAssignment {
@@ -34,22 +37,20 @@ private slots:
     void handleAssetGetInfo(QSharedPointer<ReceivedMessage> packet, SharedNodePointer senderNode);
     void handleAssetGet(QSharedPointer<ReceivedMessage> packet, SharedNodePointer senderNode);
     void handleAssetUpload(QSharedPointer<ReceivedMessage> packetList, SharedNodePointer senderNode);
+    void handleAssetChunkQuery(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleAssetMappingOperation(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
 
     void sendStatsPacket() override;
 
 private:
-    using Mappings = QVariantHash;
-
     void handleGetMappingOperation(ReceivedMessage& message, SharedNodePointer senderNode, NLPacketList& replyPacket);
     void handleGetAllMappingOperation(ReceivedMessage& message, SharedNodePointer senderNode, NLPacketList& replyPacket);
     void handleSetMappingOperation(ReceivedMessage& message, SharedNodePointer senderNode, NLPacketList& replyPacket);
     void handleDeleteMappingsOperation(ReceivedMessage& message, SharedNodePointer senderNode, NLPacketList& replyPacket);
     void handleRenameMappingOperation(ReceivedMessage& message, SharedNodePointer senderNode, NLPacketList& replyPacket);
 
-    // Mapping file operations must be called from main assignment thread only
-    bool loadMappingsFromFile();
-    bool writeMappingsToFile();
+    // Mapping operations must be called from main assignment thread only
+    bool applyMappingChanges(const AssetMappingStore::Changes& changes);
 
     /// Set the mapping for path to hash
     bool setMapping(AssetPath path, AssetHash hash);
@@ -63,10 +64,14 @@ private:
     // deletes any unmapped files from the local asset directory
     void cleanupUnmappedFiles();
 
-    Mappings _fileMappings;
+    AssetMappingStore _fileMappings;
+    QByteArray _serializedMappings; // the mappings as they are sent to get all of them, built as they are asked for
 
     QDir _resourcesDirectory;
     QDir _filesDirectory;
+    MappedFileCache _mappedFiles; // the hot asset files, mapped for sends - must outlive the tasks
+    AssetChunkStore _chunkStore { _mappedFiles }; // the assets stored as chunks - must outlive the tasks
+    bool _storeUploadsAsChunks { false };
     QThreadPool _taskPool;
 };
 
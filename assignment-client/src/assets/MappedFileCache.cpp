@@ -0,0 +1,192 @@
+//
+//  MappedFileCache.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MappedFileCache.h"
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#include <QtCore/QDebug>
+
+MappedFile::MappedFile(const QString& filePath) :
+    _file(filePath)
+{
+    if (_file.open(QIODevice::ReadOnly)) {
+        _size = _file.size();
+
+        if (_size == 0) {
+            // empty files can't be mapped, but there is nothing to read from them either
+            _isValid = true;
+        } else {
+            _data = reinterpret_cast<const char*>(_file.map(0, _size));
+            _isValid = _data != nullptr;
+        }
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (_data) {
+        // unmapping also unlocks the pages
+        _file.unmap(reinterpret_cast<uchar*>(const_cast<char*>(_data)));
+    }
+}
+
+void MappedFile::load() {
+    if (!_data) {
+        return;
+    }
+
+    // locking the pages faults the whole file in, and keeps it in memory until it is unmapped
+#ifdef Q_OS_WIN
+    _isLocked = VirtualLock(const_cast<char*>(_data), _size) != 0;
+#else
+    _isLocked = mlock(_data, _size) == 0;
+#endif
+    if (_isLocked) {
+        return;
+    }
+
+    static std::once_flag warnOnce;
+    std::call_once(warnOnce, [] {
+        qWarning() << "Could not lock an asset file in memory, so the hot asset cache may be paged out."
+            << "Raise the locked memory limit of the asset-server to the size of the cache to keep it in memory.";
+    });
+
+#ifndef Q_OS_WIN
+    // at least read the file ahead, rather than a page at a time as it is used
+    madvise(const_cast<char*>(_data), _size, MADV_WILLNEED);
+#endif
+
+    // touching a byte of every page faults the file in from start to end
+    static const qint64 PAGE_SIZE = 4096;
+
+    volatile char sum = 0;
+    for (qint64 offset = 0; offset < _size; offset += PAGE_SIZE) {
+        sum += _data[offset];
+    }
+}
+
+MappedFilePointer MappedFileCache::get(const QString& filePath, bool* isCached) {
+    std::promise<MappedFilePointer> promise;
+    std::shared_future<MappedFilePointer> loadingFile;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto it = _files.find(filePath);
+        if (it != _files.end()) {
+            // move the file to the front of the recently used files
+            _recentFiles.splice(_recentFiles.begin(), _recentFiles, it.value());
+            ++_numHits;
+
+            if (isCached) {
+                *isCached = true;
+            }
+            return _recentFiles.front().second;
+        }
+
+        auto loadingIt = _loadingFiles.find(filePath);
+        if (loadingIt != _loadingFiles.end()) {
+            loadingFile = loadingIt.value();
+        } else {
+            _loadingFiles.insert(filePath, promise.get_future().share());
+        }
+    }
+
+    if (loadingFile.valid()) {
+        // someone else is loading the file - wait for them rather than reading it again
+        ++_numCoalesced;
+        auto mappedFile = loadingFile.get();
+
+        if (isCached) {
+            *isCached = mappedFile != nullptr;
+        }
+        return mappedFile;
+    }
+
+    // map and load the file without holding the lock, since it has to wait on the disk
+    ++_numMisses;
+    MappedFilePointer mappedFile;
+    bool shouldKeep = false;
+    {
+        auto newFile = std::make_shared<MappedFile>(filePath);
+        if (newFile->isValid()) {
+            shouldKeep = newFile->size() <= _maxBytes;
+            if (shouldKeep) {
+                newFile->load();
+            }
+            mappedFile = newFile;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _loadingFiles.remove(filePath);
+
+        if (_removedLoadingFiles.remove(filePath)) {
+            shouldKeep = false;
+        }
+
+        if (shouldKeep) {
+            _recentFiles.emplace_front(filePath, mappedFile);
+            _files.insert(filePath, _recentFiles.begin());
+            _numCachedBytes += mappedFile->size();
+            if (mappedFile->isLocked()) {
+                _numLockedBytes += mappedFile->size();
+            }
+
+            evict();
+        }
+    }
+
+    promise.set_value(mappedFile);
+
+    if (isCached) {
+        *isCached = false;
+    }
+    return mappedFile;
+}
+
+void MappedFileCache::remove(const QString& filePath) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _files.find(filePath);
+    if (it != _files.end()) {
+        forgetBytes(*it.value()->second);
+        _recentFiles.erase(it.value());
+        _files.erase(it);
+    } else if (_loadingFiles.contains(filePath)) {
+        _removedLoadingFiles.insert(filePath);
+    }
+}
+
+void MappedFileCache::setMaxBytes(qint64 maxBytes) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _maxBytes = maxBytes;
+    evict();
+}
+
+void MappedFileCache::evict() {
+    while (!_recentFiles.empty() && (_numCachedBytes > _maxBytes || (int)_recentFiles.size() > _maxFiles)) {
+        forgetBytes(*_recentFiles.back().second);
+        _files.remove(_recentFiles.back().first);
+        _recentFiles.pop_back();
+    }
+}
+
+void MappedFileCache::forgetBytes(const MappedFile& mappedFile) {
+    _numCachedBytes -= mappedFile.size();
+    if (mappedFile.isLocked()) {
+        _numLockedBytes -= mappedFile.size();
+    }
+}
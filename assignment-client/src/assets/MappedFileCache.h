@@ -0,0 +1,107 @@
+//
+//  MappedFileCache.h
+//  assignment-client/src/assets
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_MappedFileCache_h
+#define hifi_MappedFileCache_h
+
+#include <atomic>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+
+// A read-only memory mapping of a whole file, unmapped once the last reference to it goes away
+class MappedFile {
+public:
+    MappedFile(const QString& filePath);
+    ~MappedFile();
+
+    bool isValid() const { return _isValid; }
+    qint64 size() const { return _size; }
+    const char* data() const { return _data; }
+
+    // reads the whole file into memory in one pass, instead of a page at a time as it is used,
+    // and locks it there if the locked memory limit of the process allows it
+    void load();
+    bool isLocked() const { return _isLocked; }
+
+private:
+    QFile _file;
+    qint64 _size { 0 };
+    const char* _data { nullptr };
+    bool _isValid { false };
+    bool _isLocked { false };
+};
+
+using MappedFilePointer = std::shared_ptr<const MappedFile>;
+
+// Keeps the most recently used files mapped and locked in memory, so that hot files are read from disk once
+//   The pages of a file are locked when the locked memory limit of the process allows it, and otherwise only read
+//   ahead, in which case the system may page them out again under memory pressure.
+//   The files are loaded by whoever asks for them first, while whoever asks for them in the meantime waits for that
+//   load instead of reading the file again. Files larger than the cache are mapped for whoever asks for them, but
+//   not kept. Evicted and removed mappings stay valid for whoever still holds them.
+class MappedFileCache {
+public:
+    MappedFileCache(qint64 maxBytes = DEFAULT_MAX_BYTES, int maxFiles = DEFAULT_MAX_FILES) :
+        _maxBytes(maxBytes), _maxFiles(maxFiles) {}
+
+    // returns the mapping of the file, or nullptr if the file could not be mapped
+    // isCached is set to whether the file was already in memory, or being loaded by someone else
+    MappedFilePointer get(const QString& filePath, bool* isCached = nullptr);
+
+    // forgets the mapping of a file, before it is changed or deleted
+    void remove(const QString& filePath);
+
+    void setMaxBytes(qint64 maxBytes);
+
+    // counts bytes sent from files that were already cached, for the stats
+    void addBytesServedFromMemory(qint64 bytes) { _bytesServedFromMemory += bytes; }
+
+    int getNumHits() const { return _numHits; }
+    int getNumCoalesced() const { return _numCoalesced; }
+    int getNumMisses() const { return _numMisses; }
+    qint64 getBytesServedFromMemory() const { return _bytesServedFromMemory; }
+    qint64 getNumCachedBytes() const { return _numCachedBytes; }
+    qint64 getNumLockedBytes() const { return _numLockedBytes; }
+
+    static const qint64 DEFAULT_MAX_BYTES = 512 * 1024 * 1024;
+    static const int DEFAULT_MAX_FILES = 256;
+
+private:
+    using RecentFiles = std::list<std::pair<QString, MappedFilePointer>>; // the most recently used first
+
+    void evict(); // must be called with the lock held
+    void forgetBytes(const MappedFile& mappedFile); // must be called with the lock held
+
+    std::mutex _mutex;
+    RecentFiles _recentFiles;
+    QHash<QString, RecentFiles::iterator> _files;
+    QHash<QString, std::shared_future<MappedFilePointer>> _loadingFiles;
+    QSet<QString> _removedLoadingFiles; // removed while they were loading, so not to be kept once loaded
+    std::atomic<qint64> _numCachedBytes { 0 };
+    std::atomic<qint64> _numLockedBytes { 0 };
+    std::atomic<qint64> _maxBytes;
+    int _maxFiles;
+
+    std::atomic<int> _numHits { 0 };
+    std::atomic<int> _numCoalesced { 0 };
+    std::atomic<int> _numMisses { 0 };
+    std::atomic<qint64> _bytesServedFromMemory { 0 };
+};
+
+#endif // hifi_MappedFileCache_h
@@ -13,8 +13,6 @@
 
 #include <cmath>
 
-#include <QFile>
-
 #include <DependencyManager.h>
 #include <NetworkLogging.h>
 #include <NLPacket.h>
@@ -26,11 +24,17 @@
 #include "ByteRange.h"
 #include "ClientServerUtils.h"
 
-SendAssetTask::SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir) :
+// ranges up to this size are written to the reply right away, larger ones as the reply is sent
+static const qint64 MAX_IMMEDIATE_WRITE_BYTES = 64 * 1024;
+
+SendAssetTask::SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir,
+                             MappedFileCache& mappedFiles, const AssetChunkStore& chunkStore) :
     QRunnable(),
     _message(message),
     _senderNode(sendToNode),
-    _resourcesDir(resourcesDir)
+    _resourcesDir(resourcesDir),
+    _mappedFiles(mappedFiles),
+    _chunkStore(chunkStore)
 {
     
 }
@@ -63,18 +67,23 @@ void SendAssetTask::run() {
     if (!byteRange.isValid()) {
         replyPacketList->writePrimitive(AssetServerError::InvalidByteRange);
     } else {
-        QString filePath = _resourcesDir.filePath(QString(hexHash));
+        QString filePath = _resourcesDir.absoluteFilePath(QString(hexHash));
         
-        QFile file { filePath };
+        // assets stored as chunks have no whole file, so they aren't looked up in the cache of whole files
+        auto chunkIndex = _chunkStore.getAsset(hexHash);
 
-        if (file.open(QIODevice::ReadOnly)) {
+        bool isCached = false;
+        auto mappedFile = chunkIndex ? MappedFilePointer() : _mappedFiles.get(filePath, &isCached);
+
+        if (mappedFile || chunkIndex) {
+            auto fileSize = mappedFile ? mappedFile->size() : chunkIndex->size;
 
             // first fixup the range based on the now known file size
-            byteRange.fixupRange(file.size());
+            byteRange.fixupRange(fileSize);
 
             // check if we're being asked to read data that we just don't have
             // because of the file size
-            if (file.size() < byteRange.fromInclusive || file.size() < byteRange.toExclusive) {
+            if (fileSize < byteRange.fromInclusive || fileSize < byteRange.toExclusive) {
                 replyPacketList->writePrimitive(AssetServerError::InvalidByteRange);
                 qCDebug(networking) << "Bad byte range: " << hexHash << " "
                     << byteRange.fromInclusive << ":" << byteRange.toExclusive;
@@ -82,29 +91,63 @@ void SendAssetTask::run() {
                 // we have a valid byte range, handle it and send the asset
                 auto size = byteRange.size();
 
-                if (byteRange.fromInclusive >= 0) {
+                // a negative range is read back from the end of the file
+                auto offset = byteRange.fromInclusive >= 0 ? byteRange.fromInclusive : fileSize + byteRange.fromInclusive;
 
-                    // this range is positive, meaning we just need to seek into the file and then read from there
-                    file.seek(byteRange.fromInclusive);
+                // the chunks the range spans are all checked before the reply says it has them
+                std::shared_ptr<AssetChunkReader> chunkReader;
+                if (chunkIndex) {
+                    chunkReader = std::make_shared<AssetChunkReader>(_chunkStore, _mappedFiles, chunkIndex,
+                                                                     offset, size);
+                }
+
+                if (chunkReader && !chunkReader->open()) {
+                    replyPacketList->writePrimitive(AssetServerError::FileOperationFailed);
+                    qCWarning(networking) << "Could not read the chunks of asset: " << hexHash;
+                } else if (chunkReader) {
                     replyPacketList->writePrimitive(AssetServerError::NoError);
                     replyPacketList->writePrimitive(size);
-                    replyPacketList->write(file.read(size));
-                } else {
-                    // this range is negative, at least the first part of the read will be back into the end of the file
 
-                    // seek to the part of the file where the negative range begins
-                    file.seek(file.size() + byteRange.fromInclusive);
+                    if (size <= MAX_IMMEDIATE_WRITE_BYTES) {
+                        chunkReader->read(*replyPacketList, size);
+                    } else {
+                        replyPacketList->setDeferredWriter([chunkReader](udt::PacketList& packetList, qint64 maxBytes) {
+                            return chunkReader->read(packetList, maxBytes);
+                        });
+                    }
 
+                    qCDebug(networking) << "Sending asset from chunks: " << hexHash;
+                } else {
                     replyPacketList->writePrimitive(AssetServerError::NoError);
                     replyPacketList->writePrimitive(size);
 
-                    // first write everything from the negative range to the end of the file
-                    replyPacketList->write(file.read(size));
-                }
+                    const char* data = mappedFile->data() + offset;
+
+                    if (size <= MAX_IMMEDIATE_WRITE_BYTES) {
+                        replyPacketList->write(data, size);
+                    } else {
+                        // write the range straight from the mapping as the reply is sent, so that only the packets
+                        // about to be sent are in memory - the mapping stays alive until the reply is written
+                        qint64 bytesRemaining = size;
+                        replyPacketList->setDeferredWriter([mappedFile, data, bytesRemaining](udt::PacketList& packetList,
+                                                                                             qint64 maxBytes) mutable {
+                            auto bytesToWrite = std::min(bytesRemaining, maxBytes);
+                            packetList.write(data, bytesToWrite);
+
+                            data += bytesToWrite;
+                            bytesRemaining -= bytesToWrite;
 
-                qCDebug(networking) << "Sending asset: " << hexHash;
+                            return bytesRemaining > 0;
+                        });
+                    }
+
+                    if (isCached) {
+                        _mappedFiles.addBytesServedFromMemory(size);
+                    }
+
+                    qCDebug(networking) << "Sending asset: " << hexHash;
+                }
             }
-            file.close();
         } else {
             qCDebug(networking) << "Asset not found: " << filePath << "(" << hexHash << ")";
             replyPacketList->writePrimitive(AssetServerError::AssetNotFound);
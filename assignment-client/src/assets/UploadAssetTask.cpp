@@ -12,6 +12,7 @@
 #include "UploadAssetTask.h"
 
 #include <QtCore/QBuffer>
+#include <QtCore/QCryptographicHash>
 #include <QtCore/QFile>
 
 #include <AssetUtils.h>
@@ -22,15 +23,29 @@
 
 
 UploadAssetTask::UploadAssetTask(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode,
-                                 const QDir& resourcesDir) :
+                                 const QDir& resourcesDir, AssetChunkStore* chunkStore) :
     _receivedMessage(receivedMessage),
     _senderNode(senderNode),
-    _resourcesDir(resourcesDir)
+    _resourcesDir(resourcesDir),
+    _chunkStore(chunkStore)
 {
     
 }
 
 void UploadAssetTask::run() {
+    auto replyPacket = NLPacket::create(PacketType::AssetUploadReply, -1, true);
+
+    if (_receivedMessage->getType() == PacketType::AssetChunkUpload) {
+        runChunkUpload(*replyPacket);
+    } else {
+        runWholeUpload(*replyPacket);
+    }
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    nodeList->sendPacket(std::move(replyPacket), *_senderNode);
+}
+
+void UploadAssetTask::runWholeUpload(NLPacket& replyPacket) {
     auto data = _receivedMessage->getMessage();
     
     QBuffer buffer { &data };
@@ -45,63 +60,226 @@ void UploadAssetTask::run() {
     qDebug() << "UploadAssetTask reading a file of " << fileSize << "bytes from"
         << uuidStringWithoutCurlyBraces(_senderNode->getUUID());
     
-    auto replyPacket = NLPacket::create(PacketType::AssetUploadReply, -1, true);
-    replyPacket->writePrimitive(messageID);
+    replyPacket.writePrimitive(messageID);
     
     if (fileSize > MAX_UPLOAD_SIZE) {
-        replyPacket->writePrimitive(AssetServerError::AssetTooLarge);
-    } else {
+        replyPacket.writePrimitive(AssetServerError::AssetTooLarge);
+    } else if (_chunkStore) {
         QByteArray fileData = buffer.read(fileSize);
-        
-        auto hash = hashData(fileData);
-        auto hexHash = hash.toHex();
-        
-        qDebug() << "Hash for uploaded file from" << uuidStringWithoutCurlyBraces(_senderNode->getUUID())
-            << "is: (" << hexHash << ") ";
-        
-        QFile file { _resourcesDir.filePath(QString(hexHash)) };
-
-        bool existingCorrectFile = false;
-        
-        if (file.exists()) {
-            // check if the local file has the correct contents, otherwise we overwrite
-            if (file.open(QIODevice::ReadOnly) && hashData(file.readAll()) == hash) {
-                qDebug() << "Not overwriting existing verified file: " << hexHash;
-
-                existingCorrectFile = true;
-
-                replyPacket->writePrimitive(AssetServerError::NoError);
-                replyPacket->write(hash);
-            } else {
-                qDebug() << "Overwriting an existing file whose contents did not match the expected hash: " << hexHash;
-                file.close();
+
+        // cut the file the way uploads of chunks are, so that it shares their chunks
+        auto index = std::make_shared<AssetChunkIndex>();
+        index->size = fileData.size();
+        index->chunks = chunkAssetData(fileData);
+
+        for (auto& chunk : index->chunks) {
+            if (!_chunkStore->writeChunk(chunk.hash, fileData.constData() + chunk.offset, chunk.size)) {
+                replyPacket.writePrimitive(AssetServerError::FileOperationFailed);
+                return;
             }
         }
 
-        if (!existingCorrectFile) {
-            if (file.open(QIODevice::WriteOnly) && file.write(fileData) == qint64(fileSize)) {
-                qDebug() << "Wrote file" << hexHash << "to disk. Upload complete";
-                file.close();
+        storeChunkedAsset(hashData(fileData), index, replyPacket);
+    } else {
+        storeFile(buffer.read(fileSize), replyPacket);
+    }
+}
+
+void UploadAssetTask::runChunkUpload(NLPacket& replyPacket) {
+    MessageID messageID { 0 };
+    if (_receivedMessage->getBytesLeftToRead() < (qint64)sizeof(messageID)) {
+        qWarning() << "Received a malformed chunk upload from" << uuidStringWithoutCurlyBraces(_senderNode->getUUID());
+        replyPacket.writePrimitive(messageID);
+        replyPacket.writePrimitive(AssetServerError::FileOperationFailed);
+        return;
+    }
+    _receivedMessage->readPrimitive(&messageID);
+    replyPacket.writePrimitive(messageID);
+
+    auto index = readAssetChunkIndex(*_receivedMessage);
+    if (!index) {
+        qWarning() << "Received a malformed chunk upload from" << uuidStringWithoutCurlyBraces(_senderNode->getUUID());
+        replyPacket.writePrimitive(AssetServerError::FileOperationFailed);
+        return;
+    }
+
+    if ((uint64_t)index->size > MAX_UPLOAD_SIZE) {
+        replyPacket.writePrimitive(AssetServerError::AssetTooLarge);
+        return;
+    }
+
+    uint32_t numSentChunks;
+    if (_receivedMessage->getBytesLeftToRead() < (qint64)sizeof(numSentChunks)) {
+        qWarning() << "Received a malformed chunk upload from" << uuidStringWithoutCurlyBraces(_senderNode->getUUID());
+        replyPacket.writePrimitive(AssetServerError::FileOperationFailed);
+        return;
+    }
+    _receivedMessage->readPrimitive(&numSentChunks);
+
+    // a chunk is only sent once, and its index must be there to read
+    if (numSentChunks > index->chunks.size()
+        || _receivedMessage->getBytesLeftToRead() < (qint64)(numSentChunks * sizeof(uint32_t))) {
+        qWarning() << "Received a malformed chunk upload from" << uuidStringWithoutCurlyBraces(_senderNode->getUUID());
+        replyPacket.writePrimitive(AssetServerError::FileOperationFailed);
+        return;
+    }
+
+    std::vector<uint32_t> sentChunks;
+    sentChunks.reserve(numSentChunks);
+    for (uint32_t i = 0; i < numSentChunks; ++i) {
+        uint32_t chunkIndex;
+        _receivedMessage->readPrimitive(&chunkIndex);
+
+        if (chunkIndex >= index->chunks.size()) {
+            qWarning() << "Received a malformed chunk upload from" << uuidStringWithoutCurlyBraces(_senderNode->getUUID());
+            replyPacket.writePrimitive(AssetServerError::FileOperationFailed);
+            return;
+        }
+        sentChunks.push_back(chunkIndex);
+    }
+
+    qDebug() << "UploadAssetTask reading" << numSentChunks << "of" << index->chunks.size() << "chunks of a file of"
+        << index->size << "bytes from" << uuidStringWithoutCurlyBraces(_senderNode->getUUID());
+
+    // the sent chunks follow, in the order of their indices - check each of them against its hash
+    std::vector<const char*> sentChunkData(index->chunks.size(), nullptr);
+
+    for (auto chunkIndex : sentChunks) {
+        if (_receivedMessage->getBytesLeftToRead() < index->chunks[chunkIndex].size) {
+            qWarning() << "Received a malformed chunk upload from" << uuidStringWithoutCurlyBraces(_senderNode->getUUID());
+            replyPacket.writePrimitive(AssetServerError::FileOperationFailed);
+            return;
+        }
+
+        auto& chunk = index->chunks[chunkIndex];
+        auto chunkData = _receivedMessage->getRawMessage() + _receivedMessage->getPosition();
+        _receivedMessage->seek(_receivedMessage->getPosition() + chunk.size);
+
+        if (hashData(QByteArray::fromRawData(chunkData, chunk.size)) != chunk.hash) {
+            qWarning() << "Chunk" << chunkIndex << "of upload from" << uuidStringWithoutCurlyBraces(_senderNode->getUUID())
+                << "does not match its hash - upload failed.";
+            replyPacket.writePrimitive(AssetServerError::FileOperationFailed);
+            return;
+        }
 
-                replyPacket->writePrimitive(AssetServerError::NoError);
-                replyPacket->write(hash);
-            } else {
-                qWarning() << "Failed to upload or write to file" << hexHash << " - upload failed.";
+        sentChunkData[chunkIndex] = chunkData;
+    }
 
-                // upload has failed - remove the file and return an error
-                auto removed = file.remove();
+    if (!_chunkStore) {
+        // without chunk storage every chunk was asked for, and they make up the file
+        QByteArray fileData;
+        fileData.reserve(index->size);
 
-                if (!removed) {
-                    qWarning() << "Removal of failed upload file" << hexHash << "failed.";
-                }
-                
-                replyPacket->writePrimitive(AssetServerError::FileOperationFailed);
+        for (size_t i = 0; i < index->chunks.size(); ++i) {
+            if (!sentChunkData[i]) {
+                replyPacket.writePrimitive(AssetServerError::FileOperationFailed);
+                return;
             }
+            fileData.append(sentChunkData[i], index->chunks[i].size);
+        }
+
+        storeFile(fileData, replyPacket);
+        return;
+    }
+
+    for (size_t i = 0; i < index->chunks.size(); ++i) {
+        auto& chunk = index->chunks[i];
+        if (sentChunkData[i] && !_chunkStore->writeChunk(chunk.hash, sentChunkData[i], chunk.size)) {
+            replyPacket.writePrimitive(AssetServerError::FileOperationFailed);
+            return;
         }
+    }
+
+    // the hash of the asset goes through all of its chunks, including the ones that were already stored
+    QCryptographicHash hash { QCryptographicHash::Sha256 };
+
+    for (size_t i = 0; i < index->chunks.size(); ++i) {
+        auto& chunk = index->chunks[i];
 
+        if (sentChunkData[i]) {
+            hash.addData(sentChunkData[i], chunk.size);
+        } else {
+            auto mappedChunk = _chunkStore->mapChunk(chunk);
 
+            if (!mappedChunk || mappedChunk->size() != chunk.size) {
+                qWarning() << "Chunk" << chunk.hash.toHex() << "could not be read - upload failed.";
+                replyPacket.writePrimitive(AssetServerError::FileOperationFailed);
+                return;
+            }
+            hash.addData(mappedChunk->data(), chunk.size);
+        }
     }
+
+    storeChunkedAsset(hash.result(), index, replyPacket);
+}
+
+void UploadAssetTask::storeFile(const QByteArray& fileData, NLPacket& replyPacket) {
+    auto hash = hashData(fileData);
+    auto hexHash = hash.toHex();
     
-    auto nodeList = DependencyManager::get<NodeList>();
-    nodeList->sendPacket(std::move(replyPacket), *_senderNode);
+    qDebug() << "Hash for uploaded file from" << uuidStringWithoutCurlyBraces(_senderNode->getUUID())
+        << "is: (" << hexHash << ") ";
+    
+    QFile file { _resourcesDir.filePath(QString(hexHash)) };
+
+    bool existingCorrectFile = false;
+    
+    if (file.exists()) {
+        // check if the local file has the correct contents, otherwise we overwrite
+        if (file.open(QIODevice::ReadOnly) && hashData(file.readAll()) == hash) {
+            qDebug() << "Not overwriting existing verified file: " << hexHash;
+
+            existingCorrectFile = true;
+
+            replyPacket.writePrimitive(AssetServerError::NoError);
+            replyPacket.write(hash);
+        } else {
+            qDebug() << "Overwriting an existing file whose contents did not match the expected hash: " << hexHash;
+            file.close();
+        }
+    }
+
+    if (!existingCorrectFile) {
+        if (file.open(QIODevice::WriteOnly) && file.write(fileData) == qint64(fileData.size())) {
+            qDebug() << "Wrote file" << hexHash << "to disk. Upload complete";
+            file.close();
+
+            replyPacket.writePrimitive(AssetServerError::NoError);
+            replyPacket.write(hash);
+        } else {
+            qWarning() << "Failed to upload or write to file" << hexHash << " - upload failed.";
+
+            // upload has failed - remove the file and return an error
+            auto removed = file.remove();
+
+            if (!removed) {
+                qWarning() << "Removal of failed upload file" << hexHash << "failed.";
+            }
+            
+            replyPacket.writePrimitive(AssetServerError::FileOperationFailed);
+        }
+    }
+}
+
+void UploadAssetTask::storeChunkedAsset(const QByteArray& hash, const AssetChunkIndexPointer& index,
+                                        NLPacket& replyPacket) {
+    auto hexHash = hash.toHex();
+
+    qDebug() << "Hash for uploaded file from" << uuidStringWithoutCurlyBraces(_senderNode->getUUID())
+        << "is: (" << hexHash << ") ";
+
+    if (QFile::exists(_resourcesDir.filePath(QString(hexHash)))) {
+        qDebug() << "Not storing the chunks of" << hexHash << "since it is already stored whole.";
+
+        replyPacket.writePrimitive(AssetServerError::NoError);
+        replyPacket.write(hash);
+    } else if (_chunkStore->writeAsset(QString(hexHash), index)) {
+        qDebug() << "Wrote the chunk index of" << hexHash << "to disk. Upload complete";
+
+        replyPacket.writePrimitive(AssetServerError::NoError);
+        replyPacket.write(hash);
+    } else {
+        qWarning() << "Failed to store the chunks of" << hexHash << " - upload failed.";
+        replyPacket.writePrimitive(AssetServerError::FileOperationFailed);
+    }
 }
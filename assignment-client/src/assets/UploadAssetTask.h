@@ -19,21 +19,33 @@
 #include <QtCore/QRunnable>
 #include <QtCore/QSharedPointer>
 
+#include "AssetChunkStore.h"
 #include "ReceivedMessage.h"
 
+class NLPacket;
 class NLPacketList;
 class Node;
 
+// Stores an asset uploaded whole (AssetUpload) or as the chunks the asset server was missing (AssetChunkUpload),
+// as a whole file or, when chunkStore is given, as chunks
 class UploadAssetTask : public QRunnable {
 public:
-    UploadAssetTask(QSharedPointer<ReceivedMessage> message, QSharedPointer<Node> senderNode, const QDir& resourcesDir);
+    UploadAssetTask(QSharedPointer<ReceivedMessage> message, QSharedPointer<Node> senderNode, const QDir& resourcesDir,
+                    AssetChunkStore* chunkStore);
 
     void run() override;
 
 private:
+    void runWholeUpload(NLPacket& replyPacket);
+    void runChunkUpload(NLPacket& replyPacket);
+
+    void storeFile(const QByteArray& fileData, NLPacket& replyPacket);
+    void storeChunkedAsset(const QByteArray& hash, const AssetChunkIndexPointer& index, NLPacket& replyPacket);
+
     QSharedPointer<ReceivedMessage> _receivedMessage;
     QSharedPointer<Node> _senderNode;
     QDir _resourcesDir;
+    AssetChunkStore* _chunkStore;
 };
 
 #endif // hifi_UploadAssetTask_h
@@ -100,7 +100,9 @@ void AudioMixer::queueAudioPacket(QSharedPointer<ReceivedMessage> message, Share
         _numSilentPackets++;
     }
 
-    getOrCreateClientData(node.data())->queuePacket(message, node);
+    if (!getOrCreateClientData(node.data())->queuePacket(message, node)) {
+        _numDroppedPackets++;
+    }
 }
 
 void AudioMixer::handleMuteEnvironmentPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
@@ -250,6 +252,8 @@ void AudioMixer::sendStatsPacket() {
     statsObject["avg_listeners_(silent)_per_frame"] = (float)_stats.sumListenersSilent / (float)_numStatFrames;
 
     statsObject["silent_packets_per_frame"] = (float)_numSilentPackets / (float)_numStatFrames;
+    statsObject["queued_packets_per_frame"] = (float)_stats.sumQueuedPackets / (float)_numStatFrames;
+    statsObject["dropped_packets"] = _numDroppedPackets;
 
     // timing stats
     QJsonObject timingStats;
@@ -265,6 +269,7 @@ void AudioMixer::sendStatsPacket() {
     addTiming(_sleepTiming, "sleep");
     addTiming(_frameTiming, "frame");
     addTiming(_prepareTiming, "prepare");
+    addTiming(_indexTiming, "index");
     addTiming(_mixTiming, "mix");
     addTiming(_eventsTiming, "events");
     addTiming(_packetsTiming, "packets");
@@ -276,6 +281,8 @@ void AudioMixer::sendStatsPacket() {
     // call it "avg_..." to keep it higher in the display, sorted alphabetically
     statsObject["avg_timing_stats"] = timingStats;
 
+    statsObject["slaves_scheduler"] = _slavePool.takeSchedulerStats();
+
     // mix stats
     QJsonObject mixStats;
 
@@ -288,9 +295,21 @@ void AudioMixer::sendStatsPacket() {
     mixStats["total_mixes"] = _stats.totalMixes;
     mixStats["avg_mixes_per_block"] = _stats.totalMixes / _numStatFrames;
 
+    mixStats["audible_range"] = _spatialIndex.getAudibleRange();
+    mixStats["avg_candidates_visited_per_frame"] = (float)_stats.candidatesVisited / (float)_numStatFrames;
+    mixStats["avg_candidates_skipped_per_frame"] = (float)_stats.candidatesSkipped / (float)_numStatFrames;
+
+    mixStats["cluster_radius"] = _clusters.getClusterRadius();
+    mixStats["avg_clusters_per_frame"] = (float)_stats.sumClusters / (float)_numStatFrames;
+    mixStats["avg_clustered_listeners_per_frame"] = (float)_stats.sumClusteredListeners / (float)_numStatFrames;
+    mixStats["avg_cluster_source_mixes_per_frame"] = (float)_stats.clusterSourceMixes / (float)_numStatFrames;
+    // how many listeners share each mixed bus
+    mixStats["cluster_reuse_ratio"] = (_stats.clusterBusMixes > 0) ?
+        (float)_stats.clusterBusRenders / (float)_stats.clusterBusMixes : 0.0f;
+
     statsObject["mix_stats"] = mixStats;
 
-    _numStatFrames = _numSilentPackets = 0;
+    _numStatFrames = _numSilentPackets = _numDroppedPackets = 0;
     _stats.reset();
 
     // add stats for each listerner
@@ -307,6 +326,7 @@ void AudioMixer::sendStatsPacket() {
             nodeStats[USERNAME_UUID_REPLACEMENT_STATS_KEY] = uuidString;
 
             nodeStats["jitter"] = clientData->getAudioStreamStats();
+            nodeStats["packet_queue"] = clientData->getPacketQueueStats();
 
             listenerStats[uuidString] = nodeStats;
         }
@@ -381,10 +401,19 @@ void AudioMixer::start() {
                 });
             }
 
+            // index the streams and cluster the listeners, so that listeners only mix what they need to
+            {
+                auto indexTimer = _indexTiming.timer();
+                _spatialIndex.build(cbegin, cend);
+                _clusters.build(cbegin, cend, _spatialIndex);
+                _stats.sumClusters += _clusters.getNumClusters();
+                _stats.sumClusteredListeners += _clusters.getNumClusteredListeners();
+            }
+
             // mix across slave threads
             {
                 auto mixTimer = _mixTiming.timer();
-                _slavePool.mix(cbegin, cend, frame, _throttlingRatio);
+                _slavePool.mix(cbegin, cend, frame, _throttlingRatio, &_spatialIndex, &_clusters);
             }
         });
 
@@ -504,6 +533,8 @@ void AudioMixer::clearDomainSettings() {
     _audioZones.clear();
     _zoneSettings.clear();
     _zoneReverbSettings.clear();
+    _spatialIndex.setAudibleRange(0.0f);
+    _clusters.setClusterRadius(0.0f);
 }
 
 void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
@@ -617,6 +648,26 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
             }
         }
 
+        const QString AUDIBLE_RANGE = "audible_range";
+        if (audioEnvGroupObject[AUDIBLE_RANGE].isString()) {
+            bool ok = false;
+            float audibleRange = audioEnvGroupObject[AUDIBLE_RANGE].toString().toFloat(&ok);
+            if (ok && audibleRange >= 0.0f) {
+                _spatialIndex.setAudibleRange(audibleRange);
+                qDebug() << "Audible range changed to" << audibleRange;
+            }
+        }
+
+        const QString LISTENER_CLUSTER_RADIUS = "listener_cluster_radius";
+        if (audioEnvGroupObject[LISTENER_CLUSTER_RADIUS].isString()) {
+            bool ok = false;
+            float clusterRadius = audioEnvGroupObject[LISTENER_CLUSTER_RADIUS].toString().toFloat(&ok);
+            if (ok && clusterRadius >= 0.0f) {
+                _clusters.setClusterRadius(clusterRadius);
+                qDebug() << "Listener cluster radius changed to" << clusterRadius;
+            }
+        }
+
         const QString AUDIO_ZONES = "zones";
         if (audioEnvGroupObject[AUDIO_ZONES].isObject()) {
             const QJsonObject& zones = audioEnvGroupObject[AUDIO_ZONES].toObject();
@@ -20,6 +20,8 @@
 
 #include "AudioMixerStats.h"
 #include "AudioMixerSlavePool.h"
+#include "AudioMixerClusters.h"
+#include "AudioMixerSpatialIndex.h"
 
 class PositionalAudioStream;
 class AvatarAudioStream;
@@ -85,11 +87,14 @@ private:
     float _throttlingRatio { 0.0f };
 
     int _numSilentPackets { 0 };
+    int _numDroppedPackets { 0 };
 
     int _numStatFrames { 0 };
     AudioMixerStats _stats;
 
     AudioMixerSlavePool _slavePool;
+    AudioMixerSpatialIndex _spatialIndex;
+    AudioMixerClusters _clusters;
 
     class Timer {
     public:
@@ -116,6 +121,7 @@ private:
     Timer _sleepTiming;
     Timer _frameTiming;
     Timer _prepareTiming;
+    Timer _indexTiming;
     Timer _mixTiming;
     Timer _eventsTiming;
     Timer _packetsTiming;
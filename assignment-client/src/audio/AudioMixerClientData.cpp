@@ -48,20 +48,16 @@ AudioMixerClientData::~AudioMixerClientData() {
     }
 }
 
-void AudioMixerClientData::queuePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer node) {
-    if (!_packetQueue.node) {
-        _packetQueue.node = node;
-    }
-    _packetQueue.push(message);
+bool AudioMixerClientData::queuePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer node) {
+    return _packetQueue.push(message, node);
 }
 
-void AudioMixerClientData::processPackets() {
-    SharedNodePointer node = _packetQueue.node;
-    assert(_packetQueue.empty() || node);
-    _packetQueue.node.clear();
-
-    while (!_packetQueue.empty()) {
-        auto& packet = _packetQueue.front();
+int AudioMixerClientData::processPackets() {
+    return _packetQueue.drain([&](QSharedPointer<ReceivedMessage>& packet, const SharedNodePointer& node) {
+        // the node may have been killed since the packet was queued
+        if (!node) {
+            return;
+        }
 
         switch (packet->getType()) {
             case PacketType::MicrophoneAudioNoEcho:
@@ -91,10 +87,7 @@ void AudioMixerClientData::processPackets() {
             default:
                 Q_UNREACHABLE();
         }
-
-        _packetQueue.pop();
-    }
-    assert(_packetQueue.empty());
+    });
 }
 
 void AudioMixerClientData::negotiateAudioFormat(ReceivedMessage& message, const SharedNodePointer& node) {
@@ -161,6 +154,18 @@ void AudioMixerClientData::removeHRTFForStream(const QUuid& nodeID, const QUuid&
     }
 }
 
+bool AudioMixerClientData::hasGainAdjustment(const QUuid& nodeID) {
+    // per-avatar gain is only set on the avatar stream (see parsePerAvatarGainSet)
+    auto it = _nodeSourcesHRTFMap.find(nodeID);
+    if (it != _nodeSourcesHRTFMap.end()) {
+        auto hrtf = it->second.find(QUuid());
+        if (hrtf != it->second.end()) {
+            return hrtf->second.getGainAdjustment() != HRTF_GAIN;
+        }
+    }
+    return false;
+}
+
 void AudioMixerClientData::removeAgentAvatarAudioStream() {
     QWriteLocker writeLocker { &_streamsLock };
     auto it = _audioStreams.find(QUuid());
@@ -452,6 +457,13 @@ QJsonObject AudioMixerClientData::getAudioStreamStats() {
     return result;
 }
 
+QJsonObject AudioMixerClientData::getPacketQueueStats() {
+    QJsonObject result;
+    result["max_depth"] = _packetQueue.takeMaxDepth();
+    result["dropped"] = _packetQueue.takeNumDropped();
+    return result;
+}
+
 void AudioMixerClientData::handleMismatchAudioFormat(SharedNodePointer node, const QString& currentCodec, const QString& recievedCodec) {
     sendSelectAudioFormat(node, currentCodec);
 }
@@ -12,11 +12,12 @@
 #ifndef hifi_AudioMixerClientData_h
 #define hifi_AudioMixerClientData_h
 
-#include <queue>
-
 #include <QtCore/QJsonObject>
 
+#include <tbb/concurrent_unordered_map.h>
+
 #include <AABox.h>
+#include <AudioFOA.h>
 #include <AudioHRTF.h>
 #include <AudioLimiter.h>
 #include <UUIDHasher.h>
@@ -25,6 +26,7 @@
 
 #include "PositionalAudioStream.h"
 #include "AvatarAudioStream.h"
+#include "AudioMixerPacketQueue.h"
 
 
 class AudioMixerClientData : public NodeData {
@@ -36,8 +38,12 @@ public:
     using SharedStreamPointer = std::shared_ptr<PositionalAudioStream>;
     using AudioStreamMap = std::unordered_map<QUuid, SharedStreamPointer>;
 
-    void queuePacket(QSharedPointer<ReceivedMessage> packet, SharedNodePointer node);
-    void processPackets();
+    // queues a packet for processPackets, or drops it if too many are queued
+    // returns whether the packet was queued
+    bool queuePacket(QSharedPointer<ReceivedMessage> packet, SharedNodePointer node);
+
+    // returns the number of packets processed
+    int processPackets();
 
     // locks the mutex to make a copy
     AudioStreamMap getAudioStreams() { QReadLocker readLock { &_streamsLock }; return _audioStreams; }
@@ -53,6 +59,9 @@ public:
     // returns a new or existing HRTF object for the given stream from the given node
     AudioHRTF& hrtfForStream(const QUuid& nodeID, const QUuid& streamID = QUuid()) { return _nodeSourcesHRTFMap[nodeID][streamID]; }
 
+    // returns whether the listener has adjusted the gain of the given node
+    bool hasGainAdjustment(const QUuid& nodeID);
+
     // removes an AudioHRTF object for a given stream
     void removeHRTFForStream(const QUuid& nodeID, const QUuid& streamID = QUuid());
 
@@ -76,6 +85,9 @@ public:
 
     QJsonObject getAudioStreamStats();
 
+    // returns inbound packet queue stats since the last call
+    QJsonObject getPacketQueueStats();
+
     void sendAudioStreamStatsPackets(const SharedNodePointer& destinationNode);
 
     void incrementOutgoingMixedAudioSequenceNumber() { _outgoingMixedAudioSequenceNumber++; }
@@ -86,6 +98,9 @@ public:
 
     AudioLimiter audioLimiter;
 
+    // renders the shared bus of this listener's cluster, if it is clustered
+    AudioFOA clusterFOA;
+
     void setupCodec(CodecPluginPointer codec, const QString& codecName);
     void cleanupCodec();
     void encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer) {
@@ -116,10 +131,7 @@ public slots:
     void sendSelectAudioFormat(SharedNodePointer node, const QString& selectedCodecName);
 
 private:
-    struct PacketQueue : public std::queue<QSharedPointer<ReceivedMessage>> {
-        QWeakPointer<Node> node;
-    };
-    PacketQueue _packetQueue;
+    AudioMixerPacketQueue _packetQueue;
 
     QReadWriteLock _streamsLock;
     AudioStreamMap _audioStreams; // microphone stream from avatar is stored under key of null UUID
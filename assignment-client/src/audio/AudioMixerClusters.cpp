@@ -0,0 +1,123 @@
+//
+//  AudioMixerClusters.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include "AudioMixerClientData.h"
+
+#include "AudioMixerClusters.h"
+
+void AudioMixerClusters::build(ConstIter begin, ConstIter end, const AudioMixerSpatialIndex& spatialIndex) {
+    for (int i = 0; i < _numClusters; ++i) {
+        Cluster& cluster = *_clusters[i];
+        cluster.listeners.clear();
+        cluster.busNodes.clear();
+        cluster.busNodeIDs.clear();
+    }
+    _numClusters = 0;
+    _listenerClusters.clear();
+
+    if (!isEnabled()) {
+        return;
+    }
+
+    // bucket the listeners by position
+    for (auto cell = _cells.begin(); cell != _cells.end();) {
+        if (cell->second.empty()) {
+            cell = _cells.erase(cell);
+        } else {
+            cell->second.clear();
+            ++cell;
+        }
+    }
+    std::for_each(begin, end, [&](const SharedNodePointer& node) {
+        AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+        if (!nodeData || node->getType() != NodeType::Agent || !node->getActiveSocket()) {
+            return;
+        }
+
+        auto stream = nodeData->getAvatarAudioStream();
+        if (stream) {
+            _cells[AudioMixerSpatialIndex::cellForPosition(stream->getPosition(), _clusterRadius)].push_back(node);
+        }
+    });
+
+    const float nearFieldDistance = NEAR_FIELD_RATIO * _clusterRadius;
+
+    for (auto& cell : _cells) {
+        auto& listeners = cell.second;
+        if ((int)listeners.size() < MIN_CLUSTER_SIZE) {
+            continue;
+        }
+
+        Cluster& cluster = nextCluster();
+        cluster.listeners = listeners;
+
+        glm::vec3 position(0.0f);
+        for (auto& listener : listeners) {
+            position += static_cast<AudioMixerClientData*>(listener->getLinkedData())->getPosition();
+            _listenerClusters[listener->getUUID()] = &cluster;
+        }
+        cluster.position = position / (float)listeners.size();
+
+        // put a node on the bus only if it sounds the same to every listener of the cluster
+        auto addToBus = [&](const SharedNodePointer& node) {
+            AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+            if (!nodeData) {
+                return;
+            }
+
+            auto streams = nodeData->getAudioStreams();
+            if (streams.empty()) {
+                return;
+            }
+
+            // near-field and stereo streams are mixed individually
+            for (auto& streamPair : streams) {
+                auto& stream = streamPair.second;
+                if (stream->isStereo() || glm::distance(stream->getPosition(), cluster.position) <= nearFieldDistance) {
+                    return;
+                }
+            }
+
+            // ignored and gain-adjusted nodes differ between listeners, so they are mixed individually
+            for (auto& listener : listeners) {
+                AudioMixerClientData* listenerData = static_cast<AudioMixerClientData*>(listener->getLinkedData());
+                if (listener->isIgnoreRadiusEnabled() || node->isIgnoreRadiusEnabled() ||
+                    listener->isIgnoringNodeWithID(node->getUUID()) || node->isIgnoringNodeWithID(listener->getUUID()) ||
+                    listenerData->hasGainAdjustment(node->getUUID())) {
+                    return;
+                }
+            }
+
+            cluster.busNodes.push_back(node);
+            cluster.busNodeIDs.insert(node->getUUID());
+        };
+
+        if (spatialIndex.isEnabled()) {
+            spatialIndex.forEachCandidate(cluster.position, _visitedNodes, addToBus);
+        } else {
+            std::for_each(begin, end, addToBus);
+        }
+    }
+}
+
+AudioMixerClusters::Cluster* AudioMixerClusters::clusterForListener(const QUuid& listenerID) const {
+    auto it = _listenerClusters.find(listenerID);
+    return (it != _listenerClusters.cend()) ? it->second : nullptr;
+}
+
+AudioMixerClusters::Cluster& AudioMixerClusters::nextCluster() {
+    // clusters are retained across frames, as they are not movable
+    if (_numClusters == (int)_clusters.size()) {
+        _clusters.emplace_back(new Cluster());
+    }
+    return *_clusters[_numClusters++];
+}
@@ -0,0 +1,91 @@
+//
+//  AudioMixerClusters.h
+//  assignment-client/src/audio
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixerClusters_h
+#define hifi_AudioMixerClusters_h
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <AudioConstants.h>
+#include <AudioFOA.h>
+#include <NodeList.h>
+#include <UUIDHasher.h>
+
+#include "AudioMixerSpatialIndex.h"
+
+// Groups co-located listeners, so that their distant sources are mixed once into a shared First-Order Ambisonic bus
+//   Each listener then renders the bus with its own orientation, and mixes only its near-field sources individually.
+//   AudioMixerClusters is not thread-safe to build, but clusters are safe to use concurrently once built.
+class AudioMixerClusters {
+public:
+    using ConstIter = NodeList::const_iterator;
+
+    // the minimum number of listeners worth sharing a bus
+    static const int MIN_CLUSTER_SIZE = 2;
+
+    // sources nearer to a cluster than this multiple of the cluster radius are mixed individually
+    static const int NEAR_FIELD_RATIO = 4;
+
+    // the bus is quantized to 16 bits for AudioFOA, so it is mixed with some headroom
+    static const int BUS_HEADROOM = 4;
+
+    struct Cluster {
+        glm::vec3 position;
+        std::vector<SharedNodePointer> listeners;
+
+        // nodes whose streams are all mixed into the bus
+        std::vector<SharedNodePointer> busNodes;
+        std::unordered_set<QUuid> busNodeIDs;
+
+        // interleaved ambiX (W, Y, Z, X) bus, mixed once per frame (guarded by mutex)
+        int16_t bus[AudioConstants::NETWORK_FRAME_SAMPLES_AMBISONIC];
+        std::atomic<unsigned int> frame { 0 };
+        std::mutex mutex;
+
+        bool isOnBus(const QUuid& nodeID) const { return busNodeIDs.find(nodeID) != busNodeIDs.cend(); }
+    };
+
+    // sets the size of a cluster; 0 disables clustering
+    void setClusterRadius(float clusterRadius) { _clusterRadius = clusterRadius; }
+    float getClusterRadius() const { return _clusterRadius; }
+    bool isEnabled() const { return _clusterRadius > 0.0f; }
+
+    // cluster the listeners in [begin, end), and choose the sources of each bus
+    // if spatialIndex is enabled, only its candidates are considered as sources
+    void build(ConstIter begin, ConstIter end, const AudioMixerSpatialIndex& spatialIndex);
+
+    // returns the cluster of the listener, or nullptr if it is not clustered
+    Cluster* clusterForListener(const QUuid& listenerID) const;
+
+    int getNumClusters() const { return _numClusters; }
+    int getNumClusteredListeners() const { return (int)_listenerClusters.size(); }
+
+private:
+    Cluster& nextCluster();
+
+    std::vector<std::unique_ptr<Cluster>> _clusters;
+    int _numClusters { 0 };
+    std::unordered_map<QUuid, Cluster*> _listenerClusters;
+
+    // scratch space
+    std::unordered_map<AudioMixerSpatialIndex::Cell, std::vector<SharedNodePointer>, AudioMixerSpatialIndex::CellHasher> _cells;
+    std::vector<bool> _visitedNodes;
+
+    float _clusterRadius { 0.0f };
+};
+
+#endif // hifi_AudioMixerClusters_h
@@ -0,0 +1,28 @@
+//
+//  AudioMixerPacketQueue.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioMixerPacketQueue.h"
+
+bool AudioMixerPacketQueue::push(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& node) {
+    const uint32_t tail = _tail.load(std::memory_order_relaxed);
+    const uint32_t head = _head.load(std::memory_order_acquire);
+
+    if (tail - head == CAPACITY) {
+        _numDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Slot& slot = _slots[tail & MASK];
+    slot.message = message;
+    slot.node = node;
+    _tail.store(tail + 1, std::memory_order_release);
+
+    return true;
+}
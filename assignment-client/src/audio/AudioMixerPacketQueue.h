@@ -0,0 +1,88 @@
+//
+//  AudioMixerPacketQueue.h
+//  assignment-client/src/audio
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixerPacketQueue_h
+#define hifi_AudioMixerPacketQueue_h
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include <QtCore/QSharedPointer>
+
+#include <Node.h>
+#include <ReceivedMessage.h>
+
+// Bounded ring of inbound audio packets for a single node
+//   AudioMixerPacketQueue is lock-free for a single producer (push) and a single consumer (drain);
+//   its slots are allocated once, with the queue, and reused in turn.
+class AudioMixerPacketQueue {
+public:
+    // the number of slots, a power of two; about 2.5s of audio for a node with a single stream
+    static const uint32_t CAPACITY = 256;
+
+    // queues a message, or drops it if the queue is full
+    // returns whether the message was queued
+    bool push(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& node);
+
+    // calls functor(message, node) on every queued message, in order, and releases their slots
+    // returns the number of messages drained
+    template <typename Functor>
+    int drain(Functor functor);
+
+    // returns the deepest the queue has been when drained, and resets it
+    int takeMaxDepth() { return _maxDepth.exchange(0); }
+
+    // returns the number of messages dropped since the last call
+    int takeNumDropped() { return _numDropped.exchange(0); }
+
+private:
+    static const uint32_t MASK = CAPACITY - 1;
+    static_assert((CAPACITY & MASK) == 0, "AudioMixerPacketQueue::CAPACITY must be a power of two");
+
+    struct Slot {
+        QSharedPointer<ReceivedMessage> message;
+        QWeakPointer<Node> node;
+    };
+
+    // the indices are free-running, and wrap modulo CAPACITY into the slots
+    // they are kept apart by the slots, so that the producer and consumer do not share a cache line
+    std::atomic<uint32_t> _head { 0 }; // written by the consumer
+    std::array<Slot, CAPACITY> _slots;
+    std::atomic<uint32_t> _tail { 0 }; // written by the producer
+
+    std::atomic<int> _maxDepth { 0 };
+    std::atomic<int> _numDropped { 0 };
+};
+
+template <typename Functor>
+int AudioMixerPacketQueue::drain(Functor functor) {
+    uint32_t head = _head.load(std::memory_order_relaxed);
+    const uint32_t tail = _tail.load(std::memory_order_acquire);
+    const int depth = (int)(tail - head);
+
+    if (depth > _maxDepth.load(std::memory_order_relaxed)) {
+        _maxDepth.store(depth, std::memory_order_relaxed);
+    }
+
+    for (; head != tail; ++head) {
+        Slot& slot = _slots[head & MASK];
+        functor(slot.message, SharedNodePointer(slot.node));
+
+        // release the message before handing the slot back to the producer
+        slot.message.clear();
+        slot.node.clear();
+        _head.store(head + 1, std::memory_order_release);
+    }
+
+    return depth;
+}
+
+#endif // hifi_AudioMixerPacketQueue_h
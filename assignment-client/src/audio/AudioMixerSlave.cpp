@@ -56,15 +56,18 @@ inline float computeAzimuth(const AvatarAudioStream& listeningNodeStream, const
 void AudioMixerSlave::processPackets(const SharedNodePointer& node) {
     AudioMixerClientData* data = (AudioMixerClientData*)node->getLinkedData();
     if (data) {
-        data->processPackets();
+        stats.sumQueuedPackets += data->processPackets();
     }
 }
 
-void AudioMixerSlave::configureMix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio) {
+void AudioMixerSlave::configureMix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio,
+        const AudioMixerSpatialIndex* spatialIndex, const AudioMixerClusters* clusters) {
     _begin = begin;
     _end = end;
     _frame = frame;
     _throttlingRatio = throttlingRatio;
+    _spatialIndex = spatialIndex;
+    _clusters = clusters;
 }
 
 void AudioMixerSlave::mix(const SharedNodePointer& node) {
@@ -131,6 +134,9 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
     bool isThrottling = _throttlingRatio > 0.0f;
     std::vector<std::pair<float, SharedNodePointer>> throttledNodes;
 
+    // distant sources of clustered listeners are mixed once, into the cluster's bus
+    AudioMixerClusters::Cluster* cluster = _clusters ? _clusters->clusterForListener(listener->getUUID()) : nullptr;
+
     typedef void (AudioMixerSlave::*MixFunctor)(
             AudioMixerClientData&, const QUuid&, const AvatarAudioStream&, const PositionalAudioStream&);
     auto forAllStreams = [&](const SharedNodePointer& node, AudioMixerClientData* nodeData, MixFunctor mixFunctor) {
@@ -145,7 +151,7 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
     auto mixStart = p_high_resolution_clock::now();
 #endif
 
-    std::for_each(_begin, _end, [&](const SharedNodePointer& node) {
+    auto mixNode = [&](const SharedNodePointer& node) {
         AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
         if (!nodeData) {
             return;
@@ -159,6 +165,8 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
                     mixStream(*listenerData, node->getUUID(), *listenerAudioStream, *nodeStream);
                 }
             }
+        } else if (cluster && cluster->isOnBus(node->getUUID())) {
+            return;
         } else if (!listenerData->shouldIgnore(listener, node, _frame)) {
             if (!isThrottling) {
                 forAllStreams(node, nodeData, &AudioMixerSlave::mixStream);
@@ -189,7 +197,23 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
                 }
             }
         }
-    });
+    };
+
+    if (_spatialIndex && _spatialIndex->isEnabled()) {
+        // only visit sources within audible range (and the loudest sources), from the spatial index
+        mixNode(listener);
+        int numCandidates = _spatialIndex->forEachCandidate(listenerAudioStream->getPosition(), _visitedNodes,
+            [&](const SharedNodePointer& node) {
+                if (*node != *listener) {
+                    mixNode(node);
+                }
+            });
+
+        stats.candidatesVisited += numCandidates;
+        stats.candidatesSkipped += _spatialIndex->size() - numCandidates;
+    } else {
+        std::for_each(_begin, _end, mixNode);
+    }
 
     if (isThrottling) {
         // pop the loudest nodes off the heap and mix their streams
@@ -216,6 +240,28 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
         }
     }
 
+    // render the HRTFs of all audible sources at once
+    renderHRTFs();
+
+    if (cluster) {
+        const int16_t* bus = prepareClusterBus(*cluster);
+
+        // rotate the world-aligned bus to the listener
+        // and convert from Y-up (OpenGL) to Z-up (Ambisonic) coordinate system
+        glm::quat orientation = glm::inverse(listenerAudioStream->getOrientation());
+        float qw = orientation.w;
+        float qx = -orientation.z;
+        float qy = -orientation.x;
+        float qz = orientation.y;
+
+        const int HRTF_DATASET_INDEX = 1;
+        listenerData->clusterFOA.render(const_cast<int16_t*>(bus), _mixSamples, HRTF_DATASET_INDEX,
+                                        qw, qx, qy, qz, (float)AudioMixerClusters::BUS_HEADROOM,
+                                        AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+
+        ++stats.clusterBusRenders;
+    }
+
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     auto mixEnd = p_high_resolution_clock::now();
     auto mixTime = std::chrono::duration_cast<std::chrono::nanoseconds>(mixEnd - mixStart);
@@ -238,6 +284,77 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
     return hasAudio;
 }
 
+const int16_t* AudioMixerSlave::prepareClusterBus(AudioMixerClusters::Cluster& cluster) {
+    // check for a memoized bus
+    if (_frame == cluster.frame.load(std::memory_order_acquire)) {
+        return cluster.bus;
+    }
+
+    // This may be called by multiple threads concurrently,
+    // so take a lock and only mix the bus if this call is first.
+    std::lock_guard<std::mutex> lock(cluster.mutex);
+    if (_frame == cluster.frame.load(std::memory_order_acquire)) {
+        return cluster.bus;
+    }
+
+    // zones are checked against a representative listener, since they are all in the cluster
+    auto representativeData = static_cast<AudioMixerClientData*>(cluster.listeners.front()->getLinkedData());
+    const AvatarAudioStream& representativeStream = *representativeData->getAvatarAudioStream();
+
+    float busSamples[AudioConstants::NETWORK_FRAME_SAMPLES_AMBISONIC] = {};
+
+    for (auto& node : cluster.busNodes) {
+        AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+        if (!nodeData) {
+            continue;
+        }
+
+        for (auto& streamPair : nodeData->getAudioStreams()) {
+            auto& stream = *streamPair.second;
+            if (!stream.lastPopSucceeded() || stream.getLastPopOutputLoudness() == 0.0f) {
+                continue;
+            }
+
+            glm::vec3 relativePosition = stream.getPosition() - cluster.position;
+            float gain = computeGain(representativeStream, stream, relativePosition, false) /
+                AudioConstants::MAX_SAMPLE_VALUE;
+
+            // encode as ambiX (ACN/SN3D), converting from Y-up (OpenGL) to Z-up (Ambisonic) coordinate system
+            glm::vec3 direction = glm::normalize(relativePosition);
+            float x = -direction.z;
+            float y = -direction.x;
+            float z = direction.y;
+
+            AudioRingBuffer::ConstIterator streamPopOutput = stream.getLastPopOutput();
+            streamPopOutput.readSamples(_bufferSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+            for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL; ++i) {
+                float sample = _bufferSamples[i] * gain;
+                busSamples[4 * i + 0] += sample;
+                busSamples[4 * i + 1] += sample * y;
+                busSamples[4 * i + 2] += sample * z;
+                busSamples[4 * i + 3] += sample * x;
+            }
+
+            ++stats.clusterSourceMixes;
+        }
+    }
+
+    // quantize the bus with headroom, as AudioFOA expects 16-bit input
+    const float BUS_SCALE = (float)AudioConstants::MAX_SAMPLE_VALUE / AudioMixerClusters::BUS_HEADROOM;
+    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_AMBISONIC; ++i) {
+        float sample = glm::clamp(busSamples[i] * BUS_SCALE, (float)AudioConstants::MIN_SAMPLE_VALUE,
+                                  (float)AudioConstants::MAX_SAMPLE_VALUE);
+        cluster.bus[i] = (int16_t)sample;
+    }
+
+    ++stats.clusterBusMixes;
+
+    unsigned int oldFrame = cluster.frame.exchange(_frame, std::memory_order_release);
+    Q_UNUSED(oldFrame);
+
+    return cluster.bus;
+}
+
 void AudioMixerSlave::throttleStream(AudioMixerClientData& listenerNodeData, const QUuid& sourceNodeID,
         const AvatarAudioStream& listeningNodeStream, const PositionalAudioStream& streamToAdd) {
     addStream(listenerNodeData, sourceNodeID, listeningNodeStream, streamToAdd, true);
@@ -351,12 +468,43 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
         return;
     }
 
-    hrtf.render(_bufferSamples, _mixSamples, HRTF_DATASET_INDEX, azimuth, distance, gain,
-                AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    queueHRTFRender(hrtf, azimuth, distance, gain);
 
     ++stats.hrtfRenders;
 }
 
+void AudioMixerSlave::queueHRTFRender(AudioHRTF& hrtf, float azimuth, float distance, float gain) {
+    _hrtfs.push_back(&hrtf);
+    _hrtfSamples.insert(_hrtfSamples.end(), _bufferSamples, _bufferSamples + AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    _hrtfAzimuths.push_back(azimuth);
+    _hrtfDistances.push_back(distance);
+    _hrtfGains.push_back(gain);
+}
+
+void AudioMixerSlave::renderHRTFs() {
+    int numSources = (int)_hrtfs.size();
+    if (numSources == 0) {
+        return;
+    }
+
+    // point into the samples only now, as they may have been reallocated while queueing
+    _hrtfInputs.resize(numSources);
+    for (int i = 0; i < numSources; ++i) {
+        _hrtfInputs[i] = &_hrtfSamples[i * AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
+    }
+
+    const int HRTF_DATASET_INDEX = 1;
+    AudioHRTF::render(_hrtfs.data(), _hrtfInputs.data(), _mixSamples, HRTF_DATASET_INDEX,
+                      _hrtfAzimuths.data(), _hrtfDistances.data(), _hrtfGains.data(), numSources,
+                      AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+
+    _hrtfs.clear();
+    _hrtfSamples.clear();
+    _hrtfAzimuths.clear();
+    _hrtfDistances.clear();
+    _hrtfGains.clear();
+}
+
 std::unique_ptr<NLPacket> createAudioPacket(PacketType type, int size, quint16 sequence, QString codec) {
     auto audioPacket = NLPacket::create(type, size);
     audioPacket->writePrimitive(sequence);
@@ -19,6 +19,8 @@
 #include <UUIDHasher.h>
 #include <NodeList.h>
 
+#include "AudioMixerClusters.h"
+#include "AudioMixerSpatialIndex.h"
 #include "AudioMixerStats.h"
 
 class PositionalAudioStream;
@@ -34,7 +36,8 @@ public:
     void processPackets(const SharedNodePointer& node);
 
     // configure a round of mixing
-    void configureMix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio);
+    void configureMix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio,
+            const AudioMixerSpatialIndex* spatialIndex, const AudioMixerClusters* clusters);
 
     // mix and broadcast non-ignored streams to the node (requires configuration using configureMix, above)
     // returns true if a mixed packet was sent to the node
@@ -53,6 +56,13 @@ private:
             const AvatarAudioStream& listenerStream, const PositionalAudioStream& streamer,
             bool throttle);
 
+    // queue an HRTF render of _bufferSamples, to be batched with the other sources of this mix
+    void queueHRTFRender(AudioHRTF& hrtf, float azimuth, float distance, float gain);
+    void renderHRTFs();
+
+    // mix the distant sources of a cluster into its shared bus, once per frame
+    const int16_t* prepareClusterBus(AudioMixerClusters::Cluster& cluster);
+
     // mixing buffers
     float _mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
     int16_t _bufferSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
@@ -62,6 +72,19 @@ private:
     ConstIter _end;
     unsigned int _frame { 0 };
     float _throttlingRatio { 0.0f };
+    const AudioMixerSpatialIndex* _spatialIndex { nullptr };
+    const AudioMixerClusters* _clusters { nullptr };
+
+    // spatial index scratch space
+    std::vector<bool> _visitedNodes;
+
+    // queued HRTF renders
+    std::vector<AudioHRTF*> _hrtfs;
+    std::vector<int16_t> _hrtfSamples;
+    std::vector<int16_t*> _hrtfInputs;
+    std::vector<float> _hrtfAzimuths;
+    std::vector<float> _hrtfDistances;
+    std::vector<float> _hrtfGains;
 };
 
 #endif // hifi_AudioMixerSlave_h
@@ -18,10 +18,11 @@ void AudioMixerSlaveThread::run() {
     while (true) {
         wait();
 
-        // iterate over all available nodes
-        SharedNodePointer node;
-        while (try_pop(node)) {
-            (this->*_function)(node);
+        // iterate over all available nodes, stealing from other slaves once ours are done
+        if (_scheduler) {
+            _scheduler->run(_index, [&](const SharedNodePointer& node) {
+                (this->*_function)(node);
+            });
         }
 
         bool stopping = _stop;
@@ -46,6 +47,7 @@ void AudioMixerSlaveThread::wait() {
         _pool._configure(*this);
     }
     _function = _pool._function;
+    _scheduler = _pool._scheduler;
 }
 
 void AudioMixerSlaveThread::notify(bool stopping) {
@@ -60,10 +62,6 @@ void AudioMixerSlaveThread::notify(bool stopping) {
     _pool._poolCondition.notify_one();
 }
 
-bool AudioMixerSlaveThread::try_pop(SharedNodePointer& node) {
-    return _pool._queue.try_pop(node);
-}
-
 #ifdef AUDIO_SINGLE_THREADED
 static AudioMixerSlave slave;
 #endif
@@ -71,21 +69,24 @@ static AudioMixerSlave slave;
 void AudioMixerSlavePool::processPackets(ConstIter begin, ConstIter end) {
     _function = &AudioMixerSlave::processPackets;
     _configure = [](AudioMixerSlave& slave) {};
-    run(begin, end);
+    run(begin, end, _packetsScheduler);
 }
 
-void AudioMixerSlavePool::mix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio) {
+void AudioMixerSlavePool::mix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio,
+        const AudioMixerSpatialIndex* spatialIndex, const AudioMixerClusters* clusters) {
     _function = &AudioMixerSlave::mix;
     _configure = [&](AudioMixerSlave& slave) {
-        slave.configureMix(_begin, _end, _frame, _throttlingRatio);
+        slave.configureMix(_begin, _end, _frame, _throttlingRatio, _spatialIndex, _clusters);
     };
     _frame = frame;
     _throttlingRatio = throttlingRatio;
+    _spatialIndex = spatialIndex;
+    _clusters = clusters;
 
-    run(begin, end);
+    run(begin, end, _mixScheduler);
 }
 
-void AudioMixerSlavePool::run(ConstIter begin, ConstIter end) {
+void AudioMixerSlavePool::run(ConstIter begin, ConstIter end, Scheduler& scheduler) {
     _begin = begin;
     _end = end;
 
@@ -95,10 +96,12 @@ void AudioMixerSlavePool::run(ConstIter begin, ConstIter end) {
         _function(slave, node);
     });
 #else
-    // fill the queue
+    // partition the nodes between the slaves
     std::for_each(_begin, _end, [&](const SharedNodePointer& node) {
-        _queue.emplace(node);
+        scheduler.add(node, node->getUUID());
     });
+    scheduler.schedule(_numThreads);
+    _scheduler = &scheduler;
 
     {
         Lock lock(_mutex);
@@ -116,7 +119,8 @@ void AudioMixerSlavePool::run(ConstIter begin, ConstIter end) {
         assert(_numStarted == _numThreads);
     }
 
-    assert(_queue.empty());
+    scheduler.finish();
+    _scheduler = nullptr;
 #endif
 }
 
@@ -130,6 +134,13 @@ void AudioMixerSlavePool::each(std::function<void(AudioMixerSlave& slave)> funct
 #endif
 }
 
+QJsonObject AudioMixerSlavePool::takeSchedulerStats() {
+    QJsonObject stats;
+    stats["packets"] = _packetsScheduler.takeStats();
+    stats["mix"] = _mixScheduler.takeStats();
+    return stats;
+}
+
 void AudioMixerSlavePool::setNumThreads(int numThreads) {
     // clamp to allowed size
     {
@@ -163,7 +174,7 @@ void AudioMixerSlavePool::resize(int numThreads) {
     if (numThreads > _numThreads) {
         // start new slaves
         for (int i = 0; i < numThreads - _numThreads; ++i) {
-            auto slave = new AudioMixerSlaveThread(*this);
+            auto slave = new AudioMixerSlaveThread(*this, (int)_slaves.size());
             slave->start();
             _slaves.emplace_back(slave);
         }
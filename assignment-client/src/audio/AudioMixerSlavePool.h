@@ -16,10 +16,10 @@
 #include <mutex>
 #include <vector>
 
-#include <tbb/concurrent_queue.h>
-
 #include <QThread>
 
+#include <WorkStealingScheduler.h>
+
 #include "AudioMixerSlave.h"
 
 class AudioMixerSlavePool;
@@ -31,7 +31,7 @@ class AudioMixerSlaveThread : public QThread, public AudioMixerSlave {
     using Lock = std::unique_lock<Mutex>;
 
 public:
-    AudioMixerSlaveThread(AudioMixerSlavePool& pool) : _pool(pool) {}
+    AudioMixerSlaveThread(AudioMixerSlavePool& pool, int index) : _pool(pool), _index(index) {}
 
     void run() override final;
 
@@ -40,17 +40,18 @@ private:
 
     void wait();
     void notify(bool stopping);
-    bool try_pop(SharedNodePointer& node);
 
     AudioMixerSlavePool& _pool;
+    const int _index;
     void (AudioMixerSlave::*_function)(const SharedNodePointer& node) { nullptr };
+    WorkStealingScheduler<SharedNodePointer>* _scheduler { nullptr };
     bool _stop { false };
 };
 
 // Slave pool for audio mixers
 //   AudioMixerSlavePool is not thread-safe! It should be instantiated and used from a single thread.
 class AudioMixerSlavePool {
-    using Queue = tbb::concurrent_queue<SharedNodePointer>;
+    using Scheduler = WorkStealingScheduler<SharedNodePointer>;
     using Mutex = std::mutex;
     using Lock = std::unique_lock<Mutex>;
     using ConditionVariable = std::condition_variable;
@@ -65,7 +66,8 @@ public:
     void processPackets(ConstIter begin, ConstIter end);
 
     // mix on slave threads
-    void mix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio);
+    void mix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio,
+            const AudioMixerSpatialIndex* spatialIndex = nullptr, const AudioMixerClusters* clusters = nullptr);
 
     // iterate over all slaves
     void each(std::function<void(AudioMixerSlave& slave)> functor);
@@ -73,15 +75,17 @@ public:
     void setNumThreads(int numThreads);
     int numThreads() { return _numThreads; }
 
+    // returns the utilization and steals of each slave, per job, since the last call
+    QJsonObject takeSchedulerStats();
+
 private:
-    void run(ConstIter begin, ConstIter end);
+    void run(ConstIter begin, ConstIter end, Scheduler& scheduler);
     void resize(int numThreads);
 
     std::vector<std::unique_ptr<AudioMixerSlaveThread>> _slaves;
 
     friend void AudioMixerSlaveThread::wait();
     friend void AudioMixerSlaveThread::notify(bool stopping);
-    friend bool AudioMixerSlaveThread::try_pop(SharedNodePointer& node);
 
     // synchronization state
     Mutex _mutex;
@@ -94,10 +98,16 @@ private:
     int _numFinished { 0 }; // guarded by _mutex
     int _numStopped { 0 }; // guarded by _mutex
 
+    // each job is scheduled separately, as the costs of its nodes differ
+    Scheduler _packetsScheduler;
+    Scheduler _mixScheduler;
+    Scheduler* _scheduler { nullptr };
+
     // frame state
-    Queue _queue;
     unsigned int _frame { 0 };
     float _throttlingRatio { 0.0f };
+    const AudioMixerSpatialIndex* _spatialIndex { nullptr };
+    const AudioMixerClusters* _clusters { nullptr };
     ConstIter _begin;
     ConstIter _end;
 };
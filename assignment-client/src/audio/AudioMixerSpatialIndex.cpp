@@ -0,0 +1,72 @@
+//
+//  AudioMixerSpatialIndex.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include "AudioMixerClientData.h"
+
+#include "AudioMixerSpatialIndex.h"
+
+void AudioMixerSpatialIndex::build(ConstIter begin, ConstIter end) {
+    // keep cells that were occupied last frame allocated, and drop the rest
+    for (auto cell = _grid.begin(); cell != _grid.end();) {
+        if (cell->second.empty()) {
+            cell = _grid.erase(cell);
+        } else {
+            cell->second.clear();
+            ++cell;
+        }
+    }
+    _nodes.clear();
+    _loudest.clear();
+
+    if (!isEnabled()) {
+        return;
+    }
+
+    std::vector<std::pair<float, int>> loudness;
+
+    std::for_each(begin, end, [&](const SharedNodePointer& node) {
+        AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+        if (!nodeData) {
+            return;
+        }
+
+        auto streams = nodeData->getAudioStreams();
+        if (streams.empty()) {
+            return;
+        }
+
+        int index = (int)_nodes.size();
+        _nodes.push_back(node);
+
+        float nodeLoudness = 0.0f;
+        for (auto& streamPair : streams) {
+            auto& stream = streamPair.second;
+            const glm::vec3& position = stream->getPosition();
+            _grid[cellForPosition(position, _audibleRange)].push_back({ position, index });
+            nodeLoudness = std::max(nodeLoudness, stream->getLastPopOutputTrailingLoudness());
+        }
+        loudness.push_back(std::make_pair(nodeLoudness, index));
+    });
+
+    // retain the loudest nodes, so that they can be heard from anywhere
+    int numLoudest = std::min((int)loudness.size(), NUM_LOUDEST_SOURCES);
+    std::partial_sort(loudness.begin(), loudness.begin() + numLoudest, loudness.end(),
+        [](const std::pair<float, int>& a, const std::pair<float, int>& b) { return a.first > b.first; });
+    for (int i = 0; i < numLoudest; ++i) {
+        _loudest.push_back(loudness[i].second);
+    }
+}
+
+AudioMixerSpatialIndex::Cell AudioMixerSpatialIndex::cellForPosition(const glm::vec3& position, float cellSize) {
+    glm::vec3 cell = glm::floor(position / cellSize);
+    return { (int)cell.x, (int)cell.y, (int)cell.z };
+}
@@ -0,0 +1,113 @@
+//
+//  AudioMixerSpatialIndex.h
+//  assignment-client/src/audio
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixerSpatialIndex_h
+#define hifi_AudioMixerSpatialIndex_h
+
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <NodeList.h>
+
+// Uniform grid over the positions of all audio streams, rebuilt once per frame by the AudioMixer
+//   AudioMixerSpatialIndex is not thread-safe to build, but it is safe to query concurrently once built.
+class AudioMixerSpatialIndex {
+public:
+    using ConstIter = NodeList::const_iterator;
+
+    // the number of loudest sources that are always mixed, regardless of their distance
+    static const int NUM_LOUDEST_SOURCES = 8;
+
+    struct Cell {
+        int x, y, z;
+        bool operator==(const Cell& other) const { return x == other.x && y == other.y && z == other.z; }
+    };
+    struct CellHasher {
+        std::size_t operator()(const Cell& cell) const {
+            // large primes, from "Optimized Spatial Hashing for Collision Detection of Deformable Objects"
+            return ((std::size_t)cell.x * 73856093) ^ ((std::size_t)cell.y * 19349663) ^ ((std::size_t)cell.z * 83492791);
+        }
+    };
+    static Cell cellForPosition(const glm::vec3& position, float cellSize);
+
+    // sets the distance past which sources are not mixed (unless they are among the loudest); 0 disables the index
+    void setAudibleRange(float audibleRange) { _audibleRange = audibleRange; }
+    float getAudibleRange() const { return _audibleRange; }
+    bool isEnabled() const { return _audibleRange > 0.0f; }
+
+    // index the streams of all nodes in [begin, end)
+    void build(ConstIter begin, ConstIter end);
+
+    // the number of indexed nodes
+    int size() const { return (int)_nodes.size(); }
+
+    // call functor on every indexed node with a stream within audible range of position, and on the loudest nodes
+    // each node is visited at most once; visited is scratch space owned by the caller
+    // returns the number of nodes visited
+    template <typename Functor>
+    int forEachCandidate(const glm::vec3& position, std::vector<bool>& visited, Functor functor) const;
+
+private:
+    struct Entry {
+        glm::vec3 position;
+        int node;
+    };
+    using Grid = std::unordered_map<Cell, std::vector<Entry>, CellHasher>;
+
+    Grid _grid;
+    std::vector<SharedNodePointer> _nodes;
+    std::vector<int> _loudest;
+    float _audibleRange { 0.0f };
+};
+
+template <typename Functor>
+int AudioMixerSpatialIndex::forEachCandidate(const glm::vec3& position, std::vector<bool>& visited, Functor functor) const {
+    visited.assign(_nodes.size(), false);
+    int numVisited = 0;
+
+    auto visit = [&](int node) {
+        if (!visited[node]) {
+            visited[node] = true;
+            ++numVisited;
+            functor(_nodes[node]);
+        }
+    };
+
+    // the grid resolution is the audible range, so audible sources are in the neighboring cells
+    const float audibleRange2 = _audibleRange * _audibleRange;
+    Cell center = cellForPosition(position, _audibleRange);
+    for (int x = center.x - 1; x <= center.x + 1; ++x) {
+        for (int y = center.y - 1; y <= center.y + 1; ++y) {
+            for (int z = center.z - 1; z <= center.z + 1; ++z) {
+                auto cell = _grid.find({ x, y, z });
+                if (cell == _grid.end()) {
+                    continue;
+                }
+
+                for (const Entry& entry : cell->second) {
+                    glm::vec3 relativePosition = entry.position - position;
+                    if (glm::dot(relativePosition, relativePosition) <= audibleRange2) {
+                        visit(entry.node);
+                    }
+                }
+            }
+        }
+    }
+
+    for (int node : _loudest) {
+        visit(node);
+    }
+
+    return numVisited;
+}
+
+#endif // hifi_AudioMixerSpatialIndex_h
@@ -15,12 +15,20 @@ void AudioMixerStats::reset() {
     sumStreams = 0;
     sumListeners = 0;
     sumListenersSilent = 0;
+    sumClusters = 0;
+    sumClusteredListeners = 0;
+    sumQueuedPackets = 0;
     totalMixes = 0;
     hrtfRenders = 0;
     hrtfSilentRenders = 0;
     hrtfThrottleRenders = 0;
     manualStereoMixes = 0;
     manualEchoMixes = 0;
+    candidatesVisited = 0;
+    candidatesSkipped = 0;
+    clusterBusMixes = 0;
+    clusterSourceMixes = 0;
+    clusterBusRenders = 0;
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     mixTime = 0;
 #endif
@@ -30,12 +38,20 @@ void AudioMixerStats::accumulate(const AudioMixerStats& otherStats) {
     sumStreams += otherStats.sumStreams;
     sumListeners += otherStats.sumListeners;
     sumListenersSilent += otherStats.sumListenersSilent;
+    sumClusters += otherStats.sumClusters;
+    sumClusteredListeners += otherStats.sumClusteredListeners;
+    sumQueuedPackets += otherStats.sumQueuedPackets;
     totalMixes += otherStats.totalMixes;
     hrtfRenders += otherStats.hrtfRenders;
     hrtfSilentRenders += otherStats.hrtfSilentRenders;
     hrtfThrottleRenders += otherStats.hrtfThrottleRenders;
     manualStereoMixes += otherStats.manualStereoMixes;
     manualEchoMixes += otherStats.manualEchoMixes;
+    candidatesVisited += otherStats.candidatesVisited;
+    candidatesSkipped += otherStats.candidatesSkipped;
+    clusterBusMixes += otherStats.clusterBusMixes;
+    clusterSourceMixes += otherStats.clusterSourceMixes;
+    clusterBusRenders += otherStats.clusterBusRenders;
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     mixTime += otherStats.mixTime;
 #endif
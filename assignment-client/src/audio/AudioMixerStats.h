@@ -20,6 +20,10 @@ struct AudioMixerStats {
     int sumStreams { 0 };
     int sumListeners { 0 };
     int sumListenersSilent { 0 };
+    int sumClusters { 0 };
+    int sumClusteredListeners { 0 };
+
+    int sumQueuedPackets { 0 };
 
     int totalMixes { 0 };
 
@@ -30,6 +34,13 @@ struct AudioMixerStats {
     int manualStereoMixes { 0 };
     int manualEchoMixes { 0 };
 
+    int candidatesVisited { 0 };
+    int candidatesSkipped { 0 };
+
+    int clusterBusMixes { 0 };
+    int clusterSourceMixes { 0 };
+    int clusterBusRenders { 0 };
+
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     uint64_t mixTime { 0 };
 #endif
@@ -144,8 +144,14 @@ void AvatarMixer::start() {
         {
             auto start = usecTimestampNow();
             nodeList->nestedEach([&](NodeList::const_iterator cbegin, NodeList::const_iterator cend) {
+                // index the avatars, so that receivers only prioritize those they may be sent
                 auto start = usecTimestampNow();
-                _slavePool.broadcastAvatarData(cbegin, cend, _lastFrameTimestamp, _maxKbpsPerNode, _throttlingRatio);
+                _spatialIndex.build(cbegin, cend);
+                _spatialIndexElapsedTime += (usecTimestampNow() - start);
+
+                start = usecTimestampNow();
+                _slavePool.broadcastAvatarData(cbegin, cend, _lastFrameTimestamp, _maxKbpsPerNode, _throttlingRatio,
+                    &_spatialIndex);
                 auto end = usecTimestampNow();
                 _broadcastAvatarDataInner += (end - start);
             }, &lockWait, &nodeTransform, &functor);
@@ -474,6 +480,7 @@ void AvatarMixer::sendStatsPacket() {
     statsObject["threads"] = _slavePool.numThreads();
     statsObject["trailing_mix_ratio"] = _trailingMixRatio;
     statsObject["throttling_ratio"] = _throttlingRatio;
+    statsObject["budget_range"] = _spatialIndex.getBudgetRange();
 
     // this things all occur on the frequency of the tight loop
     int tightLoopFrames = _numTightLoopFrames;
@@ -486,6 +493,7 @@ void AvatarMixer::sendStatsPacket() {
     QJsonObject singleCoreTasks;
     singleCoreTasks["processEvents"] = TIGHT_LOOP_STAT_UINT64(_processEventsElapsedTime);
     singleCoreTasks["queueIncomingPacket"] = TIGHT_LOOP_STAT_UINT64(_queueIncomingPacketElapsedTime);
+    singleCoreTasks["spatialIndex"] = TIGHT_LOOP_STAT_UINT64(_spatialIndexElapsedTime);
 
     QJsonObject incomingPacketStats;
     incomingPacketStats["handleAvatarIdentityPacket"] = TIGHT_LOOP_STAT_UINT64(_handleAvatarIdentityPacketElapsedTime);
@@ -551,6 +559,13 @@ void AvatarMixer::sendStatsPacket() {
 
         float averageOverBudgetAvatars = averageNodes ? stats.overBudgetAvatars / averageNodes : 0.0f;
         slaveObject["sent_7_averageOverBudgetAvatars"] = TIGHT_LOOP_STAT(averageOverBudgetAvatars);
+        slaveObject["sent_8_pairsEvaluated"] = TIGHT_LOOP_STAT(stats.pairsEvaluated);
+
+        slaveObject["encode_1_cacheHits"] = TIGHT_LOOP_STAT(stats.encodeCacheHits);
+        slaveObject["encode_2_cacheMisses"] = TIGHT_LOOP_STAT(stats.encodeCacheMisses);
+        slaveObject["encode_3_unshared"] = TIGHT_LOOP_STAT(stats.encodesUnshared);
+        int sharedEncodes = stats.encodeCacheHits + stats.encodeCacheMisses;
+        slaveObject["encode_4_cacheHitRate"] = sharedEncodes ? (float)stats.encodeCacheHits / (float)sharedEncodes : 0.0f;
 
         slaveObject["timing_1_processIncomingPackets"] = TIGHT_LOOP_STAT_UINT64(stats.processIncomingPacketsElapsedTime);
         slaveObject["timing_2_ignoreCalculation"] = TIGHT_LOOP_STAT_UINT64(stats.ignoreCalculationElapsedTime);
@@ -584,6 +599,14 @@ void AvatarMixer::sendStatsPacket() {
 
     float averageOverBudgetAvatars = averageNodes ? aggregateStats.overBudgetAvatars / averageNodes : 0.0f;
     slavesAggregatObject["sent_7_averageOverBudgetAvatars"] = TIGHT_LOOP_STAT(averageOverBudgetAvatars);
+    slavesAggregatObject["sent_8_pairsEvaluated"] = TIGHT_LOOP_STAT(aggregateStats.pairsEvaluated);
+
+    slavesAggregatObject["encode_1_cacheHits"] = TIGHT_LOOP_STAT(aggregateStats.encodeCacheHits);
+    slavesAggregatObject["encode_2_cacheMisses"] = TIGHT_LOOP_STAT(aggregateStats.encodeCacheMisses);
+    slavesAggregatObject["encode_3_unshared"] = TIGHT_LOOP_STAT(aggregateStats.encodesUnshared);
+    int sharedEncodes = aggregateStats.encodeCacheHits + aggregateStats.encodeCacheMisses;
+    slavesAggregatObject["encode_4_cacheHitRate"] = sharedEncodes ?
+        (float)aggregateStats.encodeCacheHits / (float)sharedEncodes : 0.0f;
 
     slavesAggregatObject["timing_1_processIncomingPackets"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.processIncomingPacketsElapsedTime);
     slavesAggregatObject["timing_2_ignoreCalculation"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.ignoreCalculationElapsedTime);
@@ -594,6 +617,7 @@ void AvatarMixer::sendStatsPacket() {
 
     statsObject["slaves_aggregate"] = slavesAggregatObject;
     statsObject["slaves_individual"] = slavesObject;
+    statsObject["slaves_scheduler"] = _slavePool.takeSchedulerStats();
 
     _handleViewFrustumPacketElapsedTime = 0;
     _handleAvatarIdentityPacketElapsedTime = 0;
@@ -649,6 +673,7 @@ void AvatarMixer::sendStatsPacket() {
     _broadcastAvatarDataLockWait = 0;
     _broadcastAvatarDataNodeTransform = 0;
     _broadcastAvatarDataNodeFunctor = 0;
+    _spatialIndexElapsedTime = 0;
 
     _displayNameManagementElapsedTime = 0;
     _ignoreCalculationElapsedTime = 0;
@@ -730,6 +755,14 @@ void AvatarMixer::parseDomainServerSettings(const QJsonObject& domainSettings) {
     _maxKbpsPerNode = nodeBandwidthValue.toDouble(DEFAULT_NODE_SEND_BANDWIDTH) * KILO_PER_MEGA;
     qCDebug(avatars) << "The maximum send bandwidth per node is" << _maxKbpsPerNode << "kbps.";
 
+    const QString BUDGET_RANGE_KEY = "budget_range";
+    const float DEFAULT_BUDGET_RANGE = 0.0f;
+    float budgetRange = std::max((float)avatarMixerGroupObject[BUDGET_RANGE_KEY].toDouble(DEFAULT_BUDGET_RANGE), 0.0f);
+    _spatialIndex.setBudgetRange(budgetRange);
+    if (budgetRange > 0.0f) {
+        qCDebug(avatars) << "Avatars will be prioritized within" << budgetRange << "m, in view, or in turn.";
+    }
+
     const QString AUTO_THREADS = "auto_threads";
     bool autoThreads = avatarMixerGroupObject[AUTO_THREADS].toBool();
     if (!autoThreads) {
@@ -22,6 +22,7 @@
 #include "AvatarMixerClientData.h"
 
 #include "AvatarMixerSlavePool.h"
+#include "AvatarMixerSpatialIndex.h"
 
 /// Handles assignments of type AvatarMixer - distribution of avatar data to various clients
 class AvatarMixer : public ThreadedAssignment {
@@ -92,6 +93,7 @@ private:
     quint64 _broadcastAvatarDataLockWait { 0 };
     quint64 _broadcastAvatarDataNodeTransform { 0 };
     quint64 _broadcastAvatarDataNodeFunctor { 0 };
+    quint64 _spatialIndexElapsedTime { 0 };
 
     quint64 _handleAdjustAvatarSortingElapsedTime { 0 };
     quint64 _handleViewFrustumPacketElapsedTime { 0 };
@@ -112,6 +114,7 @@ private:
 
 
     AvatarMixerSlavePool _slavePool;
+    AvatarMixerSpatialIndex _spatialIndex;
 
 };
 
@@ -65,6 +65,37 @@ int AvatarMixerClientData::parseData(ReceivedMessage& message) {
     // compute the offset to the data payload
     return _avatar->parseDataFromBuffer(message.readWithoutCopy(message.getBytesLeftToRead()));
 }
+
+QByteArray AvatarMixerClientData::getSharedAvatarData(HRCTime frame, AvatarData::AvatarDataDetail detail,
+        AvatarDataPacket::HasFlags flags, const std::function<QByteArray()>& encode, bool& isCached) const {
+    {
+        std::lock_guard<std::mutex> lock(_sharedAvatarDataMutex);
+        if (_sharedAvatarDataFrame != frame) {
+            _sharedAvatarDataFrame = frame;
+            _sharedAvatarData.clear();
+        } else {
+            for (auto& data : _sharedAvatarData) {
+                if (data.detail == detail && data.flags == flags) {
+                    isCached = true;
+                    return data.bytes;
+                }
+            }
+        }
+    }
+
+    // encode outside of the lock, so that receivers of other details are not held back
+    QByteArray bytes = encode();
+    {
+        std::lock_guard<std::mutex> lock(_sharedAvatarDataMutex);
+        if (_sharedAvatarDataFrame == frame) {
+            _sharedAvatarData.push_back({ detail, flags, bytes });
+        }
+    }
+
+    isCached = false;
+    return bytes;
+}
+
 uint64_t AvatarMixerClientData::getLastBroadcastTime(const QUuid& nodeUUID) const {
     // return the matching PacketSequenceNumber, or the default if we don't have it
     auto nodeMatch = _lastBroadcastTimes.find(nodeUUID);
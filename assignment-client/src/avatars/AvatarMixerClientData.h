@@ -14,6 +14,8 @@
 
 #include <algorithm>
 #include <cfloat>
+#include <functional>
+#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
 #include <queue>
@@ -93,6 +95,7 @@ public:
     glm::vec3 getGlobalBoundingBoxCorner() const { return _avatar ? _avatar->getGlobalBoundingBoxCorner() : glm::vec3(0); }
     bool isRadiusIgnoring(const QUuid& other) const { return _radiusIgnoredOthers.find(other) != _radiusIgnoredOthers.end(); }
     void addToRadiusIgnoringSet(const QUuid& other) { _radiusIgnoredOthers.insert(other); }
+    const std::unordered_set<QUuid>& getRadiusIgnoredOthers() const { return _radiusIgnoredOthers; }
     void removeFromRadiusIgnoringSet(SharedNodePointer self, const QUuid& other);
     void ignoreOther(SharedNodePointer self, SharedNodePointer other);
 
@@ -119,6 +122,11 @@ public:
         return result;
     }
 
+    // returns this avatar's data for a sharable detail (see AvatarData::isSharableDetail) with the given flags,
+    // calling encode only if no other receiver has yet this frame; it is safe to call concurrently
+    QByteArray getSharedAvatarData(HRCTime frame, AvatarData::AvatarDataDetail detail, AvatarDataPacket::HasFlags flags,
+        const std::function<QByteArray()>& encode, bool& isCached) const;
+
     QVector<JointData>& getLastOtherAvatarSentJoints(QUuid otherAvatar) {
         _lastOtherAvatarSentJoints[otherAvatar].resize(_avatar->getJointCount());
         return _lastOtherAvatarSentJoints[otherAvatar];
@@ -144,6 +152,16 @@ private:
     std::unordered_map<QUuid, quint64> _lastOtherAvatarEncodeTime;
     std::unordered_map<QUuid, QVector<JointData>> _lastOtherAvatarSentJoints;
 
+    // this avatar's data, as encoded for other nodes this frame (guarded by mutex)
+    struct SharedAvatarData {
+        AvatarData::AvatarDataDetail detail;
+        AvatarDataPacket::HasFlags flags;
+        QByteArray bytes;
+    };
+    mutable std::mutex _sharedAvatarDataMutex;
+    mutable HRCTime _sharedAvatarDataFrame;
+    mutable std::vector<SharedAvatarData> _sharedAvatarData;
+
     uint64_t _identityChangeTimestamp;
     bool _avatarSessionDisplayNameMustChange{ true };
 
@@ -31,6 +31,7 @@
 #include "AvatarMixer.h"
 #include "AvatarMixerClientData.h"
 #include "AvatarMixerSlave.h"
+#include "AvatarMixerSpatialIndex.h"
 
 
 void AvatarMixerSlave::configure(ConstIter begin, ConstIter end) {
@@ -40,12 +41,14 @@ void AvatarMixerSlave::configure(ConstIter begin, ConstIter end) {
 
 void AvatarMixerSlave::configureBroadcast(ConstIter begin, ConstIter end, 
                                 p_high_resolution_clock::time_point lastFrameTimestamp,
-                                float maxKbpsPerNode, float throttlingRatio) {
+                                float maxKbpsPerNode, float throttlingRatio,
+                                const AvatarMixerSpatialIndex* spatialIndex) {
     _begin = begin;
     _end = end;
     _lastFrameTimestamp = lastFrameTimestamp;
     _maxKbpsPerNode = maxKbpsPerNode;
     _throttlingRatio = throttlingRatio;
+    _spatialIndex = spatialIndex;
 }
 
 void AvatarMixerSlave::harvestStats(AvatarMixerSlaveStats& stats) {
@@ -160,7 +163,7 @@ void AvatarMixerSlave::broadcastAvatarData(const SharedNodePointer& node) {
         QList<AvatarSharedPointer> avatarList;
         std::unordered_map<AvatarSharedPointer, SharedNodePointer> avatarDataToNodes;
 
-        std::for_each(_begin, _end, [&](const SharedNodePointer& otherNode) {
+        auto addAvatar = [&](const SharedNodePointer& otherNode) {
             const AvatarMixerClientData* otherNodeData = reinterpret_cast<const AvatarMixerClientData*>(otherNode->getLinkedData());
 
             // theoretically it's possible for a Node to be in the NodeList (and therefore end up here),
@@ -171,10 +174,27 @@ void AvatarMixerSlave::broadcastAvatarData(const SharedNodePointer& node) {
                 avatarList << otherAvatar;
                 avatarDataToNodes[otherAvatar] = otherNode;
             }
-        });
+        };
 
         AvatarSharedPointer thisAvatar = nodeData->getAvatarSharedPointer();
         ViewFrustum cameraView = nodeData->getViewFrustom();
+
+        // only prioritize the candidates of the spatial index, unless the PAL needs every avatar,
+        // or this avatar's bubble may reach beyond its neighborhood
+        bool useSpatialIndex = _spatialIndex && _spatialIndex->isEnabled() && !PALIsOpen &&
+            !_spatialIndex->isLarge(AvatarMixerSpatialIndex::radiusForAvatar(nodeData->getPosition(),
+                nodeData->getGlobalBoundingBoxCorner()));
+        if (useSpatialIndex) {
+            _spatialIndex->forEachCandidate(nodeData->getPosition(), cameraView, _visitedNodes, addAvatar);
+
+            // avatars in our bubble must be considered until they leave it, wherever they went
+            for (const QUuid& otherID : nodeData->getRadiusIgnoredOthers()) {
+                _spatialIndex->visit(otherID, _visitedNodes, addAvatar);
+            }
+        } else {
+            std::for_each(_begin, _end, addAvatar);
+        }
+        _stats.pairsEvaluated += avatarList.size();
         std::priority_queue<AvatarPriority> sortedAvatars;
         AvatarData::sortAvatars(avatarList, cameraView, sortedAvatars,
 
@@ -339,9 +359,32 @@ void AvatarMixerSlave::broadcastAvatarData(const SharedNodePointer& node) {
             AvatarDataPacket::HasFlags hasFlagsOut; // the result of the toByteArray
             bool dropFaceTracking = false;
 
+            // details that do not depend on this receiver are encoded once per frame, and shared by all receivers
+            auto encode = [&](AvatarData::AvatarDataDetail encodeDetail) {
+                auto toByteArray = [&] {
+                    return otherAvatar->toByteArray(encodeDetail, lastEncodeForOther, lastSentJointsForOther,
+                        hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, &lastSentJointsForOther);
+                };
+
+                if (!AvatarData::isSharableDetail(encodeDetail)) {
+                    _stats.encodesUnshared++;
+                    return toByteArray();
+                }
+
+                bool isCached;
+                hasFlagsOut = otherAvatar->getHasFlags(encodeDetail, lastEncodeForOther, dropFaceTracking);
+                QByteArray bytes = otherNodeData->getSharedAvatarData(_lastFrameTimestamp, encodeDetail, hasFlagsOut,
+                    toByteArray, isCached);
+                if (isCached) {
+                    _stats.encodeCacheHits++;
+                } else {
+                    _stats.encodeCacheMisses++;
+                }
+                return bytes;
+            };
+
             quint64 start = usecTimestampNow();
-            QByteArray bytes = otherAvatar->toByteArray(detail, lastEncodeForOther, lastSentJointsForOther, 
-                                            hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, &lastSentJointsForOther);
+            QByteArray bytes = encode(detail);
             quint64 end = usecTimestampNow();
             _stats.toByteArrayElapsedTime += (end - start);
 
@@ -350,13 +393,11 @@ void AvatarMixerSlave::broadcastAvatarData(const SharedNodePointer& node) {
                 qCWarning(avatars) << "otherAvatar.toByteArray() resulted in very large buffer:" << bytes.size() << "... attempt to drop facial data";
 
                 dropFaceTracking = true; // first try dropping the facial data
-                bytes = otherAvatar->toByteArray(detail, lastEncodeForOther, lastSentJointsForOther,
-                    hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, &lastSentJointsForOther);
+                bytes = encode(detail);
 
                 if (bytes.size() > MAX_ALLOWED_AVATAR_DATA) {
                     qCWarning(avatars) << "otherAvatar.toByteArray() without facial data resulted in very large buffer:" << bytes.size() << "... reduce to MinimumData";
-                    bytes = otherAvatar->toByteArray(AvatarData::MinimumData, lastEncodeForOther, lastSentJointsForOther,
-                        hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, &lastSentJointsForOther);
+                    bytes = encode(AvatarData::MinimumData);
                 }
 
                 if (bytes.size() > MAX_ALLOWED_AVATAR_DATA) {
@@ -12,7 +12,10 @@
 #ifndef hifi_AvatarMixerSlave_h
 #define hifi_AvatarMixerSlave_h
 
+#include <vector>
+
 class AvatarMixerClientData;
+class AvatarMixerSpatialIndex;
 
 class AvatarMixerSlaveStats {
 public:
@@ -26,6 +29,10 @@ public:
     int numIdentityPackets { 0 };
     int numOthersIncluded { 0 };
     int overBudgetAvatars { 0 };
+    int pairsEvaluated { 0 };
+    int encodeCacheHits { 0 };
+    int encodeCacheMisses { 0 };
+    int encodesUnshared { 0 };
 
     quint64 ignoreCalculationElapsedTime { 0 };
     quint64 avatarDataPackingElapsedTime { 0 };
@@ -46,6 +53,10 @@ public:
         numIdentityPackets = 0;
         numOthersIncluded = 0;
         overBudgetAvatars = 0;
+        pairsEvaluated = 0;
+        encodeCacheHits = 0;
+        encodeCacheMisses = 0;
+        encodesUnshared = 0;
 
         ignoreCalculationElapsedTime = 0;
         avatarDataPackingElapsedTime = 0;
@@ -65,6 +76,10 @@ public:
         numIdentityPackets += rhs.numIdentityPackets;
         numOthersIncluded += rhs.numOthersIncluded;
         overBudgetAvatars += rhs.overBudgetAvatars;
+        pairsEvaluated += rhs.pairsEvaluated;
+        encodeCacheHits += rhs.encodeCacheHits;
+        encodeCacheMisses += rhs.encodeCacheMisses;
+        encodesUnshared += rhs.encodesUnshared;
 
         ignoreCalculationElapsedTime += rhs.ignoreCalculationElapsedTime;
         avatarDataPackingElapsedTime += rhs.avatarDataPackingElapsedTime;
@@ -83,7 +98,8 @@ public:
     void configure(ConstIter begin, ConstIter end);
     void configureBroadcast(ConstIter begin, ConstIter end, 
                     p_high_resolution_clock::time_point lastFrameTimestamp, 
-                    float maxKbpsPerNode, float throttlingRatio);
+                    float maxKbpsPerNode, float throttlingRatio,
+                    const AvatarMixerSpatialIndex* spatialIndex = nullptr);
 
     void processIncomingPackets(const SharedNodePointer& node);
     void broadcastAvatarData(const SharedNodePointer& node);
@@ -100,6 +116,10 @@ private:
     p_high_resolution_clock::time_point _lastFrameTimestamp;
     float _maxKbpsPerNode { 0.0f };
     float _throttlingRatio { 0.0f };
+    const AvatarMixerSpatialIndex* _spatialIndex { nullptr };
+
+    // scratch space
+    std::vector<bool> _visitedNodes;
 
     AvatarMixerSlaveStats _stats;
 };
@@ -18,10 +18,11 @@ void AvatarMixerSlaveThread::run() {
     while (true) {
         wait();
 
-        // iterate over all available nodes
-        SharedNodePointer node;
-        while (try_pop(node)) {
-            (this->*_function)(node);
+        // iterate over all available nodes, stealing from other slaves once ours are done
+        if (_scheduler) {
+            _scheduler->run(_index, [&](const SharedNodePointer& node) {
+                (this->*_function)(node);
+            });
         }
 
         bool stopping = _stop;
@@ -45,6 +46,7 @@ void AvatarMixerSlaveThread::wait() {
         _pool._configure(*this);
     }
     _function = _pool._function;
+    _scheduler = _pool._scheduler;
 }
 
 void AvatarMixerSlaveThread::notify(bool stopping) {
@@ -59,10 +61,6 @@ void AvatarMixerSlaveThread::notify(bool stopping) {
     _pool._poolCondition.notify_one();
 }
 
-bool AvatarMixerSlaveThread::try_pop(SharedNodePointer& node) {
-    return _pool._queue.try_pop(node);
-}
-
 #ifdef AVATAR_SINGLE_THREADED
 static AvatarMixerSlave slave;
 #endif
@@ -72,20 +70,21 @@ void AvatarMixerSlavePool::processIncomingPackets(ConstIter begin, ConstIter end
     _configure = [&](AvatarMixerSlave& slave) { 
         slave.configure(begin, end);
     };
-    run(begin, end);
+    run(begin, end, _packetsScheduler);
 }
 
 void AvatarMixerSlavePool::broadcastAvatarData(ConstIter begin, ConstIter end, 
                                      p_high_resolution_clock::time_point lastFrameTimestamp, 
-                                     float maxKbpsPerNode, float throttlingRatio) {
+                                     float maxKbpsPerNode, float throttlingRatio,
+                                     const AvatarMixerSpatialIndex* spatialIndex) {
     _function = &AvatarMixerSlave::broadcastAvatarData;
     _configure = [&](AvatarMixerSlave& slave) { 
-        slave.configureBroadcast(begin, end, lastFrameTimestamp, maxKbpsPerNode, throttlingRatio);
+        slave.configureBroadcast(begin, end, lastFrameTimestamp, maxKbpsPerNode, throttlingRatio, spatialIndex);
    };
-    run(begin, end);
+    run(begin, end, _broadcastScheduler);
 }
 
-void AvatarMixerSlavePool::run(ConstIter begin, ConstIter end) {
+void AvatarMixerSlavePool::run(ConstIter begin, ConstIter end, Scheduler& scheduler) {
     _begin = begin;
     _end = end;
 
@@ -95,10 +94,12 @@ void AvatarMixerSlavePool::run(ConstIter begin, ConstIter end) {
         _function(slave, node);
 });
 #else
-    // fill the queue
+    // partition the nodes between the slaves
     std::for_each(_begin, _end, [&](const SharedNodePointer& node) {
-        _queue.emplace(node);
+        scheduler.add(node, node->getUUID());
     });
+    scheduler.schedule(_numThreads);
+    _scheduler = &scheduler;
 
     {
         Lock lock(_mutex);
@@ -116,7 +117,8 @@ void AvatarMixerSlavePool::run(ConstIter begin, ConstIter end) {
         assert(_numStarted == _numThreads);
     }
 
-    assert(_queue.empty());
+    scheduler.finish();
+    _scheduler = nullptr;
 #endif
 }
 
@@ -131,6 +133,13 @@ void AvatarMixerSlavePool::each(std::function<void(AvatarMixerSlave& slave)> fun
 #endif
 }
 
+QJsonObject AvatarMixerSlavePool::takeSchedulerStats() {
+    QJsonObject stats;
+    stats["packets"] = _packetsScheduler.takeStats();
+    stats["broadcast"] = _broadcastScheduler.takeStats();
+    return stats;
+}
+
 void AvatarMixerSlavePool::setNumThreads(int numThreads) {
     // clamp to allowed size
     {
@@ -164,7 +173,7 @@ void AvatarMixerSlavePool::resize(int numThreads) {
     if (numThreads > _numThreads) {
         // start new slaves
         for (int i = 0; i < numThreads - _numThreads; ++i) {
-            auto slave = new AvatarMixerSlaveThread(*this);
+            auto slave = new AvatarMixerSlaveThread(*this, (int)_slaves.size());
             slave->start();
             _slaves.emplace_back(slave);
         }
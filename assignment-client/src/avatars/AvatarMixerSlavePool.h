@@ -16,11 +16,10 @@
 #include <mutex>
 #include <vector>
 
-#include <tbb/concurrent_queue.h>
-
 #include <QThread>
 
 #include <NodeList.h>
+#include <WorkStealingScheduler.h>
 
 #include "AvatarMixerSlave.h"
 
@@ -33,7 +32,7 @@ class AvatarMixerSlaveThread : public QThread, public AvatarMixerSlave {
     using Lock = std::unique_lock<Mutex>;
 
 public:
-    AvatarMixerSlaveThread(AvatarMixerSlavePool& pool) : _pool(pool) {}
+    AvatarMixerSlaveThread(AvatarMixerSlavePool& pool, int index) : _pool(pool), _index(index) {}
 
     void run() override final;
 
@@ -42,17 +41,18 @@ private:
 
     void wait();
     void notify(bool stopping);
-    bool try_pop(SharedNodePointer& node);
 
     AvatarMixerSlavePool& _pool;
+    const int _index;
     void (AvatarMixerSlave::*_function)(const SharedNodePointer& node) { nullptr };
+    WorkStealingScheduler<SharedNodePointer>* _scheduler { nullptr };
     bool _stop { false };
 };
 
 // Slave pool for avatar mixers
 //   AvatarMixerSlavePool is not thread-safe! It should be instantiated and used from a single thread.
 class AvatarMixerSlavePool {
-    using Queue = tbb::concurrent_queue<SharedNodePointer>;
+    using Scheduler = WorkStealingScheduler<SharedNodePointer>;
     using Mutex = std::mutex;
     using Lock = std::unique_lock<Mutex>;
     using ConditionVariable = std::condition_variable;
@@ -66,7 +66,8 @@ public:
     // Jobs the slave pool can do...
     void processIncomingPackets(ConstIter begin, ConstIter end);
     void broadcastAvatarData(ConstIter begin, ConstIter end, 
-                    p_high_resolution_clock::time_point lastFrameTimestamp, float maxKbpsPerNode, float throttlingRatio);
+                    p_high_resolution_clock::time_point lastFrameTimestamp, float maxKbpsPerNode, float throttlingRatio,
+                    const AvatarMixerSpatialIndex* spatialIndex = nullptr);
 
     // iterate over all slaves
     void each(std::function<void(AvatarMixerSlave& slave)> functor);
@@ -74,15 +75,17 @@ public:
     void setNumThreads(int numThreads);
     int numThreads() { return _numThreads; }
 
+    // returns the utilization and steals of each slave, per job, since the last call
+    QJsonObject takeSchedulerStats();
+
 private:
-    void run(ConstIter begin, ConstIter end);
+    void run(ConstIter begin, ConstIter end, Scheduler& scheduler);
     void resize(int numThreads);
 
     std::vector<std::unique_ptr<AvatarMixerSlaveThread>> _slaves;
 
     friend void AvatarMixerSlaveThread::wait();
     friend void AvatarMixerSlaveThread::notify(bool stopping);
-    friend bool AvatarMixerSlaveThread::try_pop(SharedNodePointer& node);
 
     // synchronization state
     Mutex _mutex;
@@ -95,8 +98,12 @@ private:
     int _numFinished { 0 }; // guarded by _mutex
     int _numStopped { 0 }; // guarded by _mutex
 
+    // each job is scheduled separately, as the costs of its nodes differ
+    Scheduler _packetsScheduler;
+    Scheduler _broadcastScheduler;
+    Scheduler* _scheduler { nullptr };
+
     // frame state
-    Queue _queue;
     ConstIter _begin;
     ConstIter _end;
 };
@@ -0,0 +1,97 @@
+//
+//  AvatarMixerSpatialIndex.cpp
+//  assignment-client/src/avatars
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include "AvatarMixerClientData.h"
+
+#include "AvatarMixerSpatialIndex.h"
+
+void AvatarMixerSpatialIndex::build(ConstIter begin, ConstIter end) {
+    // keep cells that were occupied last frame allocated, and drop the rest
+    for (auto cell = _grid.begin(); cell != _grid.end();) {
+        if (cell->second.empty()) {
+            cell = _grid.erase(cell);
+        } else {
+            cell->second.clear();
+            ++cell;
+        }
+    }
+    _nodes.clear();
+    _nodeIndices.clear();
+    _large.clear();
+    _occupied = { { 1, 1, 1 }, { 0, 0, 0 } };
+    ++_frame;
+
+    if (!isEnabled()) {
+        return;
+    }
+
+    std::for_each(begin, end, [&](const SharedNodePointer& node) {
+        const AvatarMixerClientData* nodeData = reinterpret_cast<const AvatarMixerClientData*>(node->getLinkedData());
+        if (!nodeData) {
+            return;
+        }
+
+        int index = (int)_nodes.size();
+        _nodes.push_back(node);
+        _nodeIndices[node->getUUID()] = index;
+
+        glm::vec3 position = nodeData->getPosition();
+        float radius = radiusForAvatar(position, nodeData->getGlobalBoundingBoxCorner());
+        Cell cell = cellForPosition(position);
+        _grid[cell].push_back({ position, radius, index });
+
+        if (_occupied.isEmpty()) {
+            _occupied = { cell, cell };
+        } else {
+            _occupied.min = { std::min(_occupied.min.x, cell.x), std::min(_occupied.min.y, cell.y),
+                              std::min(_occupied.min.z, cell.z) };
+            _occupied.max = { std::max(_occupied.max.x, cell.x), std::max(_occupied.max.y, cell.y),
+                              std::max(_occupied.max.z, cell.z) };
+        }
+
+        if (isLarge(radius)) {
+            _large.push_back(index);
+        }
+    });
+}
+
+float AvatarMixerSpatialIndex::radiusForAvatar(const glm::vec3& position, const glm::vec3& boundingBoxCorner) {
+    glm::vec3 halfScale = glm::abs(position - boundingBoxCorner);
+    return glm::max(halfScale.x, glm::max(halfScale.y, halfScale.z));
+}
+
+AvatarMixerSpatialIndex::Cell AvatarMixerSpatialIndex::cellForPosition(const glm::vec3& position) const {
+    glm::vec3 cell = glm::floor(position / _budgetRange);
+    return { (int)cell.x, (int)cell.y, (int)cell.z };
+}
+
+AvatarMixerSpatialIndex::CellRange AvatarMixerSpatialIndex::cellsInView(const ViewFrustum& view) const {
+    const glm::vec3 corners[] = {
+        view.getNearTopLeft(), view.getNearTopRight(), view.getNearBottomLeft(), view.getNearBottomRight(),
+        view.getFarTopLeft(), view.getFarTopRight(), view.getFarBottomLeft(), view.getFarBottomRight()
+    };
+
+    glm::vec3 minCorner = view.getPosition();
+    glm::vec3 maxCorner = view.getPosition();
+    for (auto& corner : corners) {
+        minCorner = glm::min(minCorner, corner);
+        maxCorner = glm::max(maxCorner, corner);
+    }
+
+    // the corners of a view with a far clip beyond the occupied cells may be too far for a cell index
+    glm::vec3 occupiedMin = glm::vec3(_occupied.min.x, _occupied.min.y, _occupied.min.z) * _budgetRange;
+    glm::vec3 occupiedMax = glm::vec3(_occupied.max.x + 1, _occupied.max.y + 1, _occupied.max.z + 1) * _budgetRange;
+    minCorner = glm::clamp(minCorner, occupiedMin, occupiedMax);
+    maxCorner = glm::clamp(maxCorner, occupiedMin, occupiedMax);
+
+    return { cellForPosition(minCorner), cellForPosition(maxCorner) };
+}
@@ -0,0 +1,210 @@
+//
+//  AvatarMixerSpatialIndex.h
+//  assignment-client/src/avatars
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarMixerSpatialIndex_h
+#define hifi_AvatarMixerSpatialIndex_h
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <AABox.h>
+#include <NodeList.h>
+#include <UUIDHasher.h>
+#include <ViewFrustum.h>
+
+// Uniform grid over the positions of all avatars, rebuilt once per frame by the AvatarMixer
+//   It bounds the avatars that a receiver prioritizes to those within budget range, those in its view,
+//   and a rotating share of the rest, so that distant avatars are still refreshed.
+//   AvatarMixerSpatialIndex is not thread-safe to build, but it is safe to query concurrently once built.
+class AvatarMixerSpatialIndex {
+public:
+    using ConstIter = NodeList::const_iterator;
+
+    // distant avatars are refreshed round-robin, each once every this many frames
+    static const int NUM_REFRESH_FRAMES = 45;
+
+    // the scale from the bounding box of an avatar to its ignore bubble (see AvatarMixerSlave::broadcastAvatarData)
+    static const int BUBBLE_SCALE = 4;
+
+    // sets the size of the neighborhood of a receiver along each axis; 0 disables the index
+    void setBudgetRange(float budgetRange) { _budgetRange = budgetRange; }
+    float getBudgetRange() const { return _budgetRange; }
+    bool isEnabled() const { return _budgetRange > 0.0f; }
+
+    // index the avatars of all nodes in [begin, end)
+    void build(ConstIter begin, ConstIter end);
+
+    // the number of indexed nodes
+    int size() const { return (int)_nodes.size(); }
+
+    // returns whether the ignore bubble of an avatar of this radius may reach beyond its neighborhood
+    bool isLarge(float radius) const { return 2.0f * BUBBLE_SCALE * radius > _budgetRange; }
+
+    // call functor on every indexed node within budget range of position (along each axis), in view,
+    // due for a refresh this frame, or large
+    // each node is visited at most once; visited is scratch space owned by the caller
+    // returns the number of nodes visited
+    template <typename Functor>
+    int forEachCandidate(const glm::vec3& position, const ViewFrustum& view, std::vector<bool>& visited, Functor functor) const;
+
+    // call functor on the indexed node with the given ID, unless it was visited by the last forEachCandidate
+    template <typename Functor>
+    void visit(const QUuid& nodeID, std::vector<bool>& visited, Functor functor) const;
+
+    // returns the half of the largest dimension of the bounding box of an avatar
+    static float radiusForAvatar(const glm::vec3& position, const glm::vec3& boundingBoxCorner);
+
+private:
+    struct Cell {
+        int x, y, z;
+        bool operator==(const Cell& other) const { return x == other.x && y == other.y && z == other.z; }
+    };
+    struct CellHasher {
+        std::size_t operator()(const Cell& cell) const {
+            // large primes, from "Optimized Spatial Hashing for Collision Detection of Deformable Objects"
+            return ((std::size_t)cell.x * 73856093) ^ ((std::size_t)cell.y * 19349663) ^ ((std::size_t)cell.z * 83492791);
+        }
+    };
+    struct Entry {
+        glm::vec3 position;
+        float radius;
+        int node;
+    };
+    using Grid = std::unordered_map<Cell, std::vector<Entry>, CellHasher>;
+
+    // the cells from min to max, inclusive, along each axis
+    struct CellRange {
+        Cell min, max;
+        bool isEmpty() const { return min.x > max.x || min.y > max.y || min.z > max.z; }
+        bool contains(const Cell& cell) const {
+            return cell.x >= min.x && cell.x <= max.x && cell.y >= min.y && cell.y <= max.y &&
+                cell.z >= min.z && cell.z <= max.z;
+        }
+        int64_t size() const {
+            return isEmpty() ? 0 : (int64_t)(max.x - min.x + 1) * (max.y - min.y + 1) * (max.z - min.z + 1);
+        }
+        CellRange intersection(const CellRange& other) const {
+            return { { std::max(min.x, other.min.x), std::max(min.y, other.min.y), std::max(min.z, other.min.z) },
+                     { std::min(max.x, other.max.x), std::min(max.y, other.max.y), std::min(max.z, other.max.z) } };
+        }
+    };
+
+    Cell cellForPosition(const glm::vec3& position) const;
+
+    // the cells that the bounds of the view overlap
+    CellRange cellsInView(const ViewFrustum& view) const;
+
+    // call functor on every occupied cell of range
+    template <typename Functor>
+    void forEachCell(const CellRange& range, Functor functor) const;
+
+    Grid _grid;
+    CellRange _occupied { { 1, 1, 1 }, { 0, 0, 0 } }; // the bounds of the cells occupied this frame
+    std::vector<SharedNodePointer> _nodes;
+    std::unordered_map<QUuid, int> _nodeIndices;
+    std::vector<int> _large;
+    unsigned int _frame { 0 };
+    float _budgetRange { 0.0f };
+};
+
+template <typename Functor>
+int AvatarMixerSpatialIndex::forEachCandidate(const glm::vec3& position, const ViewFrustum& view,
+        std::vector<bool>& visited, Functor functor) const {
+    visited.assign(_nodes.size(), false);
+    int numVisited = 0;
+
+    auto visit = [&](int node) {
+        if (!visited[node]) {
+            visited[node] = true;
+            ++numVisited;
+            functor(_nodes[node]);
+        }
+    };
+
+    // the grid resolution is the budget range, so the neighborhood is in the neighboring cells
+    Cell center = cellForPosition(position);
+    CellRange neighborhood {
+        { center.x - 1, center.y - 1, center.z - 1 },
+        { center.x + 1, center.y + 1, center.z + 1 }
+    };
+    forEachCell(neighborhood, [&](const Cell&, const std::vector<Entry>& entries) {
+        for (const Entry& entry : entries) {
+            glm::vec3 distance = glm::abs(entry.position - position);
+            if (glm::max(distance.x, glm::max(distance.y, distance.z)) <= _budgetRange ||
+                view.sphereIntersectsFrustum(entry.position, entry.radius)) {
+                visit(entry.node);
+            }
+        }
+    });
+
+    // and the rest is in view only if its cell is
+    forEachCell(cellsInView(view), [&](const Cell& key, const std::vector<Entry>& entries) {
+        AABox cellBox(glm::vec3(key.x, key.y, key.z) * _budgetRange, _budgetRange);
+        if (neighborhood.contains(key) || !view.boxIntersectsFrustum(cellBox)) {
+            return;
+        }
+        for (const Entry& entry : entries) {
+            if (view.sphereIntersectsFrustum(entry.position, entry.radius)) {
+                visit(entry.node);
+            }
+        }
+    });
+
+    for (int node = _frame % NUM_REFRESH_FRAMES; node < (int)_nodes.size(); node += NUM_REFRESH_FRAMES) {
+        visit(node);
+    }
+
+    for (int node : _large) {
+        visit(node);
+    }
+
+    return numVisited;
+}
+
+template <typename Functor>
+void AvatarMixerSpatialIndex::forEachCell(const CellRange& range, Functor functor) const {
+    CellRange occupiedRange = range.intersection(_occupied);
+
+    // look up the cells of the range while there are fewer of them than occupied cells, otherwise go through those
+    if (occupiedRange.size() <= (int64_t)_grid.size()) {
+        for (int x = occupiedRange.min.x; x <= occupiedRange.max.x; ++x) {
+            for (int y = occupiedRange.min.y; y <= occupiedRange.max.y; ++y) {
+                for (int z = occupiedRange.min.z; z <= occupiedRange.max.z; ++z) {
+                    auto cell = _grid.find({ x, y, z });
+                    if (cell != _grid.end() && !cell->second.empty()) {
+                        functor(cell->first, cell->second);
+                    }
+                }
+            }
+        }
+    } else {
+        for (auto& cell : _grid) {
+            if (!cell.second.empty() && occupiedRange.contains(cell.first)) {
+                functor(cell.first, cell.second);
+            }
+        }
+    }
+}
+
+template <typename Functor>
+void AvatarMixerSpatialIndex::visit(const QUuid& nodeID, std::vector<bool>& visited, Functor functor) const {
+    auto index = _nodeIndices.find(nodeID);
+    if (index != _nodeIndices.end() && !visited[index->second]) {
+        visited[index->second] = true;
+        functor(_nodes[index->second]);
+    }
+}
+
+#endif // hifi_AvatarMixerSpatialIndex_h
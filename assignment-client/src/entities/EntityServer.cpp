@@ -41,6 +41,11 @@ EntityServer::EntityServer(ReceivedMessage& message) :
 }
 
 EntityServer::~EntityServer() {
+    // the shared encode stage uses our payload cache, so it can't outlive us
+    if (_encodeThread) {
+        _encodeThread->terminate();
+    }
+
     if (_pruneDeletedEntitiesTimer) {
         _pruneDeletedEntitiesTimer->stop();
         _pruneDeletedEntitiesTimer->deleteLater();
@@ -64,6 +69,7 @@ OctreePointer EntityServer::createTree() {
     EntityTreePointer tree = EntityTreePointer(new EntityTree(true));
     tree->createRootElement();
     tree->addNewlyCreatedHook(this);
+    tree->setPayloadCache(_payloadCache);
     if (!_entitySimulation) {
         SimpleEntitySimulationPointer simpleSimulation { new SimpleEntitySimulation() };
         simpleSimulation->setEntityTree(tree);
@@ -92,6 +98,11 @@ void EntityServer::beforeRun() {
 void EntityServer::entityCreated(const EntityItem& newEntity, const SharedNodePointer& senderNode) {
 }
 
+int EntityServer::sharedEncode(QThreadPool& encodePool) {
+    EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
+    return _payloadCache->encodeChanges(*tree, encodePool);
+}
+
 
 // EntityServer will use the "special packets" to send list of recently deleted entities
 bool EntityServer::hasSpecialPacketsToSend(const SharedNodePointer& node) {
@@ -213,6 +224,7 @@ int EntityServer::sendSpecialPackets(const SharedNodePointer& node, OctreeQueryN
                     // found/fixed the underlying issue that caused bad UUIDs to be sent to some users.
                     deletesPacket->write(entityID.toRfc4122());
                     ++numberOfIDs;
+                    nodeData->removeSentEntity(entityID);
 
                     #ifdef EXTRA_ERASE_DEBUGGING
                         qDebug() << "EntityTree::encodeEntitiesDeletedSince() including:" << entityID;
@@ -354,6 +366,7 @@ void EntityServer::trackViewerGone(const QUuid& sessionID) {
 QString EntityServer::serverSubclassStats() {
     QLocale locale(QLocale::English);
     QString statsString;
+    const int COLUMN_WIDTH = 24;
 
     // display memory usage stats
     statsString += "<b>Entity Server Memory Statistics</b>\r\n";
@@ -361,12 +374,23 @@ QString EntityServer::serverSubclassStats() {
     statsString += QString().sprintf("       EntityItem size... %ld bytes\r\n", sizeof(EntityItem));
     statsString += "\r\n\r\n";
 
+    // display how much of the encoding of changed entities was shared between the send threads
+    statsString += "<b>Entity Server Shared Encode Statistics</b>\r\n";
+    statsString += QString("              Payloads Cached: %1 entities\r\n")
+        .arg(locale.toString(_payloadCache->getNumPayloads()).rightJustified(COLUMN_WIDTH, ' '));
+    statsString += QString("       Total Payloads Encoded: %1 entities\r\n")
+        .arg(locale.toString(_payloadCache->getNumEncoded()).rightJustified(COLUMN_WIDTH, ' '));
+    statsString += QString("       Copied By Send Threads: %1 entities\r\n")
+        .arg(locale.toString(_payloadCache->getNumReused()).rightJustified(COLUMN_WIDTH, ' '));
+    statsString += QString("      Encoded By Send Threads: %1 entities\r\n")
+        .arg(locale.toString(_payloadCache->getNumMissed()).rightJustified(COLUMN_WIDTH, ' '));
+    statsString += "\r\n\r\n";
+
     statsString += "<b>Entity Server Sending to Viewer Statistics</b>\r\n";
     statsString += "----- Viewer Node ID -----------------    ----- Entity ID ----------------------    "
                    "---------- Last Sent To ----------    ---------- Last Edited -----------\r\n";
 
     int viewers = 0;
-    const int COLUMN_WIDTH = 24;
 
     {
         QReadLocker locker(&_viewerSendingStatsLock);
@@ -56,6 +56,9 @@ public:
     virtual void readAdditionalConfiguration(const QJsonObject& settingsSectionObject) override;
     virtual QString serverSubclassStats() override;
 
+    virtual bool wantsSharedEncode() const override { return true; }
+    virtual int sharedEncode(QThreadPool& encodePool) override;
+
     virtual void trackSend(const QUuid& dataID, quint64 dataLastEdited, const QUuid& sessionID) override;
     virtual void trackViewerGone(const QUuid& sessionID) override;
 
@@ -74,6 +77,7 @@ private slots:
 
 private:
     SimpleEntitySimulationPointer _entitySimulation;
+    EntityPayloadCachePointer _payloadCache { std::make_shared<EntityPayloadCache>() };
     QTimer* _pruneDeletedEntitiesTimer = nullptr;
 
     QReadWriteLock _viewerSendingStatsLock;
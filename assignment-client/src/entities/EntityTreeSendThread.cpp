@@ -80,6 +80,36 @@ void EntityTreeSendThread::preDistributionProcessing() {
     }
 }
 
+bool EntityTreeSendThread::queueChangedElements(OctreeQueryNode* queryNodeData) {
+    auto nodeData = static_cast<EntityNodeData*>(queryNodeData);
+    auto entityTree = std::static_pointer_cast<EntityTree>(_myServer->getOctree());
+
+    // the journal of the tree has the entities changed since the last pass, so the tree doesn't need to be walked for them
+    QVector<EntityTree::EntityEditSequence> changedEntities;
+    auto lastEditSequence = entityTree->getEntitiesChangedSince(nodeData->getLastEditSequenceQueued(), changedEntities);
+
+    entityTree->withReadLock([&]{
+        for (auto& changedEntity : changedEntities) {
+            if (nodeData->hasSentEntity(changedEntity.first, changedEntity.second)) {
+                continue;
+            }
+
+            auto element = entityTree->getContainingElement(changedEntity.first);
+            if (!element) {
+                continue;
+            }
+
+            // the data of an element is encoded along with its siblings by their parent, so it's the parent that is
+            // queued - the entities of the siblings that this node has already been sent are left out of it
+            auto parentElement = entityTree->getParentElement(element);
+            nodeData->elementBag.insert(parentElement ? parentElement : element);
+        }
+    });
+
+    nodeData->setLastEditSequenceQueued(lastEditSequence);
+    return true;
+}
+
 bool EntityTreeSendThread::addAncestorsToExtraFlaggedEntities(const QUuid& filteredEntityID,
                                                               EntityItem& entityItem, EntityNodeData& nodeData) {
     // check if this entity has a parent that is also an entity
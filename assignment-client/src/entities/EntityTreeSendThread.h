@@ -24,6 +24,7 @@ public:
 
 protected:
     virtual void preDistributionProcessing() override;
+    virtual bool queueChangedElements(OctreeQueryNode* nodeData) override;
 
 private:
     // the following two methods return booleans to indicate if any extra flagged entities were new additions to set
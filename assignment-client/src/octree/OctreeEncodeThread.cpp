@@ -0,0 +1,53 @@
+//
+//  OctreeEncodeThread.cpp
+//  assignment-client/src/octree
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeEncodeThread.h"
+
+#include <chrono>
+#include <thread>
+
+#include "OctreeServer.h"
+#include "OctreeServerConsts.h"
+
+static const int ENCODE_POOL_THREAD_COUNT = 4;
+
+OctreeEncodeThread::OctreeEncodeThread(OctreeServer* myServer) :
+    _myServer(myServer)
+{
+    _encodePool.setMaxThreadCount(ENCODE_POOL_THREAD_COUNT);
+}
+
+bool OctreeEncodeThread::process() {
+    quint64 start = usecTimestampNow();
+
+    // don't encode anything until the initial load of the octree is complete...
+    if (_myServer->isInitialLoadComplete()) {
+        int numEncoded = _myServer->sharedEncode(_encodePool);
+        quint64 elapsed = usecTimestampNow() - start;
+
+        if (numEncoded > 0) {
+            OctreeServer::trackSharedEncodeTime((float)elapsed, numEncoded);
+        }
+    }
+
+    if (isStillRunning()) {
+        // sleep until the next frame of the send threads
+        int elapsed = (usecTimestampNow() - start);
+        int usecToSleep = OCTREE_SEND_INTERVAL_USECS - elapsed;
+
+        if (usecToSleep <= 0) {
+            const int MIN_USEC_TO_SLEEP = 1;
+            usecToSleep = MIN_USEC_TO_SLEEP;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(usecToSleep));
+    }
+
+    return isStillRunning();  // keep running till they terminate us
+}
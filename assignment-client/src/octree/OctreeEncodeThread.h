@@ -0,0 +1,37 @@
+//
+//  OctreeEncodeThread.h
+//  assignment-client/src/octree
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeEncodeThread_h
+#define hifi_OctreeEncodeThread_h
+
+#include <QtCore/QThreadPool>
+
+#include <GenericThread.h>
+
+class OctreeServer;
+
+/// Runs the shared encode stage of the server once per send interval, on a fixed pool of threads, so that the data
+/// changed each frame is encoded once for all of the send threads.
+class OctreeEncodeThread : public GenericThread {
+    Q_OBJECT
+public:
+    OctreeEncodeThread(OctreeServer* myServer);
+
+    int getNumEncodeThreads() const { return _encodePool.maxThreadCount(); }
+
+protected:
+    virtual bool process() override;
+
+private:
+    OctreeServer* _myServer { nullptr };
+    QThreadPool _encodePool;
+};
+
+#endif // hifi_OctreeEncodeThread_h
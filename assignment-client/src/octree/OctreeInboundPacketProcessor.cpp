@@ -28,6 +28,9 @@ OctreeInboundPacketProcessor::OctreeInboundPacketProcessor(OctreeServer* myServe
     _totalTransitTime(0),
     _totalProcessTime(0),
     _totalLockWaitTime(0),
+    _totalPersistLockWaitTime(0),
+    _totalPersistLockWaits(0),
+    _maxPersistLockWaitTime(0),
     _totalElementsInPacket(0),
     _totalPackets(0),
     _lastNackTime(usecTimestampNow()),
@@ -39,6 +42,9 @@ void OctreeInboundPacketProcessor::resetStats() {
     _totalTransitTime = 0;
     _totalProcessTime = 0;
     _totalLockWaitTime = 0;
+    _totalPersistLockWaitTime = 0;
+    _totalPersistLockWaits = 0;
+    _maxPersistLockWaitTime = 0;
     _totalElementsInPacket = 0;
     _totalPackets = 0;
     _lastNackTime = usecTimestampNow();
@@ -158,9 +164,11 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
             }
 
             quint64 startProcess, startLock = usecTimestampNow();
+            bool waitedDuringPersist = _myServer->isPersisting();
             int editDataBytesRead;
             _myServer->getOctree()->withWriteLock([&] {
                 startProcess = usecTimestampNow();
+                waitedDuringPersist = waitedDuringPersist || _myServer->isPersisting();
                 editDataBytesRead =
                     _myServer->getOctree()->processEditPacketData(*message, editData, maxSize, sendingNode);
             });
@@ -177,6 +185,16 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
             processTime += thisProcessTime;
             lockWaitTime += thisLockWaitTime;
 
+            // how long edits wait on the tree while it is persisted is tracked on its own, since it's what persisting
+            // from a snapshot is meant to keep short
+            if (waitedDuringPersist) {
+                _totalPersistLockWaitTime += thisLockWaitTime;
+                _totalPersistLockWaits++;
+                if (thisLockWaitTime > _maxPersistLockWaitTime) {
+                    _maxPersistLockWaitTime = thisLockWaitTime;
+                }
+            }
+
             // skip to next edit record in the packet
             message->seek(message->getPosition() + editDataBytesRead);
 
@@ -33,6 +33,10 @@ public:
                 { return _totalElementsInPacket == 0 ? 0 : _totalProcessTime / _totalElementsInPacket; }
     quint64 getAverageLockWaitTimePerElement() const
                 { return _totalElementsInPacket == 0 ? 0 : _totalLockWaitTime / _totalElementsInPacket; }
+    quint64 getAverageLockWaitTimeDuringPersist() const
+                { return _totalPersistLockWaits == 0 ? 0 : _totalPersistLockWaitTime / _totalPersistLockWaits; }
+    quint64 getMaxLockWaitTimeDuringPersist() const { return _maxPersistLockWaitTime; }
+    quint64 getTotalElementsProcessedDuringPersist() const { return _totalPersistLockWaits; }
     
     const SequenceNumberStats& getIncomingEditSequenceNumberStats() const { return _incomingEditSequenceNumberStats; }
     SequenceNumberStats& getIncomingEditSequenceNumberStats() { return _incomingEditSequenceNumberStats; }
@@ -97,6 +101,9 @@ private:
     std::atomic<uint64_t> _totalTransitTime;
     std::atomic<uint64_t> _totalProcessTime;
     std::atomic<uint64_t> _totalLockWaitTime;
+    std::atomic<uint64_t> _totalPersistLockWaitTime;
+    std::atomic<uint64_t> _totalPersistLockWaits;
+    std::atomic<uint64_t> _maxPersistLockWaitTime;
     std::atomic<uint64_t> _totalElementsInPacket;
     std::atomic<uint64_t> _totalPackets;
     
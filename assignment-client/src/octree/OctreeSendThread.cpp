@@ -335,6 +335,7 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
     }
 
     bool somethingToSend = true; // assume we have something
+    bool isSendingChanges = false;
 
     // If our packet already has content in it, then we must use the color choice of the waiting packet.
     // If we're starting a fresh packet, then...
@@ -397,13 +398,17 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
             if (nodeData->elementBag.isEmpty()) {
                 nodeData->elementBag.insert(_myServer->getOctree()->getRoot());
             }
+        } else if (!isFullScene && !viewFrustumChanged && nodeData->getViewSent() && queueChangedElements(nodeData)) {
+            // the view has been sent and hasn't changed, so only the elements with changes were queued - there may be
+            // none, but we still go on to send the special and nacked packets
+            isSendingChanges = true;
         } else {
             nodeData->elementBag.insert(_myServer->getOctree()->getRoot());
         }
     }
 
     // If we have something in our elementBag, then turn them into packets and send them out...
-    if (!nodeData->elementBag.isEmpty()) {
+    if (isSendingChanges || !nodeData->elementBag.isEmpty()) {
         int bytesWritten = 0;
         quint64 start = usecTimestampNow();
 
@@ -54,6 +54,10 @@ protected:
     /// Called before a packetDistributor pass to allow for pre-distribution processing
     virtual void preDistributionProcessing() {};
 
+    /// Called instead of starting a pass from the root when only changes to the scene already sent need sending.
+    /// Returns false if it can't find the elements with changes, so that the pass starts from the root.
+    virtual bool queueChangedElements(OctreeQueryNode* nodeData) { return false; }
+
     OctreeServer* _myServer { nullptr };
     QWeakPointer<Node> _node;
 
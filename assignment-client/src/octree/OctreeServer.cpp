@@ -83,6 +83,9 @@ int OctreeServer::_longProcessWait = 0;
 int OctreeServer::_shortProcessWait = 0;
 int OctreeServer::_noProcessWait = 0;
 
+SimpleMovingAverage OctreeServer::_averageSharedEncodeTime(MOVING_AVERAGE_SAMPLE_COUNTS);
+SimpleMovingAverage OctreeServer::_averageSharedEncodesPerFrame(MOVING_AVERAGE_SAMPLE_COUNTS);
+
 
 void OctreeServer::resetSendingStats() {
     _averageLoopTime.reset();
@@ -128,6 +131,14 @@ void OctreeServer::resetSendingStats() {
     _longProcessWait = 0;
     _shortProcessWait = 0;
     _noProcessWait = 0;
+
+    _averageSharedEncodeTime.reset();
+    _averageSharedEncodesPerFrame.reset();
+}
+
+void OctreeServer::trackSharedEncodeTime(float time, int numEncoded) {
+    _averageSharedEncodeTime.updateAverage(time);
+    _averageSharedEncodesPerFrame.updateAverage((float)numEncoded);
 }
 
 void OctreeServer::trackEncodeTime(float time) {
@@ -268,6 +279,12 @@ OctreeServer::~OctreeServer() {
         _persistThread->deleteLater();
     }
 
+    if (_encodeThread) {
+        _encodeThread->terminating();
+        _encodeThread->terminate();
+        _encodeThread->deleteLater();
+    }
+
     delete _jurisdiction;
     _jurisdiction = NULL;
 
@@ -378,6 +395,12 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
                 statsString += QString("Persist file: %1\r\n").arg(_persistFilePath);
             }
 
+            auto editLog = _persistThread ? _persistThread->getEditLog() : OctreeEditLogPointer();
+            if (editLog) {
+                statsString += QString("Edit log: %1 edits logged, %2 bytes to replay, %3 checkpoints\r\n")
+                    .arg(editLog->getNumAppends()).arg(editLog->getSize()).arg(editLog->getNumCheckpoints());
+            }
+
         } else {
             statsString += "Octree file not yet loaded...\r\n";
         }
@@ -591,6 +614,14 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
         statsString += QString().sprintf("         Average node lock wait time:    %9.2f usecs\r\n",
                                          (double)averageNodeWaitTime);
 
+        if (_encodeThread) {
+            statsString += QString().sprintf("          Average shared encode time:    %9.2f usecs "
+                                             "(once a frame for all clients, on %d threads)\r\n",
+                                             (double)getAverageSharedEncodeTime(), _encodeThread->getNumEncodeThreads());
+            statsString += QString().sprintf("    Average shared encodes per frame:    %9.2f\r\n",
+                                             (double)getAverageSharedEncodesPerFrame());
+        }
+
         statsString += QString().sprintf("--------------------------------------------------------------\r\n");
 
         float encodeToInsidePercent = averageInsideTime == 0.0f ? 0.0f : (averageEncodeTime / averageInsideTime) * AS_PERCENT;
@@ -653,6 +684,9 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
         quint64 averageLockWaitTimePerPacket = _octreeInboundPacketProcessor->getAverageLockWaitTimePerPacket();
         quint64 averageProcessTimePerElement = _octreeInboundPacketProcessor->getAverageProcessTimePerElement();
         quint64 averageLockWaitTimePerElement = _octreeInboundPacketProcessor->getAverageLockWaitTimePerElement();
+        quint64 averageLockWaitTimeDuringPersist = _octreeInboundPacketProcessor->getAverageLockWaitTimeDuringPersist();
+        quint64 maxLockWaitTimeDuringPersist = _octreeInboundPacketProcessor->getMaxLockWaitTimeDuringPersist();
+        quint64 totalElementsProcessedDuringPersist = _octreeInboundPacketProcessor->getTotalElementsProcessedDuringPersist();
         quint64 totalElementsProcessed = _octreeInboundPacketProcessor->getTotalElementsProcessed();
         quint64 totalPacketsProcessed = _octreeInboundPacketProcessor->getTotalPacketsProcessed();
 
@@ -690,6 +724,12 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
             .arg(locale.toString((uint)averageProcessTimePerElement).rightJustified(COLUMN_WIDTH, ' '));
         statsString += QString("  Average Wait Lock Time/Element: %1 usecs\r\n")
             .arg(locale.toString((uint)averageLockWaitTimePerElement).rightJustified(COLUMN_WIDTH, ' '));
+        statsString += QString(" Elements Processed While Persisting: %1 elements\r\n")
+            .arg(locale.toString((uint)totalElementsProcessedDuringPersist).rightJustified(COLUMN_WIDTH, ' '));
+        statsString += QString("Average Wait Lock Time/Element While Persisting: %1 usecs\r\n")
+            .arg(locale.toString((uint)averageLockWaitTimeDuringPersist).rightJustified(COLUMN_WIDTH, ' '));
+        statsString += QString("    Max Wait Lock Time While Persisting: %1 usecs\r\n")
+            .arg(locale.toString((uint)maxLockWaitTimeDuringPersist).rightJustified(COLUMN_WIDTH, ' '));
 
         statsString += QString("             Average Decode Time: %1 usecs\r\n")
             .arg(locale.toString((uint)averageDecodeTime).rightJustified(COLUMN_WIDTH, ' '));
@@ -1112,7 +1152,13 @@ void OctreeServer::readConfiguration() {
 
         qDebug() << "persistFilePath=" << _persistFilePath;
 
-        _persistAsFileType = "json.gz";
+        bool binaryPersist;
+        readOptionBool(QString("binaryPersist"), settingsSectionObject, binaryPersist);
+        _persistAsFileType = binaryPersist ? "bin" : "json.gz";
+        qDebug() << "persistAsFileType=" << _persistAsFileType;
+
+        readOptionBool(QString("persistEditLog"), settingsSectionObject, _wantEditLog);
+        qDebug() << "wantEditLog=" << _wantEditLog;
 
         _persistInterval = OctreePersistThread::DEFAULT_PERSIST_INTERVAL;
         readOptionInt(QString("persistInterval"), settingsSectionObject, _persistInterval);
@@ -1319,7 +1365,8 @@ void OctreeServer::domainSettingsRequestComplete() {
         
         // now set up PersistThread
         _persistThread = new OctreePersistThread(_tree, _persistAbsoluteFilePath, _backupDirectoryPath, _persistInterval,
-                                                 _wantBackup, _settings, _debugTimestampNow, _persistAsFileType);
+                                                 _wantBackup, _settings, _debugTimestampNow, _persistAsFileType,
+                                                 _wantEditLog);
         _persistThread->initialize(true);
     }
     
@@ -1333,6 +1380,12 @@ void OctreeServer::domainSettingsRequestComplete() {
     // set up our OctreeServerPacketProcessor
     _octreeInboundPacketProcessor = new OctreeInboundPacketProcessor(this);
     _octreeInboundPacketProcessor->initialize(true);
+
+    // set up the shared encode stage, if our subclass has one
+    if (wantsSharedEncode()) {
+        _encodeThread = new OctreeEncodeThread(this);
+        _encodeThread->initialize(true);
+    }
     
     // Convert now to tm struct for local timezone
     tm* localtm = localtime(&_started);
@@ -1413,6 +1466,11 @@ void OctreeServer::aboutToFinish() {
     // which waits on the thread to be done before returning
     _sendThreads.clear(); // Cleans up all the send threads.
 
+    // the shared encode stage calls into our subclass, so it is stopped before the subclass is torn down
+    if (_encodeThread) {
+        _encodeThread->terminate();
+    }
+
     if (_persistThread) {
         _persistThread->aboutToFinish();
         _persistThread->terminating();
@@ -1560,6 +1618,7 @@ void OctreeServer::sendStatsPacket() {
     timingArray1["5. avgCompressAndWriteTime"] = getAverageCompressAndWriteTime();
     timingArray1["6. avgSendTime"] = getAveragePacketSendingTime();
     timingArray1["7. nodeWaitTime"] = getAverageNodeWaitTime();
+    timingArray1["8. avgSharedEncodeTime"] = getAverageSharedEncodeTime();
     
     QJsonObject statsObject2;
     statsObject2["data"] = dataObject1;
@@ -1579,6 +1638,8 @@ void OctreeServer::sendStatsPacket() {
         timingArray2["3. avgLockWaitTimePerPacket"] = (double)_octreeInboundPacketProcessor->getAverageLockWaitTimePerPacket();
         timingArray2["4. avgProcessTimePerElement"] = (double)_octreeInboundPacketProcessor->getAverageProcessTimePerElement();
         timingArray2["5. avgLockWaitTimePerElement"] = (double)_octreeInboundPacketProcessor->getAverageLockWaitTimePerElement();
+        timingArray2["6. avgLockWaitTimeDuringPersist"] = (double)_octreeInboundPacketProcessor->getAverageLockWaitTimeDuringPersist();
+        timingArray2["7. maxLockWaitTimeDuringPersist"] = (double)_octreeInboundPacketProcessor->getMaxLockWaitTimeDuringPersist();
     }
     
     QJsonObject statsObject3;
@@ -22,6 +22,7 @@
 
 #include <ThreadedAssignment.h>
 
+#include "OctreeEncodeThread.h"
 #include "OctreePersistThread.h"
 #include "OctreeSendThread.h"
 #include "OctreeServerConsts.h"
@@ -59,6 +60,7 @@ public:
 
     bool isInitialLoadComplete() const { return (_persistThread) ? _persistThread->isInitialLoadComplete() : true; }
     bool isPersistEnabled() const { return (_persistThread) ? true : false; }
+    bool isPersisting() const { return (_persistThread) ? _persistThread->isPersisting() : false; }
     quint64 getLoadElapsedTime() const { return (_persistThread) ? _persistThread->getLoadElapsedTime() : 0; }
     QString getPersistFilename() const { return (_persistThread) ? _persistThread->getPersistFilename() : ""; }
     QString getPersistFileMimeType() const { return (_persistThread) ? _persistThread->getPersistFileMimeType() : "text/plain"; }
@@ -82,6 +84,11 @@ public:
     virtual void trackSend(const QUuid& dataID, quint64 dataLastEdited, const QUuid& viewerNode) { }
     virtual void trackViewerGone(const QUuid& viewerNode) { }
 
+    // a subclass that encodes the data changed each frame once for all of its send threads returns true, and encodes
+    // it on the pool in sharedEncode(), returning how many items it encoded
+    virtual bool wantsSharedEncode() const { return false; }
+    virtual int sharedEncode(QThreadPool& encodePool) { return 0; }
+
     static float SKIP_TIME; // use this for trackXXXTime() calls for non-times
 
     static void trackLoopTime(float time) { _averageLoopTime.updateAverage(time); }
@@ -106,6 +113,10 @@ public:
     static float getAveragePacketSendingTime() { return _averagePacketSendingTime.getAverage(); }
 
     static void trackProcessWaitTime(float time);
+
+    static void trackSharedEncodeTime(float time, int numEncoded);
+    static float getAverageSharedEncodeTime() { return _averageSharedEncodeTime.getAverage(); }
+    static float getAverageSharedEncodesPerFrame() { return _averageSharedEncodesPerFrame.getAverage(); }
     static float getAverageProcessWaitTime() { return _averageProcessWaitTime.getAverage(); }
 
     // these methods allow us to track which threads got to various states
@@ -188,9 +199,11 @@ protected:
     JurisdictionSender* _jurisdictionSender;
     OctreeInboundPacketProcessor* _octreeInboundPacketProcessor;
     OctreePersistThread* _persistThread;
+    OctreeEncodeThread* _encodeThread { nullptr };
 
     int _persistInterval;
     bool _wantBackup;
+    bool _wantEditLog { false };
     bool _persistFileDownload;
     QString _backupExtensionFormat;
     int _backupInterval;
@@ -248,6 +261,9 @@ protected:
     static int _shortProcessWait;
     static int _noProcessWait;
 
+    static SimpleMovingAverage _averageSharedEncodeTime;
+    static SimpleMovingAverage _averageSharedEncodesPerFrame;
+
     static QMap<OctreeSendThread*, quint64> _threadsDidProcess;
     static QMap<OctreeSendThread*, quint64> _threadsDidPacketDistributor;
     static QMap<OctreeSendThread*, quint64> _threadsDidHandlePacketSend;
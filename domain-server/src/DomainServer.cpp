@@ -1002,6 +1002,9 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const Hif
                     // pack the secret that these two nodes will use to communicate with each other
                     domainListStream << connectionSecretForNodes(node, otherNode);
 
+                    // and the hash type they will use to verify the packets they send each other
+                    domainListStream << (quint8)hashTypeForNodes(node, otherNode);
+
                     // we've added the node we wanted so end the segment now
                     domainListPackets->endSegment();
                 }
@@ -1037,6 +1040,17 @@ QUuid DomainServer::connectionSecretForNodes(const SharedNodePointer& nodeA, con
     return QUuid();
 }
 
+NLPacket::HashType DomainServer::hashTypeForNodes(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB) {
+    DomainServerNodeData* nodeAData = static_cast<DomainServerNodeData*>(nodeA->getLinkedData());
+    DomainServerNodeData* nodeBData = static_cast<DomainServerNodeData*>(nodeB->getLinkedData());
+
+    if (nodeAData && nodeBData) {
+        return NLPacket::hashTypeForSupportedTypes(nodeAData->getSupportedHashTypes(), nodeBData->getSupportedHashTypes());
+    }
+
+    return NLPacket::HashType::MD5;
+}
+
 void DomainServer::broadcastNewNode(const SharedNodePointer& addedNode) {
 
     auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
@@ -1064,8 +1078,9 @@ void DomainServer::broadcastNewNode(const SharedNodePointer& addedNode) {
 
             QByteArray rfcConnectionSecret = connectionSecretForNodes(node, addedNode).toRfc4122();
 
-            // replace the bytes at the end of the packet for the connection secret between these nodes
+            // replace the bytes at the end of the packet for the connection secret and hash type between these nodes
             addNodePacket->write(rfcConnectionSecret);
+            addNodePacket->writePrimitive((quint8)hashTypeForNodes(node, addedNode));
 
             // send off this packet to the node
             limitedNodeList->sendUnreliablePacket(*addNodePacket, *node);
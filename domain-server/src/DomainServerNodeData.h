@@ -60,6 +60,9 @@ public:
     void setMachineFingerprint(const QUuid& machineFingerprint) { _machineFingerprint = machineFingerprint; }
     const QUuid& getMachineFingerprint() { return _machineFingerprint; }
 
+    void setSupportedHashTypes(NLPacket::HashTypes supportedHashTypes) { _supportedHashTypes = supportedHashTypes; }
+    NLPacket::HashTypes getSupportedHashTypes() const { return _supportedHashTypes; }
+
     void addOverrideForKey(const QString& key, const QString& value, const QString& overrideValue);
     void removeOverrideForKey(const QString& key, const QString& value);
 
@@ -89,6 +92,7 @@ private:
     QString _nodeVersion;
     QString _hardwareAddress;
     QUuid   _machineFingerprint;
+    NLPacket::HashTypes _supportedHashTypes { 1 << (int)NLPacket::HashType::MD5 };
 
     QString _placeName;
 
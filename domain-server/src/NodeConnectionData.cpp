@@ -35,6 +35,9 @@ NodeConnectionData NodeConnectionData::fromDataStream(QDataStream& dataStream, c
 
         // now the machine fingerprint
         dataStream >> newHeader.machineFingerprint;
+
+        // and the packet hash types the node supports
+        dataStream >> newHeader.supportedHashTypes;
     }
     
     dataStream >> newHeader.nodeType
@@ -30,6 +30,7 @@ public:
     QString placeName;
     QString hardwareAddress;
     QUuid machineFingerprint;
+    NLPacket::HashTypes supportedHashTypes { 1 << (int)NLPacket::HashType::MD5 };
 
     QByteArray protocolVersion;
 };
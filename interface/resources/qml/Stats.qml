@@ -211,6 +211,16 @@ Item {
                         text: "Downloads: " + root.downloads + "/" + root.downloadLimit +
                               ", Pending: " + root.downloadsPending;
                     }
+                    StatText {
+                        visible: root.expanded;
+                        text: "Downloads by Backend: " + root.downloadsByBackend;
+                    }
+                    StatText {
+                        visible: root.expanded;
+                        text: "Loaded Since Arrival: " +
+                              (root.downloadsUsefulMs < 0 ? "loading" : root.downloadsUsefulMs + " ms") + " in view, " +
+                              (root.downloadsAllMs < 0 ? "loading" : root.downloadsAllMs + " ms") + " all";
+                    }
                     StatText {
                         visible: root.expanded;
                         text: "Processing: " + root.processing +
@@ -830,6 +830,11 @@ Application::Application(int& argc, char** argv, QElapsedTimer& startupTimer, bo
     connect(myAvatar.get(), &MyAvatar::positionGoneTo,
         DependencyManager::get<AddressManager>().data(), &AddressManager::storeCurrentAddress);
 
+    // Time how long what is in view takes to load after a teleport.
+    connect(myAvatar.get(), &MyAvatar::positionGoneTo, this, []() {
+        ResourceCache::restartLoadTimes();
+    });
+
     auto scriptEngines = DependencyManager::get<ScriptEngines>().data();
     scriptEngines->registerScriptInitializer([this](ScriptEngine* engine){
         registerScriptEngineWithApplicationServices(engine);
@@ -1320,6 +1325,8 @@ Application::Application(int& argc, char** argv, QElapsedTimer& startupTimer, bo
         auto loadingRequests = ResourceCache::getLoadingRequests();
         properties["active_downloads"] = loadingRequests.size();
         properties["pending_downloads"] = ResourceCache::getPendingRequestCount();
+        properties["useful_downloads_ms"] = DependencyManager::get<ResourceCacheSharedItems>()->getUsefulLoadMsecs();
+        properties["all_downloads_ms"] = DependencyManager::get<ResourceCacheSharedItems>()->getAllLoadMsecs();
 
         properties["throttled"] = _displayPlugin ? _displayPlugin->isThrottled() : false;
 
@@ -5212,6 +5219,7 @@ void Application::domainChanged(const QString& domainHostname) {
     updateWindowTitle();
     // disable physics until we have enough information about our new location to not cause craziness.
     resetPhysicsReadyInformation();
+    ResourceCache::restartLoadTimes();
 }
 
 
@@ -251,6 +251,16 @@ void Stats::updateStats(bool force) {
         STAT_UPDATE(downloads, loadingRequests.size());
         STAT_UPDATE(downloadLimit, ResourceCache::getRequestLimit())
         STAT_UPDATE(downloadsPending, ResourceCache::getPendingRequestCount());
+        STAT_UPDATE(downloadsByBackend, QString("HTTP %1/%2, ATP %3/%4, File %5/%6")
+            .arg(ResourceCache::getRequestsActive(ResourceRequestBackend::HTTP))
+            .arg(ResourceCache::getRequestLimit(ResourceRequestBackend::HTTP))
+            .arg(ResourceCache::getRequestsActive(ResourceRequestBackend::ATP))
+            .arg(ResourceCache::getRequestLimit(ResourceRequestBackend::ATP))
+            .arg(ResourceCache::getRequestsActive(ResourceRequestBackend::File))
+            .arg(ResourceCache::getRequestLimit(ResourceRequestBackend::File)));
+        auto resourceCacheSharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+        STAT_UPDATE(downloadsUsefulMs, resourceCacheSharedItems->getUsefulLoadMsecs());
+        STAT_UPDATE(downloadsAllMs, resourceCacheSharedItems->getAllLoadMsecs());
         STAT_UPDATE(processing, DependencyManager::get<StatTracker>()->getStat("Processing").toInt());
         STAT_UPDATE(processingPending, DependencyManager::get<StatTracker>()->getStat("PendingProcessing").toInt());
         
@@ -88,6 +88,9 @@ class Stats : public QQuickItem {
     STATS_PROPERTY(int, downloads, 0)
     STATS_PROPERTY(int, downloadLimit, 0)
     STATS_PROPERTY(int, downloadsPending, 0)
+    STATS_PROPERTY(QString, downloadsByBackend, QString())
+    STATS_PROPERTY(int, downloadsUsefulMs, -1)
+    STATS_PROPERTY(int, downloadsAllMs, -1)
     Q_PROPERTY(QStringList downloadUrls READ downloadUrls NOTIFY downloadUrlsChanged)
     STATS_PROPERTY(int, processing, 0)
     STATS_PROPERTY(int, processingPending, 0)
@@ -215,6 +218,9 @@ signals:
     void downloadsChanged();
     void downloadLimitChanged();
     void downloadsPendingChanged();
+    void downloadsByBackendChanged();
+    void downloadsUsefulMsChanged();
+    void downloadsAllMsChanged();
     void downloadUrlsChanged();
     void processingChanged();
     void processingPendingChanged();
@@ -170,6 +170,293 @@ static const float lowpassTable[NLOWPASS][5] = {    // { b0, b1, b2, a1, a2 }
 
 static const float TWOPI = 6.283185307f;
 
+//
+// portable reference code, also the scalar baseline of the SIMD code on x86
+//
+
+// 1 channel input, 4 channel output
+static void FIR_1x4_ref(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames) {
+
+    float* coef0 = coef[0] + HRTF_TAPS - 1;     // process backwards
+    float* coef1 = coef[1] + HRTF_TAPS - 1;
+    float* coef2 = coef[2] + HRTF_TAPS - 1;
+    float* coef3 = coef[3] + HRTF_TAPS - 1;
+
+    assert(numFrames % 4 == 0);
+
+    for (int i = 0; i < numFrames; i += 4) {
+
+        dst0[i+0] = 0.0f;
+        dst0[i+1] = 0.0f;
+        dst0[i+2] = 0.0f;
+        dst0[i+3] = 0.0f;
+
+        dst1[i+0] = 0.0f;
+        dst1[i+1] = 0.0f;
+        dst1[i+2] = 0.0f;
+        dst1[i+3] = 0.0f;
+
+        dst2[i+0] = 0.0f;
+        dst2[i+1] = 0.0f;
+        dst2[i+2] = 0.0f;
+        dst2[i+3] = 0.0f;
+
+        dst3[i+0] = 0.0f;
+        dst3[i+1] = 0.0f;
+        dst3[i+2] = 0.0f;
+        dst3[i+3] = 0.0f;
+
+        float* ps = &src[i - HRTF_TAPS + 1];    // process forwards
+
+        assert(HRTF_TAPS % 4 == 0);
+
+        for (int k = 0; k < HRTF_TAPS; k += 4) {
+
+            // channel 0
+            dst0[i+0] += coef0[-k-0] * ps[k+0] + coef0[-k-1] * ps[k+1] + coef0[-k-2] * ps[k+2] + coef0[-k-3] * ps[k+3];
+            dst0[i+1] += coef0[-k-0] * ps[k+1] + coef0[-k-1] * ps[k+2] + coef0[-k-2] * ps[k+3] + coef0[-k-3] * ps[k+4];
+            dst0[i+2] += coef0[-k-0] * ps[k+2] + coef0[-k-1] * ps[k+3] + coef0[-k-2] * ps[k+4] + coef0[-k-3] * ps[k+5];
+            dst0[i+3] += coef0[-k-0] * ps[k+3] + coef0[-k-1] * ps[k+4] + coef0[-k-2] * ps[k+5] + coef0[-k-3] * ps[k+6];
+
+            // channel 1
+            dst1[i+0] += coef1[-k-0] * ps[k+0] + coef1[-k-1] * ps[k+1] + coef1[-k-2] * ps[k+2] + coef1[-k-3] * ps[k+3];
+            dst1[i+1] += coef1[-k-0] * ps[k+1] + coef1[-k-1] * ps[k+2] + coef1[-k-2] * ps[k+3] + coef1[-k-3] * ps[k+4];
+            dst1[i+2] += coef1[-k-0] * ps[k+2] + coef1[-k-1] * ps[k+3] + coef1[-k-2] * ps[k+4] + coef1[-k-3] * ps[k+5];
+            dst1[i+3] += coef1[-k-0] * ps[k+3] + coef1[-k-1] * ps[k+4] + coef1[-k-2] * ps[k+5] + coef1[-k-3] * ps[k+6];
+
+            // channel 2
+            dst2[i+0] += coef2[-k-0] * ps[k+0] + coef2[-k-1] * ps[k+1] + coef2[-k-2] * ps[k+2] + coef2[-k-3] * ps[k+3];
+            dst2[i+1] += coef2[-k-0] * ps[k+1] + coef2[-k-1] * ps[k+2] + coef2[-k-2] * ps[k+3] + coef2[-k-3] * ps[k+4];
+            dst2[i+2] += coef2[-k-0] * ps[k+2] + coef2[-k-1] * ps[k+3] + coef2[-k-2] * ps[k+4] + coef2[-k-3] * ps[k+5];
+            dst2[i+3] += coef2[-k-0] * ps[k+3] + coef2[-k-1] * ps[k+4] + coef2[-k-2] * ps[k+5] + coef2[-k-3] * ps[k+6];
+
+            // channel 3
+            dst3[i+0] += coef3[-k-0] * ps[k+0] + coef3[-k-1] * ps[k+1] + coef3[-k-2] * ps[k+2] + coef3[-k-3] * ps[k+3];
+            dst3[i+1] += coef3[-k-0] * ps[k+1] + coef3[-k-1] * ps[k+2] + coef3[-k-2] * ps[k+3] + coef3[-k-3] * ps[k+4];
+            dst3[i+2] += coef3[-k-0] * ps[k+2] + coef3[-k-1] * ps[k+3] + coef3[-k-2] * ps[k+4] + coef3[-k-3] * ps[k+5];
+            dst3[i+3] += coef3[-k-0] * ps[k+3] + coef3[-k-1] * ps[k+4] + coef3[-k-2] * ps[k+5] + coef3[-k-3] * ps[k+6];
+        }
+    }
+}
+
+// 4 channel planar to interleaved
+static void interleave_4x4_ref(float* src0, float* src1, float* src2, float* src3, float* dst, int numFrames) {
+
+    for (int i = 0; i < numFrames; i++) {
+
+        dst[4*i+0] = src0[i];
+        dst[4*i+1] = src1[i];
+        dst[4*i+2] = src2[i];
+        dst[4*i+3] = src3[i];
+    }
+}
+
+// process 2 cascaded biquads on 4 channels (interleaved)
+// biquads are computed in parallel, by adding one sample of delay
+static void biquad2_4x4_ref(float* src, float* dst, float coef[5][8], float state[3][8], int numFrames) {
+
+    // restore state
+    float y00 = state[0][0];
+    float w10 = state[1][0];
+    float w20 = state[2][0];
+
+    float y01 = state[0][1];
+    float w11 = state[1][1];
+    float w21 = state[2][1];
+
+    float y02 = state[0][2];
+    float w12 = state[1][2];
+    float w22 = state[2][2];
+
+    float y03 = state[0][3];
+    float w13 = state[1][3];
+    float w23 = state[2][3];
+
+    float y04;
+    float w14 = state[1][4];
+    float w24 = state[2][4];
+
+    float y05;
+    float w15 = state[1][5];
+    float w25 = state[2][5];
+
+    float y06;
+    float w16 = state[1][6];
+    float w26 = state[2][6];
+
+    float y07;
+    float w17 = state[1][7];
+    float w27 = state[2][7];
+
+    // first biquad coefs
+    float b00 = coef[0][0];
+    float b10 = coef[1][0];
+    float b20 = coef[2][0];
+    float a10 = coef[3][0];
+    float a20 = coef[4][0];
+
+    float b01 = coef[0][1];
+    float b11 = coef[1][1];
+    float b21 = coef[2][1];
+    float a11 = coef[3][1];
+    float a21 = coef[4][1];
+
+    float b02 = coef[0][2];
+    float b12 = coef[1][2];
+    float b22 = coef[2][2];
+    float a12 = coef[3][2];
+    float a22 = coef[4][2];
+
+    float b03 = coef[0][3];
+    float b13 = coef[1][3];
+    float b23 = coef[2][3];
+    float a13 = coef[3][3];
+    float a23 = coef[4][3];
+
+    // second biquad coefs
+    float b04 = coef[0][4];
+    float b14 = coef[1][4];
+    float b24 = coef[2][4];
+    float a14 = coef[3][4];
+    float a24 = coef[4][4];
+
+    float b05 = coef[0][5];
+    float b15 = coef[1][5];
+    float b25 = coef[2][5];
+    float a15 = coef[3][5];
+    float a25 = coef[4][5];
+
+    float b06 = coef[0][6];
+    float b16 = coef[1][6];
+    float b26 = coef[2][6];
+    float a16 = coef[3][6];
+    float a26 = coef[4][6];
+
+    float b07 = coef[0][7];
+    float b17 = coef[1][7];
+    float b27 = coef[2][7];
+    float a17 = coef[3][7];
+    float a27 = coef[4][7];
+
+    for (int i = 0; i < numFrames; i++) {
+
+        // first biquad input
+        float x00 = src[4*i+0] + 1.0e-20f;    // prevent denormals
+        float x01 = src[4*i+1] + 1.0e-20f;
+        float x02 = src[4*i+2] + 1.0e-20f;
+        float x03 = src[4*i+3] + 1.0e-20f;
+        // second biquad input is previous output
+        float x04 = y00;
+        float x05 = y01;
+        float x06 = y02;
+        float x07 = y03;
+
+        // transposed Direct Form II
+        y00 = b00 * x00 + w10;
+        w10 = b10 * x00 - a10 * y00 + w20;
+        w20 = b20 * x00 - a20 * y00;
+
+        y01 = b01 * x01 + w11;
+        w11 = b11 * x01 - a11 * y01 + w21;
+        w21 = b21 * x01 - a21 * y01;
+
+        y02 = b02 * x02 + w12;
+        w12 = b12 * x02 - a12 * y02 + w22;
+        w22 = b22 * x02 - a22 * y02;
+
+        y03 = b03 * x03 + w13;
+        w13 = b13 * x03 - a13 * y03 + w23;
+        w23 = b23 * x03 - a23 * y03;
+
+        // transposed Direct Form II
+        y04 = b04 * x04 + w14;
+        w14 = b14 * x04 - a14 * y04 + w24;
+        w24 = b24 * x04 - a24 * y04;
+
+        y05 = b05 * x05 + w15;
+        w15 = b15 * x05 - a15 * y05 + w25;
+        w25 = b25 * x05 - a25 * y05;
+
+        y06 = b06 * x06 + w16;
+        w16 = b16 * x06 - a16 * y06 + w26;
+        w26 = b26 * x06 - a26 * y06;
+
+        y07 = b07 * x07 + w17;
+        w17 = b17 * x07 - a17 * y07 + w27;
+        w27 = b27 * x07 - a27 * y07;
+
+        dst[4*i+0] = y04;   // second biquad output
+        dst[4*i+1] = y05;
+        dst[4*i+2] = y06;
+        dst[4*i+3] = y07;
+    }
+
+    // save state
+    state[0][0] = y00;
+    state[1][0] = w10;
+    state[2][0] = w20;
+
+    state[0][1] = y01;
+    state[1][1] = w11;
+    state[2][1] = w21;
+
+    state[0][2] = y02;
+    state[1][2] = w12;
+    state[2][2] = w22;
+
+    state[0][3] = y03;
+    state[1][3] = w13;
+    state[2][3] = w23;
+
+    state[1][4] = w14;
+    state[2][4] = w24;
+
+    state[1][5] = w15;
+    state[2][5] = w25;
+
+    state[1][6] = w16;
+    state[2][6] = w26;
+
+    state[1][7] = w17;
+    state[2][7] = w27;
+}
+
+// crossfade 4 inputs into 2 outputs with accumulation (interleaved)
+static void crossfade_4x2_ref(float* src, float* dst, const float* win, int numFrames) {
+
+    for (int i = 0; i < numFrames; i++) {
+
+        float frac = win[i];
+
+        dst[2*i+0] += src[4*i+2] + frac * (src[4*i+0] - src[4*i+2]);
+        dst[2*i+1] += src[4*i+3] + frac * (src[4*i+1] - src[4*i+3]);
+    }
+}
+
+// linear interpolation with gain
+static void interpolate_ref(float* dst, const float* src0, const float* src1, float frac, float gain) {
+
+    float f0 = HRTF_GAIN * gain * (1.0f - frac);
+    float f1 = HRTF_GAIN * gain * frac;
+
+    for (int k = 0; k < HRTF_TAPS; k++) {
+        dst[k] = f0 * src0[k] + f1 * src1[k];
+    }
+}
+
+// process 2 cascaded biquads on 4 channels (interleaved), for 2 sources
+// the outputs of both sources are summed and accumulated into dst
+static void biquad2_4x4x2_ref(float* src0, float* src1, float* dst, float coef0[5][8], float coef1[5][8],
+                              float state0[3][8], float state1[3][8], int numFrames) {
+
+    biquad2_4x4_ref(src0, src0, coef0, state0, numFrames);
+    biquad2_4x4_ref(src1, src1, coef1, state1, numFrames);
+
+    for (int i = 0; i < 4 * numFrames; i++) {
+        dst[i] += src0[i] + src1[i];
+    }
+}
+
 //
 // on x86 architecture, assume that SSE2 is present
 //
@@ -232,22 +519,8 @@ static void FIR_1x4_SSE(float* src, float* dst0, float* dst1, float* dst2, float
     }
 }
 
-//
-// Runtime CPU dispatch
-//
-
-#include "CPUDetect.h"
-
-void FIR_1x4_AVX2(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames);
-
-static void FIR_1x4(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames) {
-
-    static auto f = cpuSupportsAVX2() ? FIR_1x4_AVX2 : FIR_1x4_SSE;
-    (*f)(src, dst0, dst1, dst2, dst3, coef, numFrames); // dispatch
-}
-
 // 4 channel planar to interleaved
-static void interleave_4x4(float* src0, float* src1, float* src2, float* src3, float* dst, int numFrames) {
+static void interleave_4x4_SSE(float* src0, float* src1, float* src2, float* src3, float* dst, int numFrames) {
 
     assert(numFrames % 4 == 0);
 
@@ -278,7 +551,7 @@ static void interleave_4x4(float* src0, float* src1, float* src2, float* src3, f
 
 // process 2 cascaded biquads on 4 channels (interleaved)
 // biquads computed in parallel, by adding one sample of delay
-static void biquad2_4x4(float* src, float* dst, float coef[5][8], float state[3][8], int numFrames) {
+static void biquad2_4x4_SSE(float* src, float* dst, float coef[5][8], float state[3][8], int numFrames) {
 
     // enable flush-to-zero mode to prevent denormals
     unsigned int ftz = _MM_GET_FLUSH_ZERO_MODE();
@@ -343,7 +616,7 @@ static void biquad2_4x4(float* src, float* dst, float coef[5][8], float state[3]
 }
 
 // crossfade 4 inputs into 2 outputs with accumulation (interleaved)
-static void crossfade_4x2(float* src, float* dst, const float* win, int numFrames) {
+static void crossfade_4x2_SSE(float* src, float* dst, const float* win, int numFrames) {
 
     assert(numFrames % 4 == 0);
 
@@ -390,7 +663,7 @@ static void crossfade_4x2(float* src, float* dst, const float* win, int numFrame
 }
 
 // linear interpolation with gain
-static void interpolate(float* dst, const float* src0, const float* src1, float frac, float gain) {
+static void interpolate_SSE(float* dst, const float* src0, const float* src1, float frac, float gain) {
 
     __m128 f0 = _mm_set1_ps(gain * (1.0f - frac));
     __m128 f1 = _mm_set1_ps(gain * frac);
@@ -402,285 +675,240 @@ static void interpolate(float* dst, const float* src0, const float* src1, float
         __m128 x0 = _mm_loadu_ps(&src0[k]);
         __m128 x1 = _mm_loadu_ps(&src1[k]);
 
-        x0 = _mm_add_ps(_mm_mul_ps(f0, x0), _mm_mul_ps(f1, x1));
-
-        _mm_storeu_ps(&dst[k], x0);
-    }
-}
-
-#else   // portable reference code
-
-// 1 channel input, 4 channel output
-static void FIR_1x4(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames) {
-
-    float* coef0 = coef[0] + HRTF_TAPS - 1;     // process backwards
-    float* coef1 = coef[1] + HRTF_TAPS - 1;
-    float* coef2 = coef[2] + HRTF_TAPS - 1;
-    float* coef3 = coef[3] + HRTF_TAPS - 1;
-
-    assert(numFrames % 4 == 0);
-
-    for (int i = 0; i < numFrames; i += 4) {
-
-        dst0[i+0] = 0.0f;
-        dst0[i+1] = 0.0f;
-        dst0[i+2] = 0.0f;
-        dst0[i+3] = 0.0f;
-
-        dst1[i+0] = 0.0f;
-        dst1[i+1] = 0.0f;
-        dst1[i+2] = 0.0f;
-        dst1[i+3] = 0.0f;
-
-        dst2[i+0] = 0.0f;
-        dst2[i+1] = 0.0f;
-        dst2[i+2] = 0.0f;
-        dst2[i+3] = 0.0f;
-
-        dst3[i+0] = 0.0f;
-        dst3[i+1] = 0.0f;
-        dst3[i+2] = 0.0f;
-        dst3[i+3] = 0.0f;
-
-        float* ps = &src[i - HRTF_TAPS + 1];    // process forwards
-
-        assert(HRTF_TAPS % 4 == 0);
-
-        for (int k = 0; k < HRTF_TAPS; k += 4) {
-
-            // channel 0
-            dst0[i+0] += coef0[-k-0] * ps[k+0] + coef0[-k-1] * ps[k+1] + coef0[-k-2] * ps[k+2] + coef0[-k-3] * ps[k+3];
-            dst0[i+1] += coef0[-k-0] * ps[k+1] + coef0[-k-1] * ps[k+2] + coef0[-k-2] * ps[k+3] + coef0[-k-3] * ps[k+4];
-            dst0[i+2] += coef0[-k-0] * ps[k+2] + coef0[-k-1] * ps[k+3] + coef0[-k-2] * ps[k+4] + coef0[-k-3] * ps[k+5];
-            dst0[i+3] += coef0[-k-0] * ps[k+3] + coef0[-k-1] * ps[k+4] + coef0[-k-2] * ps[k+5] + coef0[-k-3] * ps[k+6];
-
-            // channel 1
-            dst1[i+0] += coef1[-k-0] * ps[k+0] + coef1[-k-1] * ps[k+1] + coef1[-k-2] * ps[k+2] + coef1[-k-3] * ps[k+3];
-            dst1[i+1] += coef1[-k-0] * ps[k+1] + coef1[-k-1] * ps[k+2] + coef1[-k-2] * ps[k+3] + coef1[-k-3] * ps[k+4];
-            dst1[i+2] += coef1[-k-0] * ps[k+2] + coef1[-k-1] * ps[k+3] + coef1[-k-2] * ps[k+4] + coef1[-k-3] * ps[k+5];
-            dst1[i+3] += coef1[-k-0] * ps[k+3] + coef1[-k-1] * ps[k+4] + coef1[-k-2] * ps[k+5] + coef1[-k-3] * ps[k+6];
-
-            // channel 2
-            dst2[i+0] += coef2[-k-0] * ps[k+0] + coef2[-k-1] * ps[k+1] + coef2[-k-2] * ps[k+2] + coef2[-k-3] * ps[k+3];
-            dst2[i+1] += coef2[-k-0] * ps[k+1] + coef2[-k-1] * ps[k+2] + coef2[-k-2] * ps[k+3] + coef2[-k-3] * ps[k+4];
-            dst2[i+2] += coef2[-k-0] * ps[k+2] + coef2[-k-1] * ps[k+3] + coef2[-k-2] * ps[k+4] + coef2[-k-3] * ps[k+5];
-            dst2[i+3] += coef2[-k-0] * ps[k+3] + coef2[-k-1] * ps[k+4] + coef2[-k-2] * ps[k+5] + coef2[-k-3] * ps[k+6];
-
-            // channel 3
-            dst3[i+0] += coef3[-k-0] * ps[k+0] + coef3[-k-1] * ps[k+1] + coef3[-k-2] * ps[k+2] + coef3[-k-3] * ps[k+3];
-            dst3[i+1] += coef3[-k-0] * ps[k+1] + coef3[-k-1] * ps[k+2] + coef3[-k-2] * ps[k+3] + coef3[-k-3] * ps[k+4];
-            dst3[i+2] += coef3[-k-0] * ps[k+2] + coef3[-k-1] * ps[k+3] + coef3[-k-2] * ps[k+4] + coef3[-k-3] * ps[k+5];
-            dst3[i+3] += coef3[-k-0] * ps[k+3] + coef3[-k-1] * ps[k+4] + coef3[-k-2] * ps[k+5] + coef3[-k-3] * ps[k+6];
-        }
-    }
-}
-
-// 4 channel planar to interleaved
-static void interleave_4x4(float* src0, float* src1, float* src2, float* src3, float* dst, int numFrames) {
-
-    for (int i = 0; i < numFrames; i++) {
+        x0 = _mm_add_ps(_mm_mul_ps(f0, x0), _mm_mul_ps(f1, x1));
 
-        dst[4*i+0] = src0[i];
-        dst[4*i+1] = src1[i];
-        dst[4*i+2] = src2[i];
-        dst[4*i+3] = src3[i];
+        _mm_storeu_ps(&dst[k], x0);
     }
 }
 
-// process 2 cascaded biquads on 4 channels (interleaved)
-// biquads are computed in parallel, by adding one sample of delay
-static void biquad2_4x4(float* src, float* dst, float coef[5][8], float state[3][8], int numFrames) {
+// process 2 cascaded biquads on 4 channels (interleaved), for 2 sources
+// the outputs of both sources are summed and accumulated into dst
+// both sources are filtered in the same pass, so that their independent recurrences overlap
+static void biquad2_4x4x2_SSE(float* src0, float* src1, float* dst, float coef0[5][8], float coef1[5][8],
+                              float state0[3][8], float state1[3][8], int numFrames) {
+
+    // enable flush-to-zero mode to prevent denormals
+    unsigned int ftz = _MM_GET_FLUSH_ZERO_MODE();
+    _MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
 
     // restore state
-    float y00 = state[0][0];
-    float w10 = state[1][0];
-    float w20 = state[2][0];
+    __m128 y00 = _mm_loadu_ps(&state0[0][0]);
+    __m128 w10 = _mm_loadu_ps(&state0[1][0]);
+    __m128 w20 = _mm_loadu_ps(&state0[2][0]);
 
-    float y01 = state[0][1];
-    float w11 = state[1][1];
-    float w21 = state[2][1];
+    __m128 y01;
+    __m128 w11 = _mm_loadu_ps(&state0[1][4]);
+    __m128 w21 = _mm_loadu_ps(&state0[2][4]);
 
-    float y02 = state[0][2];
-    float w12 = state[1][2];
-    float w22 = state[2][2];
+    __m128 y10 = _mm_loadu_ps(&state1[0][0]);
+    __m128 v10 = _mm_loadu_ps(&state1[1][0]);
+    __m128 v20 = _mm_loadu_ps(&state1[2][0]);
 
-    float y03 = state[0][3];
-    float w13 = state[1][3];
-    float w23 = state[2][3];
+    __m128 y11;
+    __m128 v11 = _mm_loadu_ps(&state1[1][4]);
+    __m128 v21 = _mm_loadu_ps(&state1[2][4]);
 
-    float y04;
-    float w14 = state[1][4];
-    float w24 = state[2][4];
+    // first biquad coefs
+    __m128 b00 = _mm_loadu_ps(&coef0[0][0]);
+    __m128 b10 = _mm_loadu_ps(&coef0[1][0]);
+    __m128 b20 = _mm_loadu_ps(&coef0[2][0]);
+    __m128 a10 = _mm_loadu_ps(&coef0[3][0]);
+    __m128 a20 = _mm_loadu_ps(&coef0[4][0]);
+
+    __m128 c00 = _mm_loadu_ps(&coef1[0][0]);
+    __m128 c10 = _mm_loadu_ps(&coef1[1][0]);
+    __m128 c20 = _mm_loadu_ps(&coef1[2][0]);
+    __m128 d10 = _mm_loadu_ps(&coef1[3][0]);
+    __m128 d20 = _mm_loadu_ps(&coef1[4][0]);
 
-    float y05;
-    float w15 = state[1][5];
-    float w25 = state[2][5];
+    // second biquad coefs
+    __m128 b01 = _mm_loadu_ps(&coef0[0][4]);
+    __m128 b11 = _mm_loadu_ps(&coef0[1][4]);
+    __m128 b21 = _mm_loadu_ps(&coef0[2][4]);
+    __m128 a11 = _mm_loadu_ps(&coef0[3][4]);
+    __m128 a21 = _mm_loadu_ps(&coef0[4][4]);
+
+    __m128 c01 = _mm_loadu_ps(&coef1[0][4]);
+    __m128 c11 = _mm_loadu_ps(&coef1[1][4]);
+    __m128 c21 = _mm_loadu_ps(&coef1[2][4]);
+    __m128 d11 = _mm_loadu_ps(&coef1[3][4]);
+    __m128 d21 = _mm_loadu_ps(&coef1[4][4]);
 
-    float y06;
-    float w16 = state[1][6];
-    float w26 = state[2][6];
+    for (int i = 0; i < numFrames; i++) {
 
-    float y07;
-    float w17 = state[1][7];
-    float w27 = state[2][7];
+        __m128 x00 = _mm_loadu_ps(&src0[4*i]);
+        __m128 x01 = y00;   // first biquad output
 
-    // first biquad coefs
-    float b00 = coef[0][0];
-    float b10 = coef[1][0];
-    float b20 = coef[2][0];
-    float a10 = coef[3][0];
-    float a20 = coef[4][0];
+        __m128 x10 = _mm_loadu_ps(&src1[4*i]);
+        __m128 x11 = y10;
 
-    float b01 = coef[0][1];
-    float b11 = coef[1][1];
-    float b21 = coef[2][1];
-    float a11 = coef[3][1];
-    float a21 = coef[4][1];
+        // transposed Direct Form II
+        y00 = _mm_add_ps(w10, _mm_mul_ps(x00, b00));
+        y01 = _mm_add_ps(w11, _mm_mul_ps(x01, b01));
+        y10 = _mm_add_ps(v10, _mm_mul_ps(x10, c00));
+        y11 = _mm_add_ps(v11, _mm_mul_ps(x11, c01));
 
-    float b02 = coef[0][2];
-    float b12 = coef[1][2];
-    float b22 = coef[2][2];
-    float a12 = coef[3][2];
-    float a22 = coef[4][2];
+        w10 = _mm_add_ps(w20, _mm_mul_ps(x00, b10));
+        w11 = _mm_add_ps(w21, _mm_mul_ps(x01, b11));
+        v10 = _mm_add_ps(v20, _mm_mul_ps(x10, c10));
+        v11 = _mm_add_ps(v21, _mm_mul_ps(x11, c11));
 
-    float b03 = coef[0][3];
-    float b13 = coef[1][3];
-    float b23 = coef[2][3];
-    float a13 = coef[3][3];
-    float a23 = coef[4][3];
+        w20 = _mm_mul_ps(x00, b20);
+        w21 = _mm_mul_ps(x01, b21);
+        v20 = _mm_mul_ps(x10, c20);
+        v21 = _mm_mul_ps(x11, c21);
 
-    // second biquad coefs
-    float b04 = coef[0][4];
-    float b14 = coef[1][4];
-    float b24 = coef[2][4];
-    float a14 = coef[3][4];
-    float a24 = coef[4][4];
+        w10 = _mm_sub_ps(w10, _mm_mul_ps(y00, a10));
+        w11 = _mm_sub_ps(w11, _mm_mul_ps(y01, a11));
+        v10 = _mm_sub_ps(v10, _mm_mul_ps(y10, d10));
+        v11 = _mm_sub_ps(v11, _mm_mul_ps(y11, d11));
 
-    float b05 = coef[0][5];
-    float b15 = coef[1][5];
-    float b25 = coef[2][5];
-    float a15 = coef[3][5];
-    float a25 = coef[4][5];
+        w20 = _mm_sub_ps(w20, _mm_mul_ps(y00, a20));
+        w21 = _mm_sub_ps(w21, _mm_mul_ps(y01, a21));
+        v20 = _mm_sub_ps(v20, _mm_mul_ps(y10, d20));
+        v21 = _mm_sub_ps(v21, _mm_mul_ps(y11, d21));
 
-    float b06 = coef[0][6];
-    float b16 = coef[1][6];
-    float b26 = coef[2][6];
-    float a16 = coef[3][6];
-    float a26 = coef[4][6];
+        // sum the second biquad output of both sources, and accumulate
+        __m128 y = _mm_add_ps(y01, y11);
+        _mm_storeu_ps(&dst[4*i], _mm_add_ps(_mm_loadu_ps(&dst[4*i]), y));
+    }
 
-    float b07 = coef[0][7];
-    float b17 = coef[1][7];
-    float b27 = coef[2][7];
-    float a17 = coef[3][7];
-    float a27 = coef[4][7];
+    // save state
+    _mm_storeu_ps(&state0[0][0], y00);
+    _mm_storeu_ps(&state0[1][0], w10);
+    _mm_storeu_ps(&state0[2][0], w20);
 
-    for (int i = 0; i < numFrames; i++) {
+    _mm_storeu_ps(&state0[1][4], w11);
+    _mm_storeu_ps(&state0[2][4], w21);
 
-        // first biquad input
-        float x00 = src[4*i+0] + 1.0e-20f;    // prevent denormals
-        float x01 = src[4*i+1] + 1.0e-20f;
-        float x02 = src[4*i+2] + 1.0e-20f;
-        float x03 = src[4*i+3] + 1.0e-20f;
-        // second biquad input is previous output
-        float x04 = y00;
-        float x05 = y01;
-        float x06 = y02;
-        float x07 = y03;
+    _mm_storeu_ps(&state1[0][0], y10);
+    _mm_storeu_ps(&state1[1][0], v10);
+    _mm_storeu_ps(&state1[2][0], v20);
 
-        // transposed Direct Form II
-        y00 = b00 * x00 + w10;
-        w10 = b10 * x00 - a10 * y00 + w20;
-        w20 = b20 * x00 - a20 * y00;
+    _mm_storeu_ps(&state1[1][4], v11);
+    _mm_storeu_ps(&state1[2][4], v21);
 
-        y01 = b01 * x01 + w11;
-        w11 = b11 * x01 - a11 * y01 + w21;
-        w21 = b21 * x01 - a21 * y01;
+    _MM_SET_FLUSH_ZERO_MODE(ftz);
+}
 
-        y02 = b02 * x02 + w12;
-        w12 = b12 * x02 - a12 * y02 + w22;
-        w22 = b22 * x02 - a22 * y02;
+void FIR_1x4_AVX2(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames);
+void biquad2_4x4x2_AVX2(float* src0, float* src1, float* dst, float coef0[5][8], float coef1[5][8],
+                        float state0[3][8], float state1[3][8], int numFrames);
 
-        y03 = b03 * x03 + w13;
-        w13 = b13 * x03 - a13 * y03 + w23;
-        w23 = b23 * x03 - a23 * y03;
+#include "CPUDetect.h"
 
-        // transposed Direct Form II
-        y04 = b04 * x04 + w14;
-        w14 = b14 * x04 - a14 * y04 + w24;
-        w24 = b24 * x04 - a24 * y04;
+#endif
 
-        y05 = b05 * x05 + w15;
-        w15 = b15 * x05 - a15 * y05 + w25;
-        w25 = b25 * x05 - a25 * y05;
+//
+// Runtime CPU dispatch
+//
 
-        y06 = b06 * x06 + w16;
-        w16 = b16 * x06 - a16 * y06 + w26;
-        w26 = b26 * x06 - a26 * y06;
+struct HRTFKernels {
+    decltype(&FIR_1x4_ref) FIR_1x4;
+    decltype(&interleave_4x4_ref) interleave_4x4;
+    decltype(&biquad2_4x4_ref) biquad2_4x4;
+    decltype(&crossfade_4x2_ref) crossfade_4x2;
+    decltype(&interpolate_ref) interpolate;
+    decltype(&biquad2_4x4x2_ref) biquad2_4x4x2;
+};
 
-        y07 = b07 * x07 + w17;
-        w17 = b17 * x07 - a17 * y07 + w27;
-        w27 = b27 * x07 - a27 * y07;
+static const HRTFKernels KERNELS_REF = {
+    FIR_1x4_ref, interleave_4x4_ref, biquad2_4x4_ref, crossfade_4x2_ref, interpolate_ref, biquad2_4x4x2_ref
+};
 
-        dst[4*i+0] = y04;   // second biquad output
-        dst[4*i+1] = y05;
-        dst[4*i+2] = y06;
-        dst[4*i+3] = y07;
-    }
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
 
-    // save state
-    state[0][0] = y00;
-    state[1][0] = w10;
-    state[2][0] = w20;
+static const HRTFKernels KERNELS_SSE = {
+    FIR_1x4_SSE, interleave_4x4_SSE, biquad2_4x4_SSE, crossfade_4x2_SSE, interpolate_SSE, biquad2_4x4x2_SSE
+};
 
-    state[0][1] = y01;
-    state[1][1] = w11;
-    state[2][1] = w21;
+static const HRTFKernels KERNELS_AVX2 = {
+    FIR_1x4_AVX2, interleave_4x4_SSE, biquad2_4x4_SSE, crossfade_4x2_SSE, interpolate_SSE, biquad2_4x4x2_AVX2
+};
 
-    state[0][2] = y02;
-    state[1][2] = w12;
-    state[2][2] = w22;
+static bool simdPathIsSupported(AudioHRTF::SIMDPath path) {
+    return path != AudioHRTF::SIMD_AVX2 || cpuSupportsAVX2();
+}
 
-    state[0][3] = y03;
-    state[1][3] = w13;
-    state[2][3] = w23;
+static const HRTFKernels* kernelsForPath(AudioHRTF::SIMDPath path) {
+    switch (path) {
+        case AudioHRTF::SIMD_AVX2:
+            return &KERNELS_AVX2;
+        case AudioHRTF::SIMD_SSE:
+            return &KERNELS_SSE;
+        default:
+            return &KERNELS_REF;
+    }
+}
 
-    state[1][4] = w14;
-    state[2][4] = w24;
+static AudioHRTF::SIMDPath bestSIMDPath() {
+    return cpuSupportsAVX2() ? AudioHRTF::SIMD_AVX2 : AudioHRTF::SIMD_SSE;
+}
 
-    state[1][5] = w15;
-    state[2][5] = w25;
+#else
 
-    state[1][6] = w16;
-    state[2][6] = w26;
+static bool simdPathIsSupported(AudioHRTF::SIMDPath path) {
+    return path == AudioHRTF::SIMD_SCALAR;
+}
 
-    state[1][7] = w17;
-    state[2][7] = w27;
+static const HRTFKernels* kernelsForPath(AudioHRTF::SIMDPath) {
+    return &KERNELS_REF;
 }
 
-// crossfade 4 inputs into 2 outputs with accumulation (interleaved)
-static void crossfade_4x2(float* src, float* dst, const float* win, int numFrames) {
+static AudioHRTF::SIMDPath bestSIMDPath() {
+    return AudioHRTF::SIMD_SCALAR;
+}
 
-    for (int i = 0; i < numFrames; i++) {
+#endif
 
-        float frac = win[i];
+static AudioHRTF::SIMDPath& currentSIMDPath() {
+    static AudioHRTF::SIMDPath path = bestSIMDPath();
+    return path;
+}
 
-        dst[2*i+0] += src[4*i+2] + frac * (src[4*i+0] - src[4*i+2]);
-        dst[2*i+1] += src[4*i+3] + frac * (src[4*i+1] - src[4*i+3]);
+static const HRTFKernels*& currentKernels() {
+    static const HRTFKernels* kernels = kernelsForPath(currentSIMDPath());
+    return kernels;
+}
+
+bool AudioHRTF::setSIMDPath(SIMDPath path) {
+    if (!simdPathIsSupported(path)) {
+        return false;
     }
+    currentSIMDPath() = path;
+    currentKernels() = kernelsForPath(path);
+    return true;
 }
 
-// linear interpolation with gain
-static void interpolate(float* dst, const float* src0, const float* src1, float frac, float gain) {
+AudioHRTF::SIMDPath AudioHRTF::getSIMDPath() {
+    return currentSIMDPath();
+}
 
-    float f0 = HRTF_GAIN * gain * (1.0f - frac);
-    float f1 = HRTF_GAIN * gain * frac;
+static void FIR_1x4(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames) {
+    currentKernels()->FIR_1x4(src, dst0, dst1, dst2, dst3, coef, numFrames); // dispatch
+}
 
-    for (int k = 0; k < HRTF_TAPS; k++) {
-        dst[k] = f0 * src0[k] + f1 * src1[k];
-    }
+static void interleave_4x4(float* src0, float* src1, float* src2, float* src3, float* dst, int numFrames) {
+    currentKernels()->interleave_4x4(src0, src1, src2, src3, dst, numFrames); // dispatch
+}
+
+static void biquad2_4x4(float* src, float* dst, float coef[5][8], float state[3][8], int numFrames) {
+    currentKernels()->biquad2_4x4(src, dst, coef, state, numFrames); // dispatch
+}
+
+static void crossfade_4x2(float* src, float* dst, const float* win, int numFrames) {
+    currentKernels()->crossfade_4x2(src, dst, win, numFrames); // dispatch
+}
+
+static void interpolate(float* dst, const float* src0, const float* src1, float frac, float gain) {
+    currentKernels()->interpolate(dst, src0, src1, frac, gain); // dispatch
+}
+
+static void biquad2_4x4x2(float* src0, float* src1, float* dst, float coef0[5][8], float coef1[5][8],
+                          float state0[3][8], float state1[3][8], int numFrames) {
+    currentKernels()->biquad2_4x4x2(src0, src1, dst, coef0, coef1, state0, state1, numFrames); // dispatch
 }
 
-#endif
 
 // design a 2nd order Thiran allpass
 static void ThiranBiquad(float f, float& b0, float& b1, float& b2, float& a1, float& a2) {
@@ -848,17 +1076,15 @@ static void setFilters(float firCoef[4][HRTF_TAPS], float bqCoef[5][8], int dela
     bqCoef[4][channel+5] = a2;
 }
 
-void AudioHRTF::render(int16_t* input, float* output, int index, float azimuth, float distance, float gain, int numFrames) {
+void AudioHRTF::prepare(int16_t* input, int index, float azimuth, float distance, float gain,
+                        float bqCoef[5][8], float* bqBuffer) {
 
     assert(index >= 0);
     assert(index < HRTF_TABLES);
-    assert(numFrames == HRTF_BLOCK);
 
     ALIGN32 float in[HRTF_TAPS + HRTF_BLOCK];               // mono
     ALIGN32 float firCoef[4][HRTF_TAPS];                    // 4-channel
     ALIGN32 float firBuffer[4][HRTF_DELAY + HRTF_BLOCK];    // 4-channel
-    ALIGN32 float bqCoef[5][8];                             // 4-channel (interleaved)
-    ALIGN32 float bqBuffer[4 * HRTF_BLOCK];                 // 4-channel (interleaved)
     int delay[4];                                           // 4-channel (interleaved)
 
     // apply global and local gain adjustment
@@ -909,9 +1135,9 @@ void AudioHRTF::render(int16_t* input, float* output, int index, float azimuth,
                    &firBuffer[L1][HRTF_DELAY] - delay[L1],
                    &firBuffer[R1][HRTF_DELAY] - delay[R1],
                    bqBuffer, HRTF_BLOCK);
+}
 
-    // process old/new biquads
-    biquad2_4x4(bqBuffer, bqBuffer, bqCoef, _bqState, HRTF_BLOCK);
+void AudioHRTF::finish() {
 
     // new state becomes old
     _bqState[0][L0] = _bqState[0][L1];
@@ -930,10 +1156,72 @@ void AudioHRTF::render(int16_t* input, float* output, int index, float azimuth,
     _bqState[1][R2] = _bqState[1][R3];
     _bqState[2][R2] = _bqState[2][R3];
 
+    _silentState = false;
+}
+
+void AudioHRTF::render(int16_t* input, float* output, int index, float azimuth, float distance, float gain, int numFrames) {
+
+    assert(numFrames == HRTF_BLOCK);
+
+    ALIGN32 float bqCoef[5][8];                             // 4-channel (interleaved)
+    ALIGN32 float bqBuffer[4 * HRTF_BLOCK];                 // 4-channel (interleaved)
+
+    prepare(input, index, azimuth, distance, gain, bqCoef, bqBuffer);
+
+    // process old/new biquads
+    biquad2_4x4(bqBuffer, bqBuffer, bqCoef, _bqState, HRTF_BLOCK);
+
+    finish();
+
     // crossfade old/new output and accumulate
     crossfade_4x2(bqBuffer, output, crossfadeTable, HRTF_BLOCK);
+}
 
-    _silentState = false;
+void AudioHRTF::render(AudioHRTF* hrtfs[], int16_t* inputs[], float* output, int index,
+                       const float* azimuths, const float* distances, const float* gains, int numSources, int numFrames) {
+
+    assert(numFrames == HRTF_BLOCK);
+
+    ALIGN32 float bqCoef[2][5][8];                          // 4-channel (interleaved), per source
+    ALIGN32 float bqBuffer[2][4 * HRTF_BLOCK];              // 4-channel (interleaved), per source
+    ALIGN32 float accBuffer[4 * HRTF_BLOCK] = {};           // 4-channel (interleaved), summed over sources
+
+    int i = 0;
+
+    // process pairs of sources, with their biquads in parallel
+    for (; i + 1 < numSources; i += 2) {
+
+        AudioHRTF& hrtf0 = *hrtfs[i+0];
+        AudioHRTF& hrtf1 = *hrtfs[i+1];
+
+        hrtf0.prepare(inputs[i+0], index, azimuths[i+0], distances[i+0], gains[i+0], bqCoef[0], bqBuffer[0]);
+        hrtf1.prepare(inputs[i+1], index, azimuths[i+1], distances[i+1], gains[i+1], bqCoef[1], bqBuffer[1]);
+
+        biquad2_4x4x2(bqBuffer[0], bqBuffer[1], accBuffer, bqCoef[0], bqCoef[1], hrtf0._bqState, hrtf1._bqState, HRTF_BLOCK);
+
+        hrtf0.finish();
+        hrtf1.finish();
+    }
+
+    // process the remaining source
+    if (i < numSources) {
+
+        AudioHRTF& hrtf = *hrtfs[i];
+
+        hrtf.prepare(inputs[i], index, azimuths[i], distances[i], gains[i], bqCoef[0], bqBuffer[0]);
+
+        biquad2_4x4(bqBuffer[0], bqBuffer[0], bqCoef[0], hrtf._bqState, HRTF_BLOCK);
+
+        hrtf.finish();
+
+        for (int j = 0; j < 4 * HRTF_BLOCK; j++) {
+            accBuffer[j] += bqBuffer[0][j];
+        }
+    }
+
+    // crossfade old/new output of all sources and accumulate
+    // (the crossfade is linear, so it can be applied to the sum)
+    crossfade_4x2(accBuffer, output, crossfadeTable, HRTF_BLOCK);
 }
 
 void AudioHRTF::renderSilent(int16_t* input, float* output, int index, float azimuth, float distance, float gain, int numFrames) {
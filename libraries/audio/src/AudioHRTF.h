@@ -39,11 +39,28 @@ public:
     //
     void render(int16_t* input, float* output, int index, float azimuth, float distance, float gain, int numFrames);
 
+    //
+    // Batched render of many mono sources into the same output
+    // hrtfs, inputs, azimuths, distances, gains: one per source, as above
+    // Sources are processed in pairs, and their outputs are summed before the final crossfade.
+    //
+    static void render(AudioHRTF* hrtfs[], int16_t* inputs[], float* output, int index,
+                       const float* azimuths, const float* distances, const float* gains, int numSources, int numFrames);
+
     //
     // Fast path when input is known to be silent
     //
     void renderSilent(int16_t* input, float* output, int index, float azimuth, float distance, float gain, int numFrames);
 
+    //
+    // SIMD code used by all renders, the best the CPU supports by default
+    // Only meant for comparing the paths in benchmarks, and not to be changed while rendering.
+    // Returns false, leaving the path unchanged, if the CPU doesn't support the path.
+    //
+    enum SIMDPath { SIMD_SCALAR, SIMD_SSE, SIMD_AVX2 };
+    static bool setSIMDPath(SIMDPath path);
+    static SIMDPath getSIMDPath();
+
     //
     // HRTF local gain adjustment in amplitude (1.0 == unity)
     //
@@ -54,6 +71,13 @@ private:
     AudioHRTF(const AudioHRTF&) = delete;
     AudioHRTF& operator=(const AudioHRTF&) = delete;
 
+    // filter the input up to the biquads, into 4-channel interleaved bqBuffer
+    void prepare(int16_t* input, int index, float azimuth, float distance, float gain,
+                 float bqCoef[5][8], float* bqBuffer);
+
+    // update state after the biquads have been processed
+    void finish();
+
     // SIMD channel assignmentS
     enum Channel {
         L0, R0,
@@ -91,4 +91,86 @@ void FIR_1x4_AVX2(float* src, float* dst0, float* dst1, float* dst2, float* dst3
     _mm256_zeroupper();
 }
 
+// load 4 channels of 2 sources into the low and high lanes
+static inline __m256 load_4x2(const float* src0, const float* src1) {
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(src0)), _mm_loadu_ps(src1), 1);
+}
+
+// store the low and high lanes into 4 channels of 2 sources
+static inline void store_4x2(float* dst0, float* dst1, __m256 x) {
+    _mm_storeu_ps(dst0, _mm256_castps256_ps128(x));
+    _mm_storeu_ps(dst1, _mm256_extractf128_ps(x, 1));
+}
+
+// process 2 cascaded biquads on 4 channels (interleaved), for 2 sources in parallel
+// the outputs of both sources are summed and accumulated into dst
+void biquad2_4x4x2_AVX2(float* src0, float* src1, float* dst, float coef0[5][8], float coef1[5][8],
+                        float state0[3][8], float state1[3][8], int numFrames) {
+
+    // enable flush-to-zero mode to prevent denormals
+    unsigned int ftz = _MM_GET_FLUSH_ZERO_MODE();
+    _MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
+
+    // restore state
+    __m256 y00 = load_4x2(&state0[0][0], &state1[0][0]);
+    __m256 w10 = load_4x2(&state0[1][0], &state1[1][0]);
+    __m256 w20 = load_4x2(&state0[2][0], &state1[2][0]);
+
+    __m256 y01;
+    __m256 w11 = load_4x2(&state0[1][4], &state1[1][4]);
+    __m256 w21 = load_4x2(&state0[2][4], &state1[2][4]);
+
+    // first biquad coefs
+    __m256 b00 = load_4x2(&coef0[0][0], &coef1[0][0]);
+    __m256 b10 = load_4x2(&coef0[1][0], &coef1[1][0]);
+    __m256 b20 = load_4x2(&coef0[2][0], &coef1[2][0]);
+    __m256 a10 = load_4x2(&coef0[3][0], &coef1[3][0]);
+    __m256 a20 = load_4x2(&coef0[4][0], &coef1[4][0]);
+
+    // second biquad coefs
+    __m256 b01 = load_4x2(&coef0[0][4], &coef1[0][4]);
+    __m256 b11 = load_4x2(&coef0[1][4], &coef1[1][4]);
+    __m256 b21 = load_4x2(&coef0[2][4], &coef1[2][4]);
+    __m256 a11 = load_4x2(&coef0[3][4], &coef1[3][4]);
+    __m256 a21 = load_4x2(&coef0[4][4], &coef1[4][4]);
+
+    for (int i = 0; i < numFrames; i++) {
+
+        __m256 x00 = load_4x2(&src0[4*i], &src1[4*i]);
+        __m256 x01 = y00;   // first biquad output
+
+        // transposed Direct Form II
+        y00 = _mm256_fmadd_ps(x00, b00, w10);
+        y01 = _mm256_fmadd_ps(x01, b01, w11);
+
+        w10 = _mm256_fmadd_ps(x00, b10, w20);
+        w11 = _mm256_fmadd_ps(x01, b11, w21);
+
+        w20 = _mm256_mul_ps(x00, b20);
+        w21 = _mm256_mul_ps(x01, b21);
+
+        w10 = _mm256_fnmadd_ps(y00, a10, w10);
+        w11 = _mm256_fnmadd_ps(y01, a11, w11);
+
+        w20 = _mm256_fnmadd_ps(y00, a20, w20);
+        w21 = _mm256_fnmadd_ps(y01, a21, w21);
+
+        // sum the second biquad output of both sources, and accumulate
+        __m128 y = _mm_add_ps(_mm256_castps256_ps128(y01), _mm256_extractf128_ps(y01, 1));
+        _mm_storeu_ps(&dst[4*i], _mm_add_ps(_mm_loadu_ps(&dst[4*i]), y));
+    }
+
+    // save state
+    store_4x2(&state0[0][0], &state1[0][0], y00);
+    store_4x2(&state0[1][0], &state1[1][0], w10);
+    store_4x2(&state0[2][0], &state1[2][0], w20);
+
+    store_4x2(&state0[1][4], &state1[1][4], w11);
+    store_4x2(&state0[2][4], &state1[2][4], w21);
+
+    _MM_SET_FLUSH_ZERO_MODE(ftz);
+
+    _mm256_zeroupper();
+}
+
 #endif
@@ -391,6 +391,15 @@ public:
         AvatarDataPacket::HasFlags& hasFlagsOut, bool dropFaceTracking, bool distanceAdjust, glm::vec3 viewerPosition,
         QVector<JointData>* sentJointDataOut, AvatarDataRate* outboundDataRateOut = nullptr) const;
 
+    // returns the sections that toByteArray would include
+    AvatarDataPacket::HasFlags getHasFlags(AvatarDataDetail dataDetail, quint64 lastSentTime, bool dropFaceTracking) const;
+
+    // returns whether toByteArray depends only on this avatar and its flags from getHasFlags,
+    // so that it can be shared between receivers (the other details depend on the joint data last sent, and the viewer)
+    static bool isSharableDetail(AvatarDataDetail dataDetail) {
+        return dataDetail != CullSmallData && dataDetail != IncludeSmallData;
+    }
+
     virtual void doneEncoding(bool cullSmallChanges);
 
     /// \return true if an error should be logged
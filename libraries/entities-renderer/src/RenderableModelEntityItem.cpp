@@ -514,6 +514,16 @@ ModelPointer RenderableModelEntityItem::getModel(QSharedPointer<EntityTreeRender
         // If we don't have a model, allocate one *immediately*
         if (!_model) {
             _model = _myRenderer->allocateModel(getModelURL(), renderer->getEntityLoadingPriority(*this), this);
+            if (_model) {
+                // the entity gets closer or further as the avatar moves, so have its priority follow it until it loads
+                EntityItemWeakPointer weakEntity = getThisPointer();
+                QWeakPointer<EntityTreeRenderer> weakRenderer = _myRenderer;
+                _model->setLoadingPriorityOperator([weakEntity, weakRenderer]() {
+                    auto entity = weakEntity.lock();
+                    auto renderer = weakRenderer.toStrongRef();
+                    return (entity && renderer) ? renderer->getEntityLoadingPriority(*entity) : 0.0f;
+                });
+            }
             _needsInitialSimulation = true;
         // If we need to change URLs, update it *after rendering* (to avoid access violations)
         } else if (QUrl(getModelURL()) != _model->getURL()) {
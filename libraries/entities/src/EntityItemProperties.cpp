@@ -1072,9 +1072,15 @@ void EntityItemProperties::entityPropertyFlagsFromScriptValue(const QScriptValue
     }
 }
 
-// TODO: Implement support for edit packets that can span an MTU sized buffer. We need to implement a mechanism for the
-//       encodeEntityEditPacket() method to communicate the the caller which properties couldn't fit in the buffer. Similar
-//       to how we handle this in the Octree streaming case.
+bool EntityItemProperties::encodeEntityEditPacket(PacketType command, EntityItemID id, const EntityItemProperties& properties,
+                                                  QByteArray& buffer) {
+    EntityPropertyFlags didntFitProperties;
+    return encodeEntityEditPacket(command, id, properties, buffer, properties.getChangedProperties(), didntFitProperties,
+                                  false);
+}
+
+// TODO: Implement support for edit packets that can span an MTU sized buffer. The properties that didn't fit in the
+//       buffer are returned to the caller, but only the entity records use them so far.
 //
 // TODO: Right now, all possible properties for all subclasses are handled here. Ideally we'd prefer
 //       to handle this in a more generic way. Allowing subclasses of EntityItem to register their properties
@@ -1088,7 +1094,8 @@ void EntityItemProperties::entityPropertyFlagsFromScriptValue(const QScriptValue
 // TODO: Implement support for script and visible properties.
 //
 bool EntityItemProperties::encodeEntityEditPacket(PacketType command, EntityItemID id, const EntityItemProperties& properties,
-                                                  QByteArray& buffer) {
+                                                  QByteArray& buffer, EntityPropertyFlags requestedProperties,
+                                                  EntityPropertyFlags& didntFitProperties, bool allowPartial) {
     OctreePacketData ourDataPacket(false, buffer.size()); // create a packetData object to add out packet details too.
     OctreePacketData* packetData = &ourDataPacket; // we want a pointer to this so we can use our APPEND_ENTITY_PROPERTY macro
 
@@ -1130,7 +1137,6 @@ bool EntityItemProperties::encodeEntityEditPacket(PacketType command, EntityItem
         QByteArray encodedUpdateDelta = updateDeltaCoder;
 
         EntityPropertyFlags propertyFlags(PROP_LAST_ITEM);
-        EntityPropertyFlags requestedProperties = properties.getChangedProperties();
         EntityPropertyFlags propertiesDidntFit = requestedProperties;
 
         // TODO: we need to handle the multi-pass form of this, similar to how we handle entity data
@@ -1369,8 +1375,10 @@ bool EntityItemProperties::encodeEntityEditPacket(PacketType command, EntityItem
             appendState = OctreeElement::NONE; // if we got here, then we didn't include the item
         }
 
+        didntFitProperties = propertiesDidntFit;
+
         // If any part of the model items didn't fit, then the element is considered partial
-        if (appendState != OctreeElement::COMPLETED) {
+        if (appendState != OctreeElement::COMPLETED && !(allowPartial && appendState == OctreeElement::PARTIAL)) {
             // TODO: handle mechanism for handling partial fitting data!
             // add this item into our list for the next appendElementData() pass
             //modelTreeElementExtraEncodeData->includedItems.insert(getEntityItemID(), propertiesDidntFit);
@@ -1639,6 +1647,201 @@ bool EntityItemProperties::decodeEntityEditPacket(const unsigned char* data, int
     return valid;
 }
 
+// Packets can't carry a property bigger than one of them, so these are written after the parts of a record, whole
+static bool getLargeRecordProperty(const EntityItemProperties& properties, EntityPropertyList property,
+                                   QByteArray& value) {
+    switch (property) {
+        case PROP_SCRIPT: value = properties.getScript().toUtf8(); return true;
+        case PROP_SERVER_SCRIPTS: value = properties.getServerScripts().toUtf8(); return true;
+        case PROP_USER_DATA: value = properties.getUserData().toUtf8(); return true;
+        case PROP_MODEL_URL: value = properties.getModelURL().toUtf8(); return true;
+        case PROP_COMPOUND_SHAPE_URL: value = properties.getCompoundShapeURL().toUtf8(); return true;
+        case PROP_TEXTURES: value = properties.getTextures().toUtf8(); return true;
+        case PROP_NAME: value = properties.getName().toUtf8(); return true;
+        case PROP_HREF: value = properties.getHref().toUtf8(); return true;
+        case PROP_DESCRIPTION: value = properties.getDescription().toUtf8(); return true;
+        case PROP_VOXEL_DATA: value = properties.getVoxelData(); return true;
+        case PROP_ACTION_DATA: value = properties.getActionData(); return true;
+        default: return false;
+    }
+}
+
+static bool setLargeRecordProperty(EntityItemProperties& properties, EntityPropertyList property,
+                                   const QByteArray& value) {
+    switch (property) {
+        case PROP_SCRIPT: properties.setScript(QString::fromUtf8(value)); return true;
+        case PROP_SERVER_SCRIPTS: properties.setServerScripts(QString::fromUtf8(value)); return true;
+        case PROP_USER_DATA: properties.setUserData(QString::fromUtf8(value)); return true;
+        case PROP_MODEL_URL: properties.setModelURL(QString::fromUtf8(value)); return true;
+        case PROP_COMPOUND_SHAPE_URL: properties.setCompoundShapeURL(QString::fromUtf8(value)); return true;
+        case PROP_TEXTURES: properties.setTextures(QString::fromUtf8(value)); return true;
+        case PROP_NAME: properties.setName(QString::fromUtf8(value)); return true;
+        case PROP_HREF: properties.setHref(QString::fromUtf8(value)); return true;
+        case PROP_DESCRIPTION: properties.setDescription(QString::fromUtf8(value)); return true;
+        case PROP_VOXEL_DATA: properties.setVoxelData(value); return true;
+        case PROP_ACTION_DATA: properties.setActionData(value); return true;
+        default: return false;
+    }
+}
+
+// the size of a part that is followed by the large properties, rather than by another part
+static const quint16 LARGE_PROPERTIES_MARKER = 0;
+
+bool EntityItemProperties::encodeEntityRecord(EntityItemID id, const EntityItemProperties& properties, QByteArray& record) {
+    EntityItemProperties recordProperties = properties;
+    recordProperties.markAllChanged();
+    return encodeEntityRecord(id, recordProperties, recordProperties.getChangedProperties(), record);
+}
+
+bool EntityItemProperties::encodeEntityRecord(EntityItemID id, const EntityItemProperties& properties,
+                                              EntityPropertyFlags recordedProperties, QByteArray& record) {
+    // the simulation owner is only good for the session it was bid in, so it isn't kept (as in the JSON files)
+    EntityPropertyFlags requestedProperties = recordedProperties;
+    requestedProperties -= PROP_SIMULATION_OWNER;
+
+    // edit packets don't carry the created time or the last editor, since the entity server sets them
+    record.clear();
+    quint64 created = properties.getCreated();
+    record.append(reinterpret_cast<const char*>(&created), sizeof(created));
+    record.append(properties.getLastEditedBy().toRfc4122());
+
+    // the properties that don't fit in one part go in the next, until what is left doesn't fit in a part of its own
+    int numParts = 0;
+    QByteArray part;
+    EntityPropertyFlags didntFitProperties;
+    while (!requestedProperties.isEmpty()) {
+        part.resize(MAX_OCTREE_UNCOMRESSED_PACKET_SIZE);
+        if (!encodeEntityEditPacket(PacketType::EntityEdit, id, properties, part,
+                                    requestedProperties, didntFitProperties, true)) {
+            break;
+        }
+
+        quint16 partSize = (quint16)part.size();
+        record.append(reinterpret_cast<const char*>(&partSize), sizeof(partSize));
+        record.append(part);
+        ++numParts;
+
+        requestedProperties = didntFitProperties;
+    }
+
+    if (numParts == 0) {
+        return false;
+    }
+
+    if (!requestedProperties.isEmpty()) {
+        return appendLargeRecordProperties(id, properties, requestedProperties, record);
+    }
+    return true;
+}
+
+bool EntityItemProperties::appendLargeRecordProperties(EntityItemID id, const EntityItemProperties& properties,
+                                                       const EntityPropertyFlags& largeProperties, QByteArray& record) {
+    record.append(reinterpret_cast<const char*>(&LARGE_PROPERTIES_MARKER), sizeof(LARGE_PROPERTIES_MARKER));
+
+    for (int i = largeProperties.firstFlag(); i <= largeProperties.lastFlag(); ++i) {
+        auto property = (EntityPropertyList)i;
+        if (!largeProperties.getHasProperty(property)) {
+            continue;
+        }
+
+        // only a property that could be too big for a packet is expected here - any other one is lost
+        QByteArray value;
+        if (!getLargeRecordProperty(properties, property, value)) {
+            qCWarning(entities) << "Property" << i << "of entity" << id << "does not fit in an entity record";
+            return false;
+        }
+
+        quint16 propertyIndex = (quint16)property;
+        quint32 valueSize = (quint32)value.size();
+        record.append(reinterpret_cast<const char*>(&propertyIndex), sizeof(propertyIndex));
+        record.append(reinterpret_cast<const char*>(&valueSize), sizeof(valueSize));
+        record.append(value);
+    }
+
+    return true;
+}
+
+bool EntityItemProperties::isLargeRecordPropertiesMarker(quint16 partSize) {
+    return partSize == LARGE_PROPERTIES_MARKER;
+}
+
+bool EntityItemProperties::readLargeRecordProperties(const unsigned char* data, int bytesToRead,
+                                                     EntityItemProperties& properties) {
+    const unsigned char* dataAt = data;
+    int bytesLeftToRead = bytesToRead;
+    while (bytesLeftToRead > 0) {
+        quint16 propertyIndex;
+        quint32 valueSize;
+        if (bytesLeftToRead < (int)(sizeof(propertyIndex) + sizeof(valueSize))) {
+            return false;
+        }
+        memcpy(&propertyIndex, dataAt, sizeof(propertyIndex));
+        memcpy(&valueSize, dataAt + sizeof(propertyIndex), sizeof(valueSize));
+        dataAt += sizeof(propertyIndex) + sizeof(valueSize);
+        bytesLeftToRead -= sizeof(propertyIndex) + sizeof(valueSize);
+
+        if (valueSize > (quint32)bytesLeftToRead) {
+            return false;
+        }
+
+        QByteArray value(reinterpret_cast<const char*>(dataAt), valueSize);
+        if (!setLargeRecordProperty(properties, (EntityPropertyList)propertyIndex, value)) {
+            return false;
+        }
+        dataAt += valueSize;
+        bytesLeftToRead -= valueSize;
+    }
+    return true;
+}
+
+bool EntityItemProperties::decodeEntityRecord(const unsigned char* data, int bytesToRead,
+                                              EntityItemID& entityID, EntityItemProperties& properties) {
+    const int HEADER_SIZE = sizeof(quint64) + NUM_BYTES_RFC4122_UUID;
+    if (bytesToRead < HEADER_SIZE) {
+        return false;
+    }
+
+    quint64 created;
+    memcpy(&created, data, sizeof(created));
+    QUuid lastEditedBy = QUuid::fromRfc4122(QByteArray::fromRawData(reinterpret_cast<const char*>(data + sizeof(created)),
+                                                                    NUM_BYTES_RFC4122_UUID));
+
+    const unsigned char* dataAt = data + HEADER_SIZE;
+    int bytesLeftToRead = bytesToRead - HEADER_SIZE;
+    int numParts = 0;
+
+    // each part sets the properties it has, over the ones set by the parts before it
+    while (bytesLeftToRead > 0) {
+        quint16 partSize;
+        if (bytesLeftToRead < (int)sizeof(partSize)) {
+            return false;
+        }
+        memcpy(&partSize, dataAt, sizeof(partSize));
+        dataAt += sizeof(partSize);
+        bytesLeftToRead -= sizeof(partSize);
+
+        if (isLargeRecordPropertiesMarker(partSize)) {
+            break;
+        }
+
+        int processedBytes = 0;
+        if (partSize > bytesLeftToRead || !decodeEntityEditPacket(dataAt, partSize, processedBytes, entityID, properties)) {
+            return false;
+        }
+        dataAt += partSize;
+        bytesLeftToRead -= partSize;
+        ++numParts;
+    }
+
+    // then the large properties, if there are any, take up the rest of the record
+    if (!readLargeRecordProperties(dataAt, bytesLeftToRead, properties)) {
+        return false;
+    }
+
+    properties.setCreated(created);
+    properties.setLastEditedBy(lastEditedBy);
+    return numParts > 0;
+}
 
 // NOTE: This version will only encode the portion of the edit message immediately following the
 // header it does not include the send times and sequence number because that is handled by the
@@ -249,6 +249,21 @@ public:
     static bool decodeEntityEditPacket(const unsigned char* data, int bytesToRead, int& processedBytes,
                                        EntityItemID& entityID, EntityItemProperties& properties);
 
+    // Edits are logged as records of edit packet sized parts, along with what edit packets don't carry
+    // (the created time, the last editor, and properties too large for an edit packet of their own)
+    static bool encodeEntityRecord(EntityItemID id, const EntityItemProperties& properties, QByteArray& record);
+    // records only the given properties, such as those an edit changed
+    static bool encodeEntityRecord(EntityItemID id, const EntityItemProperties& properties,
+                                   EntityPropertyFlags recordedProperties, QByteArray& record);
+    static bool decodeEntityRecord(const unsigned char* data, int bytesToRead,
+                                   EntityItemID& entityID, EntityItemProperties& properties);
+
+    // the properties too large for a packet end a record, after a part size that marks them rather than another part
+    static bool appendLargeRecordProperties(EntityItemID id, const EntityItemProperties& properties,
+                                            const EntityPropertyFlags& largeProperties, QByteArray& record);
+    static bool isLargeRecordPropertiesMarker(quint16 partSize);
+    static bool readLargeRecordProperties(const unsigned char* data, int bytesToRead, EntityItemProperties& properties);
+
     bool localRenderAlphaChanged() const { return _localRenderAlphaChanged; }
 
     void clearID() { _id = UNKNOWN_ENTITY_ID; _idSet = false; }
@@ -309,6 +324,12 @@ protected:
     void setCollisionMaskFromString(const QString& maskString);
 
 private:
+    // encodes the requested properties that fit in the buffer, and returns the rest in didntFitProperties
+    // fails if any of them didn't fit, unless allowPartial is set, in which case it fails if none of them fit
+    static bool encodeEntityEditPacket(PacketType command, EntityItemID id, const EntityItemProperties& properties,
+                                       QByteArray& buffer, EntityPropertyFlags requestedProperties,
+                                       EntityPropertyFlags& didntFitProperties, bool allowPartial);
+
     QUuid _id;
     bool _idSet;
     quint64 _lastEdited;
@@ -28,3 +28,17 @@ bool EntityNodeData::isEntityFlaggedAsExtra(const QUuid& entityID) const {
 
     return false;
 }
+
+bool EntityNodeData::hasSentEntity(const QUuid& entityID, quint64 editSequence) const {
+    auto it = _sentEntitySequences.find(entityID);
+    return it != _sentEntitySequences.end() && it.value() >= editSequence;
+}
+
+bool EntityNodeData::getSentEntitySequence(const QUuid& entityID, quint64& editSequence) const {
+    auto it = _sentEntitySequences.find(entityID);
+    if (it == _sentEntitySequences.end()) {
+        return false;
+    }
+    editSequence = it.value();
+    return true;
+}
@@ -44,11 +44,25 @@ public:
     bool isEntityFlaggedAsExtra(const QUuid& entityID) const;
     void resetFlaggedExtraEntities() { _previousFlaggedExtraEntities = _flaggedExtraEntities; _flaggedExtraEntities.clear(); }
 
+    // the following sent entity methods can only be called from the OctreeSendThread for the given Node
+
+    // the edit sequence of each entity as it was when it was last sent, so that only changes it hasn't sent are sent
+    bool hasSentEntity(const QUuid& entityID, quint64 editSequence) const;
+    bool getSentEntitySequence(const QUuid& entityID, quint64& editSequence) const; // false if it was never sent
+    void setSentEntity(const QUuid& entityID, quint64 editSequence) { _sentEntitySequences[entityID] = editSequence; }
+    void removeSentEntity(const QUuid& entityID) { _sentEntitySequences.remove(entityID); }
+
+    // how far through the edit journal of the tree the changed entities have been queued to send
+    quint64 getLastEditSequenceQueued() const { return _lastEditSequenceQueued; }
+    void setLastEditSequenceQueued(quint64 editSequence) { _lastEditSequenceQueued = editSequence; }
+
 private:
     quint64 _lastDeletedEntitiesSentAt { usecTimestampNow() };
     QSet<QUuid> _sentFilteredEntities;
     QHash<QUuid, QSet<QUuid>> _flaggedExtraEntities;
     QHash<QUuid, QSet<QUuid>> _previousFlaggedExtraEntities;
+    QHash<QUuid, quint64> _sentEntitySequences;
+    quint64 _lastEditSequenceQueued { 0 };
 };
 
 #endif // hifi_EntityNodeData_h
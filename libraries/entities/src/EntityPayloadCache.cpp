@@ -0,0 +1,160 @@
+//
+//  EntityPayloadCache.cpp
+//  libraries/entities/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityPayloadCache.h"
+
+#include <functional>
+
+#include <QtCore/QRunnable>
+#include <QtCore/QThreadPool>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+#include "EntityTree.h"
+
+const quint64 EntityPayloadCache::MAX_PAYLOAD_AGE_USECS = USECS_PER_SECOND;
+
+struct EntityToEncode {
+    EntityItemPointer entity;
+    quint64 editSequence;
+    quint64 lastEdited;
+    quint64 lastUpdated;
+    quint64 lastSimulated;
+};
+
+class EncodeRangeTask : public QRunnable {
+public:
+    EncodeRangeTask(std::function<void()> encodeRange) : _encodeRange(encodeRange) { }
+    void run() override { _encodeRange(); }
+
+private:
+    std::function<void()> _encodeRange;
+};
+
+// returns false if the entity doesn't fit in a packet whole, in which case it is left to be encoded by the send threads
+static bool encodePayload(const EntityItemPointer& entity, OctreePacketData& packetData, QByteArray& payload) {
+    packetData.reset();
+
+    // the properties of an entity are the same for every node, so the payload is encoded without one
+    EncodeBitstreamParams params;
+    EntityTreeElementExtraEncodeDataPointer extraEncodeData { new EntityTreeElementExtraEncodeData() };
+
+    if (entity->appendEntityData(&packetData, params, extraEncodeData) != OctreeElement::COMPLETED) {
+        return false;
+    }
+
+    payload = QByteArray((const char*)packetData.getUncompressedData(), packetData.getUncompressedSize());
+    return true;
+}
+
+int EntityPayloadCache::encodeChanges(EntityTree& tree, QThreadPool& encodePool) {
+    quint64 now = usecTimestampNow();
+    prune(now - MAX_PAYLOAD_AGE_USECS);
+
+    QVector<EntityTree::EntityEditSequence> changedEntities;
+    _lastEditSequenceEncoded = tree.getEntitiesChangedSince(_lastEditSequenceEncoded, changedEntities);
+    if (changedEntities.isEmpty()) {
+        return 0;
+    }
+
+    std::vector<EntityToEncode> entities;
+    std::vector<QByteArray> payloads;
+    std::vector<char> encoded; // not bool, since the threads write to it side by side
+
+    // the tree is locked the way the send threads lock it to encode, so the entities aren't edited as they're encoded
+    tree.withReadLock([&] {
+        for (auto& changedEntity : changedEntities) {
+            auto entity = tree.findEntityByEntityItemID(changedEntity.first);
+            if (entity) {
+                // the entity is encoded as it is at these times, since the simulation waits for the tree
+                entities.push_back({ entity, changedEntity.second, entity->getLastEdited(), entity->getLastUpdated(),
+                                     entity->getLastSimulated() });
+            }
+        }
+
+        payloads.resize(entities.size());
+        encoded.resize(entities.size(), false);
+
+        // each thread of the pool encodes a range of the entities, into the slots of its range
+        int numRanges = std::max(1, std::min(encodePool.maxThreadCount(), (int)entities.size()));
+        size_t rangeSize = (entities.size() + numRanges - 1) / numRanges;
+
+        for (size_t rangeStart = 0; rangeStart < entities.size(); rangeStart += rangeSize) {
+            size_t rangeEnd = std::min(rangeStart + rangeSize, entities.size());
+
+            encodePool.start(new EncodeRangeTask([&, rangeStart, rangeEnd] {
+                OctreePacketData packetData;
+                for (size_t i = rangeStart; i < rangeEnd; ++i) {
+                    encoded[i] = encodePayload(entities[i].entity, packetData, payloads[i]);
+                }
+            }));
+        }
+
+        // the pool is only used for this, so all of its tasks are these
+        encodePool.waitForDone();
+    });
+
+    int numEncoded = 0;
+    {
+        QWriteLocker locker(&_payloadsLock);
+        for (size_t i = 0; i < entities.size(); ++i) {
+            auto& encodedEntity = entities[i];
+            auto entityID = encodedEntity.entity->getEntityItemID();
+            if (encoded[i]) {
+                _payloads[entityID] = { encodedEntity.editSequence, encodedEntity.lastEdited, encodedEntity.lastUpdated,
+                                        encodedEntity.lastSimulated, now, payloads[i] };
+                ++numEncoded;
+            } else {
+                _payloads.remove(entityID);
+            }
+        }
+    }
+
+    _numEncoded += numEncoded;
+    return numEncoded;
+}
+
+bool EntityPayloadCache::getPayload(const EntityItemPointer& entity, quint64 editSequence, QByteArray& payload) const {
+    QReadLocker locker(&_payloadsLock);
+
+    // the server simulates entities on without editing them, which the payload must not be from before
+    auto it = _payloads.find(entity->getEntityItemID());
+    if (it == _payloads.end() || it->editSequence != editSequence || it->lastEdited != entity->getLastEdited()
+        || it->lastUpdated != entity->getLastUpdated() || it->lastSimulated != entity->getLastSimulated()) {
+        return false;
+    }
+
+    payload = it->data;
+    return true;
+}
+
+void EntityPayloadCache::clear() {
+    QWriteLocker locker(&_payloadsLock);
+    _payloads.clear();
+}
+
+int EntityPayloadCache::getNumPayloads() const {
+    QReadLocker locker(&_payloadsLock);
+    return _payloads.size();
+}
+
+void EntityPayloadCache::prune(quint64 encodedBefore) {
+    QWriteLocker locker(&_payloadsLock);
+
+    auto it = _payloads.begin();
+    while (it != _payloads.end()) {
+        if (it->encodedAt < encodedBefore) {
+            it = _payloads.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
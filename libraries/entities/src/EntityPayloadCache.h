@@ -0,0 +1,78 @@
+//
+//  EntityPayloadCache.h
+//  libraries/entities/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityPayloadCache_h
+#define hifi_EntityPayloadCache_h
+
+#include <atomic>
+#include <memory>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QReadWriteLock>
+
+#include "EntityItemID.h"
+#include "EntityTypes.h"
+
+class QThreadPool;
+class EntityTree;
+
+// The encoded data of the entities changed on the server, encoded once for all of the nodes they are sent to
+//   Once a frame, the entities changed since the last frame are found in the edit journal of the tree and encoded
+//   together on a pool of threads. The send threads copy these payloads into their packets rather than encoding the
+//   entities again. A payload is only used while its entity is at the edit sequence it was encoded at and hasn't been
+//   simulated or updated since, so that it is never older than what the send thread would encode itself.
+class EntityPayloadCache {
+public:
+    // payloads are checked against their entities as they are used, so the age only drops the ones not used anymore
+    static const quint64 MAX_PAYLOAD_AGE_USECS;
+
+    // encodes the entities changed since the last call on the pool, which must only be used for this, and returns how
+    // many were encoded
+    int encodeChanges(EntityTree& tree, QThreadPool& encodePool);
+
+    // returns false if there is no payload of the entity as it is now, at the edit sequence
+    bool getPayload(const EntityItemPointer& entity, quint64 editSequence, QByteArray& payload) const;
+
+    void clear();
+
+    int getNumPayloads() const;
+    quint64 getNumEncoded() const { return _numEncoded; }
+    quint64 getNumReused() const { return _numReused; }
+    quint64 getNumMissed() const { return _numMissed; }
+
+    // called by the send threads as they take an entity from the cache, or encode it themselves since it wasn't there
+    void trackReused() { ++_numReused; }
+    void trackMissed() { ++_numMissed; }
+
+private:
+    struct Payload {
+        quint64 editSequence;
+        quint64 lastEdited;
+        quint64 lastUpdated;
+        quint64 lastSimulated;
+        quint64 encodedAt;
+        QByteArray data;
+    };
+
+    void prune(quint64 encodedBefore);
+
+    mutable QReadWriteLock _payloadsLock;
+    QHash<EntityItemID, Payload> _payloads;
+    quint64 _lastEditSequenceEncoded { 0 };
+
+    std::atomic<quint64> _numEncoded { 0 };
+    std::atomic<quint64> _numReused { 0 };
+    std::atomic<quint64> _numMissed { 0 };
+};
+
+using EntityPayloadCachePointer = std::shared_ptr<EntityPayloadCache>;
+
+#endif // hifi_EntityPayloadCache_h
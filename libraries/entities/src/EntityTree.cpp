@@ -9,6 +9,12 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include <QtCore/QIODevice>
+
 #include <PerfStat.h>
 #include <QDateTime>
 #include <QtScript/QScriptEngine>
@@ -22,13 +28,17 @@
 #include "UpdateEntityOperator.h"
 #include "QVariantGLM.h"
 #include "EntitiesLogging.h"
-#include "RecurseOctreeToMapOperator.h"
 #include "LogHandler.h"
 #include "EntityEditFilters.h"
 #include "EntityDynamicFactoryInterface.h"
 
 
 static const quint64 DELETED_ENTITIES_EXTRA_USECS_TO_CONSIDER = USECS_PER_MSEC * 50;
+
+// the edit log records start with what they are a record of
+static const quint8 EDIT_LOG_ENTITY_EDITED = 0;
+static const quint8 EDIT_LOG_ENTITY_DELETED = 1;
+static const quint8 EDIT_LOG_ENTITY_ADDED = 2;
 const float EntityTree::DEFAULT_MAX_TMP_ENTITY_LIFETIME = 60 * 60; // 1 hour
 
 
@@ -99,6 +109,13 @@ void EntityTree::eraseAllOctreeElements(bool createNewRoot) {
 
     resetClientEditStats();
     clearDeletedEntities();
+
+    {
+        // the sequence keeps counting up, so that senders don't mistake the new entities' changes for ones they sent
+        QWriteLocker locker(&_editJournalLock);
+        _editJournal.clear();
+        _entityEdits.clear();
+    }
 }
 
 bool EntityTree::handlesEditPacketType(PacketType packetType) const {
@@ -193,6 +210,7 @@ bool EntityTree::updateEntityWithElement(EntityItemPointer entity, const EntityI
                 }
                 UpdateEntityOperator theOperator(getThisPointer(), containingElement, entity, queryCube);
                 recurseTreeWithOperator(&theOperator);
+                preserveForSnapshots(entity);
                 entity->setProperties(tempProperties);
                 _isDirty = true;
             }
@@ -268,6 +286,7 @@ bool EntityTree::updateEntityWithElement(EntityItemPointer entity, const EntityI
         }
         UpdateEntityOperator theOperator(getThisPointer(), containingElement, entity, newQueryAACube);
         recurseTreeWithOperator(&theOperator);
+        preserveForSnapshots(entity);
         entity->setProperties(properties);
 
         // if the entity has children, run UpdateEntityOperator on them.  If the children have children, recurse
@@ -380,21 +399,25 @@ EntityItemPointer EntityTree::addEntity(const EntityItemID& entityID, const Enti
         if (recordCreationTime) {
             result->recordCreationTime();
         }
-        // Recurse the tree and store the entity in the correct tree element
-        AddEntityOperator theOperator(getThisPointer(), result);
-        recurseTreeWithOperator(&theOperator);
-        if (result->getAncestorMissing()) {
-            // we added the entity, but didn't know about all its ancestors, so it went into the wrong place.
-            // add it to a list of entities needing to be fixed once their parents are known.
-            QWriteLocker locker(&_missingParentLock);
-            _missingParent.append(result);
-        }
-
-        postAddEntity(result);
+        addConstructedEntity(result);
     }
     return result;
 }
 
+void EntityTree::addConstructedEntity(const EntityItemPointer& entity) {
+    // Recurse the tree and store the entity in the correct tree element
+    AddEntityOperator theOperator(getThisPointer(), entity);
+    recurseTreeWithOperator(&theOperator);
+    if (entity->getAncestorMissing()) {
+        // we added the entity, but didn't know about all its ancestors, so it went into the wrong place.
+        // add it to a list of entities needing to be fixed once their parents are known.
+        QWriteLocker locker(&_missingParentLock);
+        _missingParent.append(entity);
+    }
+
+    postAddEntity(entity);
+}
+
 void EntityTree::emitEntityScriptChanging(const EntityItemID& entityItemID, bool reload) {
     emit entityScriptChanging(entityItemID, reload);
 }
@@ -538,6 +561,8 @@ void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator)
             // set up the deleted entities ID
             QWriteLocker locker(&_recentlyDeletedEntitiesLock);
             _recentlyDeletedEntityItemIDs.insert(deletedAt, theEntity->getEntityItemID());
+            logEntityDelete(theEntity->getEntityItemID());
+            removeFromEditJournal(theEntity->getEntityItemID());
         } else {
             // on the client side, we also remember that we deleted this entity, we don't care about the time
             trackDeletedEntity(theEntity->getEntityItemID());
@@ -1018,6 +1043,9 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
                                                                                 entityItemID, properties);
             endDecode = usecTimestampNow();
 
+            // what the sender changed is sent back out even if it isn't allowed, so that the sender is set straight
+            EntityPropertyFlags editedProperties = properties.getChangedProperties();
+
             EntityItemPointer existingEntity;
             if (!isAdd) {
                 // search for the entity by EntityItemID
@@ -1143,8 +1171,12 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
                     if (!isPhysics) {
                         properties.setLastEditedBy(senderNode->getUUID());
                     }
-                    updateEntity(entityItemID, properties, senderNode);
+                    bool updated = updateEntity(entityItemID, properties, senderNode);
                     existingEntity->markAsChangedOnServer();
+                    journalEntityChange(entityItemID, editedProperties | properties.getChangedProperties());
+                    if (updated) {
+                        logEntityEdit(existingEntity, properties.getChangedProperties());
+                    }
                     endUpdate = usecTimestampNow();
                     _totalUpdates++;
                 } else if (isAdd) {
@@ -1166,6 +1198,8 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
                         _totalCreates++;
                         if (newEntity) {
                             newEntity->markAsChangedOnServer();
+                            journalEntityChange(newEntity->getEntityItemID());
+                            logEntityAdd(newEntity);
                             notifyNewlyCreatedEntity(*newEntity, senderNode);
 
                             startLogging = usecTimestampNow();
@@ -1401,6 +1435,107 @@ void EntityTree::forgetEntitiesDeletedBefore(quint64 sinceTime) {
     }
 }
 
+// the changes of an entity that are kept, so that a node that was sent it before the oldest of them is sent all of it
+static const size_t MAX_ENTITY_CHANGES_KEPT = 16;
+
+// the properties the server keeps in step with its simulation, and may adjust as it applies an edit, are sent with
+// every change - they are small, and the nodes that didn't make the edit may have simulated them on
+static EntityPropertyFlags getPropertiesSentWithChanges() {
+    EntityPropertyFlags properties;
+    properties += PROP_SIMULATION_OWNER;
+    properties += PROP_POSITION;
+    properties += PROP_ROTATION;
+    properties += PROP_DIMENSIONS;
+    properties += PROP_VELOCITY;
+    properties += PROP_ANGULAR_VELOCITY;
+    properties += PROP_ACCELERATION;
+    properties += PROP_PARENT_ID;
+    properties += PROP_PARENT_JOINT_INDEX;
+    properties += PROP_QUERY_AA_CUBE;
+    return properties;
+}
+
+quint64 EntityTree::journalEntityChange(const EntityItemID& entityID) {
+    QWriteLocker locker(&_editJournalLock);
+
+    auto& edits = _entityEdits[entityID];
+    if (edits.lastSequence > 0) {
+        _editJournal.erase(edits.lastSequence);
+    }
+
+    // none of the properties before this change are needed to know what changed after it
+    auto sequence = ++_lastEditSequence;
+    _editJournal.emplace(sequence, entityID);
+    edits.lastSequence = sequence;
+    edits.knownSince = sequence;
+    edits.changes.clear();
+    return sequence;
+}
+
+quint64 EntityTree::journalEntityChange(const EntityItemID& entityID, const EntityPropertyFlags& changedProperties) {
+    static const EntityPropertyFlags PROPERTIES_SENT_WITH_CHANGES = getPropertiesSentWithChanges();
+
+    QWriteLocker locker(&_editJournalLock);
+
+    auto& edits = _entityEdits[entityID];
+    if (edits.lastSequence > 0) {
+        _editJournal.erase(edits.lastSequence);
+    }
+
+    auto sequence = ++_lastEditSequence;
+    _editJournal.emplace(sequence, entityID);
+    edits.lastSequence = sequence;
+    edits.changes.emplace_back(sequence, changedProperties | PROPERTIES_SENT_WITH_CHANGES);
+
+    if (edits.changes.size() > MAX_ENTITY_CHANGES_KEPT) {
+        edits.knownSince = edits.changes.front().first;
+        edits.changes.pop_front();
+    }
+    return sequence;
+}
+
+quint64 EntityTree::getEntityEditSequence(const EntityItemID& entityID) const {
+    QReadLocker locker(&_editJournalLock);
+
+    auto it = _entityEdits.find(entityID);
+    return it != _entityEdits.end() ? it->lastSequence : 0;
+}
+
+bool EntityTree::getEntityPropertiesChangedSince(const EntityItemID& entityID, quint64 sequence,
+                                                 EntityPropertyFlags& changedProperties) const {
+    QReadLocker locker(&_editJournalLock);
+
+    auto it = _entityEdits.find(entityID);
+    if (it == _entityEdits.end() || sequence < it->knownSince) {
+        return false;
+    }
+
+    for (auto& change : it->changes) {
+        if (change.first > sequence) {
+            changedProperties |= change.second;
+        }
+    }
+    return true;
+}
+
+quint64 EntityTree::getEntitiesChangedSince(quint64 sequence, QVector<EntityEditSequence>& changedEntities) const {
+    QReadLocker locker(&_editJournalLock);
+    for (auto it = _editJournal.upper_bound(sequence); it != _editJournal.end(); ++it) {
+        changedEntities.push_back({ it->second, it->first });
+    }
+    return _lastEditSequence;
+}
+
+void EntityTree::removeFromEditJournal(const EntityItemID& entityID) {
+    QWriteLocker locker(&_editJournalLock);
+
+    auto it = _entityEdits.find(entityID);
+    if (it != _entityEdits.end()) {
+        _editJournal.erase(it->lastSequence);
+        _entityEdits.erase(it);
+    }
+}
+
 
 // TODO: consider consolidating processEraseMessageDetails() and processEraseMessage()
 int EntityTree::processEraseMessage(ReceivedMessage& message, const SharedNodePointer& sourceNode) {
@@ -1727,12 +1862,21 @@ bool EntityTree::sendEntitiesOperation(OctreeElementPointer element, void* extra
 
 bool EntityTree::writeToMap(QVariantMap& entityDescription, OctreeElementPointer element, bool skipDefaultValues,
                             bool skipThoseWithBadParents) {
-    if (! entityDescription.contains("Entities")) {
-        entityDescription["Entities"] = QVariantList();
-    }
+    QVariantList entitiesQList = qvariant_cast<QVariantList>(entityDescription["Entities"]);
+
     QScriptEngine scriptEngine;
-    RecurseOctreeToMapOperator theOperator(entityDescription, element, &scriptEngine, skipDefaultValues, skipThoseWithBadParents);
-    recurseTreeWithOperator(&theOperator);
+    auto snapshot = takeSnapshot(element, skipThoseWithBadParents);
+    snapshot->forEachEntity([&](const EntityItemPointer& entity, const EntityItemProperties& properties) {
+        QScriptValue qScriptValues;
+        if (skipDefaultValues) {
+            qScriptValues = EntityItemNonDefaultPropertiesToScriptValue(&scriptEngine, properties);
+        } else {
+            qScriptValues = EntityItemPropertiesToScriptValue(&scriptEngine, properties);
+        }
+        entitiesQList << qScriptValues.toVariant();
+    });
+
+    entityDescription["Entities"] = entitiesQList;
     return true;
 }
 
@@ -1773,6 +1917,403 @@ bool EntityTree::readFromMap(QVariantMap& map) {
     return success;
 }
 
+// A record of a binary file is the entity as it is sent to clients, in packet sized parts that follow each other until
+// what is left doesn't fit in a packet of its own, so that it can be read like the data packets of the version that
+// wrote it. The properties too large for any packet take up the rest of the record, whole.
+static bool encodeEntityBitstreamRecord(const EntityItemID& entityID, const EntityItemProperties& properties,
+                                        QByteArray& record) {
+    // the entity is encoded as it was when the snapshot was taken, rather than as it is now
+    EntityItemPointer entity = EntityTypes::constructEntityItem(properties.getType(), entityID, properties);
+    if (!entity) {
+        return false;
+    }
+    entity->setLastEdited(properties.getLastEdited());
+
+    // the simulation owner is only good for the session it was bid in, so it isn't kept (as in the JSON files), and
+    // avatar entities aren't persisted
+    EncodeBitstreamParams params;
+    EntityPropertyFlags recordedProperties = entity->getEntityProperties(params);
+    recordedProperties -= PROP_SIMULATION_OWNER;
+    recordedProperties -= PROP_CLIENT_ONLY;
+    recordedProperties -= PROP_OWNING_AVATAR_ID;
+
+    EntityTreeElementExtraEncodeDataPointer extraEncodeData { new EntityTreeElementExtraEncodeData() };
+    extraEncodeData->entities.insert(entityID, recordedProperties);
+
+    record.clear();
+    OctreePacketData packetData;
+    OctreeElement::AppendState appendState = OctreeElement::PARTIAL;
+    while (appendState == OctreeElement::PARTIAL) {
+        packetData.reset();
+        appendState = entity->appendEntityData(&packetData, params, extraEncodeData);
+        if (appendState == OctreeElement::NONE) {
+            break;
+        }
+
+        quint16 partSize = (quint16)packetData.getUncompressedSize();
+        record.append(reinterpret_cast<const char*>(&partSize), sizeof(partSize));
+        record.append(reinterpret_cast<const char*>(packetData.getUncompressedData()), partSize);
+    }
+
+    if (record.isEmpty()) {
+        return false;
+    }
+
+    // the properties that are left when none of them fit in a part are those too large for one
+    if (appendState == OctreeElement::NONE) {
+        EntityPropertyFlags largeProperties = extraEncodeData->entities.value(entityID) & recordedProperties;
+        return EntityItemProperties::appendLargeRecordProperties(entityID, properties, largeProperties, record);
+    }
+    return true;
+}
+
+static EntityItemPointer decodeEntityBitstreamRecord(const unsigned char* data, int bytesToRead,
+                                                     PacketVersion bitstreamVersion) {
+    ReadBitstreamToTreeParams args;
+    args.bitstreamVersion = bitstreamVersion;
+
+    EntityItemPointer entity;
+    const unsigned char* dataAt = data;
+    int bytesLeftToRead = bytesToRead;
+    while (bytesLeftToRead > 0) {
+        quint16 partSize;
+        if (bytesLeftToRead < (int)sizeof(partSize)) {
+            return nullptr;
+        }
+        memcpy(&partSize, dataAt, sizeof(partSize));
+        dataAt += sizeof(partSize);
+        bytesLeftToRead -= sizeof(partSize);
+
+        if (EntityItemProperties::isLargeRecordPropertiesMarker(partSize)) {
+            break;
+        }
+        if (partSize > bytesLeftToRead) {
+            return nullptr;
+        }
+
+        if (!entity) {
+            entity = EntityTypes::constructEntityItem(dataAt, partSize, args);
+            if (!entity) {
+                return nullptr;
+            }
+            // a new entity counts as edited when it is made, which would have the parts ignored as older than that
+            entity->setLastEdited(0);
+        }
+
+        // each part sets the properties it has, over the ones set by the parts before it
+        if (entity->readEntityDataFromBuffer(dataAt, partSize, args) <= 0) {
+            return nullptr;
+        }
+        dataAt += partSize;
+        bytesLeftToRead -= partSize;
+    }
+
+    if (!entity) {
+        return nullptr;
+    }
+
+    if (bytesLeftToRead > 0) {
+        EntityItemProperties largeProperties;
+        if (!EntityItemProperties::readLargeRecordProperties(dataAt, bytesLeftToRead, largeProperties)) {
+            return nullptr;
+        }
+
+        // setting them isn't an edit of the entity
+        quint64 lastEdited = entity->getLastEdited();
+        entity->setProperties(largeProperties);
+        entity->setLastEdited(lastEdited);
+    }
+
+    if (entity->getCreated() == UNKNOWN_CREATED_TIME) {
+        entity->recordCreationTime();
+    }
+    return entity;
+}
+
+bool EntityTree::writeToBinaryStream(QIODevice& device, OctreeElementPointer element) {
+    auto snapshot = takeSnapshot(element, true);
+
+    // each record is written as soon as it is encoded, as its size followed by the record
+    QByteArray record;
+    bool succeeded = true;
+    int numEntities = 0;
+    snapshot->forEachEntity([&](const EntityItemPointer& entity, const EntityItemProperties& properties) {
+        if (!succeeded) {
+            return;
+        }
+
+        // a file without the entity mustn't replace the one that has it
+        if (!encodeEntityBitstreamRecord(entity->getEntityItemID(), properties, record)) {
+            qCWarning(entities) << "Could not encode entity" << entity->getEntityItemID() << "to save it";
+            succeeded = false;
+            return;
+        }
+
+        quint32 recordSize = (quint32)record.size();
+        if (device.write(reinterpret_cast<const char*>(&recordSize), sizeof(recordSize)) != sizeof(recordSize)
+            || device.write(record) != record.size()) {
+            succeeded = false;
+            return;
+        }
+
+        ++numEntities;
+    });
+
+    qCDebug(entities) << "Wrote" << numEntities << "entities to binary file," << snapshot->getNumPreserved()
+        << "of them as they were before edits made while writing";
+    return succeeded;
+}
+
+class SnapshotArgs {
+public:
+    bool skipThoseWithBadParents;
+    std::vector<EntityItemPointer> entities;
+};
+
+bool EntityTree::snapshotOperation(OctreeElementPointer element, void* extraData) {
+    SnapshotArgs* args = static_cast<SnapshotArgs*>(extraData);
+    EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
+
+    entityTreeElement->forEachEntity([&](EntityItemPointer entity) {
+        // we weren't able to resolve a parent from _parentID, so don't save this entity.
+        if (!args->skipThoseWithBadParents || entity->isParentIDValid()) {
+            args->entities.push_back(entity);
+        }
+    });
+    return true;
+}
+
+EntityTreeSnapshotPointer EntityTree::takeSnapshot(OctreeElementPointer element, bool skipThoseWithBadParents) {
+    SnapshotArgs args { skipThoseWithBadParents, {} };
+    EntityTreeSnapshotPointer snapshot;
+
+    // the snapshot is registered before the tree is unlocked, so that every edit after it is preserved for it
+    withReadLock([&] {
+        recurseElementWithPostOperation(element ? element : _rootElement, snapshotOperation, &args);
+        snapshot = std::make_shared<EntityTreeSnapshot>(std::move(args.entities));
+
+        std::lock_guard<std::mutex> lock(_snapshotsMutex);
+        _snapshots.push_back(snapshot);
+    });
+
+    return snapshot;
+}
+
+void EntityTree::preserveForSnapshots(const EntityItemPointer& entity) {
+    std::lock_guard<std::mutex> lock(_snapshotsMutex);
+
+    auto it = _snapshots.begin();
+    while (it != _snapshots.end()) {
+        auto snapshot = it->lock();
+        if (snapshot) {
+            snapshot->preserve(entity);
+            ++it;
+        } else {
+            it = _snapshots.erase(it);
+        }
+    }
+}
+
+bool EntityTree::readFromBinaryData(const char* data, qint64 length, PacketVersion version) {
+    // the entities are read like those of data packets, which takes the node list
+    if (!DependencyManager::get<NodeList>()) {
+        qCDebug(entities) << "EntityTree::readFromBinaryData -- can't get NodeList";
+        return false;
+    }
+
+    // find where each record is, which only takes their sizes
+    std::vector<std::pair<const unsigned char*, int>> records;
+    qint64 offset = 0;
+    while (offset < length) {
+        quint32 recordSize;
+        if (length - offset < (qint64)sizeof(recordSize)) {
+            break;
+        }
+        memcpy(&recordSize, data + offset, sizeof(recordSize));
+        offset += sizeof(recordSize);
+
+        if (length - offset < recordSize) {
+            break;
+        }
+        records.emplace_back(reinterpret_cast<const unsigned char*>(data + offset), (int)recordSize);
+        offset += recordSize;
+    }
+
+    bool success = true;
+    if (offset < length) {
+        qCWarning(entities) << "Binary entities file is cut short - reading the" << records.size() << "entities before the cut";
+        success = false;
+    }
+
+    // The records are decoded on every core, a batch at a time so that only one batch of properties is held at once,
+    // then added to the tree in the order they were written. Adding them takes the tree, so it isn't spread out.
+    const int NUM_DECODE_THREADS = std::max(1, (int)std::thread::hardware_concurrency());
+    const int RECORDS_PER_THREAD_PER_BATCH = 256;
+    const int RECORDS_PER_BATCH = NUM_DECODE_THREADS * RECORDS_PER_THREAD_PER_BATCH;
+
+    std::vector<EntityItemPointer> entities(std::min((int)records.size(), RECORDS_PER_BATCH));
+
+    for (int batchStart = 0; batchStart < (int)records.size(); batchStart += RECORDS_PER_BATCH) {
+        int batchSize = std::min((int)records.size() - batchStart, RECORDS_PER_BATCH);
+
+        auto decodeRecords = [&](int first, int count) {
+            for (int i = first; i < first + count; ++i) {
+                auto& record = records[batchStart + i];
+                entities[i] = decodeEntityBitstreamRecord(record.first, record.second, version);
+            }
+        };
+
+        std::vector<std::thread> decodeThreads;
+        int recordsPerThread = (batchSize + NUM_DECODE_THREADS - 1) / NUM_DECODE_THREADS;
+        for (int first = recordsPerThread; first < batchSize; first += recordsPerThread) {
+            decodeThreads.emplace_back(decodeRecords, first, std::min(recordsPerThread, batchSize - first));
+        }
+        decodeRecords(0, std::min(recordsPerThread, batchSize));
+        for (auto& thread : decodeThreads) {
+            thread.join();
+        }
+
+        for (int i = 0; i < batchSize; ++i) {
+            EntityItemPointer entity = std::move(entities[i]);
+            if (!entity) {
+                qCDebug(entities) << "decoding Entity failed for record" << batchStart + i;
+                success = false;
+                continue;
+            }
+
+            if (getContainingElement(entity->getEntityItemID())) {
+                qCDebug(entities) << "adding Entity failed:" << entity->getEntityItemID() << "is already in the tree";
+                success = false;
+                continue;
+            }
+            addConstructedEntity(entity);
+        }
+    }
+
+    qCDebug(entities) << "Read" << records.size() << "entities from binary file";
+    return success;
+}
+
+bool EntityTree::readFromEditLogRecord(const char* data, int size) {
+    if (size < 1) {
+        return false;
+    }
+
+    quint8 recordType = (quint8)data[0];
+    data++;
+    size--;
+
+    if (recordType == EDIT_LOG_ENTITY_DELETED) {
+        if (size != NUM_BYTES_RFC4122_UUID) {
+            return false;
+        }
+        EntityItemID entityID { QUuid::fromRfc4122(QByteArray::fromRawData(data, size)) };
+        if (findEntityByEntityItemID(entityID)) {
+            deleteEntity(entityID, true, true);
+        }
+        return true;
+    }
+
+    if (recordType != EDIT_LOG_ENTITY_EDITED && recordType != EDIT_LOG_ENTITY_ADDED) {
+        return false;
+    }
+
+    EntityItemID entityID;
+    EntityItemProperties properties;
+    if (!EntityItemProperties::decodeEntityRecord(reinterpret_cast<const unsigned char*>(data), size, entityID, properties)) {
+        return false;
+    }
+
+    // an edit record only has what the edit changed, so it can't bring back an entity that isn't there
+    EntityItemPointer entity = findEntityByEntityItemID(entityID);
+    if (!entity) {
+        return recordType == EDIT_LOG_ENTITY_ADDED && addEntity(entityID, properties) != nullptr;
+    }
+
+    EntityTreeElementPointer containingElement = getContainingElement(entityID);
+    if (!containingElement) {
+        return false;
+    }
+
+    // the entity is set to what it was after the edit, which was already allowed when it was made
+    uint32_t preFlags = entity->getDirtyFlags();
+
+    AACube queryCube = properties.queryAACubeChanged() ? properties.getQueryAACube() : entity->getQueryAACube();
+    UpdateEntityOperator theOperator(getThisPointer(), containingElement, entity, queryCube);
+    recurseTreeWithOperator(&theOperator);
+    preserveForSnapshots(entity);
+    entity->setProperties(properties);
+
+    if (!entity->isParentIDValid()) {
+        QWriteLocker locker(&_missingParentLock);
+        _missingParent.append(entity);
+    }
+
+    uint32_t newFlags = entity->getDirtyFlags() & ~preFlags;
+    if (newFlags) {
+        if (_simulation) {
+            if (newFlags & DIRTY_SIMULATION_FLAGS) {
+                _simulation->changeEntity(entity);
+            }
+        } else {
+            entity->clearDirtyFlags();
+        }
+    }
+
+    _isDirty = true;
+    return true;
+}
+
+void EntityTree::logEntityAdd(const EntityItemPointer& entity) {
+    if (!_editLog) {
+        return;
+    }
+
+    QByteArray record;
+    if (!EntityItemProperties::encodeEntityRecord(entity->getEntityItemID(), entity->getProperties(), record)) {
+        qCWarning(entities) << "Could not encode entity" << entity->getEntityItemID() << "for the edit log";
+        return;
+    }
+    record.prepend((char)EDIT_LOG_ENTITY_ADDED);
+
+    _editLog->append(record);
+}
+
+void EntityTree::logEntityEdit(const EntityItemPointer& entity, EntityPropertyFlags changedProperties) {
+    if (!_editLog) {
+        return;
+    }
+
+    // the simulation owner isn't recorded, so an edit of nothing else has nothing to log
+    changedProperties -= PROP_SIMULATION_OWNER;
+    if (changedProperties.isEmpty()) {
+        return;
+    }
+
+    // the changed properties are logged as the entity has them, which leaves out whatever part of the edit it refused
+    QByteArray record;
+    if (!EntityItemProperties::encodeEntityRecord(entity->getEntityItemID(), entity->getProperties(changedProperties),
+                                                  changedProperties, record)) {
+        qCWarning(entities) << "Could not encode the edit of entity" << entity->getEntityItemID() << "for the edit log";
+        return;
+    }
+    record.prepend((char)EDIT_LOG_ENTITY_EDITED);
+
+    _editLog->append(record);
+}
+
+void EntityTree::logEntityDelete(const EntityItemID& entityID) {
+    if (!_editLog) {
+        return;
+    }
+
+    QByteArray record;
+    record.append((char)EDIT_LOG_ENTITY_DELETED);
+    record.append(entityID.toRfc4122());
+
+    _editLog->append(record);
+}
+
 void EntityTree::resetClientEditStats() {
     _treeResetTime = usecTimestampNow();
     _maxEditDelta = 0;
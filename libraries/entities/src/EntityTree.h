@@ -12,6 +12,9 @@
 #ifndef hifi_EntityTree_h
 #define hifi_EntityTree_h
 
+#include <deque>
+#include <map>
+
 #include <QSet>
 #include <QVector>
 
@@ -22,7 +25,9 @@ class EntityTree;
 typedef std::shared_ptr<EntityTree> EntityTreePointer;
 
 
+#include "EntityPayloadCache.h"
 #include "EntityTreeElement.h"
+#include "EntityTreeSnapshot.h"
 #include "DeleteEntityOperator.h"
 
 class EntityEditFilters;
@@ -92,6 +97,7 @@ public:
     // own definition. Implement these to allow your octree based server to support editing
     virtual bool getWantSVOfileVersions() const override { return true; }
     virtual PacketType expectedDataPacketType() const override { return PacketType::EntityData; }
+    virtual PacketType expectedEditLogPacketType() const override { return PacketType::EntityEdit; }
     virtual bool canProcessVersion(PacketVersion thisVersion) const override
                     { return thisVersion >= VERSION_ENTITIES_USE_METERS_AND_RADIANS; }
     virtual bool handlesEditPacketType(PacketType packetType) const override;
@@ -187,6 +193,24 @@ public:
 
     void forgetEntitiesDeletedBefore(quint64 sinceTime);
 
+    // the journal of entity changes on the server - each change gets the next edit sequence, and only the last change
+    // of an entity is kept, so that senders can find the entities changed since a sequence without walking the tree
+    using EntityEditSequence = std::pair<EntityItemID, quint64>;
+    quint64 journalEntityChange(const EntityItemID& entityID); // all of its properties, as when it is added
+    quint64 journalEntityChange(const EntityItemID& entityID, const EntityPropertyFlags& changedProperties);
+    quint64 getEntityEditSequence(const EntityItemID& entityID) const;
+
+    // returns false if the properties changed after the sequence aren't known anymore, so that all of them are sent
+    bool getEntityPropertiesChangedSince(const EntityItemID& entityID, quint64 sequence,
+                                         EntityPropertyFlags& changedProperties) const;
+
+    // returns the last edit sequence, and the entities changed after the given sequence in the order they changed
+    quint64 getEntitiesChangedSince(quint64 sequence, QVector<EntityEditSequence>& changedEntities) const;
+
+    // the payloads of the changed entities, if the server encodes them once for all of the nodes it sends them to
+    void setPayloadCache(EntityPayloadCachePointer payloadCache) { _payloadCache = payloadCache; }
+    EntityPayloadCachePointer getPayloadCache() const { return _payloadCache; }
+
     int processEraseMessage(ReceivedMessage& message, const SharedNodePointer& sourceNode);
     int processEraseMessageDetails(const QByteArray& buffer, const SharedNodePointer& sourceNode);
 
@@ -227,6 +251,12 @@ public:
     virtual bool writeToMap(QVariantMap& entityDescription, OctreeElementPointer element, bool skipDefaultValues,
                             bool skipThoseWithBadParents) override;
     virtual bool readFromMap(QVariantMap& entityDescription) override;
+    virtual bool writeToBinaryStream(QIODevice& device, OctreeElementPointer element) override;
+    virtual bool readFromBinaryData(const char* data, qint64 length, PacketVersion version) override;
+    virtual bool readFromEditLogRecord(const char* data, int size) override;
+
+    // lists the entities under the element, for them to be read as they are now without holding the lock of the tree
+    EntityTreeSnapshotPointer takeSnapshot(OctreeElementPointer element, bool skipThoseWithBadParents);
 
     glm::vec3 getContentsDimensions();
     float getContentsLargestDimension();
@@ -290,6 +320,7 @@ signals:
 protected:
 
     void processRemovedEntities(const DeleteEntityOperator& theOperator);
+    void addConstructedEntity(const EntityItemPointer& entity); // stores an entity that isn't in the tree yet
     bool updateEntityWithElement(EntityItemPointer entity, const EntityItemProperties& properties,
                                  EntityTreeElementPointer containingElement,
                                  const SharedNodePointer& senderNode = SharedNodePointer(nullptr));
@@ -299,10 +330,19 @@ protected:
     static bool findInBoxOperation(OctreeElementPointer element, void* extraData);
     static bool findInFrustumOperation(OctreeElementPointer element, void* extraData);
     static bool sendEntitiesOperation(OctreeElementPointer element, void* extraData);
+    static bool snapshotOperation(OctreeElementPointer element, void* extraData);
     static void bumpTimestamp(EntityItemProperties& properties);
 
     void notifyNewlyCreatedEntity(const EntityItem& newEntity, const SharedNodePointer& senderNode);
 
+    // an add is logged as the whole entity, and an edit as only the properties it changed
+    void logEntityAdd(const EntityItemPointer& entity);
+    void logEntityEdit(const EntityItemPointer& entity, EntityPropertyFlags changedProperties);
+    void logEntityDelete(const EntityItemID& entityID);
+
+    // must be called before an entity is edited, with the tree write locked
+    void preserveForSnapshots(const EntityItemPointer& entity);
+
     bool isScriptInWhitelist(const QString& scriptURL);
     
     QReadWriteLock _newlyCreatedHooksLock;
@@ -358,6 +398,23 @@ protected:
     QVector<EntityItemWeakPointer> _missingParent; // entites with a parentID but no (yet) known parent instance
     mutable QReadWriteLock _missingParentLock;
 
+    std::mutex _snapshotsMutex;
+    std::vector<std::weak_ptr<EntityTreeSnapshot>> _snapshots; // the snapshots that are still being read
+
+    struct EntityEdits {
+        quint64 lastSequence { 0 };
+        quint64 knownSince { 0 }; // the properties changed after this sequence are all in the changes
+        std::deque<std::pair<quint64, EntityPropertyFlags>> changes; // the last few, oldest first
+    };
+
+    void removeFromEditJournal(const EntityItemID& entityID);
+    mutable QReadWriteLock _editJournalLock;
+    quint64 _lastEditSequence { 0 };
+    std::map<quint64, EntityItemID> _editJournal; // the last change of each entity, by its sequence
+    QHash<EntityItemID, EntityEdits> _entityEdits;
+
+    EntityPayloadCachePointer _payloadCache;
+
     // we maintain a list of avatarIDs to notice when an entity is a child of one.
     QSet<QUuid> _avatarIDs; // IDs of avatars connected to entity server
     QHash<QUuid, QSet<EntityItemID>> _childrenOfAvatars;  // which entities are children of which avatars
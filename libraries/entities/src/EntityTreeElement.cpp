@@ -91,7 +91,19 @@ void EntityTreeElement::initializeExtraEncodeData(EncodeBitstreamParams& params)
             }
         }
         forEachEntity([&](EntityItemPointer entity) {
-            entityTreeElementExtraEncodeData->entities.insert(entity->getEntityItemID(), entity->getEntityProperties(params));
+            EntityPropertyFlags requestedProperties = entity->getEntityProperties(params);
+
+            // a node that was sent the entity before is only sent the properties that changed since
+            quint64 sentEditSequence;
+            EntityPropertyFlags changedProperties;
+            if (!params.forceSendScene && _myTree
+                && entityNodeData->getSentEntitySequence(entity->getID(), sentEditSequence)
+                && _myTree->getEntityPropertiesChangedSince(entity->getEntityItemID(), sentEditSequence,
+                                                            changedProperties)) {
+                requestedProperties &= changedProperties;
+            }
+
+            entityTreeElementExtraEncodeData->entities.insert(entity->getEntityItemID(), requestedProperties);
         });
 
         // TODO: some of these inserts might be redundant!!!
@@ -288,7 +300,19 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
             }
         }
         forEachEntity([&](EntityItemPointer entity) {
-            entityTreeElementExtraEncodeData->entities.insert(entity->getEntityItemID(), entity->getEntityProperties(params));
+            EntityPropertyFlags requestedProperties = entity->getEntityProperties(params);
+
+            // a node that was sent the entity before is only sent the properties that changed since
+            quint64 sentEditSequence;
+            EntityPropertyFlags changedProperties;
+            if (!params.forceSendScene && _myTree
+                && entityNodeData->getSentEntitySequence(entity->getID(), sentEditSequence)
+                && _myTree->getEntityPropertiesChangedSince(entity->getEntityItemID(), sentEditSequence,
+                                                            changedProperties)) {
+                requestedProperties &= changedProperties;
+            }
+
+            entityTreeElementExtraEncodeData->entities.insert(entity->getEntityItemID(), requestedProperties);
         });
     }
 
@@ -324,6 +348,12 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
                     includeThisEntity = false;
                 }
 
+                // the change times are fudged to be safe, so also skip the entities this node was sent since their last edit
+                if (includeThisEntity && !params.forceSendScene && _myTree &&
+                    entityNodeData->hasSentEntity(entity->getID(), _myTree->getEntityEditSequence(entity->getEntityItemID()))) {
+                    includeThisEntity = false;
+                }
+
                 // if this entity has been updated since our last full send and there are json filters, check them
                 if (includeThisEntity && !jsonFilters.isEmpty()) {
 
@@ -416,11 +446,30 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
         bool successAppendEntityCount = packetData->appendValue(numberOfEntities);
 
         if (successAppendEntityCount) {
+            auto payloadCache = _myTree ? _myTree->getPayloadCache() : EntityPayloadCachePointer();
+
             foreach(uint16_t i, indexesOfEntitiesToInclude) {
                 EntityItemPointer entity = _entityItems[i];
                 LevelDetails entityLevel = packetData->startLevel();
-                OctreeElement::AppendState appendEntityState = entity->appendEntityData(packetData,
-                    params, entityTreeElementExtraEncodeData);
+                OctreeElement::AppendState appendEntityState = OctreeElement::NONE;
+
+                // if the server already encoded all of this entity for every node, then the payload is copied in
+                QByteArray payload;
+                EntityPropertyFlags allProperties = entity->getEntityProperties(params);
+                bool wantsAllProperties =
+                    entityTreeElementExtraEncodeData->entities.value(entity->getEntityItemID(), allProperties) == allProperties;
+                if (payloadCache && wantsAllProperties &&
+                    payloadCache->getPayload(entity, _myTree->getEntityEditSequence(entity->getEntityItemID()), payload)
+                    && packetData->appendRawData(payload)) {
+                    appendEntityState = OctreeElement::COMPLETED;
+                    params.trackSend(entity->getID(), entity->getLastEdited());
+                    payloadCache->trackReused();
+                } else {
+                    appendEntityState = entity->appendEntityData(packetData, params, entityTreeElementExtraEncodeData);
+                    if (payloadCache) {
+                        payloadCache->trackMissed();
+                    }
+                }
 
                 // If none of this entity data was able to be appended, then discard it
                 // and don't include it in our entity count
@@ -436,6 +485,10 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
                 // If the entity item got completely appended, then we can remove it from the extra encode data
                 if (appendEntityState == OctreeElement::COMPLETED) {
                     entityTreeElementExtraEncodeData->entities.remove(entity->getEntityItemID());
+                    if (_myTree) {
+                        auto editSequence = _myTree->getEntityEditSequence(entity->getEntityItemID());
+                        entityNodeData->setSentEntity(entity->getID(), editSequence);
+                    }
                 }
 
                 // If any part of the entity items didn't fit, then the element is considered partial
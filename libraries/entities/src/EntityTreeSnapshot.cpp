@@ -0,0 +1,59 @@
+//
+//  EntityTreeSnapshot.cpp
+//  libraries/entities/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityTreeSnapshot.h"
+
+EntityTreeSnapshot::EntityTreeSnapshot(std::vector<EntityItemPointer> entities) :
+    _entities(std::move(entities))
+{
+    _indices.reserve(_entities.size());
+    for (size_t i = 0; i < _entities.size(); ++i) {
+        _indices.emplace(_entities[i].get(), i);
+    }
+}
+
+int EntityTreeSnapshot::getNumPreserved() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _numPreserved;
+}
+
+void EntityTreeSnapshot::forEachEntity(const EntityOperator& entityOperator) {
+    for (size_t i = 0; i < _entities.size(); ++i) {
+        EntityItemProperties properties;
+
+        {
+            // the entity isn't edited while it is read, since the tree has to preserve it first
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            auto preserved = _preserved.find(i);
+            if (preserved != _preserved.end()) {
+                properties = std::move(preserved->second);
+                _preserved.erase(preserved);
+            } else {
+                properties = _entities[i]->getProperties();
+            }
+            _numRead = i + 1;
+        }
+
+        entityOperator(_entities[i], properties);
+    }
+}
+
+void EntityTreeSnapshot::preserve(const EntityItemPointer& entity) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto index = _indices.find(entity.get());
+    if (index == _indices.end() || index->second < _numRead || _preserved.count(index->second) > 0) {
+        return;
+    }
+
+    _preserved.emplace(index->second, entity->getProperties());
+    ++_numPreserved;
+}
@@ -0,0 +1,53 @@
+//
+//  EntityTreeSnapshot.h
+//  libraries/entities/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityTreeSnapshot_h
+#define hifi_EntityTreeSnapshot_h
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "EntityItem.h"
+#include "EntityItemProperties.h"
+
+// The entities of a tree as they were when the snapshot was taken, read without holding the lock of the tree
+//   The entities are listed while the tree is read locked, which only takes a walk of its elements. Before the tree
+//   edits an entity that is in a snapshot and hasn't been read from it yet, it has the snapshot preserve the
+//   properties of the entity, so that the ones read are those the entity had when the snapshot was taken.
+class EntityTreeSnapshot {
+public:
+    using EntityOperator = std::function<void(const EntityItemPointer& entity, const EntityItemProperties& properties)>;
+
+    EntityTreeSnapshot(std::vector<EntityItemPointer> entities);
+
+    size_t getNumEntities() const { return _entities.size(); }
+    int getNumPreserved() const;
+
+    // reads the entities in the order they were listed
+    void forEachEntity(const EntityOperator& entityOperator);
+
+    // called by the tree before it edits the entity
+    void preserve(const EntityItemPointer& entity);
+
+private:
+    mutable std::mutex _mutex;
+    std::vector<EntityItemPointer> _entities;
+    std::unordered_map<const EntityItem*, size_t> _indices;
+    size_t _numRead { 0 };
+    std::unordered_map<size_t, EntityItemProperties> _preserved;
+    int _numPreserved { 0 };
+};
+
+using EntityTreeSnapshotPointer = std::shared_ptr<EntityTreeSnapshot>;
+
+#endif // hifi_EntityTreeSnapshot_h
@@ -43,6 +43,7 @@ AssetClient::AssetClient() {
     packetReceiver.registerListener(PacketType::AssetGetInfoReply, this, "handleAssetGetInfoReply");
     packetReceiver.registerListener(PacketType::AssetGetReply, this, "handleAssetGetReply", true);
     packetReceiver.registerListener(PacketType::AssetUploadReply, this, "handleAssetUploadReply");
+    packetReceiver.registerListener(PacketType::AssetChunkQueryReply, this, "handleAssetChunkQueryReply");
 
     connect(nodeList.data(), &LimitedNodeList::nodeKilled, this, &AssetClient::handleNodeKilled);
     connect(nodeList.data(), &LimitedNodeList::clientConnectionToNodeReset,
@@ -629,9 +630,24 @@ bool AssetClient::cancelUploadAssetRequest(MessageID id) {
             return true;
         }
     }
+    for (auto& kv : _pendingChunkQueries) {
+        if (kv.second.erase(id)) {
+            return true;
+        }
+    }
     return false;
 }
 
+static void writeAssetChunkIndex(NLPacketList& packetList, uint64_t size, const AssetChunkList& chunks) {
+    packetList.writePrimitive(size);
+    packetList.writePrimitive(uint32_t(chunks.size()));
+
+    for (auto& chunk : chunks) {
+        packetList.write(chunk.hash);
+        packetList.writePrimitive(uint32_t(chunk.size));
+    }
+}
+
 MessageID AssetClient::uploadAsset(const QByteArray& data, UploadResultCallback callback) {
     Q_ASSERT(QThread::currentThread() == thread());
 
@@ -639,17 +655,17 @@ MessageID AssetClient::uploadAsset(const QByteArray& data, UploadResultCallback
     SharedNodePointer assetServer = nodeList->soloNodeOfType(NodeType::AssetServer);
     
     if (assetServer) {
-        auto packetList = NLPacketList::create(PacketType::AssetUpload, QByteArray(), true, true);
+        // ask the asset server which chunks of the asset it is missing, and only send those once it answers
+        auto packetList = NLPacketList::create(PacketType::AssetChunkQuery, QByteArray(), true, true);
 
         auto messageID = ++_currentID;
         packetList->writePrimitive(messageID);
 
-        uint64_t size = data.length();
-        packetList->writePrimitive(size);
-        packetList->write(data.constData(), size);
+        auto chunks = chunkAssetData(data);
+        writeAssetChunkIndex(*packetList, data.length(), chunks);
 
         if (nodeList->sendPacketList(std::move(packetList), *assetServer) != -1) {
-            _pendingUploads[assetServer][messageID] = callback;
+            _pendingChunkQueries[assetServer][messageID] = { data, std::move(chunks), callback };
 
             return messageID;
         }
@@ -659,6 +675,79 @@ MessageID AssetClient::uploadAsset(const QByteArray& data, UploadResultCallback
     return INVALID_MESSAGE_ID;
 }
 
+void AssetClient::handleAssetChunkQueryReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    MessageID messageID;
+    message->readPrimitive(&messageID);
+
+    AssetServerError error;
+    message->readPrimitive(&error);
+
+    // Check if we have any pending requests for this node
+    auto messageMapIt = _pendingChunkQueries.find(senderNode);
+    if (messageMapIt == _pendingChunkQueries.end()) {
+        return;
+    }
+
+    // Found the node, get the MessageID -> upload map
+    auto& messageUploadMap = messageMapIt->second;
+
+    // Check if we have this pending request
+    auto requestIt = messageUploadMap.find(messageID);
+    if (requestIt == messageUploadMap.end()) {
+        return;
+    }
+
+    auto upload = std::move(requestIt->second);
+    messageUploadMap.erase(requestIt);
+
+    if (error) {
+        qCWarning(asset_client) << "Error uploading file to asset server";
+        upload.callback(true, error, QString());
+        return;
+    }
+
+    uint32_t numMissingChunks;
+    message->readPrimitive(&numMissingChunks);
+
+    std::vector<uint32_t> missingChunks;
+    missingChunks.reserve(numMissingChunks);
+
+    for (uint32_t i = 0; i < numMissingChunks; ++i) {
+        uint32_t chunkIndex;
+        message->readPrimitive(&chunkIndex);
+
+        if (chunkIndex < upload.chunks.size()) {
+            missingChunks.push_back(chunkIndex);
+        }
+    }
+
+    qCDebug(asset_client) << "Uploading" << missingChunks.size() << "of" << upload.chunks.size()
+        << "chunks of asset to asset-server";
+
+    // the index goes along with the chunks, so that the asset server doesn't keep anything between the two messages
+    auto packetList = NLPacketList::create(PacketType::AssetChunkUpload, QByteArray(), true, true);
+    packetList->writePrimitive(messageID);
+    writeAssetChunkIndex(*packetList, upload.data.length(), upload.chunks);
+
+    packetList->writePrimitive(uint32_t(missingChunks.size()));
+    for (auto chunkIndex : missingChunks) {
+        packetList->writePrimitive(chunkIndex);
+    }
+    for (auto chunkIndex : missingChunks) {
+        auto& chunk = upload.chunks[chunkIndex];
+        packetList->write(upload.data.constData() + chunk.offset, chunk.size);
+    }
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    if (nodeList->sendPacketList(std::move(packetList), *senderNode) != -1) {
+        _pendingUploads[senderNode][messageID] = upload.callback;
+    } else {
+        upload.callback(false, AssetServerError::NoError, QString());
+    }
+}
+
 void AssetClient::handleAssetUploadReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
     Q_ASSERT(QThread::currentThread() == thread());
 
@@ -717,6 +806,16 @@ void AssetClient::handleNodeKilled(SharedNodePointer node) {
             messageMapIt->second.clear();
         }
     }
+
+    {
+        auto messageMapIt = _pendingChunkQueries.find(node);
+        if (messageMapIt != _pendingChunkQueries.end()) {
+            for (const auto& value : messageMapIt->second) {
+                value.second.callback(false, AssetServerError::NoError, "");
+            }
+            messageMapIt->second.clear();
+        }
+    }
 }
 
 void AssetClient::handleNodeClientConnectionReset(SharedNodePointer node) {
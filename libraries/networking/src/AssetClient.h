@@ -71,6 +71,7 @@ private slots:
     void handleAssetGetInfoReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleAssetGetReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleAssetUploadReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
+    void handleAssetChunkQueryReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
 
     void handleNodeKilled(SharedNodePointer node);
     void handleNodeClientConnectionReset(SharedNodePointer node);
@@ -97,6 +98,13 @@ private:
 
     void forceFailureOfPendingRequests(SharedNodePointer node);
 
+    // an upload waiting to hear which of its chunks the asset server is missing
+    struct ChunkedUploadData {
+        QByteArray data;
+        AssetChunkList chunks;
+        UploadResultCallback callback;
+    };
+
     struct GetAssetRequestData {
         QSharedPointer<ReceivedMessage> message;
         ReceivedAssetCallback completeCallback;
@@ -108,6 +116,7 @@ private:
     std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, GetAssetRequestData>> _pendingRequests;
     std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, GetInfoCallback>> _pendingInfoRequests;
     std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, UploadResultCallback>> _pendingUploads;
+    std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, ChunkedUploadData>> _pendingChunkQueries;
 
     friend class AssetRequest;
     friend class AssetUpload;
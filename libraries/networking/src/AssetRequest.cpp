@@ -12,8 +12,14 @@
 #include "AssetRequest.h"
 
 #include <algorithm>
+#include <cmath>
 
+#include <QtCore/QDataStream>
 #include <QtCore/QThread>
+#include <QtCore/QTimer>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
 
 #include "AssetClient.h"
 #include "NetworkLogging.h"
@@ -21,8 +27,34 @@
 #include "ResourceCache.h"
 #include <Trace.h>
 
+const qint64 AssetRequest::CHUNK_SIZE = 1024 * 1024;
+const int AssetRequest::MIN_CONCURRENT_CHUNKS = 2;
+const int AssetRequest::MAX_CONCURRENT_CHUNKS = 8;
+
 static int requestID = 0;
 
+static const int MAX_RESUME_ATTEMPTS = 5;
+static const int RESUME_DELAY_MSECS = 500; // doubled with each attempt
+
+static const QString PARTIAL_DOWNLOAD_QUERY = "partial";
+
+static QUrl getPartialDownloadUrl(const QString& hash) {
+    auto url = getATPUrl(hash);
+    url.setQuery(PARTIAL_DOWNLOAD_QUERY);
+    return url;
+}
+
+static AssetRequest::Error errorForServerError(AssetServerError serverError) {
+    switch (serverError) {
+        case AssetServerError::AssetNotFound:
+            return AssetRequest::NotFound;
+        case AssetServerError::InvalidByteRange:
+            return AssetRequest::InvalidByteRange;
+        default:
+            return AssetRequest::UnknownError;
+    }
+}
+
 AssetRequest::AssetRequest(const QString& hash, const ByteRange& byteRange) :
     _requestID(++requestID),
     _hash(hash),
@@ -36,6 +68,19 @@ AssetRequest::~AssetRequest() {
     if (_assetRequestID) {
         assetClient->cancelGetAssetRequest(_assetRequestID);
     }
+
+    if (_state == WaitingForData && !_chunks.empty()) {
+        // keep what was downloaded for whoever asks for this asset next
+        savePartialDownload();
+        cancelPendingRequests();
+    }
+}
+
+int AssetRequest::computeConcurrentChunks(double bytesPerSecond, quint64 rttUsecs) {
+    double bytesInFlight = bytesPerSecond * rttUsecs / USECS_PER_SECOND;
+    int numChunks = (int)std::ceil(bytesInFlight / CHUNK_SIZE) + 1;
+
+    return std::max(MIN_CONCURRENT_CHUNKS, std::min(numChunks, MAX_CONCURRENT_CHUNKS));
 }
 
 void AssetRequest::start() {
@@ -70,6 +115,14 @@ void AssetRequest::start() {
 
     _state = WaitingForData;
 
+    if (_byteRange.isSet()) {
+        startSingleRequest();
+    } else {
+        startChunkedDownload();
+    }
+}
+
+void AssetRequest::startSingleRequest() {
     auto assetClient = DependencyManager::get<AssetClient>();
     auto that = QPointer<AssetRequest>(this); // Used to track the request's lifetime
     auto hash = _hash;
@@ -134,3 +187,423 @@ void AssetRequest::start() {
         emit progress(totalReceived, total);
     });
 }
+
+void AssetRequest::startChunkedDownload() {
+    _downloadStartTime = usecTimestampNow();
+
+    // the size of the asset isn't known until the asset server tells us, but its last chunk can be asked for
+    // right away as a range back from the end - which also covers the whole of any asset no larger than a chunk
+    _chunks.emplace_back(-CHUNK_SIZE, CHUNK_SIZE);
+
+    requestAssetInfo();
+    requestChunk(0);
+}
+
+void AssetRequest::requestAssetInfo() {
+    auto assetClient = DependencyManager::get<AssetClient>();
+    auto that = QPointer<AssetRequest>(this); // Used to track the request's lifetime
+
+    _assetInfoRequestID = assetClient->getAssetInfo(_hash,
+        [this, that](bool responseReceived, AssetServerError serverError, AssetInfo info) {
+
+        if (!that) {
+            // If the request is dead, return
+            return;
+        }
+        handleAssetInfo(responseReceived, serverError, info.size);
+    });
+}
+
+void AssetRequest::handleAssetInfo(bool responseReceived, AssetServerError serverError, qint64 assetSize) {
+    _assetInfoRequestID = INVALID_MESSAGE_ID;
+
+    if (_state == Finished || _assetSize >= 0) {
+        // the first chunk was the whole asset
+        return;
+    }
+
+    if (!responseReceived) {
+        scheduleResume();
+    } else if (serverError != AssetServerError::NoError) {
+        finishChunkedDownload(errorForServerError(serverError));
+    } else {
+        layoutChunks(assetSize);
+        checkIfComplete();
+    }
+}
+
+void AssetRequest::layoutChunks(qint64 assetSize) {
+    auto assetClient = DependencyManager::get<AssetClient>();
+    if (_assetInfoRequestID != INVALID_MESSAGE_ID) {
+        assetClient->cancelGetAssetInfoRequest(_assetInfoRequestID);
+        _assetInfoRequestID = INVALID_MESSAGE_ID;
+    }
+
+    _assetSize = assetSize;
+    _data = QByteArray((int)assetSize, Qt::Uninitialized);
+
+    // the chunk requested before the size was known becomes the last chunk of the asset
+    auto lastChunk = _chunks.front();
+    _chunks.clear();
+
+    for (auto& range : layoutChunkRanges(assetSize)) {
+        _chunks.emplace_back(range.fromInclusive, range.size());
+    }
+
+    auto& chunk = _chunks.front();
+    chunk.messageID = lastChunk.messageID;
+    chunk.requestTime = lastChunk.requestTime;
+    chunk.received = std::min(lastChunk.received, chunk.size);
+
+    if (!_tailData.isNull()) {
+        storeChunk(chunk, _tailData);
+        _tailData = QByteArray();
+    }
+
+    if (_chunks.size() > 1) {
+        loadPartialDownload();
+    }
+}
+
+std::vector<ByteRange> AssetRequest::layoutChunkRanges(qint64 assetSize) {
+    std::vector<ByteRange> ranges;
+    for (qint64 end = assetSize; end > 0 || ranges.empty(); end -= CHUNK_SIZE) {
+        ByteRange range;
+        range.fromInclusive = std::max(end - CHUNK_SIZE, (qint64)0);
+        range.toExclusive = std::max(end, (qint64)0);
+        ranges.push_back(range);
+    }
+    return ranges;
+}
+
+void AssetRequest::requestChunks() {
+    int numRequested = (int)std::count_if(_chunks.begin(), _chunks.end(), [](const Chunk& chunk) {
+        return chunk.messageID != INVALID_MESSAGE_ID;
+    });
+
+    for (int i = 0; i < (int)_chunks.size() && numRequested < _numConcurrentChunks; ++i) {
+        if (_state == Finished || _isResumeScheduled) {
+            // a request failed right away
+            return;
+        }
+
+        if (!_chunks[i].isComplete && _chunks[i].messageID == INVALID_MESSAGE_ID) {
+            requestChunk(i);
+            ++numRequested;
+        }
+    }
+}
+
+void AssetRequest::requestChunk(int chunkIndex) {
+    auto assetClient = DependencyManager::get<AssetClient>();
+    auto that = QPointer<AssetRequest>(this); // Used to track the request's lifetime
+
+    auto& chunk = _chunks[chunkIndex];
+    chunk.received = 0;
+    chunk.requestTime = usecTimestampNow();
+
+    DataOffset start = chunk.offset;
+    DataOffset end = chunk.offset < 0 ? 0 : chunk.offset + chunk.size;
+
+    // the callback is called right away when the request can't be sent, so the chunk is only looked up afterwards
+    auto messageID = assetClient->getAsset(_hash, start, end,
+        [this, that, chunkIndex](bool responseReceived, AssetServerError serverError, const QByteArray& data) {
+
+        if (!that) {
+            // If the request is dead, return
+            return;
+        }
+        handleChunkReply(chunkIndex, responseReceived, serverError, data);
+    }, [this, that, chunkIndex](qint64 totalReceived, qint64 total) {
+        if (!that) {
+            // If the request is dead, return
+            return;
+        }
+        handleChunkProgress(chunkIndex, totalReceived);
+    });
+
+    _chunks[chunkIndex].messageID = messageID;
+}
+
+void AssetRequest::handleChunkProgress(int chunkIndex, qint64 received) {
+    auto& chunk = _chunks[chunkIndex];
+
+    if (chunk.received == 0) {
+        // the time to the first bytes of a chunk is the round trip, plus however long the asset server took to
+        // read it - the quickest of them is the closest to the round trip alone
+        auto rtt = usecTimestampNow() - chunk.requestTime;
+        _minRTT = _minRTT == 0 ? rtt : std::min(_minRTT, rtt);
+    }
+
+    // the size of the message includes the header of the reply
+    chunk.received = std::min(received, chunk.size);
+
+    emit chunkProgress(chunkIndex, chunk.received, chunk.size);
+    emitProgress();
+}
+
+void AssetRequest::handleChunkReply(int chunkIndex, bool responseReceived, AssetServerError serverError,
+                                    const QByteArray& data) {
+    _chunks[chunkIndex].messageID = INVALID_MESSAGE_ID;
+
+    if (_state == Finished) {
+        return;
+    }
+
+    if (!responseReceived) {
+        _chunks[chunkIndex].received = 0;
+        scheduleResume();
+        return;
+    }
+
+    if (serverError != AssetServerError::NoError) {
+        finishChunkedDownload(errorForServerError(serverError));
+        return;
+    }
+
+    if (_assetSize < 0) {
+        if (data.size() < CHUNK_SIZE) {
+            // a range back from the end larger than the asset is the whole asset
+            layoutChunks(data.size());
+        } else {
+            // keep the last chunk until the asset info says where it goes
+            _tailData = data;
+            return;
+        }
+    }
+
+    auto& chunk = _chunks[chunkIndex];
+    if (chunk.isComplete) {
+        // this chunk was in a partial download loaded after it was requested
+        checkIfComplete();
+        return;
+    }
+
+    if (data.size() != chunk.size) {
+        finishChunkedDownload(SizeVerificationFailed);
+        return;
+    }
+
+    storeChunk(chunk, data);
+    _numBytesDownloaded += chunk.size;
+    _numResumeAttempts = 0;
+
+    if (_minRTT > 0) {
+        auto elapsed = usecTimestampNow() - _downloadStartTime;
+        double bytesPerSecond = (double)_numBytesDownloaded * USECS_PER_SECOND / std::max(elapsed, (quint64)1);
+        _numConcurrentChunks = computeConcurrentChunks(bytesPerSecond, _minRTT);
+    }
+
+    emit chunkProgress(chunkIndex, chunk.size, chunk.size);
+    emitProgress();
+
+    checkIfComplete();
+}
+
+void AssetRequest::storeChunk(Chunk& chunk, const QByteArray& data) {
+    memcpy(_data.data() + chunk.offset, data.constData(), chunk.size);
+
+    chunk.isComplete = true;
+    chunk.received = chunk.size;
+    _numBytesComplete += chunk.size;
+}
+
+void AssetRequest::checkIfComplete() {
+    if (_state == Finished || _assetSize < 0) {
+        return;
+    }
+
+    if (_numBytesComplete == _assetSize) {
+        finishChunkedDownload(NoError);
+    } else {
+        requestChunks();
+    }
+}
+
+void AssetRequest::emitProgress() {
+    qint64 totalReceived = _numBytesComplete;
+    for (auto& chunk : _chunks) {
+        if (!chunk.isComplete) {
+            totalReceived += chunk.received;
+        }
+    }
+
+    emit progress(totalReceived, _assetSize >= 0 ? _assetSize : _chunks.front().size);
+}
+
+void AssetRequest::scheduleResume() {
+    if (_state == Finished || _isResumeScheduled) {
+        return;
+    }
+
+    if (_numResumeAttempts >= MAX_RESUME_ATTEMPTS) {
+        finishChunkedDownload(NetworkError);
+        return;
+    }
+
+    // every pending request fails at once on a disconnect, from within AssetClient, so wait for the asset
+    // server to come back before asking again
+    int delay = RESUME_DELAY_MSECS << _numResumeAttempts;
+    ++_numResumeAttempts;
+    _isResumeScheduled = true;
+
+    qCDebug(asset_client) << "Resuming download of" << _hash << "in" << delay << "ms with"
+        << _numBytesComplete << "bytes received";
+
+    QTimer::singleShot(delay, this, &AssetRequest::resume);
+}
+
+void AssetRequest::resume() {
+    _isResumeScheduled = false;
+
+    if (_state == Finished) {
+        return;
+    }
+
+    if (_assetSize >= 0) {
+        requestChunks();
+        return;
+    }
+
+    if (_assetInfoRequestID == INVALID_MESSAGE_ID) {
+        requestAssetInfo();
+    }
+    if (_state != Finished && !_isResumeScheduled && _chunks.front().messageID == INVALID_MESSAGE_ID
+        && _tailData.isNull()) {
+        requestChunk(0);
+    }
+}
+
+void AssetRequest::cancelPendingRequests() {
+    auto assetClient = DependencyManager::get<AssetClient>();
+
+    if (_assetInfoRequestID != INVALID_MESSAGE_ID) {
+        assetClient->cancelGetAssetInfoRequest(_assetInfoRequestID);
+        _assetInfoRequestID = INVALID_MESSAGE_ID;
+    }
+
+    for (auto& chunk : _chunks) {
+        if (chunk.messageID != INVALID_MESSAGE_ID) {
+            assetClient->cancelGetAssetRequest(chunk.messageID);
+            chunk.messageID = INVALID_MESSAGE_ID;
+        }
+    }
+}
+
+void AssetRequest::finishChunkedDownload(Error error) {
+    cancelPendingRequests();
+
+    if (error == NoError && hashData(_data).toHex() != _hash) {
+        // the hash of the received data does not match what we expect, so we return an error
+        error = HashVerificationFailed;
+    }
+
+    if (error == NoError) {
+        saveToCache(getUrl(), _data);
+    } else {
+        if (error == NetworkError) {
+            savePartialDownload();
+        }
+        _data = QByteArray();
+
+        qCWarning(asset_client) << "Got error retrieving asset" << _hash << "- error code" << error;
+    }
+
+    _error = error;
+    _state = Finished;
+    emit finished(this);
+}
+
+QByteArray AssetRequest::writePartialDownload(qint64 assetSize, const ChunkData& chunks) {
+    QByteArray partialDownload;
+    QDataStream stream(&partialDownload, QIODevice::WriteOnly);
+
+    stream << assetSize << CHUNK_SIZE << (int)chunks.size();
+    for (auto& chunk : chunks) {
+        stream << chunk.first << chunk.second;
+    }
+    return partialDownload;
+}
+
+bool AssetRequest::readPartialDownload(const QByteArray& partialDownload, qint64 assetSize, ChunkData& chunks) {
+    QDataStream stream(partialDownload);
+    qint64 partialAssetSize;
+    qint64 chunkSize;
+    int numChunks;
+    stream >> partialAssetSize >> chunkSize >> numChunks;
+
+    if (stream.status() != QDataStream::Ok || partialAssetSize != assetSize || chunkSize != CHUNK_SIZE) {
+        return false;
+    }
+
+    for (int i = 0; i < numChunks; ++i) {
+        qint64 offset;
+        QByteArray data;
+        stream >> offset >> data;
+
+        if (stream.status() != QDataStream::Ok || offset < 0 || offset + data.size() > assetSize) {
+            break;
+        }
+        chunks[offset] = data;
+    }
+    return true;
+}
+
+void AssetRequest::loadPartialDownload() {
+    auto url = getPartialDownloadUrl(_hash);
+    auto partialDownload = loadFromCache(url);
+    if (partialDownload.isNull()) {
+        return;
+    }
+
+    // whatever happens now, the partial download is saved again if this request doesn't finish either
+    removeFromCache(url);
+
+    ChunkData partialChunks;
+    if (!readPartialDownload(partialDownload, _assetSize, partialChunks)) {
+        return;
+    }
+
+    auto assetClient = DependencyManager::get<AssetClient>();
+    for (auto& partialChunk : partialChunks) {
+        qint64 offset = partialChunk.first;
+        auto& data = partialChunk.second;
+
+        // the chunks end CHUNK_SIZE bytes apart, back from the end of the asset
+        qint64 chunkIndex = (_assetSize - (offset + data.size())) / CHUNK_SIZE;
+        if (chunkIndex < 0 || chunkIndex >= (qint64)_chunks.size()) {
+            continue;
+        }
+
+        auto& chunk = _chunks[chunkIndex];
+        if (chunk.isComplete || chunk.offset != offset || chunk.size != data.size()) {
+            continue;
+        }
+
+        if (chunk.messageID != INVALID_MESSAGE_ID) {
+            assetClient->cancelGetAssetRequest(chunk.messageID);
+            chunk.messageID = INVALID_MESSAGE_ID;
+        }
+        storeChunk(chunk, data);
+    }
+
+    qCDebug(asset_client) << "Resuming download of" << _hash << "from a partial download of"
+        << _numBytesComplete << "of" << _assetSize << "bytes";
+}
+
+void AssetRequest::savePartialDownload() {
+    if (_assetSize < 0 || _numBytesComplete == 0 || _numBytesComplete == _assetSize) {
+        return;
+    }
+
+    ChunkData completeChunks;
+    for (auto& chunk : _chunks) {
+        if (chunk.isComplete) {
+            completeChunks[chunk.offset] = QByteArray::fromRawData(_data.constData() + chunk.offset, chunk.size);
+        }
+    }
+
+    auto url = getPartialDownloadUrl(_hash);
+    removeFromCache(url);
+    saveToCache(url, writePartialDownload(_assetSize, completeChunks));
+}
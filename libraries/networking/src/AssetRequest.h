@@ -12,6 +12,9 @@
 #ifndef hifi_AssetRequest_h
 #define hifi_AssetRequest_h
 
+#include <map>
+#include <vector>
+
 #include <QByteArray>
 #include <QObject>
 #include <QString>
@@ -52,11 +55,70 @@ public:
     QUrl getUrl() const { return ::getATPUrl(_hash); }
     QString getHash() const { return _hash; }
 
+    // assets larger than a chunk are downloaded as several byte ranges at once, reassembled as they arrive
+    static const qint64 CHUNK_SIZE;
+    static const int MIN_CONCURRENT_CHUNKS;
+    static const int MAX_CONCURRENT_CHUNKS;
+
+    // the number of chunks to keep requested so that a download at bytesPerSecond fills the round trip,
+    // plus one so that the next chunk is always on its way as one finishes
+    static int computeConcurrentChunks(double bytesPerSecond, quint64 rttUsecs);
+
+    // The chunks are laid out back from the end of the asset, so that the first one requested - the last CHUNK_SIZE
+    // bytes, before the size of the asset is known - is the whole asset when it is no larger than a chunk.
+    // There is always at least one chunk, even for an empty asset.
+    static std::vector<ByteRange> layoutChunkRanges(qint64 assetSize);
+
+    // A partial download holds the complete chunks of an asset, by offset. It is read back only for an asset of the
+    // same size, and only as far as it is intact - the chunks after a corrupt one are dropped.
+    using ChunkData = std::map<qint64, QByteArray>;
+    static QByteArray writePartialDownload(qint64 assetSize, const ChunkData& chunks);
+    static bool readPartialDownload(const QByteArray& partialDownload, qint64 assetSize, ChunkData& chunks);
+
 signals:
     void finished(AssetRequest* thisRequest);
     void progress(qint64 totalReceived, qint64 total);
+    void chunkProgress(int chunkIndex, qint64 chunkReceived, qint64 chunkSize);
 
 private:
+    // see layoutChunkRanges
+    struct Chunk {
+        Chunk(qint64 offset, qint64 size) : offset(offset), size(size) {}
+
+        qint64 offset;
+        qint64 size;
+        qint64 received { 0 };
+        MessageID messageID { INVALID_MESSAGE_ID };
+        quint64 requestTime { 0 };
+        bool isComplete { false };
+    };
+
+    void startSingleRequest();
+    void startChunkedDownload();
+
+    void requestAssetInfo();
+    void handleAssetInfo(bool responseReceived, AssetServerError serverError, qint64 assetSize);
+    void layoutChunks(qint64 assetSize);
+
+    void requestChunks();
+    void requestChunk(int chunkIndex);
+    void handleChunkProgress(int chunkIndex, qint64 received);
+    void handleChunkReply(int chunkIndex, bool responseReceived, AssetServerError serverError, const QByteArray& data);
+    void storeChunk(Chunk& chunk, const QByteArray& data);
+    void checkIfComplete();
+    void emitProgress();
+
+    // re-requests what is missing once the asset server is back, keeping the chunks already received
+    void scheduleResume();
+    void resume();
+
+    void cancelPendingRequests();
+    void finishChunkedDownload(Error error);
+
+    // partial downloads are kept in the disk cache when a request gives up, for the next request of the asset
+    void loadPartialDownload();
+    void savePartialDownload();
+
     int _requestID;
     State _state = NotStarted;
     Error _error = NoError;
@@ -66,6 +128,20 @@ private:
     int _numPendingRequests { 0 };
     MessageID _assetRequestID { INVALID_MESSAGE_ID };
     const ByteRange _byteRange;
+
+    qint64 _assetSize { -1 };
+    std::vector<Chunk> _chunks;
+    QByteArray _tailData; // the first chunk, when it arrives before the size of the asset
+    qint64 _numBytesComplete { 0 };
+    qint64 _numBytesDownloaded { 0 }; // the bytes of the complete chunks that didn't come from a partial download
+    MessageID _assetInfoRequestID { INVALID_MESSAGE_ID };
+
+    int _numConcurrentChunks { MIN_CONCURRENT_CHUNKS };
+    quint64 _downloadStartTime { 0 };
+    quint64 _minRTT { 0 };
+
+    int _numResumeAttempts { 0 };
+    bool _isResumeScheduled { false };
 };
 
 #endif
@@ -11,6 +11,7 @@
 
 #include "AssetUtils.h"
 
+#include <array>
 #include <memory>
 
 #include <QtCore/QCryptographicHash>
@@ -29,6 +30,72 @@ QByteArray hashData(const QByteArray& data) {
     return QCryptographicHash::hash(data, QCryptographicHash::Sha256);
 }
 
+// the gear table of the rolling hash - it only has to be random looking, and the same for everyone
+static std::array<uint64_t, 256> createGearTable() {
+    std::array<uint64_t, 256> table;
+
+    // splitmix64, from a fixed seed
+    uint64_t state = 0x9e3779b97f4a7c15;
+    for (auto& value : table) {
+        uint64_t z = (state += 0x9e3779b97f4a7c15);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        value = z ^ (z >> 31);
+    }
+    return table;
+}
+
+static const std::array<uint64_t, 256> GEAR_TABLE = createGearTable();
+
+// the masks are checked against the high bits of the hash, which depend on the last 64 bytes
+//   Cuts are harder to find before the average size and easier after it (FastCDC normalized chunking), which
+//   gathers the chunk sizes around the average.
+static const int AVERAGE_CHUNK_MASK_BITS = 16; // log2 of AVERAGE_ASSET_CHUNK_SIZE
+static const uint64_t HARD_CHUNK_MASK = ~(~0ULL >> (AVERAGE_CHUNK_MASK_BITS + 2));
+static const uint64_t EASY_CHUNK_MASK = ~(~0ULL >> (AVERAGE_CHUNK_MASK_BITS - 2));
+
+qint64 findAssetChunkSize(const char* data, qint64 size) {
+    if (size <= MIN_ASSET_CHUNK_SIZE) {
+        return size;
+    }
+
+    auto bytes = reinterpret_cast<const uint8_t*>(data);
+    qint64 maxSize = std::min(size, MAX_ASSET_CHUNK_SIZE);
+    qint64 averageSize = std::min(size, AVERAGE_ASSET_CHUNK_SIZE);
+    uint64_t hash = 0;
+
+    // no chunk is cut before the minimum size, so the hash starts there
+    qint64 i = MIN_ASSET_CHUNK_SIZE;
+    for (; i < averageSize; ++i) {
+        hash = (hash << 1) + GEAR_TABLE[bytes[i]];
+        if (!(hash & HARD_CHUNK_MASK)) {
+            return i + 1;
+        }
+    }
+    for (; i < maxSize; ++i) {
+        hash = (hash << 1) + GEAR_TABLE[bytes[i]];
+        if (!(hash & EASY_CHUNK_MASK)) {
+            return i + 1;
+        }
+    }
+    return maxSize;
+}
+
+AssetChunkList chunkAssetData(const QByteArray& data) {
+    AssetChunkList chunks;
+
+    qint64 offset = 0;
+    do {
+        qint64 chunkSize = findAssetChunkSize(data.constData() + offset, data.size() - offset);
+        auto chunkData = QByteArray::fromRawData(data.constData() + offset, chunkSize);
+
+        chunks.push_back({ hashData(chunkData), offset, chunkSize });
+        offset += chunkSize;
+    } while (offset < data.size());
+
+    return chunks;
+}
+
 QByteArray loadFromCache(const QUrl& url) {
     if (auto cache = NetworkAccessManager::getInstance().cache()) {
 
@@ -70,6 +137,12 @@ bool saveToCache(const QUrl& url, const QByteArray& file) {
     return false;
 }
 
+void removeFromCache(const QUrl& url) {
+    if (auto cache = NetworkAccessManager::getInstance().cache()) {
+        cache->remove(url);
+    }
+}
+
 bool isValidFilePath(const AssetPath& filePath) {
     QRegExp filePathRegex { ASSET_FILE_PATH_REGEX_STRING };
     return filePathRegex.exactMatch(filePath);
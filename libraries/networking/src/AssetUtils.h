@@ -15,6 +15,7 @@
 #include <cstdint>
 
 #include <map>
+#include <vector>
 
 #include <QtCore/QByteArray>
 #include <QtCore/QUrl>
@@ -34,6 +35,19 @@ const QString ASSET_FILE_PATH_REGEX_STRING = "^(\\/[^\\/\\0]+)+$";
 const QString ASSET_PATH_REGEX_STRING = "^\\/([^\\/\\0]+(\\/)?)+$";
 const QString ASSET_HASH_REGEX_STRING = QString("^[a-fA-F0-9]{%1}$").arg(SHA256_HASH_HEX_LENGTH);
 
+// Assets are cut into chunks where a rolling hash of their content matches, so that an edit to an asset only changes
+// the chunks around it - an asset server that stores chunks keeps one copy of the rest, and uploads only send what changed
+const qint64 MIN_ASSET_CHUNK_SIZE = 16 * 1024;
+const qint64 AVERAGE_ASSET_CHUNK_SIZE = 64 * 1024;
+const qint64 MAX_ASSET_CHUNK_SIZE = 256 * 1024;
+
+struct AssetChunk {
+    QByteArray hash; // the SHA-256 of the chunk
+    qint64 offset;
+    qint64 size;
+};
+using AssetChunkList = std::vector<AssetChunk>;
+
 enum AssetServerError : uint8_t {
     NoError = 0,
     AssetNotFound,
@@ -56,8 +70,13 @@ QUrl getATPUrl(const QString& hash);
 
 QByteArray hashData(const QByteArray& data);
 
+// returns the size of the chunk that starts data, which is size when the data ends within the chunk
+qint64 findAssetChunkSize(const char* data, qint64 size);
+AssetChunkList chunkAssetData(const QByteArray& data);
+
 QByteArray loadFromCache(const QUrl& url);
 bool saveToCache(const QUrl& url, const QByteArray& file);
+void removeFromCache(const QUrl& url);
 
 bool isValidFilePath(const AssetPath& path);
 bool isValidPath(const AssetPath& path);
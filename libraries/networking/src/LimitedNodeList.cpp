@@ -49,8 +49,7 @@ const std::set<NodeType_t> SOLO_NODE_TYPES = {
 
 LimitedNodeList::LimitedNodeList(int socketListenPort, int dtlsListenPort) :
     _sessionUUID(),
-    _nodeHash(),
-    _nodeMutex(QReadWriteLock::Recursive),
+    _nodeSnapshot(std::make_shared<NodeSnapshot>()),
     _nodeSocket(this),
     _dtlsSocket(NULL),
     _localSockAddr(),
@@ -270,11 +269,8 @@ bool LimitedNodeList::packetSourceAndHashMatchAndTrackBandwidth(const udt::Packe
         if (matchingNode) {
             if (!NON_VERIFIED_PACKETS.contains(headerType)) {
 
-                QByteArray packetHeaderHash = NLPacket::verificationHashInHeader(packet);
-                QByteArray expectedHash = NLPacket::hashForPacketAndSecret(packet, matchingNode->getConnectionSecret());
-
-                // check if the md5 hash in the header matches the hash we would expect
-                if (packetHeaderHash != expectedHash) {
+                // check if the hash in the header matches the hash we would expect
+                if (!NLPacket::verifyHashInHeader(packet, matchingNode->getConnectionSecret(), matchingNode->getHashType())) {
                     static QMultiMap<QUuid, PacketType> hashDebugSuppressMap;
 
                     if (!hashDebugSuppressMap.contains(sourceID, headerType)) {
@@ -314,7 +310,7 @@ void LimitedNodeList::collectPacketStats(const NLPacket& packet) {
     _numCollectedBytes += packet.getDataSize();
 }
 
-void LimitedNodeList::fillPacketHeader(const NLPacket& packet, const QUuid& connectionSecret) {
+void LimitedNodeList::fillPacketHeader(const NLPacket& packet, const QUuid& connectionSecret, NLPacket::HashType hashType) {
     if (!NON_SOURCED_PACKETS.contains(packet.getType())) {
         packet.writeSourceID(getSessionUUID());
     }
@@ -322,7 +318,7 @@ void LimitedNodeList::fillPacketHeader(const NLPacket& packet, const QUuid& conn
     if (!connectionSecret.isNull()
         && !NON_SOURCED_PACKETS.contains(packet.getType())
         && !NON_VERIFIED_PACKETS.contains(packet.getType())) {
-        packet.writeVerificationHashGivenSecret(connectionSecret);
+        packet.writeVerificationHashGivenSecret(connectionSecret, hashType);
     }
 }
 
@@ -338,17 +334,18 @@ qint64 LimitedNodeList::sendUnreliablePacket(const NLPacket& packet, const Node&
     emit dataSent(destinationNode.getType(), packet.getDataSize());
     destinationNode.recordBytesSent(packet.getDataSize());
 
-    return sendUnreliablePacket(packet, *destinationNode.getActiveSocket(), destinationNode.getConnectionSecret());
+    return sendUnreliablePacket(packet, *destinationNode.getActiveSocket(), destinationNode.getConnectionSecret(),
+                                destinationNode.getHashType());
 }
 
 qint64 LimitedNodeList::sendUnreliablePacket(const NLPacket& packet, const HifiSockAddr& sockAddr,
-                                             const QUuid& connectionSecret) {
+                                             const QUuid& connectionSecret, NLPacket::HashType hashType) {
     Q_ASSERT(!packet.isPartOfMessage());
     Q_ASSERT_X(!packet.isReliable(), "LimitedNodeList::sendUnreliablePacket",
                "Trying to send a reliable packet unreliably.");
 
     collectPacketStats(packet);
-    fillPacketHeader(packet, connectionSecret);
+    fillPacketHeader(packet, connectionSecret, hashType);
 
     return _nodeSocket.writePacket(packet, sockAddr);
 }
@@ -361,7 +358,8 @@ qint64 LimitedNodeList::sendPacket(std::unique_ptr<NLPacket> packet, const Node&
         emit dataSent(destinationNode.getType(), packet->getDataSize());
         destinationNode.recordBytesSent(packet->getDataSize());
 
-        return sendPacket(std::move(packet), *activeSocket, destinationNode.getConnectionSecret());
+        return sendPacket(std::move(packet), *activeSocket, destinationNode.getConnectionSecret(),
+                          destinationNode.getHashType());
     } else {
         qCDebug(networking) << "LimitedNodeList::sendPacket called without active socket for node" << destinationNode << "- not sending";
         return ERROR_SENDING_PACKET_BYTES;
@@ -369,18 +367,18 @@ qint64 LimitedNodeList::sendPacket(std::unique_ptr<NLPacket> packet, const Node&
 }
 
 qint64 LimitedNodeList::sendPacket(std::unique_ptr<NLPacket> packet, const HifiSockAddr& sockAddr,
-                                   const QUuid& connectionSecret) {
+                                   const QUuid& connectionSecret, NLPacket::HashType hashType) {
     Q_ASSERT(!packet->isPartOfMessage());
     if (packet->isReliable()) {
         collectPacketStats(*packet);
-        fillPacketHeader(*packet, connectionSecret);
+        fillPacketHeader(*packet, connectionSecret, hashType);
 
         auto size = packet->getDataSize();
         _nodeSocket.writePacket(std::move(packet), sockAddr);
 
         return size;
     } else {
-        return sendUnreliablePacket(*packet, sockAddr, connectionSecret);
+        return sendUnreliablePacket(*packet, sockAddr, connectionSecret, hashType);
     }
 }
 
@@ -390,12 +388,13 @@ qint64 LimitedNodeList::sendPacketList(NLPacketList& packetList, const Node& des
     if (activeSocket) {
         qint64 bytesSent = 0;
         auto connectionSecret = destinationNode.getConnectionSecret();
+        auto hashType = destinationNode.getHashType();
 
         // close the last packet in the list
         packetList.closeCurrentPacket();
 
         while (!packetList._packets.empty()) {
-            bytesSent += sendPacket(packetList.takeFront<NLPacket>(), *activeSocket, connectionSecret);
+            bytesSent += sendPacket(packetList.takeFront<NLPacket>(), *activeSocket, connectionSecret, hashType);
         }
 
         emit dataSent(destinationNode.getType(), bytesSent);
@@ -408,28 +407,43 @@ qint64 LimitedNodeList::sendPacketList(NLPacketList& packetList, const Node& des
 }
 
 qint64 LimitedNodeList::sendPacketList(NLPacketList& packetList, const HifiSockAddr& sockAddr,
-                                       const QUuid& connectionSecret) {
+                                       const QUuid& connectionSecret, NLPacket::HashType hashType) {
     qint64 bytesSent = 0;
 
     // close the last packet in the list
     packetList.closeCurrentPacket();
 
     while (!packetList._packets.empty()) {
-        bytesSent += sendPacket(packetList.takeFront<NLPacket>(), sockAddr, connectionSecret);
+        bytesSent += sendPacket(packetList.takeFront<NLPacket>(), sockAddr, connectionSecret, hashType);
     }
 
     return bytesSent;
 }
 
-qint64 LimitedNodeList::sendPacketList(std::unique_ptr<NLPacketList> packetList, const HifiSockAddr& sockAddr) {
+void LimitedNodeList::prepareReliablePacketList(NLPacketList& packetList, const QUuid& connectionSecret,
+                                                NLPacket::HashType hashType) {
+    if (packetList.hasDeferredWriter()) {
+        // the packets of this list are written as they are sent, so their headers are filled then
+        packetList.setPacketFinisher([this, connectionSecret, hashType](udt::Packet& packet) {
+            NLPacket& nlPacket = static_cast<NLPacket&>(packet);
+            collectPacketStats(nlPacket);
+            fillPacketHeader(nlPacket, connectionSecret, hashType);
+        });
+        return;
+    }
+
     // close the last packet in the list
-    packetList->closeCurrentPacket();
+    packetList.closeCurrentPacket();
 
-    for (std::unique_ptr<udt::Packet>& packet : packetList->_packets) {
+    for (std::unique_ptr<udt::Packet>& packet : packetList._packets) {
         NLPacket* nlPacket = static_cast<NLPacket*>(packet.get());
         collectPacketStats(*nlPacket);
-        fillPacketHeader(*nlPacket);
+        fillPacketHeader(*nlPacket, connectionSecret, hashType);
     }
+}
+
+qint64 LimitedNodeList::sendPacketList(std::unique_ptr<NLPacketList> packetList, const HifiSockAddr& sockAddr) {
+    prepareReliablePacketList(*packetList);
 
     return _nodeSocket.writePacketList(std::move(packetList), sockAddr);
 }
@@ -437,14 +451,7 @@ qint64 LimitedNodeList::sendPacketList(std::unique_ptr<NLPacketList> packetList,
 qint64 LimitedNodeList::sendPacketList(std::unique_ptr<NLPacketList> packetList, const Node& destinationNode) {
     auto activeSocket = destinationNode.getActiveSocket();
     if (activeSocket) {
-        // close the last packet in the list
-        packetList->closeCurrentPacket();
-
-        for (std::unique_ptr<udt::Packet>& packet : packetList->_packets) {
-            NLPacket* nlPacket = static_cast<NLPacket*>(packet.get());
-            collectPacketStats(*nlPacket);
-            fillPacketHeader(*nlPacket, destinationNode.getConnectionSecret());
-        }
+        prepareReliablePacketList(*packetList, destinationNode.getConnectionSecret(), destinationNode.getHashType());
 
         return _nodeSocket.writePacketList(std::move(packetList), *activeSocket);
     } else {
@@ -464,7 +471,8 @@ qint64 LimitedNodeList::sendPacket(std::unique_ptr<NLPacket> packet, const Node&
     auto& destinationSockAddr = (overridenSockAddr.isNull()) ? *destinationNode.getActiveSocket()
                                                              : overridenSockAddr;
 
-    return sendPacket(std::move(packet), destinationSockAddr, destinationNode.getConnectionSecret());
+    return sendPacket(std::move(packet), destinationSockAddr, destinationNode.getConnectionSecret(),
+                      destinationNode.getHashType());
 }
 
 int LimitedNodeList::updateNodeWithDataFromPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
@@ -491,29 +499,40 @@ NodeData* LimitedNodeList::getOrCreateLinkedData(SharedNodePointer node) {
 }
 
 SharedNodePointer LimitedNodeList::nodeWithUUID(const QUuid& nodeUUID) {
-    QReadLocker readLocker(&_nodeMutex);
+    auto snapshot = getNodeSnapshot();
 
-    NodeHash::const_iterator it = _nodeHash.find(nodeUUID);
-    return it == _nodeHash.cend() ? SharedNodePointer() : it->second;
+    auto it = snapshot->nodeHash.find(nodeUUID);
+    return it == snapshot->nodeHash.cend() ? SharedNodePointer() : it->second;
  }
 
+void LimitedNodeList::setNodeSnapshot(NodeHash nodeHash) {
+    auto snapshot = std::make_shared<NodeSnapshot>();
+
+    snapshot->nodes.reserve(nodeHash.size());
+    for (auto& pair : nodeHash) {
+        snapshot->nodes.push_back(pair.second);
+    }
+    snapshot->nodeHash = std::move(nodeHash);
+
+    std::atomic_store(&_nodeSnapshot, NodeSnapshotPointer(std::move(snapshot)));
+}
+
 void LimitedNodeList::eraseAllNodes() {
     QSet<SharedNodePointer> killedNodes;
 
     {
-        // iterate the current nodes - grab them so we can emit that they are dying
-        // and then remove them from the hash
-        QWriteLocker writeLocker(&_nodeMutex);
+        // grab the current nodes so we can emit that they are dying, and then replace them with an empty snapshot
+        std::lock_guard<std::mutex> lock(_nodeSnapshotWriteMutex);
 
-        if (_nodeHash.size() > 0) {
+        auto snapshot = getNodeSnapshot();
+        if (snapshot->nodes.size() > 0) {
             qCDebug(networking) << "LimitedNodeList::eraseAllNodes() removing all nodes from NodeList.";
 
-            auto it = _nodeHash.begin();
-
-            while (it != _nodeHash.end())  {
-                killedNodes.insert(it->second);
-                it = _nodeHash.unsafe_erase(it);
+            for (auto& node : snapshot->nodes) {
+                killedNodes.insert(node);
             }
+
+            setNodeSnapshot(NodeHash());
         }
     }
 
@@ -530,24 +549,24 @@ void LimitedNodeList::reset() {
 }
 
 bool LimitedNodeList::killNodeWithUUID(const QUuid& nodeUUID) {
-    QReadLocker readLocker(&_nodeMutex);
-
-    NodeHash::iterator it = _nodeHash.find(nodeUUID);
-    if (it != _nodeHash.end()) {
-        SharedNodePointer matchingNode = it->second;
+    SharedNodePointer matchingNode;
 
-        readLocker.unlock();
+    {
+        std::lock_guard<std::mutex> lock(_nodeSnapshotWriteMutex);
 
-        {
-            QWriteLocker writeLocker(&_nodeMutex);
-            _nodeHash.unsafe_erase(it);
+        NodeHash nodeHash = getNodeSnapshot()->nodeHash;
+        auto it = nodeHash.find(nodeUUID);
+        if (it == nodeHash.end()) {
+            return false;
         }
 
-        handleNodeKill(matchingNode);
-        return true;
+        matchingNode = it->second;
+        nodeHash.erase(it);
+        setNodeSnapshot(std::move(nodeHash));
     }
 
-    return false;
+    handleNodeKill(matchingNode);
+    return true;
 }
 
 void LimitedNodeList::processKillNode(ReceivedMessage& message) {
@@ -571,22 +590,34 @@ void LimitedNodeList::handleNodeKill(const SharedNodePointer& node) {
 SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t nodeType,
                                                    const HifiSockAddr& publicSocket, const HifiSockAddr& localSocket,
                                                    const NodePermissions& permissions,
-                                                   const QUuid& connectionSecret) {
-    QReadLocker readLocker(&_nodeMutex);
-    NodeHash::const_iterator it = _nodeHash.find(uuid);
-
-    if (it != _nodeHash.end()) {
-        SharedNodePointer& matchingNode = it->second;
-
+                                                   const QUuid& connectionSecret, NLPacket::HashType hashType) {
+    auto updateMatchingNode = [&](const SharedNodePointer& matchingNode) {
         matchingNode->setPublicSocket(publicSocket);
         matchingNode->setLocalSocket(localSocket);
         matchingNode->setPermissions(permissions);
         matchingNode->setConnectionSecret(connectionSecret);
+        matchingNode->setHashType(hashType);
 
         return matchingNode;
+    };
+
+    SharedNodePointer matchingNode = nodeWithUUID(uuid);
+    if (matchingNode) {
+        return updateMatchingNode(matchingNode);
     } else {
+        std::unique_lock<std::mutex> writeLock(_nodeSnapshotWriteMutex);
+
+        // another thread may have added this node since we looked
+        NodeHash nodeHash = getNodeSnapshot()->nodeHash;
+        auto it = nodeHash.find(uuid);
+        if (it != nodeHash.end()) {
+            writeLock.unlock();
+            return updateMatchingNode(it->second);
+        }
+
         // we didn't have this node, so add them
         Node* newNode = new Node(uuid, nodeType, publicSocket, localSocket, permissions, connectionSecret, this);
+        newNode->setHashType(hashType);
 
         if (nodeType == NodeType::AudioMixer) {
             LimitedNodeList::flagTimeForConnectionStep(LimitedNodeList::AddedAudioMixer);
@@ -595,32 +626,26 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
         SharedNodePointer newNodePointer(newNode, &QObject::deleteLater);
 
         // if this is a solo node type, we assume that the DS has replaced its assignment and we should kill the previous node
+        SharedNodePointer oldSoloNode;
         if (SOLO_NODE_TYPES.count(newNode->getType())) {
-            // while we still have the read lock, see if there is a previous solo node we'll need to remove
-            auto previousSoloIt = std::find_if(_nodeHash.cbegin(), _nodeHash.cend(), [newNode](const UUIDNodePair& nodePair){
+            auto previousSoloIt = std::find_if(nodeHash.cbegin(), nodeHash.cend(), [newNode](const UUIDNodePair& nodePair){
                 return nodePair.second->getType() == newNode->getType();
             });
 
-            if (previousSoloIt != _nodeHash.cend()) {
-                // we have a previous solo node, switch to a write lock so we can remove it
-                readLocker.unlock();
-
-                QWriteLocker writeLocker(&_nodeMutex);
-
-                auto oldSoloNode = previousSoloIt->second;
-
-                _nodeHash.unsafe_erase(previousSoloIt);
-                handleNodeKill(oldSoloNode);
-
-                // convert the current lock back to a read lock for insertion of new node
-                writeLocker.unlock();
-                readLocker.relock();
+            if (previousSoloIt != nodeHash.cend()) {
+                oldSoloNode = previousSoloIt->second;
+                nodeHash.erase(previousSoloIt);
             }
         }
 
-        // insert the new node and release our read lock
-        _nodeHash.insert(UUIDNodePair(newNode->getUUID(), newNodePointer));
-        readLocker.unlock();
+        // insert the new node and publish the nodes
+        nodeHash.insert(UUIDNodePair(newNode->getUUID(), newNodePointer));
+        setNodeSnapshot(std::move(nodeHash));
+        writeLock.unlock();
+
+        if (oldSoloNode) {
+            handleNodeKill(oldSoloNode);
+        }
 
         qCDebug(networking) << "Added" << *newNode;
 
@@ -736,22 +761,33 @@ void LimitedNodeList::removeSilentNodes() {
 
     QSet<SharedNodePointer> killedNodes;
 
-    eachNodeHashIterator([&](NodeHash::iterator& it){
-        SharedNodePointer node = it->second;
-        node->getMutex().lock();
+    {
+        std::lock_guard<std::mutex> lock(_nodeSnapshotWriteMutex);
+
+        NodeHash nodeHash = getNodeSnapshot()->nodeHash;
+        auto it = nodeHash.begin();
 
-        if ((usecTimestampNow() - node->getLastHeardMicrostamp()) > (NODE_SILENCE_THRESHOLD_MSECS * USECS_PER_MSEC)) {
-            // call the NodeHash erase to get rid of this node
-            it = _nodeHash.unsafe_erase(it);
+        while (it != nodeHash.end()) {
+            SharedNodePointer node = it->second;
+            node->getMutex().lock();
 
-            killedNodes.insert(node);
-        } else {
-            // we didn't erase this node, push the iterator forwards
-            ++it;
+            if ((usecTimestampNow() - node->getLastHeardMicrostamp()) > (NODE_SILENCE_THRESHOLD_MSECS * USECS_PER_MSEC)) {
+                // erase this node from the next snapshot
+                it = nodeHash.erase(it);
+
+                killedNodes.insert(node);
+            } else {
+                // we didn't erase this node, push the iterator forwards
+                ++it;
+            }
+
+            node->getMutex().unlock();
         }
 
-        node->getMutex().unlock();
-    });
+        if (!killedNodes.isEmpty()) {
+            setNodeSnapshot(std::move(nodeHash));
+        }
+    }
 
     foreach(const SharedNodePointer& killedNode, killedNodes) {
         handleNodeKill(killedNode);
@@ -1058,11 +1094,9 @@ void LimitedNodeList::sendPeerQueryToIceServer(const HifiSockAddr& iceServerSock
 }
 
 SharedNodePointer LimitedNodeList::findNodeWithAddr(const HifiSockAddr& addr) {
-    QReadLocker locker(&_nodeMutex);
-    auto it = std::find_if(std::begin(_nodeHash), std::end(_nodeHash), [&](const UUIDNodePair& pair) {
-        return pair.second->getActiveSocket() ? (*pair.second->getActiveSocket() == addr) : false;
+    return nodeMatchingPredicate([&](const SharedNodePointer& node) {
+        return node->getActiveSocket() ? (*node->getActiveSocket() == addr) : false;
     });
-    return (it != std::end(_nodeHash)) ? it->second : SharedNodePointer();
 }
 
 void LimitedNodeList::sendPacketToIceServer(PacketType packetType, const HifiSockAddr& iceServerSockAddr,
@@ -16,8 +16,10 @@
 #include <stdint.h>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <unordered_map>
+#include <vector>
 
 #ifndef _WIN32
 #include <unistd.h> // not on windows, not needed for mac or windows
@@ -31,8 +33,6 @@
 #include <QtNetwork/QUdpSocket>
 #include <QtNetwork/QHostAddress>
 
-#include <tbb/concurrent_unordered_map.h>
-
 #include <DependencyManager.h>
 #include <SharedUtil.h>
 
@@ -66,9 +66,17 @@ const QHostAddress DEFAULT_ASSIGNMENT_CLIENT_MONITOR_HOSTNAME = QHostAddress::Lo
 
 const QString USERNAME_UUID_REPLACEMENT_STATS_KEY = "$username";
 
-using namespace tbb;
 typedef std::pair<QUuid, SharedNodePointer> UUIDNodePair;
-typedef concurrent_unordered_map<QUuid, SharedNodePointer, UUIDHasher> NodeHash;
+typedef std::unordered_map<QUuid, SharedNodePointer, UUIDHasher> NodeHash;
+
+// An immutable snapshot of the nodes of a LimitedNodeList
+//   The snapshot is replaced as a whole whenever a node is added or removed, so that readers never take a lock.
+//   A reader keeps its snapshot, and the nodes in it, alive for as long as it holds on to it.
+struct NodeSnapshot {
+    NodeHash nodeHash;
+    std::vector<SharedNodePointer> nodes;
+};
+using NodeSnapshotPointer = std::shared_ptr<const NodeSnapshot>;
 
 typedef quint8 PingType_t;
 namespace PingType {
@@ -124,28 +132,33 @@ public:
 
     qint64 sendUnreliablePacket(const NLPacket& packet, const Node& destinationNode);
     qint64 sendUnreliablePacket(const NLPacket& packet, const HifiSockAddr& sockAddr,
-                                const QUuid& connectionSecret = QUuid());
+                                const QUuid& connectionSecret = QUuid(),
+                                NLPacket::HashType hashType = NLPacket::HashType::MD5);
 
     qint64 sendPacket(std::unique_ptr<NLPacket> packet, const Node& destinationNode);
     qint64 sendPacket(std::unique_ptr<NLPacket> packet, const HifiSockAddr& sockAddr,
-                      const QUuid& connectionSecret = QUuid());
+                      const QUuid& connectionSecret = QUuid(), NLPacket::HashType hashType = NLPacket::HashType::MD5);
 
     qint64 sendPacketList(NLPacketList& packetList, const Node& destinationNode);
     qint64 sendPacketList(NLPacketList& packetList, const HifiSockAddr& sockAddr,
-                          const QUuid& connectionSecret = QUuid());
+                          const QUuid& connectionSecret = QUuid(), NLPacket::HashType hashType = NLPacket::HashType::MD5);
     qint64 sendPacketList(std::unique_ptr<NLPacketList> packetList, const HifiSockAddr& sockAddr);
     qint64 sendPacketList(std::unique_ptr<NLPacketList> packetList, const Node& destinationNode);
 
     std::function<void(Node*)> linkedDataCreateCallback;
 
-    size_t size() const { QReadLocker readLock(&_nodeMutex); return _nodeHash.size(); }
+    size_t size() const { return getNodeSnapshot()->nodes.size(); }
+
+    // returns the current nodes, which do not change for as long as the snapshot is held
+    NodeSnapshotPointer getNodeSnapshot() const { return std::atomic_load(&_nodeSnapshot); }
 
     SharedNodePointer nodeWithUUID(const QUuid& nodeUUID);
 
     SharedNodePointer addOrUpdateNode(const QUuid& uuid, NodeType_t nodeType,
                                       const HifiSockAddr& publicSocket, const HifiSockAddr& localSocket,
                                       const NodePermissions& permissions = DEFAULT_AGENT_PERMISSIONS,
-                                      const QUuid& connectionSecret = QUuid());
+                                      const QUuid& connectionSecret = QUuid(),
+                                      NLPacket::HashType hashType = NLPacket::HashType::MD5);
 
     static bool parseSTUNResponse(udt::BasePacket* packet, QHostAddress& newPublicAddress, uint16_t& newPublicPort);
     bool hasCompletedInitialSTUN() const { return _hasCompletedInitialSTUN; }
@@ -178,66 +191,58 @@ public:
     using value_type = SharedNodePointer;
     using const_iterator = std::vector<value_type>::const_iterator;
 
-    // Cede control of iteration under a single read lock (e.g. for use by thread pools)
-    // Use this for nested loops instead of taking nested read locks!
-    //   This allows multiple threads (i.e. a thread pool) to share a lock
-    //   without deadlocking when a dying node attempts to acquire a write lock
+    // Cede control of iteration over a single snapshot of the nodes (e.g. for use by thread pools)
+    // Use this for nested loops, so that every loop sees the same nodes
     template<typename NestedNodeLambda>
     void nestedEach(NestedNodeLambda functor, 
                     int* lockWaitOut = nullptr, 
                     int* nodeTransformOut = nullptr, 
                     int* functorOut = nullptr) {
         auto start = usecTimestampNow();
-        {
-            QReadLocker readLock(&_nodeMutex);
-            auto endLock = usecTimestampNow();
-            if (lockWaitOut) {
-                *lockWaitOut = (endLock - start);
-            }
+        auto snapshot = getNodeSnapshot();
+        auto endLock = usecTimestampNow();
+        if (lockWaitOut) {
+            *lockWaitOut = (endLock - start);
+        }
 
-            std::vector<SharedNodePointer> nodes(_nodeHash.size());
-            std::transform(_nodeHash.cbegin(), _nodeHash.cend(), nodes.begin(), [](const NodeHash::value_type& it) {
-                return it.second;
-            });
-            auto endTransform = usecTimestampNow();
-            if (nodeTransformOut) {
-                *nodeTransformOut = (endTransform - endLock);
-            }
+        // the snapshot already holds the nodes in a vector
+        if (nodeTransformOut) {
+            *nodeTransformOut = 0;
+        }
 
-            functor(nodes.cbegin(), nodes.cend());
-            auto endFunctor = usecTimestampNow();
-            if (functorOut) {
-                *functorOut = (endFunctor - endTransform);
-            }
+        functor(snapshot->nodes.cbegin(), snapshot->nodes.cend());
+        auto endFunctor = usecTimestampNow();
+        if (functorOut) {
+            *functorOut = (endFunctor - endLock);
         }
     }
 
     template<typename NodeLambda>
     void eachNode(NodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        auto snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            functor(it->second);
+        for (const SharedNodePointer& node : snapshot->nodes) {
+            functor(node);
         }
     }
 
     template<typename PredLambda, typename NodeLambda>
     void eachMatchingNode(PredLambda predicate, NodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        auto snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (predicate(it->second)) {
-                functor(it->second);
+        for (const SharedNodePointer& node : snapshot->nodes) {
+            if (predicate(node)) {
+                functor(node);
             }
         }
     }
 
     template<typename BreakableNodeLambda>
     void eachNodeBreakable(BreakableNodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        auto snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (!functor(it->second)) {
+        for (const SharedNodePointer& node : snapshot->nodes) {
+            if (!functor(node)) {
                 break;
             }
         }
@@ -245,11 +250,11 @@ public:
 
     template<typename PredLambda>
     SharedNodePointer nodeMatchingPredicate(const PredLambda predicate) {
-        QReadLocker readLock(&_nodeMutex);
+        auto snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (predicate(it->second)) {
-                return it->second;
+        for (const SharedNodePointer& node : snapshot->nodes) {
+            if (predicate(node)) {
+                return node;
             }
         }
 
@@ -264,6 +269,7 @@ public:
     void flagTimeForConnectionStep(ConnectionStep connectionStep);
 
     udt::Socket::StatsVector sampleStatsForAllConnections() { return _nodeSocket.sampleStatsForAllConnections(); }
+    QJsonObject takeSendQueuePoolStats() { return _nodeSocket.getSendQueuePool().takeStats(); }
 
     void setConnectionMaxBandwidth(int maxBandwidth) { _nodeSocket.setConnectionMaxBandwidth(maxBandwidth); }
 
@@ -330,7 +336,10 @@ protected:
     qint64 writePacket(const NLPacket& packet, const HifiSockAddr& destinationSockAddr,
                        const QUuid& connectionSecret = QUuid());
     void collectPacketStats(const NLPacket& packet);
-    void fillPacketHeader(const NLPacket& packet, const QUuid& connectionSecret = QUuid());
+    void fillPacketHeader(const NLPacket& packet, const QUuid& connectionSecret = QUuid(),
+                          NLPacket::HashType hashType = NLPacket::HashType::MD5);
+    void prepareReliablePacketList(NLPacketList& packetList, const QUuid& connectionSecret = QUuid(),
+                                   NLPacket::HashType hashType = NLPacket::HashType::MD5);
 
     void setLocalSocket(const HifiSockAddr& sockAddr);
 
@@ -346,9 +355,12 @@ protected:
 
     bool sockAddrBelongsToNode(const HifiSockAddr& sockAddr) { return findNodeWithAddr(sockAddr) != SharedNodePointer(); }
 
+    // publishes a new snapshot of the nodes; must be called with _nodeSnapshotWriteMutex held
+    void setNodeSnapshot(NodeHash nodeHash);
+
     QUuid _sessionUUID;
-    NodeHash _nodeHash;
-    mutable QReadWriteLock _nodeMutex;
+    NodeSnapshotPointer _nodeSnapshot; // only accessed with std::atomic_load and std::atomic_store
+    std::mutex _nodeSnapshotWriteMutex; // serializes the writers of _nodeSnapshot
     udt::Socket _nodeSocket;
     QUdpSocket* _dtlsSocket;
     HifiSockAddr _localSockAddr;
@@ -375,16 +387,6 @@ protected:
     QMap<quint64, ConnectionStep> _lastConnectionTimes;
     bool _areConnectionTimesComplete = false;
 
-    template<typename IteratorLambda>
-    void eachNodeHashIterator(IteratorLambda functor) {
-        QWriteLocker writeLock(&_nodeMutex);
-        NodeHash::iterator it = _nodeHash.begin();
-
-        while (it != _nodeHash.end()) {
-            functor(it);
-        }
-    }
-
 private slots:
     void flagTimeForConnectionStep(ConnectionStep connectionStep, quint64 timestamp);
     void possiblyTimeoutSTUNAddressLookup();
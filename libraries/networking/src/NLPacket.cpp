@@ -11,6 +11,37 @@
 
 #include "NLPacket.h"
 
+#include <QtCore/QProcessEnvironment>
+#include <QtCore/QtEndian>
+
+#include "SipHash.h"
+
+namespace {
+
+const QString DISABLE_SIPHASH_FLAG = "HIFI_DISABLE_SIPHASH_PACKETS";
+
+int hashOffset(const udt::Packet& packet) {
+    return udt::Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
+        + NUM_BYTES_RFC4122_UUID;
+}
+
+// writes the SipHash of the payload of the packet, keyed by the RFC 4122 bytes of the connection secret
+void sipHashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret, char* hash) {
+    // the same bytes as QUuid::toRfc4122, without allocating them
+    uchar key[SipHash::KEY_SIZE];
+    qToBigEndian(connectionSecret.data1, key);
+    qToBigEndian(connectionSecret.data2, key + 4);
+    qToBigEndian(connectionSecret.data3, key + 6);
+    memcpy(key + 8, connectionSecret.data4, sizeof(connectionSecret.data4));
+
+    int offset = hashOffset(packet) + NUM_BYTES_MD5_HASH;
+    SipHash::hash128(reinterpret_cast<const char*>(key), packet.getData() + offset, packet.getDataSize() - offset, hash);
+}
+
+}
+
+static_assert(SipHash::HASH_SIZE == NUM_BYTES_MD5_HASH, "SipHash must fit the verification hash in the header");
+
 int NLPacket::localHeaderSize(PacketType type) {
     bool nonSourced = NON_SOURCED_PACKETS.contains(type);
     bool nonVerified = NON_VERIFIED_PACKETS.contains(type);
@@ -32,7 +63,7 @@ std::unique_ptr<NLPacket> NLPacket::create(PacketType type, qint64 size, bool is
     return packet;
 }
 
-std::unique_ptr<NLPacket> NLPacket::fromReceivedPacket(std::unique_ptr<char[]> data, qint64 size,
+std::unique_ptr<NLPacket> NLPacket::fromReceivedPacket(udt::PacketBufferPool::Buffer data, qint64 size,
                                                        const HifiSockAddr& senderSockAddr) {
     // Fail with null data
     Q_ASSERT(data);
@@ -87,7 +118,7 @@ NLPacket::NLPacket(const NLPacket& other) : Packet(other) {
     _sourceID = other._sourceID;
 }
 
-NLPacket::NLPacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr) :
+NLPacket::NLPacket(udt::PacketBufferPool::Buffer data, qint64 size, const HifiSockAddr& senderSockAddr) :
     Packet(std::move(data), size, senderSockAddr)
 {    
     // sanity check before we decrease the payloadSize with the payloadCapacity
@@ -145,15 +176,19 @@ QUuid NLPacket::sourceIDInHeader(const udt::Packet& packet) {
 }
 
 QByteArray NLPacket::verificationHashInHeader(const udt::Packet& packet) {
-    int offset = Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion) + NUM_BYTES_RFC4122_UUID;
-    return QByteArray(packet.getData() + offset, NUM_BYTES_MD5_HASH);
+    return QByteArray(packet.getData() + hashOffset(packet), NUM_BYTES_MD5_HASH);
 }
 
-QByteArray NLPacket::hashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret) {
+QByteArray NLPacket::hashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret, HashType hashType) {
+    if (hashType == HashType::SipHash) {
+        QByteArray hash(SipHash::HASH_SIZE, 0);
+        sipHashForPacketAndSecret(packet, connectionSecret, hash.data());
+        return hash;
+    }
+
     QCryptographicHash hash(QCryptographicHash::Md5);
     
-    int offset = Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
-        + NUM_BYTES_RFC4122_UUID + NUM_BYTES_MD5_HASH;
+    int offset = hashOffset(packet) + NUM_BYTES_MD5_HASH;
     
     // add the packet payload and the connection UUID
     hash.addData(packet.getData() + offset, packet.getDataSize() - offset);
@@ -163,6 +198,30 @@ QByteArray NLPacket::hashForPacketAndSecret(const udt::Packet& packet, const QUu
     return hash.result();
 }
 
+bool NLPacket::verifyHashInHeader(const udt::Packet& packet, const QUuid& connectionSecret, HashType hashType) {
+    const char* headerHash = packet.getData() + hashOffset(packet);
+
+    if (hashType == HashType::SipHash) {
+        char expectedHash[SipHash::HASH_SIZE];
+        sipHashForPacketAndSecret(packet, connectionSecret, expectedHash);
+        return memcmp(headerHash, expectedHash, SipHash::HASH_SIZE) == 0;
+    }
+
+    QByteArray expectedHash = hashForPacketAndSecret(packet, connectionSecret, HashType::MD5);
+    return memcmp(headerHash, expectedHash.constData(), NUM_BYTES_MD5_HASH) == 0;
+}
+
+NLPacket::HashTypes NLPacket::getSupportedHashTypes() {
+    static const HashTypes supportedHashTypes = (1 << (int)HashType::MD5)
+        | (QProcessEnvironment::systemEnvironment().contains(DISABLE_SIPHASH_FLAG) ? 0 : 1 << (int)HashType::SipHash);
+    return supportedHashTypes;
+}
+
+NLPacket::HashType NLPacket::hashTypeForSupportedTypes(HashTypes supportedTypesA, HashTypes supportedTypesB) {
+    HashTypes commonTypes = supportedTypesA & supportedTypesB;
+    return (commonTypes & (1 << (int)HashType::SipHash)) ? HashType::SipHash : HashType::MD5;
+}
+
 void NLPacket::writeTypeAndVersion() {
     auto headerOffset = Packet::totalHeaderSize(isPartOfMessage());
     
@@ -212,12 +271,17 @@ void NLPacket::writeSourceID(const QUuid& sourceID) const {
     _sourceID = sourceID;
 }
 
-void NLPacket::writeVerificationHashGivenSecret(const QUuid& connectionSecret) const {
+void NLPacket::writeVerificationHashGivenSecret(const QUuid& connectionSecret, HashType hashType) const {
     Q_ASSERT(!NON_SOURCED_PACKETS.contains(_type) && !NON_VERIFIED_PACKETS.contains(_type));
     
-    auto offset = Packet::totalHeaderSize(isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
-                + NUM_BYTES_RFC4122_UUID;
-    QByteArray verificationHash = hashForPacketAndSecret(*this, connectionSecret);
+    auto offset = hashOffset(*this);
+
+    if (hashType == HashType::SipHash) {
+        sipHashForPacketAndSecret(*this, connectionSecret, _packet.get() + offset);
+        return;
+    }
+
+    QByteArray verificationHash = hashForPacketAndSecret(*this, connectionSecret, HashType::MD5);
     
     memcpy(_packet.get() + offset, verificationHash.data(), verificationHash.size());
 }
@@ -32,6 +32,14 @@ public:
     //
     //    NLPacket Header Format
 
+    // how the verification hash of a packet is computed, negotiated by the domain-server for each pair of nodes
+    //   MD5 remains for nodes that do not support, or have disabled, the keyed SipHash
+    enum class HashType : quint8 {
+        MD5 = 0,
+        SipHash = 1
+    };
+    using HashTypes = quint8; // a set of HashType bits
+
     // this is used by the Octree classes - must be known at compile time
     static const int MAX_PACKET_HEADER_SIZE =
         sizeof(udt::Packet::SequenceNumberAndBitField) + sizeof(udt::Packet::MessageNumberAndBitField) +
@@ -40,7 +48,7 @@ public:
     static std::unique_ptr<NLPacket> create(PacketType type, qint64 size = -1,
                     bool isReliable = false, bool isPartOfMessage = false, PacketVersion version = 0);
     
-    static std::unique_ptr<NLPacket> fromReceivedPacket(std::unique_ptr<char[]> data, qint64 size,
+    static std::unique_ptr<NLPacket> fromReceivedPacket(udt::PacketBufferPool::Buffer data, qint64 size,
                                                         const HifiSockAddr& senderSockAddr);
     static std::unique_ptr<NLPacket> fromBase(std::unique_ptr<Packet> packet);
     
@@ -59,7 +67,17 @@ public:
     
     static QUuid sourceIDInHeader(const udt::Packet& packet);
     static QByteArray verificationHashInHeader(const udt::Packet& packet);
-    static QByteArray hashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret);
+    static QByteArray hashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret,
+                                             HashType hashType = HashType::MD5);
+
+    // compares the hash in the header with the expected hash, without allocating for SipHash
+    static bool verifyHashInHeader(const udt::Packet& packet, const QUuid& connectionSecret, HashType hashType);
+
+    // the hash types this node supports, all unless disabled with the HIFI_DISABLE_SIPHASH_PACKETS environment variable
+    static HashTypes getSupportedHashTypes();
+
+    // the fastest hash type supported by both nodes
+    static HashType hashTypeForSupportedTypes(HashTypes supportedTypesA, HashTypes supportedTypesB);
     
     PacketType getType() const { return _type; }
     void setType(PacketType type);
@@ -70,12 +88,12 @@ public:
     const QUuid& getSourceID() const { return _sourceID; }
     
     void writeSourceID(const QUuid& sourceID) const;
-    void writeVerificationHashGivenSecret(const QUuid& connectionSecret) const;
+    void writeVerificationHashGivenSecret(const QUuid& connectionSecret, HashType hashType = HashType::MD5) const;
 
 protected:
     
     NLPacket(PacketType type, qint64 size = -1, bool forceReliable = false, bool isPartOfMessage = false, PacketVersion version = 0);
-    NLPacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr);
+    NLPacket(udt::PacketBufferPool::Buffer data, qint64 size, const HifiSockAddr& senderSockAddr);
     
     NLPacket(const NLPacket& other);
     NLPacket(NLPacket&& other);
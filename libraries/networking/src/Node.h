@@ -12,6 +12,7 @@
 #ifndef hifi_Node_h
 #define hifi_Node_h
 
+#include <atomic>
 #include <memory>
 #include <ostream>
 #include <stdint.h>
@@ -28,6 +29,7 @@
 
 #include "HifiSockAddr.h"
 #include "NetworkPeer.h"
+#include "NLPacket.h"
 #include "NodeData.h"
 #include "NodeType.h"
 #include "SimpleMovingAverage.h"
@@ -51,6 +53,10 @@ public:
     const QUuid& getConnectionSecret() const { return _connectionSecret; }
     void setConnectionSecret(const QUuid& connectionSecret) { _connectionSecret = connectionSecret; }
 
+    // the hash type of the packets verified with the connection secret, in both directions
+    NLPacket::HashType getHashType() const { return _hashType; }
+    void setHashType(NLPacket::HashType hashType) { _hashType = hashType; }
+
     NodeData* getLinkedData() const { return _linkedData.get(); }
     void setLinkedData(std::unique_ptr<NodeData> linkedData) { _linkedData = std::move(linkedData); }
 
@@ -88,6 +94,7 @@ private:
     NodeType_t _type;
 
     QUuid _connectionSecret;
+    std::atomic<NLPacket::HashType> _hashType { NLPacket::HashType::MD5 };
     std::unique_ptr<NodeData> _linkedData;
     int _pingMs;
     qint64 _clockSkewUsec;
@@ -390,6 +390,9 @@ void NodeList::sendDomainServerCheckIn() {
             // now add the machine fingerprint - a null UUID if logged in, real one if not logged in
             auto accountManager = DependencyManager::get<AccountManager>();
             packetStream << (accountManager->isLoggedIn() ? QUuid() : FingerprintUtils::getMachineFingerprint());
+
+            // and the packet hash types we support, so the domain-server can pick the one we use with each node
+            packetStream << NLPacket::getSupportedHashTypes();
         }
 
         // pack our data to send to the domain-server including
@@ -662,10 +665,11 @@ void NodeList::parseNodeFromPacketStream(QDataStream& packetStream) {
         nodePublicSocket.setAddress(_domainHandler.getIP());
     }
 
-    packetStream >> connectionUUID;
+    quint8 hashType;
+    packetStream >> connectionUUID >> hashType;
 
     SharedNodePointer node = addOrUpdateNode(nodeUUID, nodeType, nodePublicSocket,
-                                             nodeLocalSocket, permissions, connectionUUID);
+                                             nodeLocalSocket, permissions, connectionUUID, (NLPacket::HashType)hashType);
 }
 
 void NodeList::sendAssignment(Assignment& assignment) {
@@ -20,6 +20,7 @@
 #include <unistd.h> // not on windows, not needed for mac or windows
 #endif
 
+#include <tbb/concurrent_unordered_map.h>
 #include <tbb/concurrent_unordered_set.h>
 
 #include <QtCore/QElapsedTimer>
@@ -9,12 +9,14 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <cfloat>
 #include <cmath>
 
 #include <QThread>
 #include <QTimer>
 
+#include <NumericalConstants.h>
 #include <SharedUtil.h>
 #include <assert.h>
 
@@ -30,21 +32,96 @@
                            (((x) > (max)) ? (max) :\
                                             (x)))
 
-void ResourceCacheSharedItems::appendActiveRequest(QWeakPointer<Resource> resource) {
+const int DEFAULT_REQUEST_LIMIT = 10;
+
+const quint64 ResourceCacheSharedItems::PRIORITY_UPDATE_INTERVAL_USECS = 100 * USECS_PER_MSEC;
+
+ResourceCacheSharedItems::ResourceCacheSharedItems() {
+    _requestLimits.fill(DEFAULT_REQUEST_LIMIT);
+    _numLoadingRequests.fill(0);
+}
+
+bool ResourceCacheSharedItems::startOrQueueRequest(QSharedPointer<Resource> resource) {
+    auto backend = ResourceManager::getRequestBackend(resource->getURL());
     Lock lock(_mutex);
-    _loadingRequests.append(resource);
+
+    Request request { resource, backend, resource->getLoadPriority() };
+
+    if (_arrivalTime > 0) {
+        _hasRequestsSinceArrival = true;
+        _hasUsefulRequestsSinceArrival |= request.priority >= USEFUL_LOAD_PRIORITY;
+    }
+
+    if (_numLoadingRequests[(int)backend] < _requestLimits[(int)backend]) {
+        _loadingRequests.push_back(request);
+        ++_numLoadingRequests[(int)backend];
+        return true;
+    }
+
+    // wait until a slot becomes available, behind the requests with the same priority
+    auto it = std::upper_bound(_pendingRequests.begin(), _pendingRequests.end(), request.priority,
+                               [](float priority, const Request& request) {
+        return priority < request.priority;
+    });
+    _pendingRequests.insert(it, request);
+    return false;
 }
 
-void ResourceCacheSharedItems::appendPendingRequest(QWeakPointer<Resource> resource) {
+QSharedPointer<Resource> ResourceCacheSharedItems::startHighestPendingRequest() {
     Lock lock(_mutex);
-    _pendingRequests.append(resource);
+
+    if (usecTimestampNow() - _lastPriorityUpdate > PRIORITY_UPDATE_INTERVAL_USECS) {
+        updatePriorities();
+    }
+
+    // look for the highest priority pending request that its backend has room for
+    for (int i = (int)_pendingRequests.size() - 1; i >= 0; --i) {
+        auto resource = _pendingRequests[i].resource.lock();
+        if (!resource) {
+            // Clear any freed resources
+            _pendingRequests.erase(_pendingRequests.begin() + i);
+            continue;
+        }
+
+        auto backend = _pendingRequests[i].backend;
+        if (_numLoadingRequests[(int)backend] < _requestLimits[(int)backend]) {
+            _loadingRequests.push_back(_pendingRequests[i]);
+            ++_numLoadingRequests[(int)backend];
+
+            _pendingRequests.erase(_pendingRequests.begin() + i);
+            return resource;
+        }
+    }
+
+    return QSharedPointer<Resource>();
+}
+
+void ResourceCacheSharedItems::updatePriorities() {
+    Requests requests;
+    requests.reserve(_pendingRequests.size());
+
+    for (auto& request : _pendingRequests) {
+        // Clear any freed resources
+        auto resource = request.resource.lock();
+        if (resource) {
+            requests.push_back({ request.resource, request.backend, resource->getLoadPriority() });
+        }
+    }
+
+    std::stable_sort(requests.begin(), requests.end(), [](const Request& a, const Request& b) {
+        return a.priority < b.priority;
+    });
+
+    _pendingRequests.swap(requests);
+    _lastPriorityUpdate = usecTimestampNow();
 }
 
 QList<QSharedPointer<Resource>> ResourceCacheSharedItems::getPendingRequests() {
     QList<QSharedPointer<Resource>> result;
     Lock lock(_mutex);
 
-    foreach(QSharedPointer<Resource> resource, _pendingRequests) {
+    for (auto& request : _pendingRequests) {
+        auto resource = request.resource.lock();
         if (resource) {
             result.append(resource);
         }
@@ -55,14 +132,15 @@ QList<QSharedPointer<Resource>> ResourceCacheSharedItems::getPendingRequests() {
 
 uint32_t ResourceCacheSharedItems::getPendingRequestsCount() const {
     Lock lock(_mutex);
-    return _pendingRequests.size();
+    return (uint32_t)_pendingRequests.size();
 }
 
 QList<QSharedPointer<Resource>> ResourceCacheSharedItems::getLoadingRequests() {
     QList<QSharedPointer<Resource>> result;
     Lock lock(_mutex);
 
-    foreach(QSharedPointer<Resource> resource, _loadingRequests) {
+    for (auto& request : _loadingRequests) {
+        auto resource = request.resource.lock();
         if (resource) {
             result.append(resource);
         }
@@ -73,7 +151,7 @@ QList<QSharedPointer<Resource>> ResourceCacheSharedItems::getLoadingRequests() {
 
 uint32_t ResourceCacheSharedItems::getLoadingRequestsCount() const {
     Lock lock(_mutex);
-    return _loadingRequests.size();
+    return (uint32_t)_loadingRequests.size();
 }
 
 void ResourceCacheSharedItems::removeRequest(QWeakPointer<Resource> resource) {
@@ -82,47 +160,78 @@ void ResourceCacheSharedItems::removeRequest(QWeakPointer<Resource> resource) {
     // resource can only be removed if it still has a ref-count, as
     // QWeakPointer has no operator== implementation for two weak ptrs, so
     // manually loop in case resource has been freed.
-    for (int i = 0; i < _loadingRequests.size();) {
-        auto request = _loadingRequests.at(i);
+    for (auto it = _loadingRequests.begin(); it != _loadingRequests.end();) {
+        auto request = it->resource;
         // Clear our resource and any freed resources
         if (!request || request.data() == resource.data()) {
-            _loadingRequests.removeAt(i);
+            --_numLoadingRequests[(int)it->backend];
+            it = _loadingRequests.erase(it);
             continue;
         }
-        i++;
+        ++it;
     }
+
+    updateLoadTimes();
 }
 
-QSharedPointer<Resource> ResourceCacheSharedItems::getHighestPendingRequest() {
-    // look for the highest priority pending request
-    int highestIndex = -1;
-    float highestPriority = -FLT_MAX;
-    QSharedPointer<Resource> highestResource;
+void ResourceCacheSharedItems::setRequestLimit(ResourceRequestBackend backend, int limit) {
+    Lock lock(_mutex);
+    _requestLimits[(int)backend] = limit;
+}
+
+int ResourceCacheSharedItems::getRequestLimit(ResourceRequestBackend backend) const {
     Lock lock(_mutex);
+    return _requestLimits[(int)backend];
+}
 
-    for (int i = 0; i < _pendingRequests.size();) {
-        // Clear any freed resources
-        auto resource = _pendingRequests.at(i).lock();
-        if (!resource) {
-            _pendingRequests.removeAt(i);
-            continue;
-        }
+int ResourceCacheSharedItems::getLoadingRequestsCount(ResourceRequestBackend backend) const {
+    Lock lock(_mutex);
+    return _numLoadingRequests[(int)backend];
+}
 
-        // Check load priority
-        float priority = resource->getLoadPriority();
-        if (priority >= highestPriority) {
-            highestPriority = priority;
-            highestIndex = i;
-            highestResource = resource;
-        }
-        i++;
+void ResourceCacheSharedItems::restartLoadTimes() {
+    Lock lock(_mutex);
+
+    _arrivalTime = usecTimestampNow();
+    _hasRequestsSinceArrival = false;
+    _hasUsefulRequestsSinceArrival = false;
+    _usefulLoadMsecs = -1;
+    _allLoadMsecs = -1;
+
+    // what is useful depends on where the avatar is now, so don't wait for the next update of the priorities
+    _lastPriorityUpdate = 0;
+}
+
+int ResourceCacheSharedItems::getUsefulLoadMsecs() const {
+    Lock lock(_mutex);
+    return _usefulLoadMsecs;
+}
+
+int ResourceCacheSharedItems::getAllLoadMsecs() const {
+    Lock lock(_mutex);
+    return _allLoadMsecs;
+}
+
+void ResourceCacheSharedItems::updateLoadTimes() {
+    if (_arrivalTime == 0) {
+        return;
     }
 
-    if (highestIndex >= 0) {
-        _pendingRequests.takeAt(highestIndex);
+    auto isUseful = [](const Request& request) {
+        return request.priority >= USEFUL_LOAD_PRIORITY;
+    };
+
+    int loadMsecs = (int)((usecTimestampNow() - _arrivalTime) / USECS_PER_MSEC);
+
+    if (_usefulLoadMsecs < 0 && _hasUsefulRequestsSinceArrival
+        && std::none_of(_pendingRequests.begin(), _pendingRequests.end(), isUseful)
+        && std::none_of(_loadingRequests.begin(), _loadingRequests.end(), isUseful)) {
+        _usefulLoadMsecs = loadMsecs;
     }
 
-    return highestResource;
+    if (_allLoadMsecs < 0 && _hasRequestsSinceArrival && _pendingRequests.empty() && _loadingRequests.empty()) {
+        _allLoadMsecs = loadMsecs;
+    }
 }
 
 ScriptableResource::ScriptableResource(const QUrl& url) :
@@ -317,6 +426,11 @@ QVariantList ResourceCache::getResourceList() {
 void ResourceCache::setRequestLimit(int limit) {
     _requestLimit = limit;
 
+    // each network backend gets its own slots, so that slow downloads from one don't hold up the others
+    auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+    sharedItems->setRequestLimit(ResourceRequestBackend::HTTP, limit);
+    sharedItems->setRequestLimit(ResourceRequestBackend::ATP, limit);
+
     // Now go fill any new request spots
     while (attemptHighestPriorityRequest()) {
         // just keep looping until we reach the new limit or no more pending requests
@@ -472,19 +586,37 @@ int ResourceCache::getLoadingRequestCount() {
     return DependencyManager::get<ResourceCacheSharedItems>()->getLoadingRequestsCount();
 }
 
+void ResourceCache::setRequestLimit(ResourceRequestBackend backend, int limit) {
+    DependencyManager::get<ResourceCacheSharedItems>()->setRequestLimit(backend, limit);
+
+    // Now go fill any new request spots
+    while (attemptHighestPriorityRequest()) {
+        // just keep looping until we reach the new limit or no more pending requests
+    }
+}
+
+int ResourceCache::getRequestLimit(ResourceRequestBackend backend) {
+    return DependencyManager::get<ResourceCacheSharedItems>()->getRequestLimit(backend);
+}
+
+int ResourceCache::getRequestsActive(ResourceRequestBackend backend) {
+    return DependencyManager::get<ResourceCacheSharedItems>()->getLoadingRequestsCount(backend);
+}
+
+void ResourceCache::restartLoadTimes() {
+    DependencyManager::get<ResourceCacheSharedItems>()->restartLoadTimes();
+}
+
 bool ResourceCache::attemptRequest(QSharedPointer<Resource> resource) {
     Q_ASSERT(!resource.isNull());
 
 
     auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
-    if (_requestsActive >= _requestLimit) {
+    if (!sharedItems->startOrQueueRequest(resource)) {
         // wait until a slot becomes available
-        sharedItems->appendPendingRequest(resource);
         return false;
     }
-    
-    ++_requestsActive;
-    sharedItems->appendActiveRequest(resource);
+
     resource->makeRequest();
     return true;
 }
@@ -493,20 +625,22 @@ void ResourceCache::requestCompleted(QWeakPointer<Resource> resource) {
     auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
 
     sharedItems->removeRequest(resource);
-    --_requestsActive;
 
     attemptHighestPriorityRequest();
 }
 
 bool ResourceCache::attemptHighestPriorityRequest() {
     auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
-    auto resource = sharedItems->getHighestPendingRequest();
-    return (resource && attemptRequest(resource));
+    auto resource = sharedItems->startHighestPendingRequest();
+    if (!resource) {
+        return false;
+    }
+
+    resource->makeRequest();
+    return true;
 }
 
-const int DEFAULT_REQUEST_LIMIT = 10;
 int ResourceCache::_requestLimit = DEFAULT_REQUEST_LIMIT;
-int ResourceCache::_requestsActive = 0;
 
 static int requestID = 0;
 
@@ -534,6 +668,7 @@ void Resource::ensureLoading() {
 
 void Resource::setLoadPriority(const QPointer<QObject>& owner, float priority) {
     if (!(_failedToLoad)) {
+        _loadPriorityOperators.remove(owner);
         _loadPriorities.insert(owner, priority);
     }
 }
@@ -548,14 +683,22 @@ void Resource::setLoadPriorities(const QHash<QPointer<QObject>, float>& prioriti
     }
 }
 
+void Resource::setLoadPriorityOperator(const QPointer<QObject>& owner, std::function<float()> priorityOperator) {
+    if (!(_failedToLoad)) {
+        _loadPriorities.remove(owner);
+        _loadPriorityOperators.insert(owner, priorityOperator);
+    }
+}
+
 void Resource::clearLoadPriority(const QPointer<QObject>& owner) {
     if (!(_failedToLoad)) {
         _loadPriorities.remove(owner);
+        _loadPriorityOperators.remove(owner);
     }
 }
 
 float Resource::getLoadPriority() {
-    if (_loadPriorities.size() == 0) {
+    if (_loadPriorities.size() == 0 && _loadPriorityOperators.size() == 0) {
         return 0;
     }
 
@@ -568,7 +711,17 @@ float Resource::getLoadPriority() {
         highestPriority = qMax(highestPriority, it.value());
         it++;
     }
-    return highestPriority;
+    for (auto it = _loadPriorityOperators.begin(); it != _loadPriorityOperators.end(); ) {
+        if (it.key().isNull()) {
+            it = _loadPriorityOperators.erase(it);
+            continue;
+        }
+        highestPriority = qMax(highestPriority, it.value()());
+        it++;
+    }
+
+    // every owner may have gone away
+    return highestPriority > -FLT_MAX ? highestPriority : 0.0f;
 }
 
 void Resource::refresh() {
@@ -644,6 +797,7 @@ void Resource::finishedLoading(bool success) {
     if (success) {
         qCDebug(networking).noquote() << "Finished loading:" << _url.toDisplayString();
         _loadPriorities.clear();
+        _loadPriorityOperators.clear();
         _loaded = true;
     } else {
         qCDebug(networking).noquote() << "Failed to load:" << _url.toDisplayString();
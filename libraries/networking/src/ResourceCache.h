@@ -12,8 +12,11 @@
 #ifndef hifi_ResourceCache_h
 #define hifi_ResourceCache_h
 
+#include <array>
 #include <atomic>
+#include <functional>
 #include <mutex>
+#include <vector>
 
 #include <QtCore/QHash>
 #include <QtCore/QList>
@@ -55,6 +58,10 @@ static const qint64 DEFAULT_UNUSED_MAX_SIZE = 1024 * BYTES_PER_MEGABYTES;
 static const qint64 MIN_UNUSED_MAX_SIZE = 0;
 static const qint64 MAX_UNUSED_MAX_SIZE = MAXIMUM_CACHE_SIZE;
 
+// resources loaded with at least this priority are needed for a useful view of the scene, while the ones below it
+// refine what is already shown (higher texture mips) or aren't seen at all (sounds)
+static const float USEFUL_LOAD_PRIORITY = 0.0f;
+
 // We need to make sure that these items are available for all instances of
 // ResourceCache derived classes. Since we can't count on the ordering of
 // static members destruction, we need to use this Dependency manager implemented
@@ -66,21 +73,64 @@ class ResourceCacheSharedItems : public Dependency  {
     using Lock = std::unique_lock<Mutex>;
 
 public:
-    void appendPendingRequest(QWeakPointer<Resource> newRequest);
-    void appendActiveRequest(QWeakPointer<Resource> newRequest);
+    /// Counts the resource as loading if its request backend is below its limit, otherwise queues it
+    /// \return true if the resource is to make its request now, false if it was queued
+    bool startOrQueueRequest(QSharedPointer<Resource> resource);
+
+    /// Takes the queued resource with the highest load priority whose request backend is below its limit,
+    /// and counts it as loading
+    QSharedPointer<Resource> startHighestPendingRequest();
+
     void removeRequest(QWeakPointer<Resource> doneRequest);
     QList<QSharedPointer<Resource>> getPendingRequests();
     uint32_t getPendingRequestsCount() const;
     QList<QSharedPointer<Resource>> getLoadingRequests();
-    QSharedPointer<Resource> getHighestPendingRequest();
     uint32_t getLoadingRequestsCount() const;
 
+    void setRequestLimit(ResourceRequestBackend backend, int limit);
+    int getRequestLimit(ResourceRequestBackend backend) const;
+    int getLoadingRequestsCount(ResourceRequestBackend backend) const;
+
+    /// Restarts the load times, for when the avatar arrives somewhere new
+    void restartLoadTimes();
+
+    /// Returns how long it took after the last arrival for the resources with at least USEFUL_LOAD_PRIORITY to load,
+    /// or -1 while they are still loading
+    int getUsefulLoadMsecs() const;
+
+    /// Returns how long it took after the last arrival for all of the resources to load, or -1 while they are loading
+    int getAllLoadMsecs() const;
+
 private:
-    ResourceCacheSharedItems() = default;
+    struct Request {
+        QWeakPointer<Resource> resource;
+        ResourceRequestBackend backend;
+        float priority;
+    };
+    using Requests = std::vector<Request>;
+    using Counts = std::array<int, (size_t)ResourceRequestBackend::NumBackends>;
+
+    ResourceCacheSharedItems();
+
+    // the priorities of the pending requests are updated this often, for as long as they are pending
+    static const quint64 PRIORITY_UPDATE_INTERVAL_USECS;
+
+    void updatePriorities(); // must be called with the lock held
+    void updateLoadTimes(); // must be called with the lock held
 
     mutable Mutex _mutex;
-    QList<QWeakPointer<Resource>> _pendingRequests;
-    QList<QWeakPointer<Resource>> _loadingRequests;
+    Requests _pendingRequests; // sorted from the lowest priority as of the last update, and from the oldest within one
+    Requests _loadingRequests;
+    quint64 _lastPriorityUpdate { 0 };
+
+    Counts _requestLimits;
+    Counts _numLoadingRequests;
+
+    quint64 _arrivalTime { 0 };
+    bool _hasRequestsSinceArrival { false };
+    bool _hasUsefulRequestsSinceArrival { false };
+    int _usefulLoadMsecs { -1 };
+    int _allLoadMsecs { -1 };
 };
 
 /// Wrapper to expose resources to JS/QML
@@ -230,10 +280,15 @@ public:
      */
     Q_INVOKABLE QVariantList getResourceList();
 
+    /// Sets the limit of concurrent requests for each of the network request backends
     static void setRequestLimit(int limit);
     static int getRequestLimit() { return _requestLimit; }
 
-    static int getRequestsActive() { return _requestsActive; }
+    static void setRequestLimit(ResourceRequestBackend backend, int limit);
+    static int getRequestLimit(ResourceRequestBackend backend);
+
+    static int getRequestsActive() { return getLoadingRequestCount(); }
+    static int getRequestsActive(ResourceRequestBackend backend);
     
     void setUnusedResourceCacheSize(qint64 unusedResourcesMaxSize);
     qint64 getUnusedResourceCacheSize() const { return _unusedResourcesMaxSize; }
@@ -244,6 +299,9 @@ public:
 
     static int getLoadingRequestCount();
 
+    /// Restarts the load times reported by the shared items, when the avatar arrives somewhere new
+    static void restartLoadTimes();
+
     ResourceCache(QObject* parent = nullptr);
     virtual ~ResourceCache();
     
@@ -314,7 +372,6 @@ private:
     void removeResource(const QUrl& url, qint64 size = 0);
 
     static int _requestLimit;
-    static int _requestsActive;
 
     // Resources
     QHash<QUrl, QWeakPointer<Resource>> _resources;
@@ -360,6 +417,10 @@ public:
     /// Sets a set of priorities at once.
     virtual void setLoadPriorities(const QHash<QPointer<QObject>, float>& priorities);
     
+    /// Sets a load priority for one owner that is evaluated again each time the pending loads are ordered, for
+    /// priorities that change as the view moves.
+    void setLoadPriorityOperator(const QPointer<QObject>& owner, std::function<float()> priorityOperator);
+
     /// Clears the load priority for one owner.
     virtual void clearLoadPriority(const QPointer<QObject>& owner);
     
@@ -463,6 +524,7 @@ protected:
     bool _loaded = false;
 
     QHash<QPointer<QObject>, float> _loadPriorities;
+    QHash<QPointer<QObject>, std::function<float()>> _loadPriorityOperators;
     QWeakPointer<Resource> _self;
     QPointer<ResourceCache> _cache;
 
@@ -117,6 +117,19 @@ ResourceRequest* ResourceManager::createResourceRequest(QObject* parent, const Q
     return request;
 }
 
+ResourceRequestBackend ResourceManager::getRequestBackend(const QUrl& url) {
+    auto scheme = normalizeURL(url).scheme();
+
+    if (scheme == URL_SCHEME_FILE) {
+        return ResourceRequestBackend::File;
+    } else if (scheme == URL_SCHEME_ATP) {
+        return ResourceRequestBackend::ATP;
+    }
+
+    // urls with unknown schemes fail to make a request, so they can count against any of the backends
+    return ResourceRequestBackend::HTTP;
+}
+
 
 bool ResourceManager::resourceExists(const QUrl& url) {
     auto scheme = url.scheme();
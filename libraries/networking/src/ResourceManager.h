@@ -24,6 +24,14 @@ const QString URL_SCHEME_HTTPS = "https";
 const QString URL_SCHEME_FTP = "ftp";
 const QString URL_SCHEME_ATP = "atp";
 
+// the kinds of requests createResourceRequest makes, which the resource caches limit separately
+enum class ResourceRequestBackend : int {
+    HTTP = 0,
+    ATP,
+    File,
+    NumBackends
+};
+
 class ResourceManager {
 public:
 
@@ -32,6 +40,7 @@ public:
     static QUrl normalizeURL(const QUrl& url);
 
     static ResourceRequest* createResourceRequest(QObject* parent, const QUrl& url);
+    static ResourceRequestBackend getRequestBackend(const QUrl& url);
 
     static void init();
     static void cleanup();
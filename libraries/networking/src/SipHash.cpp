@@ -0,0 +1,88 @@
+//
+//  SipHash.cpp
+//  libraries/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SipHash.h"
+
+#include <cstring>
+
+#include <QtCore/QtEndian>
+
+namespace {
+
+inline quint64 rotateLeft(quint64 value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline quint64 readWord(const char* data) {
+    quint64 word;
+    memcpy(&word, data, sizeof(word));
+    return qFromLittleEndian(word);
+}
+
+inline void writeWord(char* data, quint64 word) {
+    word = qToLittleEndian(word);
+    memcpy(data, &word, sizeof(word));
+}
+
+struct State {
+    quint64 v0, v1, v2, v3;
+
+    void round() {
+        v0 += v1; v1 = rotateLeft(v1, 13); v1 ^= v0; v0 = rotateLeft(v0, 32);
+        v2 += v3; v3 = rotateLeft(v3, 16); v3 ^= v2;
+        v0 += v3; v3 = rotateLeft(v3, 21); v3 ^= v0;
+        v2 += v1; v1 = rotateLeft(v1, 17); v1 ^= v2; v2 = rotateLeft(v2, 32);
+    }
+
+    void compress(quint64 word) {
+        v3 ^= word;
+        round();
+        round();
+        v0 ^= word;
+    }
+
+    quint64 finalize(quint64 flag) {
+        v2 ^= flag;
+        round();
+        round();
+        round();
+        round();
+        return v0 ^ v1 ^ v2 ^ v3;
+    }
+};
+
+}
+
+void SipHash::hash128(const char* key, const char* data, qint64 size, char* hash) {
+    quint64 key0 = readWord(key);
+    quint64 key1 = readWord(key + sizeof(quint64));
+
+    State state {
+        key0 ^ 0x736f6d6570736575ULL,
+        key1 ^ 0x646f72616e646f6dULL ^ 0xee,
+        key0 ^ 0x6c7967656e657261ULL,
+        key1 ^ 0x7465646279746573ULL
+    };
+
+    const char* wordsEnd = data + (size & ~7);
+    for (; data != wordsEnd; data += sizeof(quint64)) {
+        state.compress(readWord(data));
+    }
+
+    // the last word holds the remaining bytes and the low byte of the size
+    char lastBytes[sizeof(quint64)] = { 0 };
+    memcpy(lastBytes, data, size & 7);
+    state.compress(readWord(lastBytes) | ((quint64)size << 56));
+
+    writeWord(hash, state.finalize(0xee));
+
+    state.v1 ^= 0xdd;
+    writeWord(hash + sizeof(quint64), state.finalize(0));
+}
@@ -0,0 +1,28 @@
+//
+//  SipHash.h
+//  libraries/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_SipHash_h
+#define hifi_SipHash_h
+
+#include <QtCore/QtGlobal>
+
+// SipHash-2-4 with a 128-bit output, a keyed hash for short messages (https://131002.net/siphash/)
+//   It hashes in place and does not allocate, so it is cheap enough to authenticate every packet.
+namespace SipHash {
+    const int KEY_SIZE = 16;
+    const int HASH_SIZE = 16;
+
+    // writes the HASH_SIZE byte hash of size bytes of data, keyed by KEY_SIZE bytes of key, to hash
+    void hash128(const char* key, const char* data, qint64 size, char* hash);
+}
+
+#endif // hifi_SipHash_h
@@ -19,6 +19,7 @@
 #include "ThreadedAssignment.h"
 
 #include "NetworkLogging.h"
+#include "udt/PacketBufferPool.h"
 
 ThreadedAssignment::ThreadedAssignment(ReceivedMessage& message) :
     Assignment(message),
@@ -103,6 +104,8 @@ void ThreadedAssignment::addPacketStatsAndSendStatsPacket(QJsonObject statsObjec
     ioStats["outbound_packets_per_s"] = packetsOutPerSecond;
 
     statsObject["io_stats"] = ioStats;
+    statsObject["packet_buffers"] = udt::PacketBufferPool::takeStats();
+    statsObject["send_queue_pool"] = nodeList->takeSendQueuePoolStats();
 
     nodeList->sendStatsToDomainServer(statsObject);
 }
@@ -0,0 +1,327 @@
+//
+//  BBRCC.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BBRCC.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include <QtCore/QtGlobal>
+
+using namespace udt;
+using namespace std::chrono;
+
+static const double USECS_PER_SECOND = 1000000.0;
+
+// 2 / ln(2), the smallest gain that doubles the delivery rate every round trip in startup
+static const double HIGH_GAIN = 2.885;
+
+// pacing gains of the probe bandwidth cycle, each held for about one minimum RTT
+static const double PROBE_BANDWIDTH_GAINS[] = { 1.25, 0.75, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0 };
+static const int PROBE_BANDWIDTH_CYCLE_LENGTH = sizeof(PROBE_BANDWIDTH_GAINS) / sizeof(PROBE_BANDWIDTH_GAINS[0]);
+static const int PROBE_BANDWIDTH_DRAIN_INDEX = 1;
+static const double PROBE_BANDWIDTH_CONGESTION_WINDOW_GAIN = 2.0;
+
+static const int BANDWIDTH_FILTER_ROUNDS = 10;
+static const auto MIN_RTT_FILTER_WINDOW = seconds(10);
+static const auto PROBE_RTT_DURATION = milliseconds(200);
+
+// startup ends once the bandwidth has not grown by 25% for this many rounds
+static const double FULL_BANDWIDTH_GROWTH = 1.25;
+static const int FULL_BANDWIDTH_ROUNDS = 3;
+
+static const int INITIAL_CONGESTION_WINDOW_PACKETS = 10;
+static const int MIN_CONGESTION_WINDOW_PACKETS = 4;
+
+static const int MAX_RTT_SAMPLE_MICROSECONDS = 10000000;
+
+BBRCC::BBRCC() :
+    _pacingGain(HIGH_GAIN),
+    _congestionWindowGain(HIGH_GAIN)
+{
+    _packetSendPeriod = 0.0;
+    _congestionWindowSize = INITIAL_CONGESTION_WINDOW_PACKETS;
+
+    setAckInterval(1); // the delivery rate is sampled from an ACK for every packet received
+
+    // we can't do this as a member initializer until our VS has support for constexpr
+    _minRTT = std::numeric_limits<int>::max();
+}
+
+double BBRCC::getBottleneckBandwidth() const {
+    return _bandwidthSamples.empty() ? 0.0 : _bandwidthSamples.front().packetsPerSecond;
+}
+
+bool BBRCC::onACK(SequenceNumber ack, p_high_resolution_clock::time_point receiveTime) {
+    auto previousAck = _lastACK;
+    _lastACK = ack;
+
+    // ACKs are cumulative, so every packet up to this one has been delivered
+    int newlyDelivered = 0;
+    SentPacket lastDelivered;
+
+    auto it = _sentPackets.begin();
+    while (it != _sentPackets.end() && it->first <= ack) {
+        lastDelivered = it->second;
+        ++newlyDelivered;
+        it = _sentPackets.erase(it);
+    }
+
+    if (newlyDelivered > 0) {
+        _delivered += newlyDelivered;
+        _deliveredTime = receiveTime;
+        _firstSendTime = lastDelivered.sendTime;
+
+        int rtt = duration_cast<microseconds>(receiveTime - lastDelivered.sendTime).count();
+        rtt = std::max(1, std::min(rtt, MAX_RTT_SAMPLE_MICROSECONDS));
+
+        // the delivery rate over the flight of the packet, which can't be faster than the rate the flight was sent at
+        auto sendElapsed = lastDelivered.sendTime - lastDelivered.firstSendTime;
+        auto ackElapsed = receiveTime - lastDelivered.deliveredTime;
+        auto interval = duration_cast<microseconds>(std::max(sendElapsed, ackElapsed)).count();
+
+        // a round trip ends when a packet sent after it began is delivered
+        bool isRoundStart = false;
+        if (lastDelivered.delivered >= _nextRoundDelivered) {
+            _nextRoundDelivered = _delivered;
+            ++_round;
+            isRoundStart = true;
+        }
+
+        if (interval > 0 && interval >= std::min(_minRTT, rtt)) {
+            updateBottleneckBandwidth((_delivered - lastDelivered.delivered) * USECS_PER_SECOND / interval);
+        }
+
+        updateMinRTT(rtt, receiveTime);
+
+        if (isRoundStart && !_isPipeFull) {
+            checkFullPipe();
+        }
+
+        // keep an EWMA of the RTT and its variance, like TCPVegasCC, to time out un-ACKed packets
+        static const int RTT_ESTIMATION_ALPHA = 8;
+        static const int RTT_ESTIMATION_VARIANCE_ALPHA = 4;
+
+        if (_ewmaRTT == -1) {
+            _ewmaRTT = rtt;
+            _rttVariance = rtt / 2;
+        } else {
+            _ewmaRTT = (_ewmaRTT * (RTT_ESTIMATION_ALPHA - 1) + rtt) / RTT_ESTIMATION_ALPHA;
+            _rttVariance = (_rttVariance * (RTT_ESTIMATION_VARIANCE_ALPHA - 1)
+                            + abs(rtt - _ewmaRTT)) / RTT_ESTIMATION_VARIANCE_ALPHA;
+        }
+    }
+
+    updateMode(receiveTime);
+    updateControlParameters();
+
+    return isFastRetransmitNeeded(ack, previousAck, receiveTime);
+}
+
+void BBRCC::updateBottleneckBandwidth(double packetsPerSecond) {
+    // drop the samples of rounds that have left the filter window
+    while (!_bandwidthSamples.empty() && _bandwidthSamples.front().round <= _round - BANDWIDTH_FILTER_ROUNDS) {
+        _bandwidthSamples.pop_front();
+    }
+
+    // keep the samples in decreasing order, so that the maximum is at the front
+    while (!_bandwidthSamples.empty() && _bandwidthSamples.back().packetsPerSecond <= packetsPerSecond) {
+        _bandwidthSamples.pop_back();
+    }
+
+    _bandwidthSamples.push_back({ _round, packetsPerSecond });
+}
+
+void BBRCC::updateMinRTT(int rtt, TimePoint now) {
+    bool hasExpired = _minRTT != std::numeric_limits<int>::max() && now - _minRTTTimestamp > MIN_RTT_FILTER_WINDOW;
+
+    if (rtt <= _minRTT || hasExpired) {
+        _minRTT = rtt;
+        _minRTTTimestamp = now;
+    }
+
+    if (hasExpired && _mode != Mode::ProbeRTT) {
+        // the minimum RTT hasn't been seen again for a while - drain the pipe briefly to measure it
+        _modeBeforeProbeRTT = _mode;
+        _mode = Mode::ProbeRTT;
+        _pacingGain = 1.0;
+        _congestionWindowGain = 1.0;
+        _probeRTTRound = -1;
+    }
+}
+
+void BBRCC::checkFullPipe() {
+    double bandwidth = getBottleneckBandwidth();
+
+    if (bandwidth >= _fullBandwidth * FULL_BANDWIDTH_GROWTH) {
+        // still growing
+        _fullBandwidth = bandwidth;
+        _fullBandwidthRounds = 0;
+    } else if (++_fullBandwidthRounds >= FULL_BANDWIDTH_ROUNDS) {
+        _isPipeFull = true;
+    }
+}
+
+void BBRCC::updateMode(TimePoint now) {
+    if (_mode == Mode::Startup && _isPipeFull) {
+        // drain the queue that startup built at the bottleneck
+        _mode = Mode::Drain;
+        _pacingGain = 1.0 / HIGH_GAIN;
+        _congestionWindowGain = HIGH_GAIN;
+    }
+
+    if (_mode == Mode::Drain && getPacketsInFlight() <= getBandwidthDelayProduct(1.0)) {
+        // start the cycle at a random phase other than the drain phase, so that flows don't synchronize
+        static std::random_device randomDevice;
+        static std::mt19937 generator(randomDevice());
+        static std::uniform_int_distribution<> distribution(0, PROBE_BANDWIDTH_CYCLE_LENGTH - 2);
+
+        _mode = Mode::ProbeBandwidth;
+        _cycleIndex = distribution(generator);
+        _cycleIndex += (_cycleIndex >= PROBE_BANDWIDTH_DRAIN_INDEX) ? 1 : 0;
+        _cycleTimestamp = now;
+        _pacingGain = PROBE_BANDWIDTH_GAINS[_cycleIndex];
+        _congestionWindowGain = PROBE_BANDWIDTH_CONGESTION_WINDOW_GAIN;
+    }
+
+    if (_mode == Mode::ProbeBandwidth) {
+        advanceCycle(now);
+    }
+
+    if (_mode == Mode::ProbeRTT) {
+        if (_probeRTTRound < 0) {
+            if (getPacketsInFlight() <= MIN_CONGESTION_WINDOW_PACKETS) {
+                // the pipe is drained - hold it there for a while, and at least a round trip
+                _probeRTTDoneTimestamp = now + PROBE_RTT_DURATION;
+                _probeRTTRound = _round + 1;
+            }
+        } else if (now >= _probeRTTDoneTimestamp && _round >= _probeRTTRound) {
+            _minRTTTimestamp = now;
+
+            if (_isPipeFull) {
+                _mode = Mode::ProbeBandwidth;
+                _cycleIndex = PROBE_BANDWIDTH_CYCLE_LENGTH - 1;
+                _cycleTimestamp = now;
+                _pacingGain = PROBE_BANDWIDTH_GAINS[_cycleIndex];
+                _congestionWindowGain = PROBE_BANDWIDTH_CONGESTION_WINDOW_GAIN;
+            } else {
+                _mode = Mode::Startup;
+                _pacingGain = HIGH_GAIN;
+                _congestionWindowGain = HIGH_GAIN;
+            }
+        }
+    }
+}
+
+void BBRCC::advanceCycle(TimePoint now) {
+    bool isFullLength = duration_cast<microseconds>(now - _cycleTimestamp).count() > _minRTT;
+    double gain = PROBE_BANDWIDTH_GAINS[_cycleIndex];
+
+    bool shouldAdvance;
+    if (gain > 1.0) {
+        // probing for more bandwidth lasts until enough is in flight to use it
+        shouldAdvance = isFullLength && getPacketsInFlight() >= getBandwidthDelayProduct(gain);
+    } else if (gain < 1.0) {
+        // draining what probing queued ends early once it's gone
+        shouldAdvance = isFullLength || getPacketsInFlight() <= getBandwidthDelayProduct(1.0);
+    } else {
+        shouldAdvance = isFullLength;
+    }
+
+    if (shouldAdvance) {
+        _cycleIndex = (_cycleIndex + 1) % PROBE_BANDWIDTH_CYCLE_LENGTH;
+        _cycleTimestamp = now;
+        _pacingGain = PROBE_BANDWIDTH_GAINS[_cycleIndex];
+    }
+}
+
+void BBRCC::updateControlParameters() {
+    double bandwidth = getBottleneckBandwidth();
+    if (bandwidth <= 0.0) {
+        // no delivery rate sample yet, keep sending with the initial window
+        return;
+    }
+
+    setPacketSendPeriod(USECS_PER_SECOND / (_pacingGain * bandwidth));
+
+    int congestionWindow;
+    if (_mode == Mode::ProbeRTT) {
+        congestionWindow = MIN_CONGESTION_WINDOW_PACKETS;
+    } else {
+        congestionWindow = std::max(getBandwidthDelayProduct(_congestionWindowGain), MIN_CONGESTION_WINDOW_PACKETS);
+
+        if (!_isPipeFull) {
+            // don't shrink the window while the bandwidth is still being discovered
+            congestionWindow = std::max(congestionWindow, _congestionWindowSize);
+        }
+    }
+
+    _congestionWindowSize = std::min(congestionWindow, udt::MAX_PACKETS_IN_FLIGHT);
+}
+
+int BBRCC::getBandwidthDelayProduct(double gain) const {
+    if (_minRTT == std::numeric_limits<int>::max() || _bandwidthSamples.empty()) {
+        return INITIAL_CONGESTION_WINDOW_PACKETS;
+    }
+
+    return (int)std::ceil(gain * getBottleneckBandwidth() * _minRTT / USECS_PER_SECOND);
+}
+
+int BBRCC::getPacketsInFlight() const {
+    return (int)_sentPackets.size();
+}
+
+bool BBRCC::isFastRetransmitNeeded(SequenceNumber ack, SequenceNumber previousAck, TimePoint now) {
+    ++_numACKSinceFastRetransmit;
+
+    // BBR doesn't slow down for loss, but without NAKs a duplicate ACK is how we find out about it
+    if (ack == previousAck || _numACKSinceFastRetransmit < 3) {
+        // we may need to re-send ackNum + 1 if it has been more than our estimated timeout since it was sent
+        auto it = _sentPackets.find(ack + 1);
+        if (it != _sentPackets.end() && _ewmaRTT != -1) {
+            auto estimatedTimeout = _ewmaRTT + _rttVariance * 4;
+            auto sinceSend = duration_cast<microseconds>(now - it->second.sendTime).count();
+
+            if (sinceSend >= estimatedTimeout) {
+                _numACKSinceFastRetransmit = 0;
+                return true;
+            }
+        }
+
+        // if this is the 3rd duplicate ACK, we fallback to Reno's fast re-transmit
+        static const int RENO_FAST_RETRANSMIT_DUPLICATE_COUNT = 3;
+
+        ++_duplicateACKCount;
+
+        if (ack == previousAck && _duplicateACKCount == RENO_FAST_RETRANSMIT_DUPLICATE_COUNT) {
+            _numACKSinceFastRetransmit = 0;
+            _duplicateACKCount = 0;
+            return true;
+        }
+    } else {
+        _duplicateACKCount = 0;
+    }
+
+    return false;
+}
+
+void BBRCC::onPacketSent(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) {
+    if (_sentPackets.empty()) {
+        // nothing is in flight, so the delivery rate of this flight starts now rather than at the last delivery
+        _firstSendTime = timePoint;
+        _deliveredTime = timePoint;
+    }
+
+    // re-sent packets keep the state of their first send, and ones that were ACKed meanwhile are not in flight
+    if (seqNum > _lastACK && _sentPackets.find(seqNum) == _sentPackets.end()) {
+        _sentPackets[seqNum] = { timePoint, _delivered, _deliveredTime, _firstSendTime };
+    }
+}
@@ -0,0 +1,124 @@
+//
+//  BBRCC.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_BBRCC_h
+#define hifi_BBRCC_h
+
+#include <deque>
+#include <map>
+
+#include "CongestionControl.h"
+#include "Constants.h"
+
+namespace udt {
+
+// Congestion control modelled on BBR, which paces at the bottleneck bandwidth it measures and keeps up to two
+// bandwidth-delay products in flight (a congestion window gain of 2 while probing bandwidth), rather than backing off
+// on queueing delay (Vegas) or loss (Reno)
+//   http://queue.acm.org/detail.cfm?id=3022184
+// Like TCPVegasCC it has the receiver ACK every packet, and samples the delivery rate and RTT from those ACKs.
+class BBRCC : public CongestionControl {
+public:
+    enum class Mode {
+        Startup, // doubles the sending rate every round trip, until the bandwidth stops growing
+        Drain, // drains the queue built during startup
+        ProbeBandwidth, // cycles the pacing gain around 1 to probe for more bandwidth
+        ProbeRTT // briefly drops what is in flight to measure the minimum RTT again
+    };
+
+    BBRCC();
+
+    virtual bool onACK(SequenceNumber ackNum, p_high_resolution_clock::time_point receiveTime) override;
+    virtual void onLoss(SequenceNumber rangeStart, SequenceNumber rangeEnd) override {};
+    virtual void onTimeout() override {};
+
+    virtual bool shouldNAK() override { return false; }
+    virtual bool shouldACK2() override { return false; }
+    virtual bool shouldProbe() override { return false; }
+
+    virtual void onPacketSent(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) override;
+
+    Mode getMode() const { return _mode; }
+    double getBottleneckBandwidth() const; // in packets per second, 0 until there is a sample
+    int getMinRTT() const { return _minRTT; } // in microseconds
+
+protected:
+    virtual void setInitialSendSequenceNumber(SequenceNumber seqNum) override { _lastACK = seqNum - 1; }
+
+private:
+    using TimePoint = p_high_resolution_clock::time_point;
+
+    struct SentPacket {
+        TimePoint sendTime;
+        int64_t delivered; // the value of _delivered when the packet was sent
+        TimePoint deliveredTime; // the value of _deliveredTime when the packet was sent
+        TimePoint firstSendTime; // the send time of the packet that was ACKed last when the packet was sent
+    };
+
+    struct BandwidthSample {
+        int64_t round;
+        double packetsPerSecond;
+    };
+
+    void updateBottleneckBandwidth(double packetsPerSecond);
+    void updateMinRTT(int rtt, TimePoint now);
+    void checkFullPipe();
+    void updateMode(TimePoint now);
+    void advanceCycle(TimePoint now);
+    void updateControlParameters();
+
+    int getBandwidthDelayProduct(double gain) const; // in packets
+    int getPacketsInFlight() const;
+
+    bool isFastRetransmitNeeded(SequenceNumber ack, SequenceNumber previousAck, TimePoint now);
+
+    using SentPacketList = std::map<SequenceNumber, SentPacket>;
+    SentPacketList _sentPackets; // packets sent and not yet ACKed, by sequence number
+
+    SequenceNumber _lastACK; // Sequence number of last packet that was ACKed
+
+    int64_t _delivered { 0 }; // number of packets delivered so far
+    TimePoint _deliveredTime; // time of the last delivery
+    TimePoint _firstSendTime; // send time of the packet that was ACKed last
+
+    int64_t _round { 0 }; // number of round trips so far
+    int64_t _nextRoundDelivered { 0 }; // the round ends once this many packets are delivered
+
+    std::deque<BandwidthSample> _bandwidthSamples; // windowed max filter of the delivery rate over recent rounds
+
+    int _minRTT; // lowest RTT in the filter window, in microseconds
+    TimePoint _minRTTTimestamp; // when _minRTT was sampled
+
+    Mode _mode { Mode::Startup };
+    double _pacingGain;
+    double _congestionWindowGain;
+
+    double _fullBandwidth { 0.0 }; // bandwidth when it last grew in startup
+    int _fullBandwidthRounds { 0 }; // rounds in startup without bandwidth growth
+    bool _isPipeFull { false };
+
+    int _cycleIndex { 0 }; // index of the pacing gain in the probe bandwidth cycle
+    TimePoint _cycleTimestamp; // when the current gain of the cycle began
+
+    TimePoint _probeRTTDoneTimestamp; // when the probe RTT mode may end, once the pipe is drained
+    int64_t _probeRTTRound { -1 };
+    Mode _modeBeforeProbeRTT { Mode::Startup };
+
+    int _ewmaRTT { -1 }; // Exponential weighted moving average RTT, for fast re-transmits
+    int _rttVariance { 0 }; // Variance in collected RTT values
+    int _numACKSinceFastRetransmit { 3 }; // Number of ACKs received since fast re-transmit, default avoids immediate re-transmit
+    int _duplicateACKCount { 0 }; // Counter for duplicate ACKs received
+};
+
+}
+
+#endif // hifi_BBRCC_h
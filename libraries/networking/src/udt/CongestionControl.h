@@ -39,6 +39,9 @@ public:
     int synInterval() const { return _synInterval; }
     void setMaxBandwidth(int maxBandwidth);
 
+    double getPacketSendPeriod() const { return _packetSendPeriod; }
+    int getCongestionWindowSize() const { return _congestionWindowSize; }
+
     virtual void init() {}
 
     // return value specifies if connection should perform a fast re-transmit of ACK + 1 (used in TCP style congestion control)
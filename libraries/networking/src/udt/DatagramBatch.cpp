@@ -0,0 +1,95 @@
+//
+//  DatagramBatch.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "DatagramBatch.h"
+
+#ifdef UDT_BATCHED_IO
+
+#include <cerrno>
+#include <cstring>
+
+using namespace udt;
+
+int DatagramBatch::receive(int socketDescriptor) {
+    for (int i = 0; i < BATCH_SIZE; ++i) {
+        // replace the buffers that were taken by the last receive
+        if (!_buffers[i]) {
+            _buffers[i] = PacketBufferPool::allocate(MAX_PACKET_SIZE);
+        }
+
+        _vectors[i].iov_base = _buffers[i].get();
+        _vectors[i].iov_len = MAX_PACKET_SIZE;
+
+        msghdr& header = _headers[i].msg_hdr;
+        memset(&header, 0, sizeof(header));
+        header.msg_name = &_addresses[i];
+        header.msg_namelen = sizeof(_addresses[i]);
+        header.msg_iov = &_vectors[i];
+        header.msg_iovlen = 1;
+        _headers[i].msg_len = 0;
+    }
+
+    return recvmmsg(socketDescriptor, _headers.data(), BATCH_SIZE, MSG_DONTWAIT, nullptr);
+}
+
+HifiSockAddr DatagramBatch::getSenderSockAddr(int index) const {
+    return HifiSockAddr(reinterpret_cast<const sockaddr*>(&_addresses[index]));
+}
+
+bool DatagramBatch::queue(const char* data, qint64 size, const HifiSockAddr& sockAddr) {
+    if (_numQueued == BATCH_SIZE || sockAddr.getAddress().protocol() != QAbstractSocket::IPv4Protocol) {
+        return false;
+    }
+
+    sockaddr_in& address = reinterpret_cast<sockaddr_in&>(_addresses[_numQueued]);
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(sockAddr.getAddress().toIPv4Address());
+    address.sin_port = htons(sockAddr.getPort());
+
+    _vectors[_numQueued].iov_base = const_cast<char*>(data);
+    _vectors[_numQueued].iov_len = size;
+
+    msghdr& header = _headers[_numQueued].msg_hdr;
+    memset(&header, 0, sizeof(header));
+    header.msg_name = &address;
+    header.msg_namelen = sizeof(address);
+    header.msg_iov = &_vectors[_numQueued];
+    header.msg_iovlen = 1;
+
+    ++_numQueued;
+    return true;
+}
+
+qint64 DatagramBatch::send(int socketDescriptor) {
+    qint64 bytesSent = 0;
+    int numSent = 0;
+
+    // sendmmsg may stop short of the whole batch, so resume from the first datagram it did not send
+    while (numSent < _numQueued) {
+        int result = sendmmsg(socketDescriptor, _headers.data() + numSent, _numQueued - numSent, 0);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        for (int i = numSent; i < numSent + result; ++i) {
+            bytesSent += _headers[i].msg_len;
+        }
+        numSent += result;
+    }
+
+    _numQueued = 0;
+    return (numSent > 0) ? bytesSent : -1;
+}
+
+#endif // UDT_BATCHED_IO
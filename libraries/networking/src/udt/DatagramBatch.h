@@ -0,0 +1,76 @@
+//
+//  DatagramBatch.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_DatagramBatch_h
+#define hifi_DatagramBatch_h
+
+#include <QtCore/QtGlobal>
+
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+#define UDT_BATCHED_IO
+#endif
+
+#ifdef UDT_BATCHED_IO
+
+#include <array>
+#include <memory>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "../HifiSockAddr.h"
+#include "Constants.h"
+#include "PacketBufferPool.h"
+
+namespace udt {
+
+// Reads or writes a batch of datagrams with a single recvmmsg/sendmmsg system call
+//   Receive buffers are drawn from the PacketBufferPool, and a slot only gets a new one once its buffer is taken.
+//   DatagramBatch is not thread-safe; each reader or writer needs its own.
+class DatagramBatch {
+public:
+    static const int BATCH_SIZE = 64;
+
+    // reads up to BATCH_SIZE pending datagrams, without blocking
+    // returns the number of datagrams read, or -1 on error (with errno set, EAGAIN if none were pending)
+    int receive(int socketDescriptor);
+
+    // accessors for the datagrams of the last receive, in [0, the number read)
+    qint64 getSize(int index) const { return _headers[index].msg_len; }
+    bool isTruncated(int index) const { return _headers[index].msg_hdr.msg_flags & MSG_TRUNC; }
+    HifiSockAddr getSenderSockAddr(int index) const;
+
+    // takes the buffer of a datagram, which holds at least getSize(index) bytes
+    PacketBufferPool::Buffer takeData(int index) { return std::move(_buffers[index]); }
+
+    // queues an IPv4 datagram to be sent; data is not copied, and must remain valid until send
+    // returns false if the batch is full or the address is not IPv4
+    bool queue(const char* data, qint64 size, const HifiSockAddr& sockAddr);
+    int getNumQueued() const { return _numQueued; }
+
+    // sends the queued datagrams and clears the queue
+    // returns the number of bytes sent, or -1 if the first datagram could not be sent (with errno set)
+    qint64 send(int socketDescriptor);
+
+private:
+    std::array<mmsghdr, BATCH_SIZE> _headers;
+    std::array<iovec, BATCH_SIZE> _vectors;
+    std::array<sockaddr_storage, BATCH_SIZE> _addresses;
+    std::array<PacketBufferPool::Buffer, BATCH_SIZE> _buffers;
+    int _numQueued { 0 };
+};
+
+} // namespace udt
+
+#endif // UDT_BATCHED_IO
+
+#endif // hifi_DatagramBatch_h
@@ -0,0 +1,260 @@
+//
+//  LinkImpairment.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LinkImpairment.h"
+
+#include <QtCore/QStringList>
+
+using namespace udt;
+using namespace std::chrono;
+
+static const double PERCENT = 100.0;
+static const double BITS_PER_BYTE = 8.0;
+static const int UDP_IP_HEADER_BYTES = 28;
+
+bool LinkImpairment::Profile::fromString(const QString& string, Profile& profile) {
+    Profile parsed;
+
+    for (auto& setting : string.split(',', QString::SkipEmptyParts)) {
+        QStringList keyValue = setting.trimmed().split('=');
+        if (keyValue.size() != 2) {
+            return false;
+        }
+
+        const QString& key = keyValue[0];
+        QStringList values = keyValue[1].split(':');
+        bool ok = true;
+        bool secondOK = true;
+
+        if (key == "loss" && values.size() == 1) {
+            parsed.lossRate = values[0].toDouble(&ok) / PERCENT;
+        } else if (key == "burst" && values.size() == 2) {
+            parsed.burstStartRate = values[0].toDouble(&ok) / PERCENT;
+            double meanBurstLength = values[1].toDouble(&secondOK);
+            secondOK = secondOK && meanBurstLength >= 1.0;
+            parsed.burstEndRate = secondOK ? 1.0 / meanBurstLength : 1.0;
+        } else if (key == "reorder" && values.size() == 2) {
+            parsed.reorderRate = values[0].toDouble(&ok) / PERCENT;
+            parsed.reorderMsecs = values[1].toInt(&secondOK);
+        } else if (key == "latency" && values.size() == 1) {
+            parsed.latencyMsecs = values[0].toInt(&ok);
+        } else if (key == "jitter" && values.size() == 1) {
+            parsed.jitterMsecs = values[0].toInt(&ok);
+        } else if (key == "bandwidth" && values.size() == 1) {
+            parsed.bandwidthMbps = values[0].toDouble(&ok);
+        } else if (key == "queue" && values.size() == 1) {
+            parsed.queuePackets = values[0].toInt(&ok);
+        } else {
+            return false;
+        }
+
+        if (!ok || !secondOK) {
+            return false;
+        }
+    }
+
+    profile = parsed;
+    return true;
+}
+
+QString LinkImpairment::Profile::toString() const {
+    return QString("loss=%1,burst=%2:%3,reorder=%4:%5,latency=%6,jitter=%7,bandwidth=%8,queue=%9")
+        .arg(lossRate * PERCENT).arg(burstStartRate * PERCENT).arg(1.0 / burstEndRate)
+        .arg(reorderRate * PERCENT).arg(reorderMsecs).arg(latencyMsecs).arg(jitterMsecs)
+        .arg(bandwidthMbps).arg(queuePackets);
+}
+
+LinkImpairment::LinkImpairment(WriteFunction writeFunction) :
+    _writeFunction(writeFunction)
+{
+
+}
+
+LinkImpairment::~LinkImpairment() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isStopping = true;
+    }
+    _pendingCondition.notify_one();
+
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+void LinkImpairment::setProfile(const HifiSockAddr& sockAddr, const Profile& profile) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _profiles[sockAddr] = profile;
+    _isEnabled = true;
+}
+
+void LinkImpairment::clearProfile(const HifiSockAddr& sockAddr) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _profiles.erase(sockAddr);
+    _isEnabled = !_profiles.empty();
+}
+
+void LinkImpairment::clearProfiles() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _profiles.clear();
+    _isEnabled = false;
+}
+
+void LinkImpairment::seed(quint32 value) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _generator.seed(value);
+}
+
+const LinkImpairment::Profile* LinkImpairment::findProfile(const HifiSockAddr& sockAddr) const {
+    auto it = _profiles.find(sockAddr);
+    if (it == _profiles.end()) {
+        it = _profiles.find(HifiSockAddr());
+    }
+    return (it != _profiles.end()) ? &it->second : nullptr;
+}
+
+qint64 LinkImpairment::write(const QByteArray& datagram, const HifiSockAddr& sockAddr) {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    const Profile* profile = findProfile(sockAddr);
+    if (!profile) {
+        lock.unlock();
+        return _writeFunction(datagram, sockAddr);
+    }
+
+    Link& link = _links[sockAddr];
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+
+    // bursts follow the Gilbert model - every datagram is lost in a burst, which ends with a fixed probability
+    if (link.isInBurst) {
+        link.isInBurst = chance(_generator) >= profile->burstEndRate;
+    } else {
+        link.isInBurst = profile->burstStartRate > 0.0 && chance(_generator) < profile->burstStartRate;
+    }
+
+    if (link.isInBurst) {
+        ++link.stats.burstLost;
+        return datagram.size();
+    }
+
+    if (profile->lossRate > 0.0 && chance(_generator) < profile->lossRate) {
+        ++link.stats.lost;
+        return datagram.size();
+    }
+
+    auto now = p_high_resolution_clock::now();
+    auto releaseTime = now;
+
+    if (profile->bandwidthMbps > 0.0) {
+        // forget the datagrams that have left the bottleneck, then tail drop if the queue is still full
+        while (!link.departureTimes.empty() && link.departureTimes.front() <= now) {
+            link.departureTimes.pop_front();
+        }
+
+        if ((int)link.departureTimes.size() >= profile->queuePackets) {
+            ++link.stats.queueDrops;
+            return datagram.size();
+        }
+
+        auto transmissionTime = microseconds((qint64)((datagram.size() + UDP_IP_HEADER_BYTES) * BITS_PER_BYTE
+                                                      / profile->bandwidthMbps));
+        link.bottleneckFreeTime = std::max(link.bottleneckFreeTime, now) + transmissionTime;
+        link.departureTimes.push_back(link.bottleneckFreeTime);
+
+        releaseTime = link.bottleneckFreeTime;
+    }
+
+    releaseTime += milliseconds(profile->latencyMsecs);
+    if (profile->jitterMsecs > 0) {
+        releaseTime += microseconds(std::uniform_int_distribution<int>(0, profile->jitterMsecs * 1000)(_generator));
+    }
+
+    if (profile->reorderRate > 0.0 && chance(_generator) < profile->reorderRate) {
+        // held back without holding back the datagrams after it
+        ++link.stats.reordered;
+        releaseTime = std::max(releaseTime, link.lastReleaseTime) + milliseconds(profile->reorderMsecs);
+    } else {
+        // keep the order of the datagrams that aren't re-ordered
+        releaseTime = std::max(releaseTime, link.lastReleaseTime);
+        link.lastReleaseTime = releaseTime;
+    }
+
+    ++link.stats.written;
+
+    if (releaseTime <= now && _pendingDatagrams.empty()) {
+        lock.unlock();
+        _writeFunction(datagram, sockAddr);
+        return datagram.size();
+    }
+
+    // the datagram may not own its data, so it is copied to be written later
+    _pendingDatagrams.emplace(releaseTime, PendingDatagram { QByteArray(datagram.constData(), datagram.size()), sockAddr });
+
+    if (!_thread.joinable()) {
+        _thread = std::thread([this] { run(); });
+    }
+
+    lock.unlock();
+    _pendingCondition.notify_one();
+
+    return datagram.size();
+}
+
+void LinkImpairment::run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (!_isStopping) {
+        if (_pendingDatagrams.empty()) {
+            _pendingCondition.wait(lock);
+            continue;
+        }
+
+        auto now = p_high_resolution_clock::now();
+        auto firstReleaseTime = _pendingDatagrams.begin()->first;
+        if (firstReleaseTime > now) {
+            _pendingCondition.wait_until(lock, firstReleaseTime);
+            continue;
+        }
+
+        // write the datagrams that are due without holding the lock
+        std::vector<PendingDatagram> dueDatagrams;
+        auto it = _pendingDatagrams.begin();
+        while (it != _pendingDatagrams.end() && it->first <= now) {
+            dueDatagrams.push_back(std::move(it->second));
+            it = _pendingDatagrams.erase(it);
+        }
+
+        _numWriting = (int)dueDatagrams.size();
+
+        lock.unlock();
+        for (auto& pending : dueDatagrams) {
+            _writeFunction(pending.datagram, pending.sockAddr);
+        }
+        lock.lock();
+
+        _numWriting = 0;
+    }
+}
+
+LinkImpairment::Stats LinkImpairment::takeStats(const HifiSockAddr& sockAddr) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    Stats stats;
+    auto it = _links.find(sockAddr);
+    if (it != _links.end()) {
+        std::swap(stats, it->second.stats);
+    }
+    return stats;
+}
+
+int LinkImpairment::getNumPending() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return (int)_pendingDatagrams.size() + _numWriting;
+}
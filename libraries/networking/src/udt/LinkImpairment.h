@@ -0,0 +1,134 @@
+//
+//  LinkImpairment.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_LinkImpairment_h
+#define hifi_LinkImpairment_h
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+#include <PortableHighResolutionClock.h>
+
+#include "../HifiSockAddr.h"
+
+// only test builds impair what a udt::Socket writes
+#if (PR_BUILD || DEV_BUILD)
+#define UDT_LINK_IMPAIRMENT
+#endif
+
+namespace udt {
+
+// Impairs datagrams on their way to the network, to reproduce lossy and slow links locally
+//   Each destination can have its own profile, and the profile of the null HifiSockAddr applies to every destination
+//   without one. Datagrams to a destination without a profile are written right away. Delayed datagrams are written
+//   by a thread of the impairment, started with the first of them.
+class LinkImpairment {
+public:
+    struct Profile {
+        double lossRate { 0.0 }; // probability that a datagram is dropped at random
+        double burstStartRate { 0.0 }; // probability that a loss burst starts at a datagram (Gilbert model)
+        double burstEndRate { 1.0 }; // probability that a loss burst ends at a datagram, for bursts of 1 / burstEndRate
+        double reorderRate { 0.0 }; // probability that a datagram is held back, so that the next ones overtake it
+        int reorderMsecs { 10 }; // how long re-ordered datagrams are held back
+        int latencyMsecs { 0 }; // delay added to every datagram
+        int jitterMsecs { 0 }; // maximum random delay added on top of the latency - jitter alone doesn't re-order
+        double bandwidthMbps { 0.0 }; // bottleneck rate, 0 for unlimited
+        int queuePackets { 1000 }; // datagrams queued at the bottleneck before it drops them
+
+        // parses comma separated settings, with percentages for rates, milliseconds for times and Mb/s for bandwidth
+        //   loss=1,burst=0.1:20,reorder=1:10,latency=50,jitter=10,bandwidth=20,queue=100
+        // where burst is the start rate and mean length of bursts, and reorder is the rate and time held back
+        // returns false if the string isn't a valid profile
+        static bool fromString(const QString& string, Profile& profile);
+        QString toString() const;
+    };
+
+    struct Stats {
+        int written { 0 }; // datagrams written, or to be written once their delay is over
+        int lost { 0 }; // datagrams dropped at random
+        int burstLost { 0 }; // datagrams dropped in loss bursts
+        int queueDrops { 0 }; // datagrams dropped at the bottleneck
+        int reordered { 0 }; // datagrams held back to be re-ordered
+    };
+
+    using WriteFunction = std::function<qint64(const QByteArray& datagram, const HifiSockAddr& sockAddr)>;
+
+    LinkImpairment(WriteFunction writeFunction);
+    ~LinkImpairment();
+
+    void setProfile(const HifiSockAddr& sockAddr, const Profile& profile);
+    void clearProfile(const HifiSockAddr& sockAddr);
+    void clearProfiles();
+
+    // whether any destination has a profile
+    bool isEnabled() const { return _isEnabled; }
+
+    // seeds the impairments, for tests that need them to be reproducible
+    void seed(quint32 value);
+
+    // writes the datagram now, later, or never, according to the profile of its destination
+    // returns the size of the datagram if it is impaired, as if the network had taken it
+    qint64 write(const QByteArray& datagram, const HifiSockAddr& sockAddr);
+
+    // returns the stats of a destination since the last call, and resets them
+    Stats takeStats(const HifiSockAddr& sockAddr);
+
+    // the number of datagrams that haven't been written yet, because of their delay
+    int getNumPending();
+
+private:
+    using TimePoint = p_high_resolution_clock::time_point;
+
+    struct Link {
+        bool isInBurst { false };
+        TimePoint bottleneckFreeTime; // when the bottleneck is done with what is queued
+        std::deque<TimePoint> departureTimes; // when each datagram queued at the bottleneck leaves it
+        TimePoint lastReleaseTime; // when the last datagram that wasn't re-ordered is written
+        Stats stats;
+    };
+
+    struct PendingDatagram {
+        QByteArray datagram;
+        HifiSockAddr sockAddr;
+    };
+
+    const Profile* findProfile(const HifiSockAddr& sockAddr) const;
+    void run();
+
+    WriteFunction _writeFunction;
+
+    std::mutex _mutex;
+    std::atomic<bool> _isEnabled { false };
+    std::unordered_map<HifiSockAddr, Profile> _profiles;
+    std::unordered_map<HifiSockAddr, Link> _links;
+    std::mt19937 _generator { std::random_device()() };
+
+    std::multimap<TimePoint, PendingDatagram> _pendingDatagrams; // by the time they are written
+    int _numWriting { 0 }; // due datagrams the thread is writing
+    std::condition_variable _pendingCondition;
+    std::thread _thread;
+    bool _isStopping { false };
+};
+
+}
+
+#endif // hifi_LinkImpairment_h
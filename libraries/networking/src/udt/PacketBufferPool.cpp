@@ -0,0 +1,137 @@
+//
+//  PacketBufferPool.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketBufferPool.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QString>
+
+#include "Constants.h"
+
+using namespace udt;
+
+namespace {
+
+// control packets and small unreliable packets, mid-size packets, and full packets
+const qint64 SIZE_CLASSES[PacketBufferPool::NUM_SIZE_CLASSES] = { 128, 512, MAX_PACKET_SIZE };
+
+// free buffers kept per size class; any beyond this are deleted on release
+const size_t MAX_FREE_BUFFERS = 4096;
+
+struct SizeClass {
+    std::mutex mutex;
+    std::vector<char*> freeBuffers;
+
+    std::atomic<int> numHits { 0 };
+    std::atomic<int> numMisses { 0 };
+    std::atomic<int> numInUse { 0 };
+    std::atomic<int> highWaterMark { 0 };
+};
+
+SizeClass* sizeClasses() {
+    // never destroyed, since packets may still be released by static destructors
+    static SizeClass* classes = new SizeClass[PacketBufferPool::NUM_SIZE_CLASSES];
+    return classes;
+}
+
+}
+
+qint64 PacketBufferPool::sizeOfClass(int sizeClass) {
+    return SIZE_CLASSES[sizeClass];
+}
+
+PacketBufferPool::Buffer PacketBufferPool::allocate(qint64 size) {
+    int index = 0;
+    while (index < NUM_SIZE_CLASSES && SIZE_CLASSES[index] < size) {
+        ++index;
+    }
+
+    if (index == NUM_SIZE_CLASSES) {
+        return Buffer(new char[size]);
+    }
+
+    SizeClass& sizeClass = sizeClasses()[index];
+
+    char* buffer = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(sizeClass.mutex);
+        if (!sizeClass.freeBuffers.empty()) {
+            buffer = sizeClass.freeBuffers.back();
+            sizeClass.freeBuffers.pop_back();
+        }
+    }
+
+    if (buffer) {
+        ++sizeClass.numHits;
+    } else {
+        ++sizeClass.numMisses;
+        buffer = new char[SIZE_CLASSES[index]];
+    }
+
+    int numInUse = ++sizeClass.numInUse;
+    int highWaterMark = sizeClass.highWaterMark.load(std::memory_order_relaxed);
+    while (numInUse > highWaterMark &&
+           !sizeClass.highWaterMark.compare_exchange_weak(highWaterMark, numInUse, std::memory_order_relaxed)) {
+    }
+
+    Buffer pooledBuffer(buffer);
+    pooledBuffer.get_deleter().sizeClass = index;
+    return pooledBuffer;
+}
+
+void PacketBufferPool::release(char* buffer, int index) {
+    if (!buffer) {
+        return;
+    }
+
+    if (index == HEAP) {
+        delete[] buffer;
+        return;
+    }
+
+    SizeClass& sizeClass = sizeClasses()[index];
+    --sizeClass.numInUse;
+
+    {
+        std::lock_guard<std::mutex> lock(sizeClass.mutex);
+        if (sizeClass.freeBuffers.size() < MAX_FREE_BUFFERS) {
+            sizeClass.freeBuffers.push_back(buffer);
+            return;
+        }
+    }
+
+    delete[] buffer;
+}
+
+QJsonObject PacketBufferPool::takeStats() {
+    QJsonObject stats;
+
+    for (int i = 0; i < NUM_SIZE_CLASSES; ++i) {
+        SizeClass& sizeClass = sizeClasses()[i];
+        int numInUse = sizeClass.numInUse.load();
+
+        QJsonObject classStats;
+        classStats["hits"] = sizeClass.numHits.exchange(0);
+        classStats["misses"] = sizeClass.numMisses.exchange(0);
+        classStats["in_use"] = numInUse;
+        classStats["high_water"] = sizeClass.highWaterMark.exchange(numInUse);
+        {
+            std::lock_guard<std::mutex> lock(sizeClass.mutex);
+            classStats["free"] = (int)sizeClass.freeBuffers.size();
+        }
+
+        stats[QString::number(SIZE_CLASSES[i])] = classStats;
+    }
+
+    return stats;
+}
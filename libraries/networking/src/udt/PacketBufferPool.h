@@ -0,0 +1,55 @@
+//
+//  PacketBufferPool.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_PacketBufferPool_h
+#define hifi_PacketBufferPool_h
+
+#include <memory>
+
+#include <QtCore/QJsonObject>
+
+namespace udt {
+
+// Thread-safe pool of packet buffers, in a few size classes up to MAX_PACKET_SIZE
+//   A buffer returns itself to the pool when released, from whichever thread releases it.
+//   Larger buffers, and those adopted from the heap, are deleted instead.
+class PacketBufferPool {
+public:
+    static const int NUM_SIZE_CLASSES = 3;
+    static const int HEAP = -1; // the size class of buffers that are not pooled
+
+    struct Deleter {
+        int sizeClass { HEAP };
+        void operator()(char* buffer) const { PacketBufferPool::release(buffer, sizeClass); }
+    };
+    using Buffer = std::unique_ptr<char[], Deleter>;
+
+    // returns a buffer of at least size bytes, whose contents are undefined
+    static Buffer allocate(qint64 size);
+
+    // wraps a buffer allocated with new[], so that it can be used where pooled buffers are
+    static Buffer adopt(std::unique_ptr<char[]> buffer) { return Buffer(buffer.release()); }
+
+    // returns the hits, misses, buffers in use, and high-water mark of buffers in use of each size class since the last
+    // call, keyed by the size of the class, and resets them
+    static QJsonObject takeStats();
+
+    // the size of the buffers of a size class
+    static qint64 sizeOfClass(int sizeClass);
+
+private:
+    static void release(char* buffer, int sizeClass);
+};
+
+} // namespace udt
+
+#endif // hifi_PacketBufferPool_h
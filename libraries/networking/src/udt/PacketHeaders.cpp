@@ -44,7 +44,7 @@ const QSet<PacketType> NON_SOURCED_PACKETS = QSet<PacketType>()
 PacketVersion versionForPacketType(PacketType packetType) {
     switch (packetType) {
         case PacketType::DomainList:
-            return static_cast<PacketVersion>(DomainListVersion::GetMachineFingerprintFromUUIDSupport);
+            return static_cast<PacketVersion>(DomainListVersion::HasHashType);
         case PacketType::EntityAdd:
         case PacketType::EntityEdit:
         case PacketType::EntityData:
@@ -65,6 +65,9 @@ PacketVersion versionForPacketType(PacketType packetType) {
         case PacketType::AssetGet:
         case PacketType::AssetUpload:
             return static_cast<PacketVersion>(AssetServerPacketVersion::RangeRequestSupport);
+        case PacketType::AssetChunkQuery:
+        case PacketType::AssetChunkUpload:
+            return static_cast<PacketVersion>(AssetServerPacketVersion::ChunkedUploadSupport);
         case PacketType::NodeIgnoreRequest:
             return 18; // Introduction of node ignore request (which replaced an unused packet tpye)
 
@@ -72,10 +75,10 @@ PacketVersion versionForPacketType(PacketType packetType) {
             return static_cast<PacketVersion>(DomainConnectionDeniedVersion::IncludesExtraInfo);
 
         case PacketType::DomainConnectRequest:
-            return static_cast<PacketVersion>(DomainConnectRequestVersion::HasMachineFingerprint);
+            return static_cast<PacketVersion>(DomainConnectRequestVersion::HasSupportedHashTypes);
 
         case PacketType::DomainServerAddedNode:
-            return static_cast<PacketVersion>(DomainServerAddedNodeVersion::PermissionsGrid);
+            return static_cast<PacketVersion>(DomainServerAddedNodeVersion::HasHashType);
 
         case PacketType::MixedAudio:
         case PacketType::SilentAudioFrame:
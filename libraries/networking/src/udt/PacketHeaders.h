@@ -114,7 +114,10 @@ public:
         EntityServerScriptLog,
         AdjustAvatarSorting,
         OctreeFileReplacement,
-        LAST_PACKET_TYPE = OctreeFileReplacement
+        AssetChunkQuery,
+        AssetChunkQueryReply,
+        AssetChunkUpload,
+        LAST_PACKET_TYPE = AssetChunkUpload
     };
 };
 
@@ -217,7 +220,8 @@ enum class EntityQueryPacketVersion: PacketVersion {
 
 enum class AssetServerPacketVersion: PacketVersion {
     VegasCongestionControl = 19,
-    RangeRequestSupport
+    RangeRequestSupport,
+    ChunkedUploadSupport
 };
 
 enum class AvatarMixerPacketVersion : PacketVersion {
@@ -243,7 +247,8 @@ enum class DomainConnectRequestVersion : PacketVersion {
     HasHostname,
     HasProtocolVersions,
     HasMACAddress,
-    HasMachineFingerprint
+    HasMachineFingerprint,
+    HasSupportedHashTypes
 };
 
 enum class DomainConnectionDeniedVersion : PacketVersion {
@@ -254,14 +259,16 @@ enum class DomainConnectionDeniedVersion : PacketVersion {
 
 enum class DomainServerAddedNodeVersion : PacketVersion {
     PrePermissionsGrid = 17,
-    PermissionsGrid
+    PermissionsGrid,
+    HasHashType
 };
 
 enum class DomainListVersion : PacketVersion {
     PrePermissionsGrid = 18,
     PermissionsGrid,
     GetUsernameFromUUIDSupport,
-    GetMachineFingerprintFromUUIDSupport
+    GetMachineFingerprintFromUUIDSupport,
+    HasHashType
 };
 
 enum class AudioVersion : PacketVersion {
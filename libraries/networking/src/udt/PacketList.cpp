@@ -158,6 +158,38 @@ void PacketList::preparePackets(MessageNumber messageNumber) {
     }
 }
 
+void PacketList::setDeferredWriter(DeferredWriter writer) {
+    Q_ASSERT_X(_isReliable && _isOrdered, "PacketList::setDeferredWriter",
+               "Only reliable ordered PacketLists can write their data as they are sent");
+    _deferredWriter = writer;
+}
+
+bool PacketList::takeDeferredPackets(std::list<std::unique_ptr<Packet>>& packets) {
+    // the packets the writer completes at once - this bounds the packets of the list that wait in memory to be sent
+    static const qint64 DEFERRED_WRITE_PACKETS = 32;
+
+    if (_deferredWriter && !_deferredWriter(*this, DEFERRED_WRITE_PACKETS * Packet::maxPayloadSize(true))) {
+        _deferredWriter = DeferredWriter();
+        closeCurrentPacket();
+    }
+
+    if (_deferredWriter && !_currentPacket && !_packets.empty()) {
+        // hold back the last packet until we know whether it ends the message
+        _currentPacket = std::move(_packets.back());
+        _packets.pop_back();
+    }
+
+    if (_packetFinisher) {
+        for (auto& packet : _packets) {
+            _packetFinisher(*packet);
+        }
+    }
+
+    packets.splice(packets.end(), _packets);
+
+    return (bool)_deferredWriter;
+}
+
 const qint64 PACKET_LIST_WRITE_ERROR = -1;
 
 qint64 PacketList::writeString(const QString& string) {
@@ -12,6 +12,7 @@
 #ifndef hifi_PacketList_h
 #define hifi_PacketList_h
 
+#include <functional>
 #include <memory>
 
 #include <QtCore/QIODevice>
@@ -30,6 +31,14 @@ class PacketList : public QIODevice {
 public:
     using MessageNumber = uint32_t;
     using PacketPointer = std::unique_ptr<Packet>;
+
+    // Writes the rest of a reliable ordered list as its packets are sent, so that large messages never hold all of
+    // their packets in memory. It is called from the sending thread with the number of bytes it may write, and
+    // returns false once it has written everything.
+    using DeferredWriter = std::function<bool(PacketList& packetList, qint64 maxBytes)>;
+
+    // Called with each packet a DeferredWriter completes, before it is sent
+    using PacketFinisher = std::function<void(Packet& packet)>;
     
     static std::unique_ptr<PacketList> create(PacketType packetType, QByteArray extendedHeader = QByteArray(),
                                               bool isReliable = false, bool isOrdered = false);
@@ -53,6 +62,10 @@ public:
     
     void closeCurrentPacket(bool shouldSendEmpty = false);
 
+    void setDeferredWriter(DeferredWriter writer);
+    bool hasDeferredWriter() const { return (bool)_deferredWriter; }
+    void setPacketFinisher(PacketFinisher finisher) { _packetFinisher = finisher; }
+
     // QIODevice virtual functions
     virtual bool isSequential() const override { return false; }
     virtual qint64 size() const override { return getDataSize(); }
@@ -68,6 +81,10 @@ protected:
     
     void preparePackets(MessageNumber messageNumber);
 
+    // calls the deferred writer, and moves the packets it completes to the back of packets
+    // returns false once the deferred writer is done and every packet was moved
+    bool takeDeferredPackets(std::list<std::unique_ptr<Packet>>& packets);
+
     virtual qint64 writeData(const char* data, qint64 maxSize) override;
     // Not implemented, added an assert so that it doesn't get used by accident
     virtual qint64 readData(char* data, qint64 maxSize) override { Q_ASSERT(false); return 0; }
@@ -100,6 +117,9 @@ private:
     int _segmentStartIndex = -1;
     
     QByteArray _extendedHeader;
+
+    DeferredWriter _deferredWriter;
+    PacketFinisher _packetFinisher;
 };
 
 template <typename T> qint64 PacketList::readPrimitive(T* data) {
@@ -16,7 +16,7 @@
 using namespace udt;
 
 PacketQueue::PacketQueue() {
-    _channels.emplace_back(new std::list<PacketPointer>());
+    _channels.emplace_back(new Channel());
 }
 
 MessageNumber PacketQueue::getNextMessageNumber() {
@@ -28,7 +28,7 @@ MessageNumber PacketQueue::getNextMessageNumber() {
 bool PacketQueue::isEmpty() const {
     LockGuard locker(_packetsLock);
     // Only the main channel and it is empty
-    return (_channels.size() == 1) && _channels.front()->empty();
+    return (_channels.size() == 1) && _channels.front()->packets.empty();
 }
 
 PacketQueue::PacketPointer PacketQueue::takePacket() {
@@ -38,19 +38,24 @@ PacketQueue::PacketPointer PacketQueue::takePacket() {
     }
 
     // Find next non empty channel
-    if (_channels[nextIndex()]->empty()) {
+    if (_channels[nextIndex()]->packets.empty() && !_channels[_currentIndex]->deferredList) {
         nextIndex();
     }
-    auto& channel = _channels[_currentIndex];
-    Q_ASSERT(!channel->empty());
+    auto& channel = *_channels[_currentIndex];
 
     // Take front packet
-    auto packet = std::move(channel->front());
-    channel->pop_front();
+    PacketPointer packet;
+    if (channel.isDeferred) {
+        packet = takeDeferredPacket(channel);
+    } else {
+        Q_ASSERT(!channel.packets.empty());
+        packet = std::move(channel.packets.front());
+        channel.packets.pop_front();
+    }
 
     // Remove now empty channel (Don't remove the main channel)
-    if (channel->empty() && _currentIndex != 0) {
-        channel->swap(*_channels.back());
+    if (channel.packets.empty() && !channel.deferredList && _currentIndex != 0) {
+        _channels[_currentIndex].swap(_channels.back());
         _channels.pop_back();
         --_currentIndex;
     }
@@ -58,6 +63,39 @@ PacketQueue::PacketPointer PacketQueue::takePacket() {
     return packet;
 }
 
+PacketQueue::PacketPointer PacketQueue::takeDeferredPacket(Channel& channel) {
+    // have the list write packets until it completes one, or is done
+    while (channel.packets.empty() && channel.deferredList) {
+        if (!channel.deferredList->takeDeferredPackets(channel.packets)) {
+            channel.deferredList.reset();
+        }
+    }
+
+    if (channel.packets.empty()) {
+        return PacketPointer();
+    }
+
+    auto packet = std::move(channel.packets.front());
+    channel.packets.pop_front();
+
+    // the list holds back its last packet until it is done, so this is the last packet once nothing is left
+    bool isFirst = channel.nextMessagePartNumber == 0;
+    bool isLast = channel.packets.empty() && !channel.deferredList;
+
+    auto position = Packet::PacketPosition::MIDDLE;
+    if (isFirst && isLast) {
+        position = Packet::PacketPosition::ONLY;
+    } else if (isFirst) {
+        position = Packet::PacketPosition::FIRST;
+    } else if (isLast) {
+        position = Packet::PacketPosition::LAST;
+    }
+
+    packet->writeMessageNumber(channel.messageNumber, position, channel.nextMessagePartNumber++);
+
+    return packet;
+}
+
 unsigned int PacketQueue::nextIndex() {
     _currentIndex = (_currentIndex + 1) % _channels.size();
     return _currentIndex;
@@ -65,15 +103,24 @@ unsigned int PacketQueue::nextIndex() {
 
 void PacketQueue::queuePacket(PacketPointer packet) {
     LockGuard locker(_packetsLock);
-    _channels.front()->push_back(std::move(packet));
+    _channels.front()->packets.push_back(std::move(packet));
 }
 
 void PacketQueue::queuePacketList(PacketListPointer packetList) {
-    if (packetList->isOrdered()) {
-        packetList->preparePackets(getNextMessageNumber());
+    ChannelPointer channel { new Channel() };
+
+    if (packetList->hasDeferredWriter()) {
+        // the packets are written and numbered as they are taken
+        channel->isDeferred = true;
+        channel->messageNumber = getNextMessageNumber();
+        channel->deferredList = std::move(packetList);
+    } else {
+        if (packetList->isOrdered()) {
+            packetList->preparePackets(getNextMessageNumber());
+        }
+        channel->packets.swap(packetList->_packets);
     }
 
     LockGuard locker(_packetsLock);
-    _channels.emplace_back(new std::list<PacketPointer>());
-    _channels.back()->swap(packetList->_packets);
+    _channels.push_back(std::move(channel));
 }
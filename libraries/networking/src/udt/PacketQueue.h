@@ -30,8 +30,18 @@ class PacketQueue {
     using LockGuard = std::lock_guard<Mutex>;
     using PacketPointer = std::unique_ptr<Packet>;
     using PacketListPointer = std::unique_ptr<PacketList>;
-    using Channel = std::unique_ptr<std::list<PacketPointer>>;
-    using Channels = std::vector<Channel>;
+
+    struct Channel {
+        std::list<PacketPointer> packets;
+
+        // the packets of a list with a deferred writer are written by it, and numbered, as they are taken
+        bool isDeferred { false };
+        PacketListPointer deferredList; // until it has written everything
+        MessageNumber messageNumber { 0 };
+        Packet::MessagePartNumber nextMessagePartNumber { 0 };
+    };
+    using ChannelPointer = std::unique_ptr<Channel>;
+    using Channels = std::vector<ChannelPointer>;
     
 public:
     PacketQueue();
@@ -46,6 +56,7 @@ public:
 private:
     MessageNumber getNextMessageNumber();
     unsigned int nextIndex();
+    PacketPointer takeDeferredPacket(Channel& channel);
     
     MessageNumber _currentMessageNumber { 0 };
     
@@ -13,12 +13,9 @@
 
 #include <algorithm>
 #include <random>
-#include <thread>
 
-#include <QtCore/QCoreApplication>
 #include <QtCore/QDateTime>
 #include <QtCore/QJsonObject>
-#include <QtCore/QThread>
 
 #include <LogHandler.h>
 #include <NumericalConstants.h>
@@ -29,6 +26,7 @@
 #include "Packet.h"
 #include "PacketList.h"
 #include "../UserActivityLogger.h"
+#include "SendQueuePool.h"
 #include "Socket.h"
 #include <Trace.h>
 #include <Profile.h>
@@ -67,26 +65,16 @@ std::unique_ptr<SendQueue> SendQueue::create(Socket* socket, HifiSockAddr destin
     
     auto queue = std::unique_ptr<SendQueue>(new SendQueue(socket, destination));
 
-    // Setup queue private thread
-    QThread* thread = new QThread;
-    thread->setObjectName("Networking: SendQueue " + destination.objectName()); // Name thread for easier debug
-    
-    connect(thread, &QThread::started, queue.get(), &SendQueue::run);
-    
-    connect(queue.get(), &QObject::destroyed, thread, &QThread::quit); // Thread auto cleanup
-    connect(thread, &QThread::finished, thread, &QThread::deleteLater); // Thread auto cleanup
-    
-    // Move queue to private thread and start it
-    queue->moveToThread(thread);
-    
-    thread->start();
+    // the queue is serviced by the pacing threads of the socket, starting now
+    queue->_pool->add(queue.get());
     
     return queue;
 }
     
 SendQueue::SendQueue(Socket* socket, HifiSockAddr dest) :
     _socket(socket),
-    _destination(dest)
+    _destination(dest),
+    _pool(&socket->getSendQueuePool())
 {
     // setup psuedo-random number generation for all instances of SendQueue
     static std::random_device rd;
@@ -106,37 +94,34 @@ SendQueue::SendQueue(Socket* socket, HifiSockAddr dest) :
 }
 
 SendQueue::~SendQueue() {
+    // make sure the pool is done with us before we are destroyed
+    _pool->remove(this);
+}
+
+void SendQueue::wake() {
+    _pool->wake(this);
 }
 
 void SendQueue::queuePacket(std::unique_ptr<Packet> packet) {
     _packets.queuePacket(std::move(packet));
     
-    // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for packets
-    _emptyCondition.notify_one();
-    
-    if (!this->thread()->isRunning() && _state == State::NotStarted) {
-        this->thread()->start();
-    }
+    // wake the queue in case it is waiting for packets
+    wake();
 }
 
 void SendQueue::queuePacketList(std::unique_ptr<PacketList> packetList) {
     _packets.queuePacketList(std::move(packetList));
     
-    // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for packets
-    _emptyCondition.notify_one();
-    
-    if (!this->thread()->isRunning() && _state == State::NotStarted) {
-        this->thread()->start();
-    }
+    // wake the queue in case it is waiting for packets
+    wake();
 }
 
 void SendQueue::stop() {
     
     _state = State::Stopped;
     
-    // Notify all conditions in case we're waiting somewhere
-    _handshakeACKCondition.notify_one();
-    _emptyCondition.notify_one();
+    // wake the queue in case it's waiting somewhere, so that its pool thread stops servicing it
+    wake();
 }
     
 int SendQueue::sendPacket(const Packet& packet) {
@@ -169,8 +154,8 @@ void SendQueue::ack(SequenceNumber ack) {
     
     _lastACKSequenceNumber = (uint32_t) ack;
 
-    // call notify_one on the condition_variable_any in case the send thread is sleeping with a full congestion window
-    _emptyCondition.notify_one();
+    // wake the queue in case it is waiting with a full congestion window
+    wake();
 }
 
 void SendQueue::nak(SequenceNumber start, SequenceNumber end) {
@@ -182,8 +167,8 @@ void SendQueue::nak(SequenceNumber start, SequenceNumber end) {
         _naks.insert(start, end);
     }
     
-    // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for losses to re-send
-    _emptyCondition.notify_one();
+    // wake the queue in case it is waiting for losses to re-send
+    wake();
 }
 
 void SendQueue::fastRetransmit(udt::SequenceNumber ack) {
@@ -192,8 +177,8 @@ void SendQueue::fastRetransmit(udt::SequenceNumber ack) {
         _naks.insert(ack, ack);
     }
 
-    // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for losses to re-send
-    _emptyCondition.notify_one();
+    // wake the queue in case it is waiting for losses to re-send
+    wake();
 }
 
 void SendQueue::overrideNAKListFromPacket(ControlPacket& packet) {
@@ -217,8 +202,8 @@ void SendQueue::overrideNAKListFromPacket(ControlPacket& packet) {
         }
     }
     
-    // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for losses to re-send
-    _emptyCondition.notify_one();
+    // wake the queue in case it is waiting for losses to re-send
+    wake();
 }
 
 void SendQueue::sendHandshake() {
@@ -228,10 +213,6 @@ void SendQueue::sendHandshake() {
         auto handshakePacket = ControlPacket::create(ControlPacket::Handshake, sizeof(SequenceNumber));
         handshakePacket->writePrimitive(_initialSequenceNumber);
         _socket->writeBasePacket(*handshakePacket, _destination);
-        
-        // we wait for the ACK or the re-send interval to expire
-        static const auto HANDSHAKE_RESEND_INTERVAL = std::chrono::milliseconds(100);
-        _handshakeACKCondition.wait_for(handshakeLock, HANDSHAKE_RESEND_INTERVAL);
     }
 }
 
@@ -241,8 +222,8 @@ void SendQueue::handshakeACK(SequenceNumber initialSequenceNumber) {
             std::lock_guard<std::mutex> locker { _handshakeMutex };
             _hasReceivedHandshakeACK = true;
         }
-        // Notify on the handshake ACK condition
-        _handshakeACKCondition.notify_one();
+        // wake the queue so that it starts sending
+        wake();
     }
 }
 
@@ -289,113 +270,135 @@ bool SendQueue::sendNewPacketAndAddToSentList(std::unique_ptr<Packet> newPacket,
     }
 }
 
-void SendQueue::run() {
-    if (_state == State::Stopped) {
-        // we've already been asked to stop before we even got a chance to start
-        // don't start now
-#ifdef UDT_CONNECTION_DEBUG
-        qCDebug(networking) << "SendQueue asked to run after being told to stop. Will not run.";
-#endif
-        return;
-    } else if (_state == State::Running) {
-#ifdef UDT_CONNECTION_DEBUG
-        qCDebug(networking) << "SendQueue asked to run but is already running (according to state). Will not re-run.";
-#endif
-        return;
+p_high_resolution_clock::time_point SendQueue::process(p_high_resolution_clock::time_point now) {
+    static const auto STOPPED = p_high_resolution_clock::time_point::max();
+
+    State notStarted = State::NotStarted;
+    if (!_state.compare_exchange_strong(notStarted, State::Running) && _state == State::Stopped) {
+        // we've been asked to stop, possibly before we even got a chance to start
+        return STOPPED;
     }
-    
-    _state = State::Running;
-    
+
     // Wait for handshake to be complete
-    while (_state == State::Running && !_hasReceivedHandshakeACK) {
-        sendHandshake();
+    if (!_hasReceivedHandshakeACK) {
+        // re-send the handshake until it is ACKed - the handshake ACK wakes us
+        static const auto HANDSHAKE_RESEND_INTERVAL = std::chrono::milliseconds(100);
 
-        // Keep processing events
-        QCoreApplication::sendPostedEvents(this);
-        
-        // Once we're here we've either received the handshake ACK or it's going to be time to re-send a handshake.
-        // Either way let's continue processing - no packets will be sent if no handshake ACK has been received.
+        if (now >= _nextHandshakeTimestamp) {
+            sendHandshake();
+            _nextHandshakeTimestamp = now + HANDSHAKE_RESEND_INTERVAL;
+        }
+
+        return _nextHandshakeTimestamp;
     }
 
-    // Keep an HRC to know when the next packet should have been
-    auto nextPacketTimestamp = p_high_resolution_clock::now();
+    if (!_hasStartedPacing) {
+        // Keep an HRC to know when the next packet should have been
+        _nextPacketTimestamp = now;
+        _pacingSleepEnd = now;
+        _hasStartedPacing = true;
+    }
 
-    while (_state == State::Running) {
-        bool attemptedToSendPacket = maybeResendPacket();
-        
-        // if we didn't find a packet to re-send AND we think we can fit a new packet on the wire
-        // (this is according to the current flow window size) then we send out a new packet
-        auto newPacketCount = 0;
-        if (!attemptedToSendPacket) {
-            newPacketCount = maybeSendNewPacket();
-            attemptedToSendPacket = (newPacketCount > 0);
-        }
-        
-        // since we're a while loop, give the thread a chance to process events
-        QCoreApplication::sendPostedEvents(this);
-        
-        // we just processed events so check now if we were just told to stop
-        // If the send queue has been innactive, skip the sleep for
-        // Either _isRunning will have been set to false and we'll break
-        // Or something happened and we'll keep going
-        if (_state != State::Running || isInactive(attemptedToSendPacket)) {
-            return;
+    if (_idleWait != IdleWait::None) {
+        // we're here either because we were woken or because the wait is over
+        auto idleWait = _idleWait;
+        _idleWait = IdleWait::None;
+
+        if (now >= _idleWaitEnd && finishIdleWait(idleWait)) {
+            return STOPPED;
         }
 
-        if (_packetSendPeriod > 0) {
-            // push the next packet timestamp forwards by the current packet send period
-            auto nextPacketDelta = (newPacketCount == 2 ? 2 : 1) * _packetSendPeriod;
-            nextPacketTimestamp += std::chrono::microseconds(nextPacketDelta);
+        return pace(now, 0);
+    }
 
-            // sleep as long as we need for next packet send, if we can
-            auto now = p_high_resolution_clock::now();
+    if (now < _pacingSleepEnd) {
+        // being woken doesn't hurry the next packet
+        return _pacingSleepEnd;
+    }
 
-            auto timeToSleep = duration_cast<microseconds>(nextPacketTimestamp - now);
+    bool attemptedToSendPacket = maybeResendPacket();
 
-            // we use nextPacketTimestamp so that we don't fall behind, not to force long sleeps
-            // we'll never allow nextPacketTimestamp to force us to sleep for more than nextPacketDelta
-            // so cap it to that value
-            if (timeToSleep > std::chrono::microseconds(nextPacketDelta)) {
-                // reset the nextPacketTimestamp so that it is correct next time we come around
-                nextPacketTimestamp = now + std::chrono::microseconds(nextPacketDelta);
+    // if we didn't find a packet to re-send AND we think we can fit a new packet on the wire
+    // (this is according to the current flow window size) then we send out a new packet
+    auto newPacketCount = 0;
+    if (!attemptedToSendPacket) {
+        newPacketCount = maybeSendNewPacket();
+        attemptedToSendPacket = (newPacketCount > 0);
+    }
 
-                timeToSleep = std::chrono::microseconds(nextPacketDelta);
-            }
+    // check now if we were just told to stop
+    if (_state != State::Running) {
+        return STOPPED;
+    }
 
-            // we're seeing SendQueues sleep for a long period of time here,
-            // which can lock the NodeList if it's attempting to clear connections
-            // for now we guard this by capping the time this thread and sleep for
-
-            const microseconds MAX_SEND_QUEUE_SLEEP_USECS { 2000000 };
-            if (timeToSleep > MAX_SEND_QUEUE_SLEEP_USECS) {
-                qWarning() << "udt::SendQueue wanted to sleep for" << timeToSleep.count() << "microseconds";
-                qWarning() << "Capping sleep to" << MAX_SEND_QUEUE_SLEEP_USECS.count();
-                qWarning() << "PSP:" << _packetSendPeriod << "NPD:" << nextPacketDelta
-                << "NPT:" << nextPacketTimestamp.time_since_epoch().count()
-                << "NOW:" << now.time_since_epoch().count();
-
-                // alright, we're in a weird state
-                // we want to know why this is happening so we can implement a better fix than this guard
-                // send some details up to the API (if the user allows us) that indicate how we could such a large timeToSleep
-                static const QString SEND_QUEUE_LONG_SLEEP_ACTION = "sendqueue-sleep";
-
-                // setup a json object with the details we want
-                QJsonObject longSleepObject;
-                longSleepObject["timeToSleep"] = qint64(timeToSleep.count());
-                longSleepObject["packetSendPeriod"] = _packetSendPeriod.load();
-                longSleepObject["nextPacketDelta"] = nextPacketDelta;
-                longSleepObject["nextPacketTimestamp"] = qint64(nextPacketTimestamp.time_since_epoch().count());
-                longSleepObject["then"] = qint64(now.time_since_epoch().count());
-
-                // hopefully send this event using the user activity logger
-                UserActivityLogger::getInstance().logAction(SEND_QUEUE_LONG_SLEEP_ACTION, longSleepObject);
-                
-                timeToSleep = MAX_SEND_QUEUE_SLEEP_USECS;
-            }
-            
-            std::this_thread::sleep_for(timeToSleep);
-        }
+    if (hasReceiverTimedOut()) {
+        deactivate();
+        return STOPPED;
+    }
+
+    // if we didn't send anything, we wait until we have data to handle
+    if (!attemptedToSendPacket && startIdleWait(now)) {
+        return _idleWaitEnd;
     }
+
+    return pace(now, newPacketCount);
+}
+
+p_high_resolution_clock::time_point SendQueue::pace(p_high_resolution_clock::time_point now, int newPacketCount) {
+    if (_packetSendPeriod <= 0) {
+        _pacingSleepEnd = now;
+        return now;
+    }
+
+    // push the next packet timestamp forwards by the current packet send period
+    auto nextPacketDelta = (newPacketCount == 2 ? 2 : 1) * _packetSendPeriod;
+    _nextPacketTimestamp += std::chrono::microseconds(nextPacketDelta);
+
+    // sleep as long as we need for next packet send, if we can
+    auto timeToSleep = duration_cast<microseconds>(_nextPacketTimestamp - now);
+
+    // we use _nextPacketTimestamp so that we don't fall behind, not to force long sleeps
+    // we'll never allow _nextPacketTimestamp to force us to sleep for more than nextPacketDelta
+    // so cap it to that value
+    if (timeToSleep > std::chrono::microseconds(nextPacketDelta)) {
+        // reset the _nextPacketTimestamp so that it is correct next time we come around
+        _nextPacketTimestamp = now + std::chrono::microseconds(nextPacketDelta);
+
+        timeToSleep = std::chrono::microseconds(nextPacketDelta);
+    }
+
+    // we're seeing SendQueues sleep for a long period of time here,
+    // for now we guard this by capping the time this queue can sleep for
+
+    const microseconds MAX_SEND_QUEUE_SLEEP_USECS { 2000000 };
+    if (timeToSleep > MAX_SEND_QUEUE_SLEEP_USECS) {
+        qWarning() << "udt::SendQueue wanted to sleep for" << timeToSleep.count() << "microseconds";
+        qWarning() << "Capping sleep to" << MAX_SEND_QUEUE_SLEEP_USECS.count();
+        qWarning() << "PSP:" << _packetSendPeriod << "NPD:" << nextPacketDelta
+        << "NPT:" << _nextPacketTimestamp.time_since_epoch().count()
+        << "NOW:" << now.time_since_epoch().count();
+
+        // alright, we're in a weird state
+        // we want to know why this is happening so we can implement a better fix than this guard
+        // send some details up to the API (if the user allows us) that indicate how we could such a large timeToSleep
+        static const QString SEND_QUEUE_LONG_SLEEP_ACTION = "sendqueue-sleep";
+
+        // setup a json object with the details we want
+        QJsonObject longSleepObject;
+        longSleepObject["timeToSleep"] = qint64(timeToSleep.count());
+        longSleepObject["packetSendPeriod"] = _packetSendPeriod.load();
+        longSleepObject["nextPacketDelta"] = nextPacketDelta;
+        longSleepObject["nextPacketTimestamp"] = qint64(_nextPacketTimestamp.time_since_epoch().count());
+        longSleepObject["then"] = qint64(now.time_since_epoch().count());
+
+        // hopefully send this event using the user activity logger
+        UserActivityLogger::getInstance().logAction(SEND_QUEUE_LONG_SLEEP_ACTION, longSleepObject);
+
+        timeToSleep = MAX_SEND_QUEUE_SLEEP_USECS;
+    }
+
+    _pacingSleepEnd = now + std::max(timeToSleep, microseconds(0));
+    return _pacingSleepEnd;
 }
 
 void SendQueue::setProbePacketEnabled(bool enabled) {
@@ -534,9 +537,7 @@ bool SendQueue::maybeResendPacket() {
     return false;
 }
 
-bool SendQueue::isInactive(bool attemptedToSendPacket) {
-    // check for connection timeout first
-
+bool SendQueue::hasReceiverTimedOut() const {
     // that will be the case if we have had 16 timeouts since hearing back from the client, and it has been
     // at least 5 seconds
     static const int NUM_TIMEOUTS_BEFORE_INACTIVE = 16;
@@ -555,72 +556,79 @@ bool SendQueue::isInactive(bool attemptedToSendPacket) {
             << "and" << MIN_MS_BEFORE_INACTIVE << "milliseconds before receiving any ACK/NAK and is now inactive. Stopping.";
 #endif
 
-        deactivate();
         return true;
     }
 
-    if (!attemptedToSendPacket) {
-        // During our processing above we didn't send any packets
-        
-        // If that is still the case we should use a condition_variable_any to sleep until we have data to handle.
-        // To confirm that the queue of packets and the NAKs list are still both empty we'll need to use the DoubleLock
-        using DoubleLock = DoubleLock<std::recursive_mutex, std::mutex>;
-        DoubleLock doubleLock(_packets.getLock(), _naksLock);
-        DoubleLock::Lock locker(doubleLock, std::try_to_lock);
+    return false;
+}
+
+bool SendQueue::startIdleWait(p_high_resolution_clock::time_point now) {
+    // During our processing we didn't send any packets
+    
+    // If that is still the case we should wait until we have data to handle.
+    // To confirm that the queue of packets and the NAKs list are still both empty we'll need to use the DoubleLock
+    using DoubleLock = DoubleLock<std::recursive_mutex, std::mutex>;
+    DoubleLock doubleLock(_packets.getLock(), _naksLock);
+    DoubleLock::Lock locker(doubleLock, std::try_to_lock);
+    
+    if (locker.owns_lock() && (_packets.isEmpty() || isFlowWindowFull()) && _naks.isEmpty()) {
+        // The packets queue and loss list mutexes are now both locked and they're both empty
+        // anything that changes that once they're unlocked wakes us
         
-        if (locker.owns_lock() && (_packets.isEmpty() || isFlowWindowFull()) && _naks.isEmpty()) {
-            // The packets queue and loss list mutexes are now both locked and they're both empty
-            
-            if (uint32_t(_lastACKSequenceNumber) == uint32_t(_currentSequenceNumber)) {
-                // we've sent the client as much data as we have (and they've ACKed it)
-                // either wait for new data to send or 5 seconds before cleaning up the queue
-                static const auto EMPTY_QUEUES_INACTIVE_TIMEOUT = std::chrono::seconds(5);
-                
-                // use our condition_variable_any to wait
-                auto cvStatus = _emptyCondition.wait_for(locker, EMPTY_QUEUES_INACTIVE_TIMEOUT);
-                
-                if (cvStatus == std::cv_status::timeout && (_packets.isEmpty() || isFlowWindowFull()) && _naks.isEmpty()) {
+        if (uint32_t(_lastACKSequenceNumber) == uint32_t(_currentSequenceNumber)) {
+            // we've sent the client as much data as we have (and they've ACKed it)
+            // either wait for new data to send or 5 seconds before cleaning up the queue
+            static const auto EMPTY_QUEUES_INACTIVE_TIMEOUT = std::chrono::seconds(5);
+
+            _idleWait = IdleWait::Empty;
+            _idleWaitEnd = now + EMPTY_QUEUES_INACTIVE_TIMEOUT;
+        } else {
+            // We think the client is still waiting for data (based on the sequence number gap)
+            // Let's wait either for a response from the client or until the estimated timeout
+            // (plus the sync interval to allow the client to respond) has elapsed
+            _idleWait = IdleWait::Unacknowledged;
+            _idleWaitEnd = now + std::chrono::microseconds(_estimatedTimeout + _syncInterval);
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+bool SendQueue::finishIdleWait(IdleWait idleWait) {
+    using DoubleLock = DoubleLock<std::recursive_mutex, std::mutex>;
+    DoubleLock doubleLock(_packets.getLock(), _naksLock);
+    DoubleLock::Lock locker(doubleLock);
+
+    if ((_packets.isEmpty() || isFlowWindowFull()) && _naks.isEmpty()) {
+        if (idleWait == IdleWait::Empty) {
 #ifdef UDT_CONNECTION_DEBUG
-                    qCDebug(networking) << "SendQueue to" << _destination << "has been empty for"
-                        << EMPTY_QUEUES_INACTIVE_TIMEOUT.count()
-                        << "seconds and receiver has ACKed all packets."
-                        << "The queue is now inactive and will be stopped.";
+            qCDebug(networking) << "SendQueue to" << _destination << "has been empty for"
+                << "5 seconds and receiver has ACKed all packets."
+                << "The queue is now inactive and will be stopped.";
 #endif
 
-                    // we have the lock again - Make sure to unlock it
-                    locker.unlock();
-                    
-                    // Deactivate queue
-                    deactivate();
-                    return true;
-                }
+            // we have the lock - Make sure to unlock it
+            locker.unlock();
 
-            } else {
-                // We think the client is still waiting for data (based on the sequence number gap)
-                // Let's wait either for a response from the client or until the estimated timeout
-                // (plus the sync interval to allow the client to respond) has elapsed
-                auto waitDuration = std::chrono::microseconds(_estimatedTimeout + _syncInterval);
-                
-                // use our condition_variable_any to wait
-                auto cvStatus = _emptyCondition.wait_for(locker, waitDuration);
-                
-                if (cvStatus == std::cv_status::timeout && (_packets.isEmpty() || isFlowWindowFull()) && _naks.isEmpty()
-                    && SequenceNumber(_lastACKSequenceNumber) < _currentSequenceNumber) {
-                    // after a timeout if we still have sent packets that the client hasn't ACKed we
-                    // add them to the loss list
-                    
-                    // Note that thanks to the DoubleLock we have the _naksLock right now
-                    _naks.append(SequenceNumber(_lastACKSequenceNumber) + 1, _currentSequenceNumber);
-
-                    // we have the lock again - time to unlock it
-                    locker.unlock();
-                    
-                    emit timeout();
-                }
-            }
+            // Deactivate queue
+            deactivate();
+            return true;
+        } else if (SequenceNumber(_lastACKSequenceNumber) < _currentSequenceNumber) {
+            // after a timeout if we still have sent packets that the client hasn't ACKed we
+            // add them to the loss list
+
+            // Note that thanks to the DoubleLock we have the _naksLock right now
+            _naks.append(SequenceNumber(_lastACKSequenceNumber) + 1, _currentSequenceNumber);
+
+            // we have the lock - time to unlock it
+            locker.unlock();
+
+            emit timeout();
         }
     }
-    
+
     return false;
 }
 
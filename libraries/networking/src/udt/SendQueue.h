@@ -13,7 +13,6 @@
 #define hifi_SendQueue_h
 
 #include <atomic>
-#include <condition_variable>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -38,6 +37,7 @@ class BasePacket;
 class ControlPacket;
 class Packet;
 class PacketList;
+class SendQueuePool;
 class Socket;
     
 class SendQueue : public QObject {
@@ -50,6 +50,7 @@ public:
         Stopped
     };
     
+    // creates a queue serviced by the SendQueuePool of the socket
     static std::unique_ptr<SendQueue> create(Socket* socket, HifiSockAddr destination);
 
     virtual ~SendQueue();
@@ -87,13 +88,22 @@ signals:
     void shortCircuitLoss(quint32 sequenceNumber);
     void timeout();
     
-private slots:
-    void run();
-    
 private:
+    // the waits of a queue with nothing to send, which end early if it is woken
+    enum class IdleWait {
+        None,
+        Empty, // everything sent has been ACKed, so wait for more to send or become inactive
+        Unacknowledged // wait for ACKs, or time out the unACKed packets
+    };
+
     SendQueue(Socket* socket, HifiSockAddr dest);
     SendQueue(SendQueue& other) = delete;
     SendQueue(SendQueue&& other) = delete;
+
+    // called by a SendQueuePool thread: re-sends or sends what the queue can, and returns when it should next be
+    // called, which is sooner if the queue is woken; returns time_point::max() once the queue has stopped
+    p_high_resolution_clock::time_point process(p_high_resolution_clock::time_point now);
+    void wake();
     
     void sendHandshake();
     
@@ -103,7 +113,10 @@ private:
     int maybeSendNewPacket(); // Figures out what packet to send next
     bool maybeResendPacket(); // Determines whether to resend a packet and which one
     
-    bool isInactive(bool attemptedToSendPacket);
+    bool hasReceiverTimedOut() const;
+    bool startIdleWait(p_high_resolution_clock::time_point now);
+    bool finishIdleWait(IdleWait idleWait); // returns true if the queue became inactive
+    p_high_resolution_clock::time_point pace(p_high_resolution_clock::time_point now, int newPacketCount);
     void deactivate(); // makes the queue inactive and cleans it up
 
     bool isFlowWindowFull() const;
@@ -116,6 +129,9 @@ private:
     Socket* _socket { nullptr }; // Socket to send packet on
     HifiSockAddr _destination; // Destination addr
 
+    SendQueuePool* _pool { nullptr }; // Pool of the threads that service the queue
+    int _poolThread { -1 }; // Index of the pool thread that services the queue, set by the pool
+
     SequenceNumber _initialSequenceNumber; // Randomized on SendQueue creation, identifies connection during re-connect requests
     
     std::atomic<uint32_t> _lastACKSequenceNumber { 0 }; // Last ACKed sequence number
@@ -139,14 +155,20 @@ private:
     using PacketResendPair = std::pair<uint8_t, std::unique_ptr<Packet>>; // Number of resend + packet ptr
     std::unordered_map<SequenceNumber, PacketResendPair> _sentPackets; // Packets waiting for ACK.
     
-    std::mutex _handshakeMutex; // Protects the handshake ACK condition_variable
+    std::mutex _handshakeMutex; // Protects the handshake ACK flag while a handshake is sent
     std::atomic<bool> _hasReceivedHandshakeACK { false }; // flag for receipt of handshake ACK from client
-    std::condition_variable _handshakeACKCondition;
-    
-    std::condition_variable_any _emptyCondition;
 
+    // only used by the pool thread servicing the queue
+    p_high_resolution_clock::time_point _nextHandshakeTimestamp; // When to re-send the handshake
+    bool _hasStartedPacing { false }; // Whether packets have been paced since the handshake ACK
+    p_high_resolution_clock::time_point _nextPacketTimestamp; // When the next packet should have been sent
+    p_high_resolution_clock::time_point _pacingSleepEnd; // When the queue is next serviced to send
+    IdleWait _idleWait { IdleWait::None };
+    p_high_resolution_clock::time_point _idleWaitEnd; // When the idle wait ends if the queue isn't woken
 
     std::atomic<bool> _shouldSendProbes { true };
+
+    friend class SendQueuePool;
 };
     
 }
@@ -0,0 +1,285 @@
+//
+//  SendQueuePool.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SendQueuePool.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+
+#include <QtCore/QProcessEnvironment>
+#include <QtCore/QString>
+
+#include "SendQueue.h"
+#include "TimerWheel.h"
+
+using namespace udt;
+using namespace std::chrono;
+
+namespace {
+
+const QString SEND_THREADS_FLAG = "HIFI_UDT_SEND_THREADS";
+const int MAX_DEFAULT_SEND_THREADS = 4;
+
+int defaultNumThreads() {
+    bool ok = false;
+    int numThreads = QProcessEnvironment::systemEnvironment().value(SEND_THREADS_FLAG).toInt(&ok);
+    if (ok && numThreads > 0) {
+        return numThreads;
+    }
+
+    return std::max(1, std::min(MAX_DEFAULT_SEND_THREADS, (int)std::thread::hardware_concurrency() / 2));
+}
+
+}
+
+class SendQueuePool::Thread {
+public:
+    using TimePoint = p_high_resolution_clock::time_point;
+
+    ~Thread();
+
+    void start() { _thread = std::thread([this] { run(); }); }
+
+    void add(SendQueue* queue);
+    void remove(SendQueue* queue);
+    void wake(SendQueue* queue);
+
+    int getNumQueues();
+    QJsonObject takeStats();
+
+private:
+    struct Schedule {
+        TimePoint due { TimePoint::max() }; // TimePoint::max() while the queue is not in the wheel
+        bool isWoken { false }; // whether the queue was woken while it was being serviced
+    };
+
+    void run();
+    void schedule(SendQueue* queue, Schedule& schedule, TimePoint due);
+
+    std::thread _thread;
+
+    std::mutex _mutex;
+    std::condition_variable _wakeCondition; // wakes the thread for earlier work, or to stop
+    std::condition_variable _serviceCondition; // signals the end of a service, for remove
+    bool _isStopping { false };
+
+    TimerWheel<SendQueue*> _wheel;
+    std::deque<TimerWheel<SendQueue*>::Entry> _ready; // queues that are due, in the order they will be serviced
+    std::unordered_map<SendQueue*, Schedule> _schedules;
+    SendQueue* _servicing { nullptr };
+
+    int _numServices { 0 };
+    qint64 _totalLatenessUsecs { 0 };
+    qint64 _maxLatenessUsecs { 0 };
+};
+
+SendQueuePool::Thread::~Thread() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isStopping = true;
+    }
+    _wakeCondition.notify_one();
+
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+void SendQueuePool::Thread::add(SendQueue* queue) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        schedule(queue, _schedules[queue], p_high_resolution_clock::now());
+    }
+    _wakeCondition.notify_one();
+}
+
+void SendQueuePool::Thread::remove(SendQueue* queue) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (_servicing == queue) {
+        _serviceCondition.wait(lock);
+    }
+
+    auto it = _schedules.find(queue);
+    if (it != _schedules.end()) {
+        if (it->second.due != TimePoint::max()) {
+            _wheel.remove(queue, it->second.due);
+        }
+        _schedules.erase(it);
+    }
+
+    _ready.erase(std::remove_if(_ready.begin(), _ready.end(), [queue](const TimerWheel<SendQueue*>::Entry& entry) {
+        return entry.item == queue;
+    }), _ready.end());
+}
+
+void SendQueuePool::Thread::wake(SendQueue* queue) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _schedules.find(queue);
+        if (it == _schedules.end()) {
+            return;
+        }
+
+        Schedule& queueSchedule = it->second;
+        if (_servicing == queue) {
+            // the service may have missed what woke the queue, so service it again right away
+            queueSchedule.isWoken = true;
+            return;
+        }
+
+        // a queue that is not in the wheel is either about to be serviced, or has stopped
+        auto now = p_high_resolution_clock::now();
+        if (queueSchedule.due == TimePoint::max() || queueSchedule.due <= now) {
+            return;
+        }
+
+        schedule(queue, queueSchedule, now);
+    }
+    _wakeCondition.notify_one();
+}
+
+int SendQueuePool::Thread::getNumQueues() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return (int)_schedules.size();
+}
+
+QJsonObject SendQueuePool::Thread::takeStats() {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    QJsonObject stats;
+    stats["queues"] = (int)_schedules.size();
+    stats["services"] = _numServices;
+    stats["avg_lateness_usecs"] = (_numServices > 0) ? (double)_totalLatenessUsecs / _numServices : 0.0;
+    stats["max_lateness_usecs"] = _maxLatenessUsecs;
+
+    _numServices = 0;
+    _totalLatenessUsecs = 0;
+    _maxLatenessUsecs = 0;
+
+    return stats;
+}
+
+void SendQueuePool::Thread::schedule(SendQueue* queue, Schedule& queueSchedule, TimePoint due) {
+    if (queueSchedule.due != TimePoint::max()) {
+        _wheel.remove(queue, queueSchedule.due);
+    }
+
+    _wheel.insert(queue, due);
+    queueSchedule.due = due;
+}
+
+void SendQueuePool::Thread::run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (!_isStopping) {
+        if (_ready.empty()) {
+            _wheel.expire(p_high_resolution_clock::now(), _ready);
+
+            for (auto& entry : _ready) {
+                _schedules[entry.item].due = TimePoint::max();
+            }
+
+            if (_ready.empty()) {
+                // sleep until the next queue is due, or an earlier one is woken
+                auto nextDue = _wheel.getNextDue();
+                if (nextDue == TimePoint::max()) {
+                    _wakeCondition.wait(lock);
+                } else {
+                    _wakeCondition.wait_until(lock, nextDue);
+                }
+                continue;
+            }
+        }
+
+        auto entry = _ready.front();
+        _ready.pop_front();
+        _servicing = entry.item;
+
+        lock.unlock();
+        auto now = p_high_resolution_clock::now();
+        auto nextDue = entry.item->process(now);
+        lock.lock();
+
+        _servicing = nullptr;
+
+        qint64 latenessUsecs = std::max((qint64)0, (qint64)duration_cast<microseconds>(now - entry.due).count());
+        ++_numServices;
+        _totalLatenessUsecs += latenessUsecs;
+        _maxLatenessUsecs = std::max(_maxLatenessUsecs, latenessUsecs);
+
+        // the queue is still ours, since remove waits for the service to end
+        Schedule& queueSchedule = _schedules[entry.item];
+        if (nextDue != TimePoint::max()) {
+            schedule(entry.item, queueSchedule, queueSchedule.isWoken ? std::min(nextDue, now) : nextDue);
+        }
+        queueSchedule.isWoken = false;
+
+        _serviceCondition.notify_all();
+    }
+}
+
+SendQueuePool::SendQueuePool(int numThreads) :
+    _numThreads((numThreads > 0) ? numThreads : defaultNumThreads())
+{
+    for (int i = 0; i < _numThreads; ++i) {
+        _threads.emplace_back(new Thread);
+    }
+}
+
+SendQueuePool::~SendQueuePool() {
+    // the threads stop and join as they are destroyed
+}
+
+void SendQueuePool::start() {
+    for (auto& thread : _threads) {
+        thread->start();
+    }
+}
+
+void SendQueuePool::add(SendQueue* queue) {
+    std::call_once(_startFlag, [this] { start(); });
+
+    int leastBusyThread = 0;
+    int leastNumQueues = std::numeric_limits<int>::max();
+    for (int i = 0; i < _numThreads; ++i) {
+        int numQueues = _threads[i]->getNumQueues();
+        if (numQueues < leastNumQueues) {
+            leastBusyThread = i;
+            leastNumQueues = numQueues;
+        }
+    }
+
+    queue->_poolThread = leastBusyThread;
+    _threads[leastBusyThread]->add(queue);
+}
+
+void SendQueuePool::remove(SendQueue* queue) {
+    if (queue->_poolThread >= 0) {
+        _threads[queue->_poolThread]->remove(queue);
+    }
+}
+
+void SendQueuePool::wake(SendQueue* queue) {
+    if (queue->_poolThread >= 0) {
+        _threads[queue->_poolThread]->wake(queue);
+    }
+}
+
+QJsonObject SendQueuePool::takeStats() {
+    QJsonObject stats;
+    for (int i = 0; i < _numThreads; ++i) {
+        stats[QString::number(i)] = _threads[i]->takeStats();
+    }
+    return stats;
+}
@@ -0,0 +1,63 @@
+//
+//  SendQueuePool.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_SendQueuePool_h
+#define hifi_SendQueuePool_h
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QJsonObject>
+
+namespace udt {
+
+class SendQueue;
+
+// Small pool of pacing threads shared by the SendQueues of a Socket
+//   Each thread services its queues through a timer wheel keyed by the time each queue next wants to send,
+//   so that idle queues cost nothing and a queue is never serviced by two threads at once.
+//   The threads are started with the first queue.
+class SendQueuePool {
+public:
+    // the number of threads defaults to half the cores, up to 4, or HIFI_UDT_SEND_THREADS if set in the environment
+    SendQueuePool(int numThreads = -1);
+    ~SendQueuePool();
+
+    // schedules the queue to be serviced now, on the thread with the fewest queues
+    void add(SendQueue* queue);
+
+    // stops servicing the queue, waiting for its thread to finish with it if it is being serviced
+    void remove(SendQueue* queue);
+
+    // services the queue now, or as soon as it has been serviced if it is being serviced
+    void wake(SendQueue* queue);
+
+    int getNumThreads() const { return _numThreads; }
+
+    // returns the number of queues, and the number of services and their average and maximum lateness past the time
+    // they were due, of each thread since the last call, and resets them
+    QJsonObject takeStats();
+
+private:
+    class Thread;
+
+    void start();
+
+    int _numThreads;
+    std::once_flag _startFlag;
+    std::vector<std::unique_ptr<Thread>> _threads;
+};
+
+} // namespace udt
+
+#endif // hifi_SendQueuePool_h
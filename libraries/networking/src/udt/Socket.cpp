@@ -15,6 +15,13 @@
 #include <sys/socket.h>
 #endif
 
+#ifdef UDT_BATCHED_IO
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#endif
+
+#include <QtCore/QProcessEnvironment>
 #include <QtCore/QThread>
 
 #include <LogHandler.h>
@@ -30,12 +37,37 @@
 
 using namespace udt;
 
+static const QString BATCHED_IO_FLAG = "HIFI_UDT_BATCHED_IO";
+#ifdef UDT_LINK_IMPAIRMENT
+static const QString LINK_IMPAIRMENT_FLAG = "HIFI_UDT_LINK_IMPAIRMENT";
+#endif
+
 Socket::Socket(QObject* parent, bool shouldChangeSocketOptions) :
     QObject(parent),
+#ifdef UDT_LINK_IMPAIRMENT
+    _linkImpairment([this](const QByteArray& datagram, const HifiSockAddr& sockAddr) {
+        return writeDatagramToSocket(datagram, sockAddr);
+    }),
+#endif
     _synTimer(new QTimer(this)),
     _readyReadBackupTimer(new QTimer(this)),
-    _shouldChangeSocketOptions(shouldChangeSocketOptions)
+    _shouldChangeSocketOptions(shouldChangeSocketOptions),
+    _batchedIOEnabled(isBatchedIOSupported() && QProcessEnvironment::systemEnvironment().contains(BATCHED_IO_FLAG))
 {
+#ifdef UDT_LINK_IMPAIRMENT
+    auto environment = QProcessEnvironment::systemEnvironment();
+    if (environment.contains(LINK_IMPAIRMENT_FLAG)) {
+        LinkImpairment::Profile profile;
+        if (LinkImpairment::Profile::fromString(environment.value(LINK_IMPAIRMENT_FLAG), profile)) {
+            qCDebug(networking) << "Socket is impairing the datagrams it writes with" << profile.toString();
+            _linkImpairment.setProfile(HifiSockAddr(), profile);
+        } else {
+            qCWarning(networking) << "Could not parse a link impairment profile from" << LINK_IMPAIRMENT_FLAG
+                << "-" << environment.value(LINK_IMPAIRMENT_FLAG);
+        }
+    }
+#endif
+
     connect(&_udpSocket, &QUdpSocket::readyRead, this, &Socket::readPendingDatagrams);
 
     // make sure our synchronization method is called every SYN interval
@@ -55,6 +87,15 @@ Socket::Socket(QObject* parent, bool shouldChangeSocketOptions) :
     _readyReadBackupTimer->start(READY_READ_BACKUP_CHECK_MSECS);
 }
 
+Socket::~Socket() {
+#ifdef UDT_BATCHED_IO
+    delete _batchedReadNotifier;
+    if (_batchedReadDescriptor != -1) {
+        ::close(_batchedReadDescriptor);
+    }
+#endif
+}
+
 void Socket::bind(const QHostAddress& address, quint16 port) {
     _udpSocket.bind(address, port);
 
@@ -71,6 +112,8 @@ void Socket::bind(const QHostAddress& address, quint16 port) {
         setsockopt(sd, IPPROTO_IP, IP_DONTFRAGMENT, &val, sizeof(val));
 #endif
     }
+
+    setupBatchedIO();
 }
 
 void Socket::rebind() {
@@ -82,6 +125,56 @@ void Socket::rebind(quint16 localPort) {
     bind(QHostAddress::AnyIPv4, localPort);
 }
 
+bool Socket::isBatchedIOSupported() {
+#ifdef UDT_BATCHED_IO
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Socket::setBatchedIOEnabled(bool enabled) {
+    _batchedIOEnabled = enabled && isBatchedIOSupported();
+    setupBatchedIO();
+}
+
+void Socket::setupBatchedIO() {
+#ifdef UDT_BATCHED_IO
+    // let go of the descriptor of the previous bind, if any
+    // the notifier is deleted later, since this may be reached from its own activated signal
+    if (_batchedReadNotifier) {
+        _batchedReadNotifier->setEnabled(false);
+        _batchedReadNotifier->deleteLater();
+        _batchedReadNotifier = nullptr;
+    }
+    if (_batchedReadDescriptor != -1) {
+        ::close(_batchedReadDescriptor);
+        _batchedReadDescriptor = -1;
+    }
+
+    auto socketDescriptor = _udpSocket.socketDescriptor();
+    if (_batchedIOEnabled && socketDescriptor != -1) {
+        // QUdpSocket only re-arms its read notifier once it is read from, so batched reads are driven by our own
+        // notifier, on a duplicate descriptor so that it does not collide with the one QUdpSocket registered
+        _batchedReadDescriptor = dup(socketDescriptor);
+
+        if (_batchedReadDescriptor != -1) {
+            _batchedReadNotifier = new QSocketNotifier(_batchedReadDescriptor, QSocketNotifier::Read, this);
+            connect(_batchedReadNotifier, &QSocketNotifier::activated, this, &Socket::readPendingDatagramBatches);
+            disconnect(&_udpSocket, &QUdpSocket::readyRead, this, &Socket::readPendingDatagrams);
+
+            qCDebug(networking) << "udt::Socket is using batched datagram I/O";
+            return;
+        }
+
+        qCWarning(networking) << "udt::Socket could not set up batched datagram I/O -" << strerror(errno);
+        _batchedIOEnabled = false;
+    }
+
+    connect(&_udpSocket, &QUdpSocket::readyRead, this, &Socket::readPendingDatagrams, Qt::UniqueConnection);
+#endif
+}
+
 void Socket::setSystemBufferSizes() {
     for (int i = 0; i < 2; i++) {
         QAbstractSocket::SocketOption bufferOpt;
@@ -184,6 +277,17 @@ qint64 Socket::writePacketList(std::unique_ptr<PacketList> packetList, const Hif
         return 0;
     }
 
+#ifdef UDT_BATCHED_IO
+    // impaired datagrams go through writeDatagram one at a time
+    bool isImpaired = false;
+#ifdef UDT_LINK_IMPAIRMENT
+    isImpaired = _linkImpairment.isEnabled();
+#endif
+    if (_batchedIOEnabled && !isImpaired && sockAddr.getAddress().protocol() == QAbstractSocket::IPv4Protocol) {
+        return writePacketBatch(std::move(packetList), sockAddr);
+    }
+#endif
+
     // Unerliable and Unordered
     qint64 totalBytesSent = 0;
     while (!packetList->_packets.empty()) {
@@ -223,7 +327,16 @@ qint64 Socket::writeDatagram(const char* data, qint64 size, const HifiSockAddr&
 }
 
 qint64 Socket::writeDatagram(const QByteArray& datagram, const HifiSockAddr& sockAddr) {
+#ifdef UDT_LINK_IMPAIRMENT
+    if (_linkImpairment.isEnabled()) {
+        return _linkImpairment.write(datagram, sockAddr);
+    }
+#endif
+
+    return writeDatagramToSocket(datagram, sockAddr);
+}
 
+qint64 Socket::writeDatagramToSocket(const QByteArray& datagram, const HifiSockAddr& sockAddr) {
     qint64 bytesWritten = _udpSocket.writeDatagram(datagram, sockAddr.getAddress(), sockAddr.getPort());
 
     if (bytesWritten < 0) {
@@ -238,6 +351,58 @@ qint64 Socket::writeDatagram(const QByteArray& datagram, const HifiSockAddr& soc
     return bytesWritten;
 }
 
+#ifdef UDT_BATCHED_IO
+
+qint64 Socket::writePacketBatch(std::unique_ptr<PacketList> packetList, const HifiSockAddr& sockAddr) {
+    // the batch points into the packets, so they are held until it is sent
+    std::vector<std::unique_ptr<Packet>> packets;
+    packets.reserve(packetList->getNumPackets());
+    while (!packetList->_packets.empty()) {
+        packets.push_back(packetList->takeFront<Packet>());
+    }
+
+    {
+        Lock lock(_unreliableSequenceNumbersMutex);
+        auto& sequenceNumber = _unreliableSequenceNumbers[sockAddr];
+        for (auto& packet : packets) {
+            packet->writeSequenceNumber(++sequenceNumber);
+        }
+    }
+
+    DatagramBatch batch;
+    qint64 totalBytesSent = 0;
+
+    auto sendBatch = [&] {
+        qint64 bytesSent = batch.send(_udpSocket.socketDescriptor());
+
+        if (bytesSent < 0) {
+            // as in writeDatagram, suppress repeats of this error since it is not uncommon when saturating a link
+            static const QString WRITE_ERROR_REGEX = "Socket::writePacketBatch sendmmsg failed";
+            static QString repeatedMessage
+                = LogHandler::getInstance().addRepeatedMessageRegex(WRITE_ERROR_REGEX);
+
+            qCDebug(networking) << "Socket::writePacketBatch sendmmsg failed -" << strerror(errno);
+        } else {
+            totalBytesSent += bytesSent;
+        }
+    };
+
+    for (auto& packet : packets) {
+        if (!batch.queue(packet->getData(), packet->getDataSize(), sockAddr)) {
+            sendBatch();
+            batch.queue(packet->getData(), packet->getDataSize(), sockAddr);
+        }
+    }
+
+    if (batch.getNumQueued() > 0) {
+        sendBatch();
+    }
+
+    return totalBytesSent;
+}
+
+#endif
+
 Connection* Socket::findOrCreateConnection(const HifiSockAddr& sockAddr) {
     auto it = _connectionsHash.find(sockAddr);
 
@@ -342,7 +507,7 @@ void Socket::readPendingDatagrams() {
         HifiSockAddr senderSockAddr;
 
         // setup a buffer to read the packet into
-        auto buffer = std::unique_ptr<char[]>(new char[packetSizeWithHeader]);
+        auto buffer = PacketBufferPool::allocate(packetSizeWithHeader);
 
         // pull the datagram
         auto sizeRead = _udpSocket.readDatagram(buffer.get(), packetSizeWithHeader,
@@ -358,65 +523,112 @@ void Socket::readPendingDatagrams() {
             continue;
         }
 
-        auto it = _unfilteredHandlers.find(senderSockAddr);
+        processDatagram(std::move(buffer), packetSizeWithHeader, senderSockAddr, receiveTime);
+    }
+}
 
-        if (it != _unfilteredHandlers.end()) {
-            // we have a registered unfiltered handler for this HifiSockAddr - call that and return
-            if (it->second) {
-                auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-                basePacket->setReceiveTime(receiveTime);
-                it->second(std::move(basePacket));
-            }
+#ifdef UDT_BATCHED_IO
 
-            continue;
+void Socket::readPendingDatagramBatches() {
+    int numRead = 0;
+
+    // a full batch may have left more datagrams behind, so keep reading until one comes up short
+    do {
+        numRead = _receiveBatch.receive(_batchedReadDescriptor);
+
+        if (numRead < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                qCDebug(networking) << "Socket::readPendingDatagramBatches recvmmsg failed -" << strerror(errno);
+            }
+            return;
         }
 
-        // check if this was a control packet or a data packet
-        bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
+        // we're reading packets so re-start the readyRead backup timer
+        _readyReadBackupTimer->start();
+
+        // the datagrams of a batch were all pending at the same time, so they share a receive time
+        auto receiveTime = p_high_resolution_clock::now();
 
-        if (isControlPacket) {
-            // setup a control packet from the data we just read
-            auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-            controlPacket->setReceiveTime(receiveTime);
+        for (int i = 0; i < numRead; ++i) {
+            auto sizeRead = _receiveBatch.getSize(i);
+            auto senderSockAddr = _receiveBatch.getSenderSockAddr(i);
 
-            // move this control packet to the matching connection, if there is one
-            auto connection = findOrCreateConnection(senderSockAddr);
+            // save information for this packet, in case it is the one that sticks the read notifier
+            _lastPacketSizeRead = sizeRead;
+            _lastPacketSockAddr = senderSockAddr;
 
-            if (connection) {
-                connection->processControl(move(controlPacket));
+            if (sizeRead <= 0 || _receiveBatch.isTruncated(i)) {
+                // a datagram larger than MAX_PACKET_SIZE cannot be a valid packet
+                continue;
             }
 
-        } else {
-            // setup a Packet from the data we just read
-            auto packet = Packet::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-            packet->setReceiveTime(receiveTime);
-
-            // save the sequence number in case this is the packet that sticks readyRead
-            _lastReceivedSequenceNumber = packet->getSequenceNumber();
-
-            // call our verification operator to see if this packet is verified
-            if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
-                if (packet->isReliable()) {
-                    // if this was a reliable packet then signal the matching connection with the sequence number
-                    auto connection = findOrCreateConnection(senderSockAddr);
-
-                    if (!connection || !connection->processReceivedSequenceNumber(packet->getSequenceNumber(),
-                                                                                  packet->getDataSize(),
-                                                                                  packet->getPayloadSize())) {
-                        // the connection could not be created or indicated that we should not continue processing this packet
-                        continue;
-                    }
+            processDatagram(_receiveBatch.takeData(i), sizeRead, senderSockAddr, receiveTime);
+        }
+    } while (numRead == DatagramBatch::BATCH_SIZE && _batchedReadDescriptor != -1);
+}
+
+#endif
+
+void Socket::processDatagram(PacketBufferPool::Buffer buffer, qint64 packetSizeWithHeader,
+                             const HifiSockAddr& senderSockAddr, p_high_resolution_clock::time_point receiveTime) {
+    auto it = _unfilteredHandlers.find(senderSockAddr);
+
+    if (it != _unfilteredHandlers.end()) {
+        // we have a registered unfiltered handler for this HifiSockAddr - call that and return
+        if (it->second) {
+            auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
+            basePacket->setReceiveTime(receiveTime);
+            it->second(std::move(basePacket));
+        }
+
+        return;
+    }
+
+    // check if this was a control packet or a data packet
+    bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
+
+    if (isControlPacket) {
+        // setup a control packet from the data we just read
+        auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
+        controlPacket->setReceiveTime(receiveTime);
+
+        // move this control packet to the matching connection, if there is one
+        auto connection = findOrCreateConnection(senderSockAddr);
+
+        if (connection) {
+            connection->processControl(move(controlPacket));
+        }
+
+    } else {
+        // setup a Packet from the data we just read
+        auto packet = Packet::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
+        packet->setReceiveTime(receiveTime);
+
+        // save the sequence number in case this is the packet that sticks readyRead
+        _lastReceivedSequenceNumber = packet->getSequenceNumber();
+
+        // call our verification operator to see if this packet is verified
+        if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
+            if (packet->isReliable()) {
+                // if this was a reliable packet then signal the matching connection with the sequence number
+                auto connection = findOrCreateConnection(senderSockAddr);
+
+                if (!connection || !connection->processReceivedSequenceNumber(packet->getSequenceNumber(),
+                                                                              packet->getDataSize(),
+                                                                              packet->getPayloadSize())) {
+                    // the connection could not be created or indicated that we should not continue processing this packet
+                    return;
                 }
+            }
 
-                if (packet->isPartOfMessage()) {
-                    auto connection = findOrCreateConnection(senderSockAddr);
-                    if (connection) {
-                        connection->queueReceivedMessagePacket(std::move(packet));
-                    }
-                } else if (_packetHandler) {
-                    // call the verified packet callback to let it handle this packet
-                    _packetHandler(std::move(packet));
+            if (packet->isPartOfMessage()) {
+                auto connection = findOrCreateConnection(senderSockAddr);
+                if (connection) {
+                    connection->queueReceivedMessagePacket(std::move(packet));
                 }
+            } else if (_packetHandler) {
+                // call the verified packet callback to let it handle this packet
+                _packetHandler(std::move(packet));
             }
         }
     }
@@ -19,12 +19,16 @@
 #include <mutex>
 
 #include <QtCore/QObject>
+#include <QtCore/QSocketNotifier>
 #include <QtCore/QTimer>
 #include <QtNetwork/QUdpSocket>
 
 #include "../HifiSockAddr.h"
 #include "TCPVegasCC.h"
 #include "Connection.h"
+#include "DatagramBatch.h"
+#include "LinkImpairment.h"
+#include "SendQueuePool.h"
 
 //#define UDT_CONNECTION_DEBUG
 
@@ -55,6 +59,7 @@ public:
     using StatsVector = std::vector<std::pair<HifiSockAddr, ConnectionStats::Stats>>;
     
     Socket(QObject* object = 0, bool shouldChangeSocketOptions = true);
+    ~Socket();
     
     quint16 localPort() const { return _udpSocket.localPort(); }
     
@@ -83,15 +88,30 @@ public:
     void setCongestionControlFactory(std::unique_ptr<CongestionControlVirtualFactory> ccFactory);
     void setConnectionMaxBandwidth(int maxBandwidth);
 
+    // reads and writes batches of datagrams with a single system call, on platforms that support it
+    //   this defaults to whether HIFI_UDT_BATCHED_IO is set in the environment, and should be changed before bind
+    static bool isBatchedIOSupported();
+    void setBatchedIOEnabled(bool enabled);
+    bool isBatchedIOEnabled() const { return _batchedIOEnabled; }
+
     void messageReceived(std::unique_ptr<Packet> packet);
     void messageFailed(Connection* connection, Packet::MessageNumber messageNumber);
     
     StatsVector sampleStatsForAllConnections();
 
+    // the pacing threads that service the SendQueues of this socket's connections
+    SendQueuePool& getSendQueuePool() { return _sendQueuePool; }
+
 #if (PR_BUILD || DEV_BUILD)
     void sendFakedHandshakeRequest(const HifiSockAddr& sockAddr);
 #endif
 
+#ifdef UDT_LINK_IMPAIRMENT
+    // impairs the datagrams this socket writes, per destination - this defaults to the profile in
+    //   HIFI_UDT_LINK_IMPAIRMENT for every destination, if it is set in the environment
+    LinkImpairment& getLinkImpairment() { return _linkImpairment; }
+#endif
+
 signals:
     void clientHandshakeRequestComplete(const HifiSockAddr& sockAddr);
 
@@ -109,6 +129,14 @@ private slots:
 
 private:
     void setSystemBufferSizes();
+    void setupBatchedIO();
+    qint64 writeDatagramToSocket(const QByteArray& datagram, const HifiSockAddr& sockAddr);
+    void processDatagram(PacketBufferPool::Buffer buffer, qint64 packetSizeWithHeader,
+                         const HifiSockAddr& senderSockAddr, p_high_resolution_clock::time_point receiveTime);
+#ifdef UDT_BATCHED_IO
+    void readPendingDatagramBatches();
+    qint64 writePacketBatch(std::unique_ptr<PacketList> packetList, const HifiSockAddr& sockAddr);
+#endif
     Connection* findOrCreateConnection(const HifiSockAddr& sockAddr);
     bool socketMatchesNodeOrDomain(const HifiSockAddr& sockAddr);
    
@@ -122,6 +150,9 @@ private:
     Q_INVOKABLE void writeReliablePacketList(PacketList* packetList, const HifiSockAddr& sockAddr);
     
     QUdpSocket _udpSocket { this };
+#ifdef UDT_LINK_IMPAIRMENT
+    LinkImpairment _linkImpairment; // must outlive the SendQueues that write through it
+#endif
     PacketFilterOperator _packetFilterOperator;
     PacketHandler _packetHandler;
     MessageHandler _messageHandler;
@@ -132,6 +163,8 @@ private:
 
     std::unordered_map<HifiSockAddr, BasePacketHandler> _unfilteredHandlers;
     std::unordered_map<HifiSockAddr, SequenceNumber> _unreliableSequenceNumbers;
+
+    SendQueuePool _sendQueuePool; // must outlive the connections, whose SendQueues it services
     std::unordered_map<HifiSockAddr, std::unique_ptr<Connection>> _connectionsHash;
     
     int _synInterval { 10 }; // 10ms
@@ -145,6 +178,13 @@ private:
 
     bool _shouldChangeSocketOptions { true };
 
+    bool _batchedIOEnabled { false };
+#ifdef UDT_BATCHED_IO
+    DatagramBatch _receiveBatch;
+    QSocketNotifier* _batchedReadNotifier { nullptr };
+    int _batchedReadDescriptor { -1 }; // a duplicate of the socket descriptor, for _batchedReadNotifier
+#endif
+
     int _lastPacketSizeRead { 0 };
     SequenceNumber _lastReceivedSequenceNumber;
     HifiSockAddr _lastPacketSockAddr;
@@ -0,0 +1,156 @@
+//
+//  TimerWheel.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_TimerWheel_h
+#define hifi_TimerWheel_h
+
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <iterator>
+#include <vector>
+
+#include <PortableHighResolutionClock.h>
+
+namespace udt {
+
+// Hashed timer wheel of items, each due at a time point
+//   Items are hashed into slots by the tick of their due time, so that inserting and removing an item is cheap,
+//   and expiring only visits the slots of the ticks that have passed. Items due beyond one turn of the wheel share
+//   slots with nearer ones, and are left in place until their turn comes around.
+//   TimerWheel is not thread-safe.
+template <typename T>
+class TimerWheel {
+public:
+    using TimePoint = p_high_resolution_clock::time_point;
+
+    struct Entry {
+        T item;
+        TimePoint due;
+    };
+
+    static const int NUM_SLOTS = 512;
+    static const int TICK_USECS = 100;
+
+    // due must be before TimePoint::max()
+    void insert(T item, TimePoint due);
+
+    // removes an item inserted with the given due time, returns false if there was none
+    bool remove(const T& item, TimePoint due);
+
+    // appends the entries due by now to expired, and removes them from the wheel
+    void expire(TimePoint now, std::deque<Entry>& expired);
+
+    // returns the earliest due time, or TimePoint::max() if the wheel is empty
+    TimePoint getNextDue() const;
+
+    bool isEmpty() const { return _size == 0; }
+    int size() const { return _size; }
+
+private:
+    static qint64 tickForTime(TimePoint time) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count() / TICK_USECS;
+    }
+
+    // items that are already overdue go in the current slot, so that the next expire finds them
+    qint64 slotTickForTime(TimePoint due) const {
+        return (_currentTick < 0) ? tickForTime(due) : std::max(tickForTime(due), _currentTick);
+    }
+    std::vector<Entry>& slotForTick(qint64 tick) { return _slots[tick % NUM_SLOTS]; }
+    const std::vector<Entry>& slotForTick(qint64 tick) const { return _slots[tick % NUM_SLOTS]; }
+
+    std::array<std::vector<Entry>, NUM_SLOTS> _slots;
+    qint64 _currentTick { -1 }; // the earliest tick that may have entries left to expire, once expire has been called
+    int _size { 0 };
+};
+
+template <typename T>
+void TimerWheel<T>::insert(T item, TimePoint due) {
+    slotForTick(slotTickForTime(due)).push_back({ item, due });
+    ++_size;
+}
+
+template <typename T>
+bool TimerWheel<T>::remove(const T& item, TimePoint due) {
+    if (_size == 0) {
+        return false;
+    }
+
+    auto& slot = slotForTick(slotTickForTime(due));
+    auto it = std::find_if(slot.begin(), slot.end(), [&](const Entry& entry) {
+        return entry.item == item && entry.due == due;
+    });
+
+    if (it == slot.end()) {
+        return false;
+    }
+
+    slot.erase(it);
+    --_size;
+    return true;
+}
+
+template <typename T>
+void TimerWheel<T>::expire(TimePoint now, std::deque<Entry>& expired) {
+    qint64 nowTick = tickForTime(now);
+
+    // visit every slot up to now once, and the current slot even if no tick has passed
+    qint64 firstTick = (_currentTick < 0) ? nowTick - NUM_SLOTS + 1 : _currentTick;
+    qint64 lastTick = std::min(nowTick, firstTick + NUM_SLOTS - 1);
+    for (qint64 tick = firstTick; tick <= lastTick && _size > 0; ++tick) {
+        auto& slot = slotForTick(tick);
+
+        auto firstLater = std::stable_partition(slot.begin(), slot.end(), [&](const Entry& entry) {
+            return entry.due <= now;
+        });
+
+        _size -= (int)(firstLater - slot.begin());
+        std::move(slot.begin(), firstLater, std::back_inserter(expired));
+        slot.erase(slot.begin(), firstLater);
+    }
+
+    _currentTick = std::max(_currentTick, nowTick);
+}
+
+template <typename T>
+typename TimerWheel<T>::TimePoint TimerWheel<T>::getNextDue() const {
+    if (_size == 0) {
+        return TimePoint::max();
+    }
+
+    // the first slot with an entry due in the current turn of the wheel has the earliest entry
+    for (qint64 tick = _currentTick; _currentTick >= 0 && tick < _currentTick + NUM_SLOTS; ++tick) {
+        TimePoint nextDue = TimePoint::max();
+        for (auto& entry : slotForTick(tick)) {
+            if (tickForTime(entry.due) <= tick) {
+                nextDue = std::min(nextDue, entry.due);
+            }
+        }
+
+        if (nextDue != TimePoint::max()) {
+            return nextDue;
+        }
+    }
+
+    // every entry is due after this turn of the wheel
+    TimePoint nextDue = TimePoint::max();
+    for (auto& slot : _slots) {
+        for (auto& entry : slot) {
+            nextDue = std::min(nextDue, entry.due);
+        }
+    }
+    return nextDue;
+}
+
+} // namespace udt
+
+#endif // hifi_TimerWheel_h
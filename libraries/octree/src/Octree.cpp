@@ -30,6 +30,7 @@
 #include <QFile>
 #include <QJsonDocument>
 #include <QFileInfo>
+#include <QSaveFile>
 #include <QString>
 
 #include <GeometryUtil.h>
@@ -51,7 +52,20 @@
 #include "OctreeUtils.h"
 
 
-QVector<QString> PERSIST_EXTENSIONS = {"json", "json.gz"};
+QVector<QString> PERSIST_EXTENSIONS = {"json", "json.gz", "bin"};
+
+// Binary files are a header followed by the records of the tree's elements, in a format of the tree's choosing that is
+// usually its data packet encoding. They are written as the tree is traversed, and mapped into memory to be read.
+static const char BINARY_FILE_SIGNATURE[4] = { 'H', 'F', 'O', 'B' };
+static const quint8 BINARY_FILE_FORMAT_VERSION = 2;
+
+struct BinaryFileHeader {
+    char signature[sizeof(BINARY_FILE_SIGNATURE)];
+    quint8 formatVersion;
+    quint8 packetType; // the type and version of the data packets the records are encoded like
+    PacketVersion packetVersion;
+    quint8 reserved;
+};
 
 Octree::Octree(bool shouldReaverage) :
     _rootElement(NULL),
@@ -683,6 +697,14 @@ OctreeElementPointer Octree::getOctreeEnclosingElementAt(float x, float y, float
     return element;
 }
 
+OctreeElementPointer Octree::getParentElement(const OctreeElementPointer& element) const {
+    OctreeElementPointer parentElement = NULL;
+    if (element && element != _rootElement) {
+        nodeForOctalCode(_rootElement, element->getOctalCode(), &parentElement);
+    }
+    return parentElement;
+}
+
 
 OctreeElementPointer Octree::getOrCreateChildElementAt(float x, float y, float z, float s) {
     return getRoot()->getOrCreateChildElementAt(x, y, z, s);
@@ -1625,6 +1647,10 @@ bool Octree::readFromFile(const char* fileName) {
         return readJSONFromGzippedFile(qFileName);
     }
 
+    if (qFileName.endsWith(".bin")) {
+        return readFromBinaryFile(qFileName);
+    }
+
     QFile file(qFileName);
 
     if (!file.open(QIODevice::ReadOnly)) {
@@ -1667,6 +1693,60 @@ bool Octree::readJSONFromGzippedFile(QString qFileName) {
     return readJSONFromStream(-1, jsonStream);
 }
 
+bool Octree::readFromBinaryFile(QString qFileName) {
+    QFile file(qFileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCritical() << "Cannot open binary file for reading: " << qFileName;
+        return false;
+    }
+
+    qint64 fileSize = file.size();
+    if (fileSize < (qint64)sizeof(BinaryFileHeader)) {
+        qCritical() << "Binary file is too short for its header: " << qFileName;
+        return false;
+    }
+
+    // the records are decoded straight out of the page cache, rather than being copied out of it first
+    auto fileData = file.map(0, fileSize);
+    if (!fileData) {
+        qCritical() << "Cannot map binary file for reading: " << qFileName;
+        return false;
+    }
+
+    BinaryFileHeader header;
+    memcpy(&header, fileData, sizeof(header));
+
+    PacketType expectedType = expectedDataPacketType();
+    PacketVersion expectedVersion = versionForPacketType(expectedType);
+
+    bool success = false;
+    if (memcmp(header.signature, BINARY_FILE_SIGNATURE, sizeof(BINARY_FILE_SIGNATURE)) != 0
+        || header.formatVersion != BINARY_FILE_FORMAT_VERSION) {
+        qCritical() << "Binary file is not in a format that can be read: " << qFileName;
+    } else if (header.packetType != (quint8)expectedType) {
+        qCritical() << "Binary file type mismatch. Expected: " << expectedType << " Got: " << (PacketType)header.packetType;
+    } else if (header.packetVersion > expectedVersion || !canProcessVersion(header.packetVersion)) {
+        // the records are decoded like the data packets of the version that wrote them, which has to be one this
+        // version can read - the file is kept aside, since the next persist would replace it
+        qCritical("Binary file version mismatch. Expected: %d Got: %d", expectedVersion, header.packetVersion);
+
+        QString keptFileName = qFileName + ".v" + QString::number(header.packetVersion);
+        if (QFile::exists(keptFileName) || QFile::copy(qFileName, keptFileName)) {
+            qCritical() << "Binary file kept at" << keptFileName << "- save it as JSON with the version that wrote it";
+        }
+    } else {
+        qCDebug(octree) << "Loading binary file" << qFileName << "...";
+
+        emit importProgress(0);
+        success = readFromBinaryData(reinterpret_cast<const char*>(fileData) + sizeof(header),
+                                     fileSize - sizeof(header), header.packetVersion);
+        emit importProgress(100);
+    }
+
+    file.unmap(fileData);
+    return success;
+}
+
 bool Octree::readFromURL(const QString& urlString) {
     auto request = std::unique_ptr<ResourceRequest>(ResourceManager::createResourceRequest(this, urlString));
 
@@ -1877,6 +1957,8 @@ bool Octree::writeToFile(const char* fileName, OctreeElementPointer element, QSt
         success = writeToJSONFile(cFileName, element);
     } else if (persistAsFileType == "json.gz") {
         success = writeToJSONFile(cFileName, element, true);
+    } else if (persistAsFileType == "bin") {
+        success = writeToBinaryFile(cFileName, element);
     } else {
         qCDebug(octree) << "unable to write octree to file of type" << persistAsFileType;
     }
@@ -1884,10 +1966,28 @@ bool Octree::writeToFile(const char* fileName, OctreeElementPointer element, QSt
 }
 
 bool Octree::writeToJSONFile(const char* fileName, OctreeElementPointer element, bool doGzip) {
-    QVariantMap entityDescription;
-
     qCDebug(octree, "Saving JSON SVO to file %s...", fileName);
 
+    QByteArray jsonDataForFile;
+    if (!writeToJSONData(jsonDataForFile, element, doGzip)) {
+        return false;
+    }
+
+    // the file only replaces the last one once it has been completely written
+    QSaveFile persistFile(fileName);
+    bool success = false;
+    if (persistFile.open(QIODevice::WriteOnly)) {
+        success = persistFile.write(jsonDataForFile) != -1 && persistFile.commit();
+    } else {
+        qCritical("Could not write to JSON description of entities.");
+    }
+
+    return success;
+}
+
+bool Octree::writeToJSONData(QByteArray& data, OctreeElementPointer element, bool doGzip) {
+    QVariantMap entityDescription;
+
     OctreeElementPointer top;
     if (element) {
         top = element;
@@ -1909,26 +2009,51 @@ bool Octree::writeToJSONFile(const char* fileName, OctreeElementPointer element,
 
     // convert the QVariantMap to JSON
     QByteArray jsonData = QJsonDocument::fromVariant(entityDescription).toJson();
-    QByteArray jsonDataForFile;
 
     if (doGzip) {
-        if (!gzip(jsonData, jsonDataForFile, -1)) {
+        if (!gzip(jsonData, data, -1)) {
             qCritical("unable to gzip data while saving to json.");
             return false;
         }
     } else {
-        jsonDataForFile = jsonData;
+        data = jsonData;
     }
 
-    QFile persistFile(fileName);
-    bool success = false;
-    if (persistFile.open(QIODevice::WriteOnly)) {
-        success = persistFile.write(jsonDataForFile) != -1;
-    } else {
-        qCritical("Could not write to JSON description of entities.");
+    return true;
+}
+
+bool Octree::writeToBinaryFile(const char* fileName, OctreeElementPointer element) {
+    qCDebug(octree, "Saving binary SVO to file %s...", fileName);
+
+    // the records are written as they are encoded, and the file only replaces the last one once they all have been
+    QSaveFile persistFile(fileName);
+    if (!persistFile.open(QIODevice::WriteOnly)) {
+        qCritical("Could not open binary file of entities for writing.");
+        return false;
     }
 
-    return success;
+    PacketType expectedType = expectedDataPacketType();
+
+    BinaryFileHeader header;
+    memcpy(header.signature, BINARY_FILE_SIGNATURE, sizeof(BINARY_FILE_SIGNATURE));
+    header.formatVersion = BINARY_FILE_FORMAT_VERSION;
+    header.packetType = (quint8)expectedType;
+    header.packetVersion = versionForPacketType(expectedType);
+    header.reserved = 0;
+    persistFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    if (!writeToBinaryStream(persistFile, element ? element : _rootElement)) {
+        qCritical("Failed to write entities to binary file.");
+        persistFile.cancelWriting();
+        return false;
+    }
+
+    if (!persistFile.commit()) {
+        qCritical("Could not write to binary file of entities.");
+        return false;
+    }
+
+    return true;
 }
 
 unsigned long Octree::getOctreeElementsCount() {
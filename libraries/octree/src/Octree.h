@@ -24,11 +24,13 @@
 #include <ViewFrustum.h>
 
 #include "JurisdictionMap.h"
+#include "OctreeEditLog.h"
 #include "OctreeElement.h"
 #include "OctreeElementBag.h"
 #include "OctreePacketData.h"
 #include "OctreeSceneStats.h"
 
+class QIODevice;
 class ReadBitstreamToTreeParams;
 class Octree;
 class OctreeElement;
@@ -206,6 +208,7 @@ public:
     // own definition. Implement these to allow your octree based server to support editing
     virtual bool getWantSVOfileVersions() const { return false; }
     virtual PacketType expectedDataPacketType() const { return PacketType::Unknown; }
+    virtual PacketType expectedEditLogPacketType() const { return PacketType::Unknown; } // what edits are logged as
     virtual bool canProcessVersion(PacketVersion thisVersion) const {
                     return thisVersion == versionForPacketType(expectedDataPacketType()); }
     virtual PacketVersion expectedVersion() const { return versionForPacketType(expectedDataPacketType()); }
@@ -244,6 +247,10 @@ public:
     /// Find the voxel at position x,y,z,s
     /// \return pointer to the OctreeElement or to the smallest enclosing parent if none at x,y,z,s.
     OctreeElementPointer getOctreeEnclosingElementAt(float x, float y, float z, float s) const;
+
+    /// Find the element that has the given element as a child
+    /// \return pointer to the OctreeElement or NULL if the given element is the root.
+    OctreeElementPointer getParentElement(const OctreeElementPointer& element) const;
     
     OctreeElementPointer getOrCreateChildElementAt(float x, float y, float z, float s);
     OctreeElementPointer getOrCreateChildElementContaining(const AACube& box);
@@ -295,9 +302,14 @@ public:
     // Octree exporters
     bool writeToFile(const char* filename, OctreeElementPointer element = NULL, QString persistAsFileType = "json.gz");
     bool writeToJSONFile(const char* filename, OctreeElementPointer element = NULL, bool doGzip = false);
+    bool writeToJSONData(QByteArray& data, OctreeElementPointer element = NULL, bool doGzip = false);
+    bool writeToBinaryFile(const char* filename, OctreeElementPointer element = NULL);
     virtual bool writeToMap(QVariantMap& entityDescription, OctreeElementPointer element, bool skipDefaultValues,
                             bool skipThoseWithBadParents) = 0;
 
+    // writes the records of a binary file as it goes, after its header has been written
+    virtual bool writeToBinaryStream(QIODevice& device, OctreeElementPointer element) = 0;
+
     // Octree importers
     bool readFromFile(const char* filename);
     bool readFromURL(const QString& url); // will support file urls as well...
@@ -305,8 +317,19 @@ public:
     bool readSVOFromStream(unsigned long streamLength, QDataStream& inputStream);
     bool readJSONFromStream(unsigned long streamLength, QDataStream& inputStream);
     bool readJSONFromGzippedFile(QString qFileName);
+    bool readFromBinaryFile(QString qFileName);
     virtual bool readFromMap(QVariantMap& entityDescription) = 0;
 
+    // reads the records of a binary file, which were encoded like the data packets of the given version
+    virtual bool readFromBinaryData(const char* data, qint64 length, PacketVersion version) = 0;
+
+    // the edits made to the tree are appended to the edit log, if it has one, once they have been applied
+    void setEditLog(OctreeEditLogPointer editLog) { _editLog = editLog; }
+    OctreeEditLogPointer getEditLog() const { return _editLog; }
+
+    // applies a record of the edit log, which may already have been applied to the tree
+    virtual bool readFromEditLogRecord(const char* data, int size) = 0;
+
     unsigned long getOctreeElementsCount();
 
     bool getShouldReaverage() const { return _shouldReaverage; }
@@ -375,6 +398,8 @@ protected:
 
     bool _isViewing;
     bool _isServer;
+
+    OctreeEditLogPointer _editLog;
 };
 
 #endif // hifi_Octree_h
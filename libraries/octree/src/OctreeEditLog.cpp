@@ -0,0 +1,247 @@
+//
+//  OctreeEditLog.cpp
+//  libraries/octree/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeEditLog.h"
+
+#include <algorithm>
+
+#include <QtCore/QDateTime>
+
+#include <RecordLog.h>
+
+#include "OctreeLogging.h"
+
+static const QString CHECKPOINT_FILE_EXTENSION = ".checkpoint";
+
+static const char EDIT_LOG_SIGNATURE[4] = { 'H', 'F', 'E', 'L' };
+
+struct EditLogHeader {
+    char signature[sizeof(EDIT_LOG_SIGNATURE)];
+    quint8 packetType;
+    PacketVersion packetVersion;
+    quint16 reserved;
+};
+
+// the records of a file written by another version may be encoded differently, so they are kept for that version
+static bool setAside(const QString& fileName, const QByteArray& data) {
+    EditLogHeader header;
+    QString version = "unknown";
+    if (data.size() >= (int)sizeof(header)
+        && memcmp(data.constData(), EDIT_LOG_SIGNATURE, sizeof(EDIT_LOG_SIGNATURE)) == 0) {
+        memcpy(&header, data.constData(), sizeof(header));
+        version = QString::number(header.packetVersion);
+    }
+
+    static const QString FILENAME_TIMESTAMP_FORMAT = "yyyyMMdd-hhmmss";
+    QString keptFileName = fileName + ".v" + version + "."
+        + QDateTime::currentDateTime().toString(FILENAME_TIMESTAMP_FORMAT);
+    if (!QFile::rename(fileName, keptFileName)) {
+        qCCritical(octree) << "Failed to set aside edit log at" << fileName << ", which was written by another version";
+        return false;
+    }
+
+    qCWarning(octree) << "Edit log at" << fileName << "was written by another version - kept at" << keptFileName
+        << "rather than replayed";
+    return true;
+}
+
+OctreeEditLog::OctreeEditLog(const QString& fileName, PacketType packetType) :
+    _logFile(fileName),
+    _checkpointFileName(fileName + CHECKPOINT_FILE_EXTENSION)
+{
+    EditLogHeader header;
+    memcpy(header.signature, EDIT_LOG_SIGNATURE, sizeof(EDIT_LOG_SIGNATURE));
+    header.packetType = (quint8)packetType;
+    header.packetVersion = versionForPacketType(packetType);
+    header.reserved = 0;
+    _header = QByteArray(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+bool OctreeEditLog::writeHeader(QFile& file) const {
+    return file.resize(0) && file.seek(0) && file.write(_header) == _header.size() && file.flush();
+}
+
+// drops the end of a record that was not completely written, before records are appended after it
+bool OctreeEditLog::trimToRecords(QFile& file) const {
+    auto data = file.readAll();
+    auto records = QByteArray::fromRawData(data.constData() + _header.size(), data.size() - _header.size());
+
+    int numRecords = 0;
+    auto recordsSize = readLogRecords(records, nullptr, numRecords);
+
+    if (recordsSize < records.size()) {
+        qCWarning(octree) << "Dropping" << records.size() - recordsSize << "bytes from the end of the edit log at"
+            << file.fileName() << "since they were not completely written.";
+        return file.resize(_header.size() + recordsSize);
+    }
+    return true;
+}
+
+int OctreeEditLog::replay(const RecordHandler& handler) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    int numRecords = 0;
+    for (auto& fileName : { _checkpointFileName, _logFile.fileName() }) {
+        QFile file { fileName };
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+
+        auto contents = file.readAll();
+        file.close();
+        if (contents.isEmpty()) {
+            continue;
+        }
+        if (!hasHeader(contents)) {
+            setAside(fileName, contents);
+            continue;
+        }
+
+        auto records = QByteArray::fromRawData(contents.constData() + _header.size(), contents.size() - _header.size());
+        readLogRecords(records, [&](const char* data, int size) {
+            handler(data, size);
+            return true;
+        }, numRecords);
+    }
+    return numRecords;
+}
+
+bool OctreeEditLog::open() {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    QFile checkpointFile { _checkpointFileName };
+    if (checkpointFile.exists()) {
+        if (!checkpointFile.open(QIODevice::ReadWrite)) {
+            qCCritical(octree) << "Failed to open edit log checkpoint at" << _checkpointFileName;
+            return false;
+        }
+
+        auto data = checkpointFile.readAll();
+        if (hasHeader(data)) {
+            if (!checkpointFile.seek(0) || !trimToRecords(checkpointFile)) {
+                qCCritical(octree) << "Failed to open edit log checkpoint at" << _checkpointFileName;
+                return false;
+            }
+            _checkpointSize = checkpointFile.size() - _header.size();
+        } else {
+            checkpointFile.close();
+            if (!setAside(_checkpointFileName, data)) {
+                return false;
+            }
+        }
+    }
+
+    if (!_logFile.open(QIODevice::ReadWrite)) {
+        qCCritical(octree) << "Failed to open edit log at" << _logFile.fileName();
+        return false;
+    }
+
+    auto data = _logFile.readAll();
+    if (!data.isEmpty() && !hasHeader(data)) {
+        _logFile.close();
+        if (!setAside(_logFile.fileName(), data) || !_logFile.open(QIODevice::ReadWrite)) {
+            qCCritical(octree) << "Failed to open edit log at" << _logFile.fileName();
+            return false;
+        }
+        data.clear();
+    }
+
+    bool opened = data.isEmpty() ? writeHeader(_logFile) : (_logFile.seek(0) && trimToRecords(_logFile));
+    if (!opened) {
+        qCCritical(octree) << "Failed to open edit log at" << _logFile.fileName();
+    }
+    return opened;
+}
+
+bool OctreeEditLog::append(const QByteArray& record) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (appendLogRecord(_logFile, record)) {
+        ++_numAppends;
+        return true;
+    }
+
+    qCWarning(octree) << "Failed to write to edit log at" << _logFile.fileName();
+    return false;
+}
+
+bool OctreeEditLog::beginCheckpoint() {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto recordsSize = _logFile.size() - _header.size();
+
+    if (!QFile::exists(_checkpointFileName)) {
+        auto logFileName = _logFile.fileName();
+        _logFile.close();
+
+        // the checkpoint file keeps the header of the log
+        bool renamed = QFile::rename(logFileName, _checkpointFileName);
+        if (renamed) {
+            _checkpointSize = recordsSize;
+        }
+
+        if (!_logFile.open(QIODevice::ReadWrite) || (renamed && !writeHeader(_logFile))) {
+            qCCritical(octree) << "Failed to reopen edit log at" << logFileName;
+            return false;
+        }
+        if (!renamed) {
+            qCWarning(octree) << "Failed to move edit log to checkpoint at" << _checkpointFileName;
+        }
+        return renamed;
+    }
+
+    // the last checkpoint didn't finish, so its records are still needed - these ones are added after them
+    QFile checkpointFile { _checkpointFileName };
+    if (!_logFile.seek(_header.size())) {
+        return false;
+    }
+    auto records = _logFile.readAll();
+
+    if (!checkpointFile.open(QIODevice::Append) || checkpointFile.write(records) != records.size()
+        || !checkpointFile.flush()) {
+        qCWarning(octree) << "Failed to add edit log to checkpoint at" << _checkpointFileName;
+        checkpointFile.resize(_header.size() + _checkpointSize);
+        return false;
+    }
+
+    _checkpointSize += records.size();
+    return _logFile.resize(_header.size());
+}
+
+void OctreeEditLog::endCheckpoint() {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (QFile::exists(_checkpointFileName) && !QFile::remove(_checkpointFileName)) {
+        // replaying the records over the octree that has them is harmless, so this only costs the time to do so
+        qCWarning(octree) << "Failed to remove edit log checkpoint at" << _checkpointFileName;
+        return;
+    }
+
+    _checkpointSize = 0;
+    ++_numCheckpoints;
+}
+
+void OctreeEditLog::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (QFile::exists(_checkpointFileName) && !QFile::remove(_checkpointFileName)) {
+        qCWarning(octree) << "Failed to remove edit log checkpoint at" << _checkpointFileName;
+    }
+    _checkpointSize = 0;
+
+    if (_logFile.exists() && !_logFile.resize(_logFile.isOpen() ? _header.size() : 0)) {
+        qCWarning(octree) << "Failed to empty edit log at" << _logFile.fileName();
+    }
+}
+
+qint64 OctreeEditLog::getSize() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return std::max(_logFile.size() - _header.size(), (qint64)0) + _checkpointSize;
+}
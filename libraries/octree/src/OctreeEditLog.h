@@ -0,0 +1,78 @@
+//
+//  OctreeEditLog.h
+//  libraries/octree/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeEditLog_h
+#define hifi_OctreeEditLog_h
+
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QString>
+
+#include <udt/PacketHeaders.h>
+
+// An append-only file of the edits made to an octree since it was last persisted
+//   Each edit is one record of the log (see RecordLog.h). Before the octree is persisted the log is rolled over to a
+//   checkpoint file, which is removed once the persist file has been written. Until then, the checkpoint file and the
+//   log are both replayed over the persist file, so that the records must be safe to apply to an octree that already
+//   has them.
+//   Both files start with the type and version of the packets the records are encoded like. A file written by another
+//   version is set aside rather than replayed.
+class OctreeEditLog {
+public:
+    using RecordHandler = std::function<void(const char* data, int size)>;
+
+    OctreeEditLog(const QString& fileName, PacketType packetType);
+
+    QString getFileName() const { return _logFile.fileName(); }
+    QString getCheckpointFileName() const { return _checkpointFileName; }
+
+    // calls the handler with each record of the checkpoint file and then the log, and returns how many there were
+    int replay(const RecordHandler& handler);
+
+    // opens the log for appending, dropping the end of a record that was not completely written
+    bool open();
+
+    bool append(const QByteArray& record);
+
+    // moves the records in the log to the checkpoint file, leaving the log for the edits made from now on
+    bool beginCheckpoint();
+
+    // removes the checkpoint file, once the octree has been persisted with all of its records
+    void endCheckpoint();
+
+    // removes the checkpoint file and empties the log, for when the octree is replaced
+    void clear();
+
+    qint64 getSize() const; // of the records in the log and the checkpoint file
+    int getNumAppends() const { return _numAppends; }
+    int getNumCheckpoints() const { return _numCheckpoints; }
+
+private:
+    bool hasHeader(const QByteArray& data) const { return data.startsWith(_header); }
+    bool writeHeader(QFile& file) const;
+    bool trimToRecords(QFile& file) const;
+
+    mutable std::mutex _mutex;
+    QFile _logFile;
+    QString _checkpointFileName;
+    QByteArray _header;
+    qint64 _checkpointSize { 0 };
+
+    int _numAppends { 0 };
+    int _numCheckpoints { 0 };
+};
+
+using OctreeEditLogPointer = std::shared_ptr<OctreeEditLog>;
+
+#endif // hifi_OctreeEditLog_h
@@ -9,6 +9,7 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
@@ -35,9 +36,14 @@
 const int OctreePersistThread::DEFAULT_PERSIST_INTERVAL = 1000 * 30; // every 30 seconds
 const QString OctreePersistThread::REPLACEMENT_FILE_EXTENSION = ".replace";
 
+static const QString EDIT_LOG_FILE_EXTENSION = ".edits";
+
+// the edit log is checkpointed once it is larger than the persist file, but not while it is this small
+static const qint64 MIN_EDIT_LOG_SIZE_TO_CHECKPOINT = 1024 * 1024;
+
 OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& filename, const QString& backupDirectory, int persistInterval,
                                          bool wantBackup, const QJsonObject& settings, bool debugTimestampNow,
-                                         QString persistAsFileType) :
+                                         QString persistAsFileType, bool wantEditLog) :
     _tree(tree),
     _filename(filename),
     _backupDirectory(backupDirectory),
@@ -55,12 +61,18 @@ OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& file
     // in case the persist filename has an extension that doesn't match the file type
     QString sansExt = fileNameWithoutExtension(_filename, PERSIST_EXTENSIONS);
     _filename = sansExt + "." + _persistAsFileType;
+
+    if (wantEditLog) {
+        _editLog = std::make_shared<OctreeEditLog>(sansExt + EDIT_LOG_FILE_EXTENSION,
+                                                   _tree->expectedEditLogPacketType());
+    }
 }
 
 QString OctreePersistThread::getPersistFileMimeType() const {
     if (_persistAsFileType == "json") {
         return "application/json";
-    } if (_persistAsFileType == "json.gz") {
+    } if (_persistAsFileType == "json.gz" || _persistAsFileType == "bin") {
+        // binary files are downloaded as gzipped JSON, like the others
         return "application/zip";
     }
     return "";
@@ -134,7 +146,9 @@ quint64 OctreePersistThread::getMostRecentBackupTimeInUsecs(const QString& forma
 
 void OctreePersistThread::possiblyReplaceContent() {
     // before we load the normal file, check if there's a pending replacement file
-    auto replacementFileName = _filename + REPLACEMENT_FILE_EXTENSION;
+    // replacements are always gzipped JSON, whatever the persist file type is
+    auto replacedFileName = fileNameWithoutExtension(_filename, PERSIST_EXTENSIONS) + ".json.gz";
+    auto replacementFileName = replacedFileName + REPLACEMENT_FILE_EXTENSION;
 
     QFile replacementFile { replacementFileName };
     if (replacementFile.exists()) {
@@ -160,10 +174,20 @@ void OctreePersistThread::possiblyReplaceContent() {
             }
         }
 
+        // a gzipped JSON file left from before persisting in another type is older than the replacement
+        if (replacedFileName != _filename && QFile::exists(replacedFileName) && !QFile::remove(replacedFileName)) {
+            qWarning() << "Could not remove previous models file at" << replacedFileName;
+        }
+
         // rename the replacement file to match what the persist thread is just about to read
-        if (!replacementFile.rename(_filename)) {
+        if (!replacementFile.rename(replacedFileName)) {
             qWarning() << "Could not replace models file with" << replacementFileName << "- starting with empty models file";
         }
+
+        // the edits in the log were made to the previous models
+        if (_editLog) {
+            _editLog->clear();
+        }
     }
 }
 
@@ -186,12 +210,19 @@ bool OctreePersistThread::process() {
             QString lockFileName = _filename + ".lock";
             std::ifstream lockFile(qPrintable(lockFileName), std::ios::in | std::ios::binary | std::ios::ate);
             if (lockFile.is_open()) {
-                qCDebug(octree) << "WARNING: Octree lock file detected at startup:" << lockFileName
-                    << "-- Attempting to restore from previous backup file.";
+                if (_editLog) {
+                    // the persist file is only replaced once it has been completely written, and the edits made
+                    // since the one that is there are still in the edit log, so nothing was lost
+                    qCDebug(octree) << "WARNING: Octree lock file detected at startup:" << lockFileName
+                        << "-- Replaying edit log over the last complete persist file.";
+                } else {
+                    qCDebug(octree) << "WARNING: Octree lock file detected at startup:" << lockFileName
+                        << "-- Attempting to restore from previous backup file.";
 
-                // This is where we should attempt to find the most recent backup and restore from
-                // that file as our persist file.
-                restoreFromMostRecentBackup();
+                    // This is where we should attempt to find the most recent backup and restore from
+                    // that file as our persist file.
+                    restoreFromMostRecentBackup();
+                }
 
                 lockFile.close();
                 qCDebug(octree) << "Loading Octree... lock file closed:" << lockFileName;
@@ -200,6 +231,12 @@ bool OctreePersistThread::process() {
             }
 
             persistantFileRead = _tree->readFromFile(qPrintable(_filename.toLocal8Bit()));
+            _persistFileSize = QFileInfo(_filename).size();
+
+            if (_editLog) {
+                replayEditLog();
+            }
+
             _tree->pruneTree();
         });
 
@@ -273,15 +310,49 @@ bool OctreePersistThread::process() {
 }
 
 
+void OctreePersistThread::replayEditLog() {
+    int numFailed = 0;
+    int numReplayed = _editLog->replay([&](const char* data, int size) {
+        if (!_tree->readFromEditLogRecord(data, size)) {
+            ++numFailed;
+        }
+    });
+
+    if (numReplayed > 0) {
+        qCDebug(octree) << "Replayed" << numReplayed << "edits from edit log at" << _editLog->getFileName();
+    }
+    if (numFailed > 0) {
+        qCWarning(octree) << "Failed to replay" << numFailed << "edits from edit log at" << _editLog->getFileName();
+    }
+
+    // edits are only logged from here, so that the ones just replayed aren't logged again
+    if (_editLog->open()) {
+        _tree->setEditLog(_editLog);
+    } else {
+        qCWarning(octree) << "Persisting the whole octree each time, without an edit log";
+        _editLog.reset();
+    }
+}
+
 void OctreePersistThread::aboutToFinish() {
     qCDebug(octree) << "Persist thread about to finish...";
-    persist();
+
+    // the next run may be of another version, which sets aside an edit log it didn't write rather than replay it
+    persist(true);
     qCDebug(octree) << "Persist thread done with about to finish...";
     _stopThread = true;
 }
 
 QByteArray OctreePersistThread::getPersistFileContents() const {
     QByteArray fileContents;
+
+    if (_persistAsFileType == "bin" || _editLog) {
+        // the binary file is only for the entity server, and the persist file doesn't have the edits in the edit log,
+        // so tools are given the entities in the tree
+        _tree->writeToJSONData(fileContents, NULL, _persistAsFileType != "json");
+        return fileContents;
+    }
+
     QFile file(_filename);
     if (file.open(QIODevice::ReadOnly)) {
         fileContents = file.readAll();
@@ -289,8 +360,28 @@ QByteArray OctreePersistThread::getPersistFileContents() const {
     return fileContents;
 }
 
-void OctreePersistThread::persist() {
-    if (_tree->isDirty() && _initialLoadComplete) {
+void OctreePersistThread::persist(bool checkpointEditLog) {
+    // the edits replayed from the log when the tree was loaded leave it clean, though the persist file lacks them
+    bool hasLoggedEdits = checkpointEditLog && _editLog && _editLog->getSize() > 0;
+
+    if ((_tree->isDirty() || hasLoggedEdits) && _initialLoadComplete) {
+
+        if (_editLog && !checkpointEditLog) {
+            // the edits are already persisted in the edit log, so the tree is only written once replaying the log
+            // would take longer than reading the tree, or when it is backed up - backups are of the persist file alone
+            if (_editLog->getSize() <= std::max(MIN_EDIT_LOG_SIZE_TO_CHECKPOINT, _persistFileSize) && !isBackupDue()) {
+                return;
+            }
+        }
+
+        if (_editLog) {
+            // the edits from here are logged after the ones the persist file will have
+            if (!_editLog->beginCheckpoint()) {
+                return;
+            }
+        }
+
+        _isPersisting = true;
 
         _tree->withWriteLock([&] {
             qCDebug(octree) << "pruning Octree before saving...";
@@ -298,9 +389,11 @@ void OctreePersistThread::persist() {
             qCDebug(octree) << "DONE pruning Octree before saving...";
         });
 
-        qCDebug(octree) << "persist operation calling backup...";
-        backup(); // handle backup if requested        
-        qCDebug(octree) << "persist operation DONE with backup...";
+        if (!_editLog) {
+            qCDebug(octree) << "persist operation calling backup...";
+            backup(); // handle backup if requested        
+            qCDebug(octree) << "persist operation DONE with backup...";
+        }
 
 
         // create our "lock" file to indicate we're saving.
@@ -309,16 +402,33 @@ void OctreePersistThread::persist() {
         if(lockFile.is_open()) {
             qCDebug(octree) << "saving Octree lock file created at:" << lockFileName;
 
-            _tree->writeToFile(qPrintable(_filename), NULL, _persistAsFileType);
+            // the tree is written from a snapshot while it is still edited, so it is clean as of the snapshot
+            _tree->clearDirtyBit();
+            bool persisted = _tree->writeToFile(qPrintable(_filename), NULL, _persistAsFileType);
+            if (!persisted) {
+                _tree->setDirtyBit();
+            }
             time(&_lastPersistTime);
-            _tree->clearDirtyBit(); // tree is clean after saving
             qCDebug(octree) << "DONE saving Octree to file...";
 
+            if (_editLog && persisted) {
+                _persistFileSize = QFileInfo(_filename).size();
+                _editLog->endCheckpoint();
+                qCDebug(octree) << "Checkpointed edit log at" << _editLog->getFileName();
+
+                // the persist file only has the logged edits once it has been written, so it is backed up after
+                qCDebug(octree) << "persist operation calling backup...";
+                backup();
+                qCDebug(octree) << "persist operation DONE with backup...";
+            }
+
             lockFile.close();
             qCDebug(octree) << "saving Octree lock file closed:" << lockFileName;
             remove(qPrintable(lockFileName));
             qCDebug(octree) << "saving Octree lock file removed:" << lockFileName;
         }
+
+        _isPersisting = false;
     }
 }
 
@@ -454,6 +564,22 @@ void OctreePersistThread::rollOldBackupVersions(const BackupRule& rule) {
 }
 
 
+bool OctreePersistThread::isBackupDue() const {
+    if (!_wantBackup) {
+        return false;
+    }
+
+    quint64 now = usecTimestampNow();
+    const quint64 SECS_TO_USECS = 1000 * 1000;
+
+    for (auto& rule : _backupRules) {
+        if (rule.maxBackupVersions > 0 && now - rule.lastBackup > rule.interval * SECS_TO_USECS) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void OctreePersistThread::backup() {
     qCDebug(octree) << "backup operation wantBackup:" << _wantBackup;
     if (_wantBackup) {
@@ -14,6 +14,8 @@
 #ifndef hifi_OctreePersistThread_h
 #define hifi_OctreePersistThread_h
 
+#include <atomic>
+
 #include <QString>
 #include <GenericThread.h>
 #include "Octree.h"
@@ -36,7 +38,8 @@ public:
 
     OctreePersistThread(OctreePointer tree, const QString& filename, const QString& backupDirectory,
                         int persistInterval = DEFAULT_PERSIST_INTERVAL, bool wantBackup = false,
-                        const QJsonObject& settings = QJsonObject(), bool debugTimestampNow = false, QString persistAsFileType="json.gz");
+                        const QJsonObject& settings = QJsonObject(), bool debugTimestampNow = false, QString persistAsFileType="json.gz",
+                        bool wantEditLog = false);
 
     bool isInitialLoadComplete() const { return _initialLoadComplete; }
     quint64 getLoadElapsedTime() const { return _loadTimeUSecs; }
@@ -47,6 +50,12 @@ public:
     QString getPersistFileMimeType() const;
     QByteArray getPersistFileContents() const;
 
+    // true from when the tree is pruned before it is written until it has been written
+    bool isPersisting() const { return _isPersisting; }
+
+    // with an edit log, the persist file is only rewritten once the log has outgrown it
+    OctreeEditLogPointer getEditLog() const { return _editLog; }
+
 signals:
     void loadCompleted();
 
@@ -54,14 +63,16 @@ protected:
     /// Implements generic processing behavior for this thread.
     virtual bool process() override;
 
-    void persist();
+    void persist(bool checkpointEditLog = false); // with an edit log, writes the tree even if the log is small
     void backup();
+    bool isBackupDue() const;
     void rollOldBackupVersions(const BackupRule& rule);
     void restoreFromMostRecentBackup();
     bool getMostRecentBackup(const QString& format, QString& mostRecentBackupFileName, QDateTime& mostRecentBackupTime);
     quint64 getMostRecentBackupTimeInUsecs(const QString& format);
     void parseSettings(const QJsonObject& settings);
     void possiblyReplaceContent();
+    void replayEditLog();
 
 private:
     OctreePointer _tree;
@@ -81,6 +92,11 @@ private:
     quint64 _lastTimeDebug;
 
     QString _persistAsFileType;
+
+    OctreeEditLogPointer _editLog;
+    qint64 _persistFileSize { 0 };
+
+    std::atomic<bool> _isPersisting { false };
 };
 
 #endif // hifi_OctreePersistThread_h
@@ -812,12 +812,26 @@ void Model::setURL(const QUrl& url) {
 
     auto resource = DependencyManager::get<ModelCache>()->getGeometryResource(url);
     if (resource) {
-        resource->setLoadPriority(this, _loadingPriority);
+        if (_loadingPriorityOperator) {
+            resource->setLoadPriorityOperator(this, _loadingPriorityOperator);
+        } else {
+            resource->setLoadPriority(this, _loadingPriority);
+        }
         _renderWatcher.setResource(resource);
     }
     onInvalidate();
 }
 
+void Model::setLoadingPriorityOperator(std::function<float()> priorityOperator) {
+    _loadingPriorityOperator = priorityOperator;
+
+    // the geometry may already be waiting to load
+    auto resource = _renderWatcher.getResource();
+    if (resource) {
+        resource->setLoadPriorityOperator(this, _loadingPriorityOperator);
+    }
+}
+
 void Model::loadURLFinished(bool success) {
     if (!success) {
         _visualGeometryRequestFailed = true;
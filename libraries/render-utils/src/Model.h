@@ -234,6 +234,9 @@ public:
 
     void setLoadingPriority(float priority) { _loadingPriority = priority; }
 
+    // the priority is evaluated again whenever the pending loads are ordered, and is used instead of the loading priority
+    void setLoadingPriorityOperator(std::function<float()> priorityOperator);
+
     size_t getRenderInfoVertexCount() const { return _renderInfoVertexCount; }
     size_t getRenderInfoTextureSize();
     int getRenderInfoTextureCount();
@@ -411,6 +414,7 @@ protected:
 
 private:
     float _loadingPriority { 0.0f };
+    std::function<float()> _loadingPriorityOperator;
 
     void calculateTextureInfo();
 };
@@ -0,0 +1,56 @@
+//
+//  RecordLog.cpp
+//  libraries/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "RecordLog.h"
+
+#include <QtCore/QDataStream>
+
+static const qint64 RECORD_HEADER_SIZE = sizeof(quint32) + sizeof(quint16);
+
+qint64 readLogRecords(const QByteArray& data, const LogRecordHandler& handler, int& numRecords) {
+    qint64 position = 0;
+
+    while (data.size() - position >= RECORD_HEADER_SIZE) {
+        QDataStream headerStream(QByteArray::fromRawData(data.constData() + position, RECORD_HEADER_SIZE));
+
+        quint32 recordSize;
+        quint16 checksum;
+        headerStream >> recordSize >> checksum;
+
+        auto recordStart = data.constData() + position + RECORD_HEADER_SIZE;
+        if (data.size() - position - RECORD_HEADER_SIZE < recordSize || qChecksum(recordStart, recordSize) != checksum) {
+            break;
+        }
+
+        if (handler && !handler(recordStart, (int)recordSize)) {
+            break;
+        }
+
+        position += RECORD_HEADER_SIZE + recordSize;
+        ++numRecords;
+    }
+
+    return position;
+}
+
+bool appendLogRecord(QFile& logFile, const QByteArray& record) {
+    QByteArray header;
+    QDataStream headerStream(&header, QIODevice::WriteOnly);
+    headerStream << (quint32)record.size() << qChecksum(record.constData(), record.size());
+
+    auto logSize = logFile.size();
+    if (logFile.seek(logSize) && logFile.write(header) == header.size() && logFile.write(record) == record.size()
+        && logFile.flush()) {
+        return true;
+    }
+
+    logFile.resize(logSize);
+    return false;
+}
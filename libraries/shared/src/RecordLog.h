@@ -0,0 +1,33 @@
+//
+//  RecordLog.h
+//  libraries/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_RecordLog_h
+#define hifi_RecordLog_h
+
+#include <functional>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+
+// Append-only logs are files of records, each written with its size and checksum ahead of it, so that a record cut
+// short by a crash is found on the next read. Such a record never happened, and is dropped before anything is appended
+// after it, since it would hide the records that follow.
+
+// returns false to stop reading at the record it was given, as if the record wasn't complete
+using LogRecordHandler = std::function<bool(const char* data, int size)>;
+
+// calls the handler with each complete record of the data in turn, if there is one, and returns the size of the records
+// it went through - anything after that isn't a complete record
+qint64 readLogRecords(const QByteArray& data, const LogRecordHandler& handler, int& numRecords);
+
+// appends the record to the end of the log, dropping whatever part of it was written if it can't all be
+bool appendLogRecord(QFile& logFile, const QByteArray& record);
+
+#endif // hifi_RecordLog_h
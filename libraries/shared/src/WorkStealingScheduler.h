@@ -0,0 +1,267 @@
+//
+//  WorkStealingScheduler.h
+//  libraries/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_WorkStealingScheduler_h
+#define hifi_WorkStealingScheduler_h
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+
+#include "PortableHighResolutionClock.h"
+#include "UUIDHasher.h"
+
+// Schedules a batch of tasks over a set of workers, which steal from each other once their own tasks run out
+//   Tasks are dealt to the workers longest first, using the cost of their key in the previous batch as an estimate.
+//   add, schedule, finish, and takeStats must be called from a single thread, while no worker is running;
+//   between schedule and finish, each worker may call run concurrently with the others.
+template <typename Task>
+class WorkStealingScheduler {
+public:
+    using Clock = p_high_resolution_clock;
+
+    // adds a task to the next batch; key identifies the task across batches, to estimate its cost
+    void add(const Task& task, const QUuid& key);
+
+    // partitions the batch between numWorkers workers
+    void schedule(int numWorkers);
+
+    // calls functor(task) on tasks of the batch until none are left, starting with those of worker
+    void run(int worker, const std::function<void(const Task&)>& functor);
+
+    // records the costs of the batch, and clears it
+    void finish();
+
+    // returns the utilization, tasks run, and tasks stolen of each worker since the last call, and resets them
+    QJsonObject takeStats();
+
+private:
+    using Nanoseconds = std::chrono::nanoseconds;
+
+    struct Worker {
+        // the [front, back) range of the worker's tasks in _order, packed as (back << 32 | front)
+        //   the worker pops from the front and thieves steal from the back, both by compare-and-swap
+        std::atomic<uint64_t> range { 0 };
+
+        // written by the worker, read between batches
+        Nanoseconds busyTime { 0 };
+        int numTasks { 0 };
+        int numSteals { 0 };
+    };
+
+    static uint64_t pack(uint32_t front, uint32_t back) { return ((uint64_t)back << 32) | front; }
+    static uint32_t front(uint64_t range) { return (uint32_t)range; }
+    static uint32_t back(uint64_t range) { return (uint32_t)(range >> 32); }
+
+    bool pop(Worker& worker, uint32_t& index);
+    bool steal(int thief, uint32_t& index);
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+    int _numWorkers { 0 };
+
+    // batch state
+    std::vector<Task> _tasks;
+    std::vector<QUuid> _keys;
+    std::vector<Nanoseconds> _taskCosts; // each written by the worker that ran the task
+    std::vector<uint32_t> _order; // task indices, grouped by worker
+    Clock::time_point _batchStart;
+
+    std::unordered_map<QUuid, Nanoseconds> _costs; // of the previous batch
+    Nanoseconds _wallTime { 0 }; // spent in batches since the last takeStats
+};
+
+template <typename Task>
+void WorkStealingScheduler<Task>::add(const Task& task, const QUuid& key) {
+    _tasks.push_back(task);
+    _keys.push_back(key);
+}
+
+template <typename Task>
+void WorkStealingScheduler<Task>::schedule(int numWorkers) {
+    _numWorkers = std::max(numWorkers, 1);
+    while ((int)_workers.size() < _numWorkers) {
+        _workers.emplace_back(new Worker());
+    }
+
+    const uint32_t numTasks = (uint32_t)_tasks.size();
+    _taskCosts.assign(numTasks, Nanoseconds(0));
+
+    // estimate the cost of each task, defaulting to the average cost of the last batch
+    Nanoseconds defaultCost(1);
+    if (!_costs.empty()) {
+        Nanoseconds totalCost(0);
+        for (auto& cost : _costs) {
+            totalCost += cost.second;
+        }
+        defaultCost = std::max(totalCost / (int64_t)_costs.size(), defaultCost);
+    }
+
+    std::vector<Nanoseconds> estimates(numTasks);
+    std::vector<uint32_t> sorted(numTasks);
+    for (uint32_t i = 0; i < numTasks; ++i) {
+        auto cost = _costs.find(_keys[i]);
+        estimates[i] = (cost != _costs.end()) ? cost->second : defaultCost;
+        sorted[i] = i;
+    }
+    std::sort(sorted.begin(), sorted.end(), [&](uint32_t a, uint32_t b) { return estimates[a] > estimates[b]; });
+
+    // deal the longest remaining task to the least loaded worker
+    using Load = std::pair<Nanoseconds, int>;
+    std::priority_queue<Load, std::vector<Load>, std::greater<Load>> loads;
+    for (int i = 0; i < _numWorkers; ++i) {
+        loads.push({ Nanoseconds(0), i });
+    }
+
+    std::vector<int> assignments(numTasks);
+    std::vector<uint32_t> counts(_numWorkers, 0);
+    for (uint32_t index : sorted) {
+        Load load = loads.top();
+        loads.pop();
+
+        assignments[index] = load.second;
+        ++counts[load.second];
+
+        load.first += estimates[index];
+        loads.push(load);
+    }
+
+    // lay out the tasks of each worker contiguously, longest first
+    std::vector<uint32_t> offsets(_numWorkers, 0);
+    for (int i = 1; i < _numWorkers; ++i) {
+        offsets[i] = offsets[i - 1] + counts[i - 1];
+    }
+    for (int i = 0; i < _numWorkers; ++i) {
+        _workers[i]->range.store(pack(offsets[i], offsets[i] + counts[i]), std::memory_order_relaxed);
+    }
+    for (int i = _numWorkers; i < (int)_workers.size(); ++i) {
+        _workers[i]->range.store(0, std::memory_order_relaxed);
+    }
+
+    _order.resize(numTasks);
+    for (uint32_t index : sorted) {
+        _order[offsets[assignments[index]]++] = index;
+    }
+
+    _batchStart = Clock::now();
+}
+
+template <typename Task>
+void WorkStealingScheduler<Task>::run(int worker, const std::function<void(const Task&)>& functor) {
+    if (worker >= (int)_workers.size()) {
+        return;
+    }
+    Worker& self = *_workers[worker];
+
+    uint32_t index;
+    while (pop(self, index) || steal(worker, index)) {
+        auto start = Clock::now();
+        functor(_tasks[index]);
+        auto cost = std::chrono::duration_cast<Nanoseconds>(Clock::now() - start);
+
+        _taskCosts[index] = cost;
+        self.busyTime += cost;
+        ++self.numTasks;
+    }
+}
+
+template <typename Task>
+void WorkStealingScheduler<Task>::finish() {
+    _wallTime += std::chrono::duration_cast<Nanoseconds>(Clock::now() - _batchStart);
+
+    // only remember the keys of this batch, so that departed keys do not accumulate
+    _costs.clear();
+    for (size_t i = 0; i < _tasks.size(); ++i) {
+        _costs[_keys[i]] = _taskCosts[i];
+    }
+
+    _tasks.clear();
+    _keys.clear();
+    _taskCosts.clear();
+    _order.clear();
+}
+
+template <typename Task>
+QJsonObject WorkStealingScheduler<Task>::takeStats() {
+    QJsonObject stats;
+
+    for (int i = 0; i < (int)_workers.size(); ++i) {
+        Worker& worker = *_workers[i];
+
+        QJsonObject workerStats;
+        workerStats["utilization"] = (_wallTime.count() > 0) ?
+            (double)worker.busyTime.count() / (double)_wallTime.count() : 0.0;
+        workerStats["tasks"] = worker.numTasks;
+        workerStats["steals"] = worker.numSteals;
+        stats[QString::number(i + 1)] = workerStats;
+
+        worker.busyTime = Nanoseconds(0);
+        worker.numTasks = 0;
+        worker.numSteals = 0;
+    }
+    _wallTime = Nanoseconds(0);
+
+    return stats;
+}
+
+template <typename Task>
+bool WorkStealingScheduler<Task>::pop(Worker& worker, uint32_t& index) {
+    uint64_t range = worker.range.load(std::memory_order_acquire);
+    while (front(range) < back(range)) {
+        if (worker.range.compare_exchange_weak(range, pack(front(range) + 1, back(range)), std::memory_order_acq_rel)) {
+            index = _order[front(range)];
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename Task>
+bool WorkStealingScheduler<Task>::steal(int thief, uint32_t& index) {
+    while (true) {
+        // steal from the worker with the most tasks left
+        Worker* victim = nullptr;
+        uint64_t victimRange = 0;
+        uint32_t mostLeft = 0;
+        for (int i = 0; i < _numWorkers; ++i) {
+            if (i == thief) {
+                continue;
+            }
+            uint64_t range = _workers[i]->range.load(std::memory_order_acquire);
+            uint32_t left = back(range) - front(range);
+            if (front(range) < back(range) && left > mostLeft) {
+                victim = _workers[i].get();
+                victimRange = range;
+                mostLeft = left;
+            }
+        }
+
+        if (!victim) {
+            return false;
+        }
+
+        uint32_t stolen = back(victimRange) - 1;
+        if (victim->range.compare_exchange_strong(victimRange, pack(front(victimRange), stolen), std::memory_order_acq_rel)) {
+            index = _order[stolen];
+            ++_workers[thief]->numSteals;
+            return true;
+        }
+    }
+}
+
+#endif // hifi_WorkStealingScheduler_h
@@ -0,0 +1,185 @@
+//
+//  AudioHRTFTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioHRTFTests.h"
+
+#include <math.h>
+#include <memory>
+
+#include <AudioHRTF.h>
+
+QTEST_MAIN(AudioHRTFTests)
+
+// an odd number, to exercise both the paired and the remaining source
+static const int NUM_SOURCES = 33;
+static const int NUM_BLOCKS = 20;
+static const int NUM_BENCHMARK_BLOCKS = 1000;
+static const int HRTF_DATASET_INDEX = 1;
+
+struct Sources {
+    AudioHRTF hrtfs[NUM_SOURCES];
+    int16_t input[NUM_SOURCES][HRTF_BLOCK];
+    float azimuths[NUM_SOURCES];
+    float distances[NUM_SOURCES];
+    float gains[NUM_SOURCES];
+
+    AudioHRTF* hrtfPointers[NUM_SOURCES];
+    int16_t* inputPointers[NUM_SOURCES];
+
+    Sources() {
+        for (int i = 0; i < NUM_SOURCES; i++) {
+            hrtfPointers[i] = &hrtfs[i];
+            inputPointers[i] = input[i];
+        }
+    }
+
+    void randomize() {
+        for (int i = 0; i < NUM_SOURCES; i++) {
+            for (int j = 0; j < HRTF_BLOCK; j++) {
+                input[i][j] = (int16_t)(qrand() % 20000 - 10000);
+            }
+            azimuths[i] = (qrand() % 628) / 100.0f;
+            distances[i] = 1.0f + (qrand() % 100);
+            gains[i] = 0.5f;
+        }
+    }
+};
+
+void AudioHRTFTests::testBatchedRender() {
+    // the hrtfs keep state across blocks, so render each set separately
+    auto single = std::unique_ptr<Sources>(new Sources());
+    auto batched = std::unique_ptr<Sources>(new Sources());
+
+    float singleOutput[2 * HRTF_BLOCK];
+    float batchedOutput[2 * HRTF_BLOCK];
+
+    for (int block = 0; block < NUM_BLOCKS; block++) {
+        single->randomize();
+        memcpy(batched->input, single->input, sizeof(single->input));
+        memcpy(batched->azimuths, single->azimuths, sizeof(single->azimuths));
+        memcpy(batched->distances, single->distances, sizeof(single->distances));
+        memcpy(batched->gains, single->gains, sizeof(single->gains));
+
+        memset(singleOutput, 0, sizeof(singleOutput));
+        memset(batchedOutput, 0, sizeof(batchedOutput));
+
+        for (int i = 0; i < NUM_SOURCES; i++) {
+            single->hrtfs[i].render(single->input[i], singleOutput, HRTF_DATASET_INDEX,
+                                    single->azimuths[i], single->distances[i], single->gains[i], HRTF_BLOCK);
+        }
+
+        AudioHRTF::render(batched->hrtfPointers, batched->inputPointers, batchedOutput, HRTF_DATASET_INDEX,
+                          batched->azimuths, batched->distances, batched->gains, NUM_SOURCES, HRTF_BLOCK);
+
+        // the sum is reordered, so allow for rounding
+        const float EPSILON = 1.0e-5f;
+        for (int i = 0; i < 2 * HRTF_BLOCK; i++) {
+            QVERIFY(fabsf(singleOutput[i] - batchedOutput[i]) < EPSILON);
+        }
+    }
+}
+
+void AudioHRTFTests::testSIMDPaths() {
+    const AudioHRTF::SIMDPath paths[] = { AudioHRTF::SIMD_SCALAR, AudioHRTF::SIMD_SSE, AudioHRTF::SIMD_AVX2 };
+    const int NUM_PATHS = 3;
+    const AudioHRTF::SIMDPath bestPath = AudioHRTF::getSIMDPath();
+
+    // render the same blocks on each path, with its own hrtfs since they keep state across blocks
+    std::unique_ptr<Sources> sources[NUM_PATHS];
+    float outputs[NUM_PATHS][2 * HRTF_BLOCK];
+    bool isSupported[NUM_PATHS];
+
+    for (int path = 0; path < NUM_PATHS; path++) {
+        sources[path] = std::unique_ptr<Sources>(new Sources());
+        isSupported[path] = AudioHRTF::setSIMDPath(paths[path]);
+    }
+    QVERIFY(isSupported[0]);
+
+    for (int block = 0; block < NUM_BLOCKS; block++) {
+        sources[0]->randomize();
+
+        for (int path = 0; path < NUM_PATHS; path++) {
+            if (!isSupported[path]) {
+                continue;
+            }
+            AudioHRTF::setSIMDPath(paths[path]);
+
+            Sources& pathSources = *sources[path];
+            if (path > 0) {
+                memcpy(pathSources.input, sources[0]->input, sizeof(pathSources.input));
+                memcpy(pathSources.azimuths, sources[0]->azimuths, sizeof(pathSources.azimuths));
+                memcpy(pathSources.distances, sources[0]->distances, sizeof(pathSources.distances));
+                memcpy(pathSources.gains, sources[0]->gains, sizeof(pathSources.gains));
+            }
+
+            memset(outputs[path], 0, sizeof(outputs[path]));
+            AudioHRTF::render(pathSources.hrtfPointers, pathSources.inputPointers, outputs[path], HRTF_DATASET_INDEX,
+                              pathSources.azimuths, pathSources.distances, pathSources.gains, NUM_SOURCES, HRTF_BLOCK);
+        }
+
+        // the SIMD paths round differently, so allow for that against the scalar reference
+        const float EPSILON = 1.0e-5f;
+        for (int path = 1; path < NUM_PATHS; path++) {
+            if (!isSupported[path]) {
+                continue;
+            }
+            for (int i = 0; i < 2 * HRTF_BLOCK; i++) {
+                QVERIFY(fabsf(outputs[0][i] - outputs[path][i]) < EPSILON);
+            }
+        }
+    }
+
+    AudioHRTF::setSIMDPath(bestPath);
+}
+
+void AudioHRTFTests::benchmarkRender() {
+    auto sources = std::unique_ptr<Sources>(new Sources());
+    sources->randomize();
+
+    float output[2 * HRTF_BLOCK] = {};
+
+    const double numRenders = (double)NUM_SOURCES * NUM_BENCHMARK_BLOCKS;
+
+    // the scalar baseline next to the SIMD paths the CPU supports
+    const AudioHRTF::SIMDPath paths[] = { AudioHRTF::SIMD_SCALAR, AudioHRTF::SIMD_SSE, AudioHRTF::SIMD_AVX2 };
+    const char* pathNames[] = { "scalar", "SSE", "AVX2" };
+    const AudioHRTF::SIMDPath bestPath = AudioHRTF::getSIMDPath();
+
+    for (int path = 0; path < 3; path++) {
+        if (!AudioHRTF::setSIMDPath(paths[path])) {
+            qDebug() << pathNames[path] << "not supported";
+            continue;
+        }
+
+        {
+            QElapsedTimer timer;
+            timer.start();
+            for (int block = 0; block < NUM_BENCHMARK_BLOCKS; block++) {
+                for (int i = 0; i < NUM_SOURCES; i++) {
+                    sources->hrtfs[i].render(sources->input[i], output, HRTF_DATASET_INDEX, sources->azimuths[i],
+                                             sources->distances[i], sources->gains[i], HRTF_BLOCK);
+                }
+            }
+            qDebug() << pathNames[path] << "single:" << numRenders / (timer.nsecsElapsed() / 1.0e6) << "sources/ms";
+        }
+
+        {
+            QElapsedTimer timer;
+            timer.start();
+            for (int block = 0; block < NUM_BENCHMARK_BLOCKS; block++) {
+                AudioHRTF::render(sources->hrtfPointers, sources->inputPointers, output, HRTF_DATASET_INDEX,
+                                  sources->azimuths, sources->distances, sources->gains, NUM_SOURCES, HRTF_BLOCK);
+            }
+            qDebug() << pathNames[path] << "batched:" << numRenders / (timer.nsecsElapsed() / 1.0e6) << "sources/ms";
+        }
+    }
+
+    AudioHRTF::setSIMDPath(bestPath);
+}
@@ -0,0 +1,106 @@
+//
+//  AssetChunkTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetChunkTests.h"
+
+#include <random>
+
+#include <QtCore/QSet>
+
+#include <AssetUtils.h>
+
+QTEST_MAIN(AssetChunkTests)
+
+static QByteArray randomData(int size, unsigned int seed) {
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> distribution(0, 255);
+
+    QByteArray data(size, '\0');
+    for (int i = 0; i < size; ++i) {
+        data[i] = (char)distribution(generator);
+    }
+    return data;
+}
+
+void AssetChunkTests::boundsTest() {
+    const int DATA_SIZE = 16 * 1024 * 1024;
+    auto data = randomData(DATA_SIZE, 1);
+    auto chunks = chunkAssetData(data);
+
+    qint64 offset = 0;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        QCOMPARE(chunks[i].offset, offset);
+        QVERIFY(chunks[i].size <= MAX_ASSET_CHUNK_SIZE);
+
+        // only the last chunk can be cut short by the end of the data
+        if (i + 1 < chunks.size()) {
+            QVERIFY(chunks[i].size >= MIN_ASSET_CHUNK_SIZE);
+        }
+
+        QCOMPARE(chunks[i].hash, hashData(data.mid(chunks[i].offset, chunks[i].size)));
+        offset += chunks[i].size;
+    }
+    QCOMPARE(offset, (qint64)DATA_SIZE);
+
+    // random data should be cut near the average size, rather than at the limits
+    auto averageSize = DATA_SIZE / (qint64)chunks.size();
+    QVERIFY(averageSize > AVERAGE_ASSET_CHUNK_SIZE / 2);
+    QVERIFY(averageSize < AVERAGE_ASSET_CHUNK_SIZE * 2);
+}
+
+void AssetChunkTests::determinismTest() {
+    auto data = randomData(4 * 1024 * 1024, 2);
+    auto chunks = chunkAssetData(data);
+    auto chunksAgain = chunkAssetData(QByteArray(data.constData(), data.size()));
+
+    QCOMPARE(chunks.size(), chunksAgain.size());
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        QCOMPARE(chunks[i].offset, chunksAgain[i].offset);
+        QCOMPARE(chunks[i].size, chunksAgain[i].size);
+        QCOMPARE(chunks[i].hash, chunksAgain[i].hash);
+    }
+}
+
+void AssetChunkTests::insertionTest() {
+    auto data = randomData(8 * 1024 * 1024, 3);
+    auto editedData = data;
+    editedData.insert(data.size() / 2, randomData(1000, 4));
+
+    auto chunks = chunkAssetData(data);
+    auto editedChunks = chunkAssetData(editedData);
+
+    QSet<QByteArray> chunkHashes;
+    for (auto& chunk : chunks) {
+        chunkHashes.insert(chunk.hash);
+    }
+
+    int numSharedChunks = 0;
+    for (auto& chunk : editedChunks) {
+        if (chunkHashes.contains(chunk.hash)) {
+            ++numSharedChunks;
+        }
+    }
+
+    // the cut points resynchronize shortly after the insertion, so at most a few chunks around it differ
+    const int MAX_CHANGED_CHUNKS = 3;
+    QVERIFY(numSharedChunks >= (int)editedChunks.size() - MAX_CHANGED_CHUNKS);
+}
+
+void AssetChunkTests::smallDataTest() {
+    auto emptyChunks = chunkAssetData(QByteArray());
+    QCOMPARE((int)emptyChunks.size(), 1);
+    QCOMPARE(emptyChunks[0].size, (qint64)0);
+    QCOMPARE(emptyChunks[0].hash, hashData(QByteArray()));
+
+    auto data = randomData(MIN_ASSET_CHUNK_SIZE, 5);
+    auto chunks = chunkAssetData(data);
+    QCOMPARE((int)chunks.size(), 1);
+    QCOMPARE(chunks[0].size, (qint64)data.size());
+}
@@ -0,0 +1,34 @@
+//
+//  AssetChunkTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetChunkTests_h
+#define hifi_AssetChunkTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class AssetChunkTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that chunks cover the data in order, within the chunk size limits
+    void boundsTest();
+
+    // Test that the same data is always cut the same way
+    void determinismTest();
+
+    // Test that inserting into the data only changes the chunks around the insertion
+    void insertionTest();
+
+    // Test that empty and small data are a single chunk
+    void smallDataTest();
+};
+
+#endif // hifi_AssetChunkTests_h
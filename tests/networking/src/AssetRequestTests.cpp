@@ -0,0 +1,133 @@
+//
+//  AssetRequestTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetRequestTests.h"
+
+#include <AssetRequest.h>
+#include <NumericalConstants.h>
+
+QTEST_MAIN(AssetRequestTests)
+
+static const qint64 CHUNK_SIZE = AssetRequest::CHUNK_SIZE;
+
+static void verifyChunkRanges(qint64 assetSize, int expectedNumChunks) {
+    auto ranges = AssetRequest::layoutChunkRanges(assetSize);
+    QCOMPARE((int)ranges.size(), expectedNumChunks);
+
+    // the first chunk ends the asset, and each one after it ends where the one before it starts
+    qint64 end = assetSize;
+    for (auto& range : ranges) {
+        QCOMPARE(range.toExclusive, end);
+        QVERIFY(range.fromInclusive >= 0);
+        QVERIFY(range.size() <= CHUNK_SIZE);
+        end = range.fromInclusive;
+    }
+    QCOMPARE(end, (qint64)0);
+
+    // every chunk but the one at the start of the asset is a whole chunk
+    for (size_t i = 0; i + 1 < ranges.size(); ++i) {
+        QCOMPARE(ranges[i].size(), CHUNK_SIZE);
+    }
+}
+
+void AssetRequestTests::layoutChunksTest() {
+    verifyChunkRanges(0, 1);
+    QCOMPARE(AssetRequest::layoutChunkRanges(0).front().size(), (qint64)0);
+
+    verifyChunkRanges(1, 1);
+    verifyChunkRanges(CHUNK_SIZE / 2, 1);
+    verifyChunkRanges(CHUNK_SIZE, 1);
+    verifyChunkRanges(CHUNK_SIZE + 1, 2);
+    verifyChunkRanges(4 * CHUNK_SIZE, 4);
+
+    const qint64 REMAINDER = 1234;
+    verifyChunkRanges(4 * CHUNK_SIZE + REMAINDER, 5);
+    QCOMPARE(AssetRequest::layoutChunkRanges(4 * CHUNK_SIZE + REMAINDER).back().size(), REMAINDER);
+}
+
+static AssetRequest::ChunkData makeChunks(qint64 assetSize, const std::vector<int>& chunkIndices) {
+    auto ranges = AssetRequest::layoutChunkRanges(assetSize);
+
+    AssetRequest::ChunkData chunks;
+    for (int chunkIndex : chunkIndices) {
+        auto& range = ranges[chunkIndex];
+        chunks[range.fromInclusive] = QByteArray((int)range.size(), (char)('a' + chunkIndex));
+    }
+    return chunks;
+}
+
+void AssetRequestTests::partialDownloadTest() {
+    const qint64 ASSET_SIZE = 3 * CHUNK_SIZE + 100;
+    auto chunks = makeChunks(ASSET_SIZE, { 0, 2, 3 });
+
+    auto partialDownload = AssetRequest::writePartialDownload(ASSET_SIZE, chunks);
+
+    AssetRequest::ChunkData readChunks;
+    QVERIFY(AssetRequest::readPartialDownload(partialDownload, ASSET_SIZE, readChunks));
+    QVERIFY(readChunks == chunks);
+
+    // a partial download without any complete chunk reads back as one
+    readChunks.clear();
+    QVERIFY(AssetRequest::readPartialDownload(AssetRequest::writePartialDownload(ASSET_SIZE, {}), ASSET_SIZE,
+                                              readChunks));
+    QVERIFY(readChunks.empty());
+}
+
+void AssetRequestTests::corruptPartialDownloadTest() {
+    const qint64 ASSET_SIZE = 3 * CHUNK_SIZE + 100;
+    auto chunks = makeChunks(ASSET_SIZE, { 0, 1, 3 });
+    auto partialDownload = AssetRequest::writePartialDownload(ASSET_SIZE, chunks);
+
+    // a partial download of an asset of another size isn't read at all
+    AssetRequest::ChunkData readChunks;
+    QVERIFY(!AssetRequest::readPartialDownload(partialDownload, ASSET_SIZE + 1, readChunks));
+    QVERIFY(readChunks.empty());
+
+    // and neither is one that is too short to say what it is of
+    QVERIFY(!AssetRequest::readPartialDownload(partialDownload.left(4), ASSET_SIZE, readChunks));
+    QVERIFY(!AssetRequest::readPartialDownload(QByteArray(), ASSET_SIZE, readChunks));
+    QVERIFY(readChunks.empty());
+
+    // one cut short keeps the chunks written before the cut, and drops the one it went through
+    QVERIFY(AssetRequest::readPartialDownload(partialDownload.left(partialDownload.size() - 10), ASSET_SIZE,
+                                              readChunks));
+    QCOMPARE((int)readChunks.size(), 2);
+    auto lastChunk = *chunks.rbegin();
+    QVERIFY(readChunks.find(lastChunk.first) == readChunks.end());
+    for (auto& chunk : readChunks) {
+        QCOMPARE(chunk.second, chunks[chunk.first]);
+    }
+
+    // a chunk that goes past the end of the asset is dropped
+    AssetRequest::ChunkData outOfRangeChunks;
+    outOfRangeChunks[ASSET_SIZE - 10] = QByteArray(20, 'x');
+    readChunks.clear();
+    QVERIFY(AssetRequest::readPartialDownload(AssetRequest::writePartialDownload(ASSET_SIZE, outOfRangeChunks),
+                                              ASSET_SIZE, readChunks));
+    QVERIFY(readChunks.empty());
+}
+
+void AssetRequestTests::concurrentChunksTest() {
+    // with nothing known of the link, the fewest chunks are kept in flight
+    QCOMPARE(AssetRequest::computeConcurrentChunks(0.0, 0), AssetRequest::MIN_CONCURRENT_CHUNKS);
+    QCOMPARE(AssetRequest::computeConcurrentChunks(CHUNK_SIZE, 0), AssetRequest::MIN_CONCURRENT_CHUNKS);
+
+    // four chunks in flight over a round trip, plus the next one
+    QCOMPARE(AssetRequest::computeConcurrentChunks(4.0 * CHUNK_SIZE, USECS_PER_SECOND), 5);
+
+    // a part of a chunk in flight is a whole chunk
+    QCOMPARE(AssetRequest::computeConcurrentChunks(3.5 * CHUNK_SIZE, USECS_PER_SECOND), 5);
+
+    // and no more than the most chunks, however fast or far the asset server is
+    QCOMPARE(AssetRequest::computeConcurrentChunks(1000.0 * CHUNK_SIZE, USECS_PER_SECOND),
+             AssetRequest::MAX_CONCURRENT_CHUNKS);
+    QCOMPARE(AssetRequest::computeConcurrentChunks(4.0 * CHUNK_SIZE, 60 * USECS_PER_SECOND),
+             AssetRequest::MAX_CONCURRENT_CHUNKS);
+}
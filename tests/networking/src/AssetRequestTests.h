@@ -0,0 +1,34 @@
+//
+//  AssetRequestTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetRequestTests_h
+#define hifi_AssetRequestTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class AssetRequestTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that chunks cover the asset back from its end, with the short chunk at its start
+    void layoutChunksTest();
+
+    // Test that a partial download reads back the chunks it was written with
+    void partialDownloadTest();
+
+    // Test that a partial download that doesn't match the asset, or is cut short, is read only as far as it is intact
+    void corruptPartialDownloadTest();
+
+    // Test that the chunks kept in flight follow the bandwidth-delay product, within their limits
+    void concurrentChunksTest();
+};
+
+#endif // hifi_AssetRequestTests_h
@@ -0,0 +1,92 @@
+//
+//  BBRCCTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BBRCCTests.h"
+
+#include <map>
+
+#include <udt/BBRCC.h>
+
+QTEST_MAIN(BBRCCTests)
+
+using namespace udt;
+using namespace std::chrono;
+
+using TimePoint = p_high_resolution_clock::time_point;
+
+void BBRCCTests::bottleneckTest_data() {
+    QTest::addColumn<int>("packetsPerSecond");
+    QTest::addColumn<int>("rttMsecs");
+
+    QTest::newRow("LAN") << 20000 << 2;
+    QTest::newRow("Long-haul") << 2000 << 150;
+}
+
+void BBRCCTests::bottleneckTest() {
+    QFETCH(int, packetsPerSecond);
+    QFETCH(int, rttMsecs);
+
+    // a lossless link with a bottleneck of packetsPerSecond, and a deep queue in front of it
+    const microseconds transmissionTime { 1000000 / packetsPerSecond };
+    const microseconds rtt { rttMsecs * 1000 };
+
+    BBRCC congestionControl;
+
+    std::multimap<TimePoint, SequenceNumber> acks;
+    SequenceNumber nextSequenceNumber { 0 };
+    SequenceNumber lastACK = nextSequenceNumber - 1;
+
+    auto now = p_high_resolution_clock::now();
+    auto end = now + seconds(20);
+    auto nextSendTime = now;
+    auto bottleneckFreeTime = now;
+    microseconds totalQueueing { 0 };
+    int numQueueingSamples = 0;
+
+    while (now < end) {
+        bool canSend = seqlen(lastACK, nextSequenceNumber) <= congestionControl.getCongestionWindowSize();
+
+        if (canSend && (acks.empty() || nextSendTime <= acks.begin()->first)) {
+            // send the next packet, paced by the congestion control
+            now = std::max(now, nextSendTime);
+            congestionControl.onPacketSent(udt::MAX_PACKET_SIZE, nextSequenceNumber, now);
+
+            bottleneckFreeTime = std::max(bottleneckFreeTime, now) + transmissionTime;
+            acks.emplace(bottleneckFreeTime + rtt, nextSequenceNumber);
+
+            if (now > end - seconds(5)) {
+                totalQueueing += duration_cast<microseconds>(bottleneckFreeTime - now - transmissionTime);
+                ++numQueueingSamples;
+            }
+
+            ++nextSequenceNumber;
+            nextSendTime = now + microseconds((qint64)congestionControl.getPacketSendPeriod());
+        } else if (!acks.empty()) {
+            now = acks.begin()->first;
+            lastACK = acks.begin()->second;
+            acks.erase(acks.begin());
+
+            QVERIFY(!congestionControl.onACK(lastACK, now));
+        } else {
+            QFAIL("nothing in flight, and the congestion window is full");
+        }
+    }
+
+    QCOMPARE(congestionControl.getMode(), BBRCC::Mode::ProbeBandwidth);
+
+    // the bandwidth and RTT estimates match the link
+    QVERIFY(qAbs(congestionControl.getBottleneckBandwidth() - packetsPerSecond) < packetsPerSecond * 0.05);
+    QVERIFY(congestionControl.getMinRTT() >= rtt.count());
+    QVERIFY(congestionControl.getMinRTT() < rtt.count() + 4 * transmissionTime.count());
+
+    // and however deep the queue at the bottleneck is, at most twice the bandwidth-delay product is in flight,
+    // so the queueing delay stays under the RTT - no bufferbloat
+    QVERIFY(totalQueueing.count() / numQueueingSamples < rtt.count());
+}
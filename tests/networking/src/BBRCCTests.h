@@ -0,0 +1,26 @@
+//
+//  BBRCCTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BBRCCTests_h
+#define hifi_BBRCCTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class BBRCCTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that the controller finds the bandwidth and RTT of a bottleneck link, and paces at that bandwidth
+    void bottleneckTest();
+    void bottleneckTest_data();
+};
+
+#endif // hifi_BBRCCTests_h
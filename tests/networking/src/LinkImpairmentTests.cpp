@@ -0,0 +1,292 @@
+//
+//  LinkImpairmentTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LinkImpairmentTests.h"
+
+#include <mutex>
+
+#include <udt/LinkImpairment.h>
+
+QTEST_MAIN(LinkImpairmentTests)
+
+using namespace udt;
+using namespace std::chrono;
+using TimePoint = p_high_resolution_clock::time_point;
+
+static const quint32 SEED = 742272;
+static const int DATAGRAM_SIZE = 972; // 1000 bytes on the wire, with the UDP and IP headers
+static const int DRAIN_TIMEOUT_MSECS = 2000;
+
+static const HifiSockAddr FIRST_DESTINATION { QHostAddress::LocalHost, 4000 };
+static const HifiSockAddr SECOND_DESTINATION { QHostAddress::LocalHost, 4001 };
+
+// records the index each datagram carries, and when it was written
+class Capture {
+public:
+    struct Arrival {
+        int index;
+        HifiSockAddr sockAddr;
+        TimePoint time;
+    };
+
+    LinkImpairment::WriteFunction writeFunction() {
+        return [this](const QByteArray& datagram, const HifiSockAddr& sockAddr) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _arrivals.push_back({ *reinterpret_cast<const int*>(datagram.constData()), sockAddr,
+                                  p_high_resolution_clock::now() });
+            return (qint64)datagram.size();
+        };
+    }
+
+    std::vector<Arrival> arrivals() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _arrivals;
+    }
+
+    std::vector<int> indices() {
+        std::vector<int> indices;
+        for (auto& arrival : arrivals()) {
+            indices.push_back(arrival.index);
+        }
+        return indices;
+    }
+
+private:
+    std::mutex _mutex;
+    std::vector<Arrival> _arrivals;
+};
+
+static QByteArray makeDatagram(int index) {
+    QByteArray datagram(DATAGRAM_SIZE, 0);
+    memcpy(datagram.data(), &index, sizeof(index));
+    return datagram;
+}
+
+static LinkImpairment::Profile makeProfile(const QString& string) {
+    LinkImpairment::Profile profile;
+    bool isValid = LinkImpairment::Profile::fromString(string, profile);
+    Q_ASSERT(isValid);
+    Q_UNUSED(isValid);
+    return profile;
+}
+
+void LinkImpairmentTests::profileStringTest() {
+    LinkImpairment::Profile profile;
+    QVERIFY(LinkImpairment::Profile::fromString("loss=1,burst=0.5:20,reorder=2:15,latency=50,jitter=10,"
+                                                "bandwidth=20,queue=100", profile));
+    QCOMPARE(profile.lossRate, 0.01);
+    QCOMPARE(profile.burstStartRate, 0.005);
+    QCOMPARE(profile.burstEndRate, 0.05);
+    QCOMPARE(profile.reorderRate, 0.02);
+    QCOMPARE(profile.reorderMsecs, 15);
+    QCOMPARE(profile.latencyMsecs, 50);
+    QCOMPARE(profile.jitterMsecs, 10);
+    QCOMPARE(profile.bandwidthMbps, 20.0);
+    QCOMPARE(profile.queuePackets, 100);
+
+    LinkImpairment::Profile roundTrip;
+    QVERIFY(LinkImpairment::Profile::fromString(profile.toString(), roundTrip));
+    QCOMPARE(roundTrip.toString(), profile.toString());
+
+    // a failed parse leaves the profile alone
+    QVERIFY(!LinkImpairment::Profile::fromString("loss=1,speed=5", profile));
+    QVERIFY(!LinkImpairment::Profile::fromString("latency=fast", profile));
+    QVERIFY(!LinkImpairment::Profile::fromString("burst=1", profile));
+    QVERIFY(!LinkImpairment::Profile::fromString("burst=1:0.5", profile));
+    QCOMPARE(profile.latencyMsecs, 50);
+}
+
+void LinkImpairmentTests::lossTest() {
+    static const int NUM_DATAGRAMS = 10000;
+
+    Capture capture;
+    LinkImpairment impairment(capture.writeFunction());
+    impairment.seed(SEED);
+    impairment.setProfile(FIRST_DESTINATION, makeProfile("loss=10"));
+
+    for (int i = 0; i < NUM_DATAGRAMS; ++i) {
+        QCOMPARE(impairment.write(makeDatagram(i), FIRST_DESTINATION), (qint64)DATAGRAM_SIZE);
+    }
+
+    // without delays every datagram that isn't lost is written right away
+    auto stats = impairment.takeStats(FIRST_DESTINATION);
+    QCOMPARE((int)capture.arrivals().size(), stats.written);
+    QCOMPARE(stats.written + stats.lost, NUM_DATAGRAMS);
+    QVERIFY(qAbs(stats.lost - NUM_DATAGRAMS / 10) < NUM_DATAGRAMS / 100 * 3);
+
+    // the stats are reset once taken
+    QCOMPARE(impairment.takeStats(FIRST_DESTINATION).lost, 0);
+}
+
+void LinkImpairmentTests::burstTest() {
+    static const int NUM_DATAGRAMS = 100000;
+    static const double MEAN_BURST_LENGTH = 10.0;
+
+    Capture capture;
+    LinkImpairment impairment(capture.writeFunction());
+    impairment.seed(SEED);
+    impairment.setProfile(FIRST_DESTINATION, makeProfile("burst=0.5:10"));
+
+    for (int i = 0; i < NUM_DATAGRAMS; ++i) {
+        impairment.write(makeDatagram(i), FIRST_DESTINATION);
+    }
+
+    auto stats = impairment.takeStats(FIRST_DESTINATION);
+    QCOMPARE(stats.lost, 0);
+    QVERIFY(stats.burstLost > 0);
+
+    // every gap in the indices is a burst
+    int numBursts = 0;
+    int previous = -1;
+    for (int index : capture.indices()) {
+        if (index != previous + 1) {
+            ++numBursts;
+        }
+        previous = index;
+    }
+    if (previous != NUM_DATAGRAMS - 1) {
+        ++numBursts;
+    }
+
+    double meanBurstLength = (double)stats.burstLost / numBursts;
+    QVERIFY2(qAbs(meanBurstLength - MEAN_BURST_LENGTH) < MEAN_BURST_LENGTH * 0.15,
+             qPrintable(QString("mean burst length was %1").arg(meanBurstLength)));
+}
+
+void LinkImpairmentTests::delayTest() {
+    static const int NUM_DATAGRAMS = 200;
+    static const milliseconds LATENCY { 20 };
+    static const milliseconds JITTER { 10 };
+
+    Capture capture;
+    LinkImpairment impairment(capture.writeFunction());
+    impairment.seed(SEED);
+    impairment.setProfile(FIRST_DESTINATION, makeProfile("latency=20,jitter=10"));
+
+    std::vector<TimePoint> writeTimes;
+    for (int i = 0; i < NUM_DATAGRAMS; ++i) {
+        writeTimes.push_back(p_high_resolution_clock::now());
+        impairment.write(makeDatagram(i), FIRST_DESTINATION);
+
+        if (i % 10 == 0) {
+            std::this_thread::sleep_for(milliseconds(1));
+        }
+    }
+
+    QVERIFY(capture.arrivals().size() < (size_t)NUM_DATAGRAMS);
+    QTRY_COMPARE_WITH_TIMEOUT(impairment.getNumPending(), 0, DRAIN_TIMEOUT_MSECS);
+
+    auto arrivals = capture.arrivals();
+    QCOMPARE((int)arrivals.size(), NUM_DATAGRAMS);
+
+    auto maxDelay = microseconds(0);
+    for (int i = 0; i < NUM_DATAGRAMS; ++i) {
+        // jitter alone never re-orders
+        QCOMPARE(arrivals[i].index, i);
+
+        auto delay = duration_cast<microseconds>(arrivals[i].time - writeTimes[i]);
+        QVERIFY(delay >= LATENCY);
+        maxDelay = std::max(maxDelay, delay);
+    }
+
+    // at least one datagram was held back by jitter
+    QVERIFY(maxDelay > LATENCY + JITTER / 2);
+}
+
+void LinkImpairmentTests::reorderTest() {
+    static const int NUM_DATAGRAMS = 500;
+
+    Capture capture;
+    LinkImpairment impairment(capture.writeFunction());
+    impairment.seed(SEED);
+    impairment.setProfile(FIRST_DESTINATION, makeProfile("reorder=10:5"));
+
+    for (int i = 0; i < NUM_DATAGRAMS; ++i) {
+        impairment.write(makeDatagram(i), FIRST_DESTINATION);
+
+        if (i % 10 == 0) {
+            std::this_thread::sleep_for(milliseconds(1));
+        }
+    }
+
+    QTRY_COMPARE_WITH_TIMEOUT(impairment.getNumPending(), 0, DRAIN_TIMEOUT_MSECS);
+
+    auto stats = impairment.takeStats(FIRST_DESTINATION);
+    QCOMPARE(stats.written, NUM_DATAGRAMS);
+    QVERIFY(stats.reordered > 0);
+
+    // nothing is lost, and the datagrams held back were overtaken
+    auto indices = capture.indices();
+    QCOMPARE((int)indices.size(), NUM_DATAGRAMS);
+    QVERIFY(!std::is_sorted(indices.begin(), indices.end()));
+
+    std::sort(indices.begin(), indices.end());
+    for (int i = 0; i < NUM_DATAGRAMS; ++i) {
+        QCOMPARE(indices[i], i);
+    }
+}
+
+void LinkImpairmentTests::bandwidthTest() {
+    static const int NUM_DATAGRAMS = 50;
+    static const int QUEUE_PACKETS = 20;
+    static const milliseconds TRANSMISSION_TIME { 10 }; // 1000 bytes at 0.8 Mb/s
+
+    Capture capture;
+    LinkImpairment impairment(capture.writeFunction());
+    impairment.setProfile(FIRST_DESTINATION, makeProfile("bandwidth=0.8,queue=20"));
+
+    // written all at once, the datagrams beyond the queue are dropped
+    auto start = p_high_resolution_clock::now();
+    for (int i = 0; i < NUM_DATAGRAMS; ++i) {
+        impairment.write(makeDatagram(i), FIRST_DESTINATION);
+    }
+
+    QTRY_COMPARE_WITH_TIMEOUT(impairment.getNumPending(), 0, DRAIN_TIMEOUT_MSECS);
+
+    auto stats = impairment.takeStats(FIRST_DESTINATION);
+    QCOMPARE(stats.written, QUEUE_PACKETS);
+    QCOMPARE(stats.queueDrops, NUM_DATAGRAMS - QUEUE_PACKETS);
+
+    // and the ones queued leave the bottleneck one transmission time apart
+    auto arrivals = capture.arrivals();
+    QCOMPARE((int)arrivals.size(), QUEUE_PACKETS);
+    for (int i = 0; i < QUEUE_PACKETS; ++i) {
+        QCOMPARE(arrivals[i].index, i);
+        QVERIFY(arrivals[i].time - start >= TRANSMISSION_TIME * (i + 1));
+    }
+}
+
+void LinkImpairmentTests::destinationTest() {
+    Capture capture;
+    LinkImpairment impairment(capture.writeFunction());
+    QVERIFY(!impairment.isEnabled());
+
+    impairment.setProfile(FIRST_DESTINATION, makeProfile("loss=100"));
+    QVERIFY(impairment.isEnabled());
+
+    impairment.write(makeDatagram(0), FIRST_DESTINATION);
+    impairment.write(makeDatagram(1), SECOND_DESTINATION);
+    QCOMPARE(capture.indices(), std::vector<int>({ 1 }));
+
+    // the profile of the null address applies to the destinations without their own
+    impairment.setProfile(HifiSockAddr(), makeProfile("loss=100"));
+    impairment.clearProfile(FIRST_DESTINATION);
+    impairment.write(makeDatagram(2), FIRST_DESTINATION);
+    impairment.write(makeDatagram(3), SECOND_DESTINATION);
+    QCOMPARE(capture.indices(), std::vector<int>({ 1 }));
+
+    QCOMPARE(impairment.takeStats(FIRST_DESTINATION).lost, 2);
+    QCOMPARE(impairment.takeStats(SECOND_DESTINATION).lost, 1);
+
+    impairment.clearProfiles();
+    QVERIFY(!impairment.isEnabled());
+    impairment.write(makeDatagram(4), FIRST_DESTINATION);
+    QCOMPARE(capture.indices(), std::vector<int>({ 1, 4 }));
+}
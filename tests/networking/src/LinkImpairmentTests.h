@@ -0,0 +1,43 @@
+//
+//  LinkImpairmentTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LinkImpairmentTests_h
+#define hifi_LinkImpairmentTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class LinkImpairmentTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that profiles survive a round trip through their string form, and that invalid ones are refused
+    void profileStringTest();
+
+    // Test that random loss drops about the configured fraction of datagrams
+    void lossTest();
+
+    // Test that loss bursts have about the configured mean length
+    void burstTest();
+
+    // Test that latency and jitter delay datagrams without re-ordering them
+    void delayTest();
+
+    // Test that re-ordered datagrams are overtaken by the ones after them
+    void reorderTest();
+
+    // Test that the bottleneck paces datagrams at its bandwidth and drops them once its queue is full
+    void bandwidthTest();
+
+    // Test that a profile only impairs its own destination
+    void destinationTest();
+};
+
+#endif // hifi_LinkImpairmentTests_h
@@ -0,0 +1,65 @@
+//
+//  PacketBufferPoolTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketBufferPoolTests.h"
+
+#include <NLPacket.h>
+#include <udt/Constants.h>
+#include <udt/PacketBufferPool.h>
+
+QTEST_MAIN(PacketBufferPoolTests)
+
+using namespace udt;
+
+static QJsonObject takeStatsForSize(qint64 size) {
+    return PacketBufferPool::takeStats()[QString::number(size)].toObject();
+}
+
+void PacketBufferPoolTests::reuseTest() {
+    auto buffer = PacketBufferPool::allocate(100);
+    QVERIFY(buffer.get_deleter().sizeClass != PacketBufferPool::HEAP);
+
+    const qint64 classSize = PacketBufferPool::sizeOfClass(buffer.get_deleter().sizeClass);
+    QVERIFY(classSize >= 100);
+
+    char* data = buffer.get();
+    buffer.reset();
+    takeStatsForSize(classSize);
+
+    auto reused = PacketBufferPool::allocate(classSize);
+    QCOMPARE(reused.get(), data);
+
+    auto stats = takeStatsForSize(classSize);
+    QCOMPARE(stats["hits"].toInt(), 1);
+    QCOMPARE(stats["misses"].toInt(), 0);
+    QCOMPARE(stats["high_water"].toInt(), stats["in_use"].toInt());
+}
+
+void PacketBufferPoolTests::largeBufferTest() {
+    auto buffer = PacketBufferPool::allocate(MAX_PACKET_SIZE + 1);
+    QCOMPARE(buffer.get_deleter().sizeClass, PacketBufferPool::HEAP);
+
+    auto adopted = PacketBufferPool::adopt(std::unique_ptr<char[]>(new char[16]));
+    QCOMPARE(adopted.get_deleter().sizeClass, PacketBufferPool::HEAP);
+}
+
+void PacketBufferPoolTests::packetTest() {
+    takeStatsForSize(MAX_PACKET_SIZE);
+
+    {
+        auto first = NLPacket::create(PacketType::Unknown);
+        auto second = NLPacket::create(PacketType::Unknown);
+    }
+
+    auto stats = takeStatsForSize(MAX_PACKET_SIZE);
+    QCOMPARE(stats["hits"].toInt() + stats["misses"].toInt(), 2);
+    QVERIFY(stats["high_water"].toInt() >= stats["in_use"].toInt() + 2);
+    QVERIFY(stats["free"].toInt() >= 2);
+}
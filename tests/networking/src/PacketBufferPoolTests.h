@@ -0,0 +1,31 @@
+//
+//  PacketBufferPoolTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketBufferPoolTests_h
+#define hifi_PacketBufferPoolTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class PacketBufferPoolTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that a released buffer is reused by the next allocation of its size class
+    void reuseTest();
+
+    // Test that buffers larger than the largest size class come from the heap
+    void largeBufferTest();
+
+    // Test that packets draw their buffers from the pool
+    void packetTest();
+};
+
+#endif // hifi_PacketBufferPoolTests_h
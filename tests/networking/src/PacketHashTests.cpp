@@ -0,0 +1,113 @@
+//
+//  PacketHashTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketHashTests.h"
+
+#include <NLPacket.h>
+#include <SipHash.h>
+
+QTEST_MAIN(PacketHashTests)
+
+Q_DECLARE_METATYPE(NLPacket::HashType)
+
+static std::unique_ptr<NLPacket> createVerifiedPacket(int payloadSize, const QUuid& connectionSecret,
+                                                      NLPacket::HashType hashType) {
+    auto packet = NLPacket::create(PacketType::AvatarData);
+    for (int i = 0; i < payloadSize; ++i) {
+        packet->writePrimitive((quint8)i);
+    }
+
+    packet->writeSourceID(QUuid::createUuid());
+    packet->writeVerificationHashGivenSecret(connectionSecret, hashType);
+    return packet;
+}
+
+void PacketHashTests::sipHashTest() {
+    char key[SipHash::KEY_SIZE];
+    for (int i = 0; i < SipHash::KEY_SIZE; ++i) {
+        key[i] = i;
+    }
+
+    char message[15];
+    for (int i = 0; i < (int)sizeof(message); ++i) {
+        message[i] = i;
+    }
+
+    char hash[SipHash::HASH_SIZE];
+
+    SipHash::hash128(key, message, 0, hash);
+    QCOMPARE(QByteArray(hash, SipHash::HASH_SIZE).toHex(), QByteArray("a3817f04ba25a8e66df67214c7550293"));
+
+    SipHash::hash128(key, message, sizeof(message), hash);
+    QCOMPARE(QByteArray(hash, SipHash::HASH_SIZE).toHex(), QByteArray("5493e99933b0a8117e08ec0f97cfc3d9"));
+}
+
+void PacketHashTests::verifyTest_data() {
+    QTest::addColumn<NLPacket::HashType>("hashType");
+
+    QTest::newRow("MD5") << NLPacket::HashType::MD5;
+    QTest::newRow("SipHash") << NLPacket::HashType::SipHash;
+}
+
+void PacketHashTests::verifyTest() {
+    QFETCH(NLPacket::HashType, hashType);
+    NLPacket::HashType otherHashType = (hashType == NLPacket::HashType::MD5) ? NLPacket::HashType::SipHash
+                                                                              : NLPacket::HashType::MD5;
+
+    QUuid connectionSecret = QUuid::createUuid();
+    auto packet = createVerifiedPacket(100, connectionSecret, hashType);
+
+    QVERIFY(NLPacket::verifyHashInHeader(*packet, connectionSecret, hashType));
+    QCOMPARE(NLPacket::verificationHashInHeader(*packet), NLPacket::hashForPacketAndSecret(*packet, connectionSecret, hashType));
+
+    QVERIFY(!NLPacket::verifyHashInHeader(*packet, QUuid::createUuid(), hashType));
+    QVERIFY(!NLPacket::verifyHashInHeader(*packet, connectionSecret, otherHashType));
+
+    // change the last byte of the payload
+    packet->seek(packet->getPayloadSize() - 1);
+    packet->writePrimitive((quint8)0xff);
+    QVERIFY(!NLPacket::verifyHashInHeader(*packet, connectionSecret, hashType));
+}
+
+void PacketHashTests::negotiationTest() {
+    const NLPacket::HashTypes MD5_ONLY = 1 << (int)NLPacket::HashType::MD5;
+    const NLPacket::HashTypes ALL = MD5_ONLY | 1 << (int)NLPacket::HashType::SipHash;
+
+    QCOMPARE(NLPacket::hashTypeForSupportedTypes(ALL, ALL), NLPacket::HashType::SipHash);
+    QCOMPARE(NLPacket::hashTypeForSupportedTypes(ALL, MD5_ONLY), NLPacket::HashType::MD5);
+    QCOMPARE(NLPacket::hashTypeForSupportedTypes(MD5_ONLY, ALL), NLPacket::HashType::MD5);
+    QCOMPARE(NLPacket::hashTypeForSupportedTypes(MD5_ONLY, MD5_ONLY), NLPacket::HashType::MD5);
+}
+
+void PacketHashTests::verifyBenchmark_data() {
+    verifyTest_data();
+}
+
+void PacketHashTests::verifyBenchmark() {
+    QFETCH(NLPacket::HashType, hashType);
+
+    // a batch of packets the size of typical avatar and audio packets
+    const int NUM_PACKETS = 1000;
+    const int PAYLOAD_SIZE = 200;
+
+    QUuid connectionSecret = QUuid::createUuid();
+    std::vector<std::unique_ptr<NLPacket>> packets;
+    for (int i = 0; i < NUM_PACKETS; ++i) {
+        packets.push_back(createVerifiedPacket(PAYLOAD_SIZE, connectionSecret, hashType));
+    }
+
+    int numVerified = 0;
+    QBENCHMARK {
+        for (auto& packet : packets) {
+            numVerified += NLPacket::verifyHashInHeader(*packet, connectionSecret, hashType) ? 1 : 0;
+        }
+    }
+    QVERIFY(numVerified > 0 && numVerified % NUM_PACKETS == 0);
+}
@@ -0,0 +1,36 @@
+//
+//  PacketHashTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketHashTests_h
+#define hifi_PacketHashTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class PacketHashTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test SipHash against the reference test vectors
+    void sipHashTest();
+
+    // Test that packets verify with the secret and hash type they were written with, and no other
+    void verifyTest_data();
+    void verifyTest();
+
+    // Test that nodes agree on the fastest hash type they both support
+    void negotiationTest();
+
+    // Compare the time to verify a batch of packets with each hash type
+    void verifyBenchmark_data();
+    void verifyBenchmark();
+};
+
+#endif // hifi_PacketHashTests_h
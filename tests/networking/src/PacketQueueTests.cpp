@@ -0,0 +1,148 @@
+//
+//  PacketQueueTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketQueueTests.h"
+
+#include <udt/PacketList.h>
+#include <udt/PacketQueue.h>
+
+QTEST_MAIN(PacketQueueTests)
+
+using namespace udt;
+
+static QByteArray makeData(int size) {
+    QByteArray data(size, 0);
+    for (int i = 0; i < size; ++i) {
+        data[i] = (char)(i * 7);
+    }
+    return data;
+}
+
+static std::vector<std::unique_ptr<Packet>> takeAllPackets(PacketQueue& queue) {
+    std::vector<std::unique_ptr<Packet>> packets;
+    while (!queue.isEmpty()) {
+        auto packet = queue.takePacket();
+        if (!packet) {
+            break;
+        }
+        packets.push_back(std::move(packet));
+    }
+    return packets;
+}
+
+// checks that the packets are the parts of one message, and returns its payload
+static QByteArray verifyMessage(const std::vector<std::unique_ptr<Packet>>& packets) {
+    QByteArray payload;
+
+    for (size_t i = 0; i < packets.size(); ++i) {
+        auto& packet = packets[i];
+        auto expectedPosition = Packet::PacketPosition::MIDDLE;
+        if (packets.size() == 1) {
+            expectedPosition = Packet::PacketPosition::ONLY;
+        } else if (i == 0) {
+            expectedPosition = Packet::PacketPosition::FIRST;
+        } else if (i == packets.size() - 1) {
+            expectedPosition = Packet::PacketPosition::LAST;
+        }
+
+        if (packet->getPacketPosition() != expectedPosition
+            || packet->getMessagePartNumber() != (Packet::MessagePartNumber)i
+            || packet->getMessageNumber() != packets.front()->getMessageNumber()) {
+            return QByteArray();
+        }
+
+        payload.append(packet->getPayload(), (int)packet->getPayloadSize());
+    }
+
+    return payload;
+}
+
+void PacketQueueTests::orderedListTest() {
+    auto data = makeData(Packet::maxPayloadSize(true) * 5 / 2);
+
+    auto packetList = PacketList::create(PacketType::Unknown, QByteArray(), true, true);
+    packetList->write(data);
+    packetList->closeCurrentPacket();
+
+    PacketQueue queue;
+    queue.queuePacketList(std::move(packetList));
+
+    auto packets = takeAllPackets(queue);
+    QCOMPARE((int)packets.size(), 3);
+    QCOMPARE(verifyMessage(packets), data);
+}
+
+void PacketQueueTests::deferredListTest() {
+    // enough data for several calls of the writer
+    auto data = makeData(Packet::maxPayloadSize(true) * 100 + 123);
+    auto header = makeData(16);
+
+    auto packetList = PacketList::create(PacketType::Unknown, QByteArray(), true, true);
+    packetList->write(header);
+
+    int numWrites = 0;
+    int numFinished = 0;
+    int bytesWritten = 0;
+    packetList->setDeferredWriter([&](PacketList& list, qint64 maxBytes) {
+        ++numWrites;
+        auto bytesToWrite = std::min((qint64)(data.size() - bytesWritten), maxBytes);
+        list.write(data.constData() + bytesWritten, bytesToWrite);
+        bytesWritten += bytesToWrite;
+        return bytesWritten < data.size();
+    });
+    packetList->setPacketFinisher([&](Packet& packet) {
+        ++numFinished;
+    });
+
+    PacketQueue queue;
+    queue.queuePacketList(std::move(packetList));
+
+    // nothing is written before the packets are taken
+    QCOMPARE(numWrites, 0);
+
+    // and taking the first packet only writes the first few
+    auto firstPacket = queue.takePacket();
+    QCOMPARE(numWrites, 1);
+    QVERIFY(bytesWritten < data.size());
+
+    std::vector<std::unique_ptr<Packet>> packets;
+    packets.push_back(std::move(firstPacket));
+    for (auto& packet : takeAllPackets(queue)) {
+        packets.push_back(std::move(packet));
+    }
+
+    QVERIFY(numWrites > 1);
+    QCOMPARE(numFinished, (int)packets.size());
+    QCOMPARE(verifyMessage(packets), header + data);
+}
+
+void PacketQueueTests::deferredExactFitTest() {
+    auto data = makeData(Packet::maxPayloadSize(true) * 2);
+
+    auto packetList = PacketList::create(PacketType::Unknown, QByteArray(), true, true);
+
+    bool isWritten = false;
+    packetList->setDeferredWriter([&](PacketList& list, qint64 maxBytes) {
+        if (!isWritten) {
+            list.write(data);
+            isWritten = true;
+            // claim there is more, to write nothing when called again
+            return true;
+        }
+        return false;
+    });
+
+    PacketQueue queue;
+    queue.queuePacketList(std::move(packetList));
+
+    auto packets = takeAllPackets(queue);
+    QCOMPARE((int)packets.size(), 2);
+    QCOMPARE(verifyMessage(packets), data);
+}
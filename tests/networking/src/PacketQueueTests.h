@@ -0,0 +1,31 @@
+//
+//  PacketQueueTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketQueueTests_h
+#define hifi_PacketQueueTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class PacketQueueTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that the packets of an ordered list are numbered as parts of one message
+    void orderedListTest();
+
+    // Test that a list with a deferred writer is written as it is taken, into the same packets
+    void deferredListTest();
+
+    // Test that a deferred list that ends on a packet boundary still ends its message
+    void deferredExactFitTest();
+};
+
+#endif // hifi_PacketQueueTests_h
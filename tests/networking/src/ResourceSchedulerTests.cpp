@@ -0,0 +1,128 @@
+//
+//  ResourceSchedulerTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ResourceSchedulerTests.h"
+
+#include "DependencyManager.h"
+#include "ResourceCache.h"
+
+QTEST_MAIN(ResourceSchedulerTests)
+
+static QSharedPointer<Resource> createResource(const QString& url, QObject* owner, float priority) {
+    auto resource = QSharedPointer<Resource>::create(QUrl(url));
+    resource->setSelf(resource);
+    resource->setLoadPriority(owner, priority);
+    return resource;
+}
+
+void ResourceSchedulerTests::init() {
+    // start each test with nothing loading or pending
+    DependencyManager::set<ResourceCacheSharedItems>();
+}
+
+void ResourceSchedulerTests::backendLimitTest() {
+    auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+    sharedItems->setRequestLimit(ResourceRequestBackend::HTTP, 1);
+    sharedItems->setRequestLimit(ResourceRequestBackend::File, 1);
+
+    QObject owner;
+    auto first = createResource("http://example.com/first.fbx", &owner, 0.0f);
+    auto second = createResource("http://example.com/second.fbx", &owner, 0.0f);
+    auto local = createResource("file:///tmp/local.fbx", &owner, 0.0f);
+
+    QVERIFY(sharedItems->startOrQueueRequest(first));
+    QVERIFY(!sharedItems->startOrQueueRequest(second));
+
+    // a slow HTTP download doesn't hold up local files
+    QVERIFY(sharedItems->startOrQueueRequest(local));
+    QCOMPARE(sharedItems->getLoadingRequestsCount(ResourceRequestBackend::HTTP), 1);
+    QCOMPARE(sharedItems->getLoadingRequestsCount(ResourceRequestBackend::File), 1);
+
+    // the queued HTTP download waits for an HTTP slot, not for any slot
+    sharedItems->removeRequest(local);
+    QVERIFY(sharedItems->startHighestPendingRequest().isNull());
+
+    sharedItems->removeRequest(first);
+    QCOMPARE(sharedItems->startHighestPendingRequest(), second);
+    QCOMPARE(sharedItems->getLoadingRequestsCount(ResourceRequestBackend::HTTP), 1);
+    QCOMPARE(sharedItems->getPendingRequestsCount(), (uint32_t)0);
+}
+
+void ResourceSchedulerTests::priorityOrderTest() {
+    auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+    sharedItems->setRequestLimit(ResourceRequestBackend::HTTP, 1);
+
+    QObject owner;
+    auto loading = createResource("http://example.com/loading.fbx", &owner, 0.0f);
+    auto low = createResource("http://example.com/low.fbx", &owner, -1.0f);
+    auto high = createResource("http://example.com/high.fbx", &owner, 1.0f);
+    auto olderEqual = createResource("http://example.com/older.fbx", &owner, 0.5f);
+    auto newerEqual = createResource("http://example.com/newer.fbx", &owner, 0.5f);
+
+    QVERIFY(sharedItems->startOrQueueRequest(loading));
+    QVERIFY(!sharedItems->startOrQueueRequest(low));
+    QVERIFY(!sharedItems->startOrQueueRequest(olderEqual));
+    QVERIFY(!sharedItems->startOrQueueRequest(high));
+    QVERIFY(!sharedItems->startOrQueueRequest(newerEqual));
+
+    QSharedPointer<Resource> expectedOrder[] = { high, newerEqual, olderEqual, low };
+    QSharedPointer<Resource> previous = loading;
+    for (auto& expected : expectedOrder) {
+        sharedItems->removeRequest(previous);
+        previous = sharedItems->startHighestPendingRequest();
+        QCOMPARE(previous, expected);
+    }
+}
+
+void ResourceSchedulerTests::priorityOperatorTest() {
+    auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+    sharedItems->setRequestLimit(ResourceRequestBackend::ATP, 1);
+
+    QObject owner;
+    auto loading = createResource("atp:/loading.fbx", &owner, 0.0f);
+    auto nearby = createResource("atp:/nearby.fbx", &owner, 1.0f);
+    auto distant = createResource("atp:/distant.fbx", &owner, 0.0f);
+
+    float distantPriority = 0.0f;
+    distant->setLoadPriorityOperator(&owner, [&distantPriority]() { return distantPriority; });
+
+    QVERIFY(sharedItems->startOrQueueRequest(loading));
+    QVERIFY(!sharedItems->startOrQueueRequest(nearby));
+    QVERIFY(!sharedItems->startOrQueueRequest(distant));
+
+    // the avatar moves to near the distant resource, and the priorities are updated on arrival
+    distantPriority = 2.0f;
+    sharedItems->restartLoadTimes();
+
+    sharedItems->removeRequest(loading);
+    QCOMPARE(sharedItems->startHighestPendingRequest(), distant);
+}
+
+void ResourceSchedulerTests::loadTimesTest() {
+    auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+    QCOMPARE(sharedItems->getUsefulLoadMsecs(), -1);
+    QCOMPARE(sharedItems->getAllLoadMsecs(), -1);
+
+    sharedItems->restartLoadTimes();
+
+    QObject owner;
+    auto model = createResource("http://example.com/model.fbx", &owner, 0.5f);
+    auto mip = createResource("http://example.com/texture.ktx", &owner, -1.0f);
+
+    QVERIFY(sharedItems->startOrQueueRequest(model));
+    QVERIFY(sharedItems->startOrQueueRequest(mip));
+
+    sharedItems->removeRequest(model);
+    QVERIFY(sharedItems->getUsefulLoadMsecs() >= 0);
+    QCOMPARE(sharedItems->getAllLoadMsecs(), -1);
+
+    sharedItems->removeRequest(mip);
+    QVERIFY(sharedItems->getAllLoadMsecs() >= sharedItems->getUsefulLoadMsecs());
+}
@@ -0,0 +1,26 @@
+//
+//  ResourceSchedulerTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ResourceSchedulerTests_h
+#define hifi_ResourceSchedulerTests_h
+
+#include <QtTest/QtTest>
+
+class ResourceSchedulerTests : public QObject {
+    Q_OBJECT
+private slots:
+    void init();
+    void backendLimitTest();
+    void priorityOrderTest();
+    void priorityOperatorTest();
+    void loadTimesTest();
+};
+
+#endif // hifi_ResourceSchedulerTests_h
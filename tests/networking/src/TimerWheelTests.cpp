@@ -0,0 +1,105 @@
+//
+//  TimerWheelTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TimerWheelTests.h"
+
+#include <udt/TimerWheel.h>
+
+QTEST_MAIN(TimerWheelTests)
+
+using namespace udt;
+using Wheel = TimerWheel<int>;
+using Usecs = std::chrono::microseconds;
+
+static const Usecs TICK { Wheel::TICK_USECS };
+
+static std::vector<int> expireItems(Wheel& wheel, Wheel::TimePoint now) {
+    std::deque<Wheel::Entry> expired;
+    wheel.expire(now, expired);
+
+    std::vector<int> items;
+    for (auto& entry : expired) {
+        items.push_back(entry.item);
+    }
+    return items;
+}
+
+void TimerWheelTests::expireTest() {
+    Wheel wheel;
+    auto start = p_high_resolution_clock::now();
+    expireItems(wheel, start);
+
+    wheel.insert(3, start + 30 * TICK);
+    wheel.insert(1, start + 10 * TICK);
+    wheel.insert(2, start + 20 * TICK);
+    wheel.insert(0, start - TICK); // already overdue
+    QCOMPARE(wheel.size(), 4);
+
+    QCOMPARE(expireItems(wheel, start), std::vector<int>({ 0 }));
+    QCOMPARE(expireItems(wheel, start + 5 * TICK), std::vector<int>());
+    QCOMPARE(expireItems(wheel, start + 25 * TICK), std::vector<int>({ 1, 2 }));
+    QCOMPARE(expireItems(wheel, start + 30 * TICK), std::vector<int>({ 3 }));
+    QVERIFY(wheel.isEmpty());
+}
+
+void TimerWheelTests::farFutureTest() {
+    Wheel wheel;
+    auto start = p_high_resolution_clock::now();
+    expireItems(wheel, start);
+
+    // shares a slot with an item due one turn of the wheel earlier
+    wheel.insert(1, start + 10 * TICK);
+    wheel.insert(2, start + (10 + Wheel::NUM_SLOTS) * TICK);
+
+    QCOMPARE(expireItems(wheel, start + 10 * TICK), std::vector<int>({ 1 }));
+    QCOMPARE(expireItems(wheel, start + (Wheel::NUM_SLOTS + 5) * TICK), std::vector<int>());
+    QCOMPARE(expireItems(wheel, start + (Wheel::NUM_SLOTS + 10) * TICK), std::vector<int>({ 2 }));
+
+    // an expire long after everything was due still finds it
+    wheel.insert(3, start + (Wheel::NUM_SLOTS + 20) * TICK);
+    QCOMPARE(expireItems(wheel, start + (10 * Wheel::NUM_SLOTS) * TICK), std::vector<int>({ 3 }));
+    QVERIFY(wheel.isEmpty());
+}
+
+void TimerWheelTests::removeTest() {
+    Wheel wheel;
+    auto start = p_high_resolution_clock::now();
+    expireItems(wheel, start);
+
+    wheel.insert(1, start + 10 * TICK);
+    wheel.insert(2, start + 10 * TICK);
+
+    QVERIFY(wheel.remove(1, start + 10 * TICK));
+    QVERIFY(!wheel.remove(1, start + 10 * TICK));
+    QVERIFY(!wheel.remove(2, start + 11 * TICK));
+    QCOMPARE(wheel.size(), 1);
+
+    QCOMPARE(expireItems(wheel, start + 10 * TICK), std::vector<int>({ 2 }));
+}
+
+void TimerWheelTests::nextDueTest() {
+    Wheel wheel;
+    QVERIFY(wheel.getNextDue() == Wheel::TimePoint::max());
+
+    auto start = p_high_resolution_clock::now();
+    expireItems(wheel, start);
+
+    auto farDue = start + (2 * Wheel::NUM_SLOTS) * TICK;
+    wheel.insert(1, farDue);
+    QVERIFY(wheel.getNextDue() == farDue);
+
+    // due sooner, in a later slot of the wheel than the far item
+    auto nearDue = start + (Wheel::NUM_SLOTS / 2) * TICK + Usecs(1);
+    wheel.insert(2, nearDue);
+    QVERIFY(wheel.getNextDue() == nearDue);
+
+    wheel.remove(2, nearDue);
+    QVERIFY(wheel.getNextDue() == farDue);
+}
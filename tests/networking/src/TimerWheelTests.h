@@ -0,0 +1,34 @@
+//
+//  TimerWheelTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TimerWheelTests_h
+#define hifi_TimerWheelTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class TimerWheelTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that items expire once they are due, in the order they were due
+    void expireTest();
+
+    // Test that items due beyond one turn of the wheel wait for their turn
+    void farFutureTest();
+
+    // Test that removed items never expire
+    void removeTest();
+
+    // Test that the next due time is the earliest of all the items
+    void nextDueTest();
+};
+
+#endif // hifi_TimerWheelTests_h
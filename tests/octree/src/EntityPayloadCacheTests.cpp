@@ -0,0 +1,134 @@
+//
+//  EntityPayloadCacheTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityPayloadCacheTests.h"
+
+#include <QtCore/QThreadPool>
+
+#include <EntityPayloadCache.h>
+#include <EntityTree.h>
+#include <NumericalConstants.h>
+#include <OctreePacketData.h>
+
+QTEST_MAIN(EntityPayloadCacheTests)
+
+// adds entities the way the tree does once they are constructed, without the node list addEntity checks rights with
+class PayloadCacheTestTree : public EntityTree {
+public:
+    using EntityTree::addConstructedEntity;
+};
+
+static std::shared_ptr<PayloadCacheTestTree> createTree() {
+    auto tree = std::make_shared<PayloadCacheTestTree>();
+    tree->createRootElement();
+    return tree;
+}
+
+static EntityItemPointer addBox(PayloadCacheTestTree& tree) {
+    EntityItemProperties properties;
+    properties.setType(EntityTypes::Box);
+    properties.setPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+    properties.setName("box");
+
+    auto entity = EntityTypes::constructEntityItem(EntityTypes::Box, EntityItemID(QUuid::createUuid()), properties);
+    tree.withWriteLock([&] {
+        tree.addConstructedEntity(entity);
+    });
+    return entity;
+}
+
+void EntityPayloadCacheTests::reuseTest() {
+    auto tree = createTree();
+    auto entity = addBox(*tree);
+    auto editSequence = tree->journalEntityChange(entity->getEntityItemID());
+
+    QThreadPool encodePool;
+    EntityPayloadCache cache;
+    QCOMPARE(cache.encodeChanges(*tree, encodePool), 1);
+    QCOMPARE(cache.getNumPayloads(), 1);
+
+    QByteArray payload;
+    QVERIFY(cache.getPayload(entity, editSequence, payload));
+    QVERIFY(!payload.isEmpty());
+
+    // the entity is only encoded again once it changes, and its payload is used until then
+    QCOMPARE(cache.encodeChanges(*tree, encodePool), 0);
+    QByteArray reusedPayload;
+    QVERIFY(cache.getPayload(entity, editSequence, reusedPayload));
+    QCOMPARE(reusedPayload, payload);
+}
+
+void EntityPayloadCacheTests::changedTest() {
+    auto tree = createTree();
+    auto entity = addBox(*tree);
+    auto editSequence = tree->journalEntityChange(entity->getEntityItemID());
+
+    QThreadPool encodePool;
+    EntityPayloadCache cache;
+    QCOMPARE(cache.encodeChanges(*tree, encodePool), 1);
+
+    // a send thread that has seen a later edit doesn't take the payload from before it
+    QByteArray payload;
+    auto nameSequence = tree->journalEntityChange(entity->getEntityItemID(), EntityPropertyFlags(PROP_NAME));
+    QVERIFY(!cache.getPayload(entity, nameSequence, payload));
+
+    QCOMPARE(cache.encodeChanges(*tree, encodePool), 1);
+    QVERIFY(!cache.getPayload(entity, editSequence, payload));
+    QVERIFY(cache.getPayload(entity, nameSequence, payload));
+
+    // nor one from before the entity was last simulated or updated, which moves it without an edit
+    entity->setLastSimulated(entity->getLastSimulated() + 1);
+    QVERIFY(!cache.getPayload(entity, nameSequence, payload));
+
+    auto lastSequence = tree->journalEntityChange(entity->getEntityItemID());
+    QCOMPARE(cache.encodeChanges(*tree, encodePool), 1);
+    QVERIFY(cache.getPayload(entity, lastSequence, payload));
+
+    entity->update(entity->getLastUpdated() + 1);
+    QVERIFY(!cache.getPayload(entity, lastSequence, payload));
+}
+
+void EntityPayloadCacheTests::pruneTest() {
+    auto tree = createTree();
+    auto entity = addBox(*tree);
+    auto editSequence = tree->journalEntityChange(entity->getEntityItemID());
+
+    QThreadPool encodePool;
+    EntityPayloadCache cache;
+    QCOMPARE(cache.encodeChanges(*tree, encodePool), 1);
+
+    // a payload that is still good for its entity is dropped once it is old, since it is likely not sent anymore
+    QTest::qSleep((int)(EntityPayloadCache::MAX_PAYLOAD_AGE_USECS / USECS_PER_MSEC) + 100);
+    QCOMPARE(cache.encodeChanges(*tree, encodePool), 0);
+    QCOMPARE(cache.getNumPayloads(), 0);
+
+    QByteArray payload;
+    QVERIFY(!cache.getPayload(entity, editSequence, payload));
+}
+
+void EntityPayloadCacheTests::oversizedTest() {
+    auto tree = createTree();
+    auto entity = addBox(*tree);
+    tree->journalEntityChange(entity->getEntityItemID());
+
+    QThreadPool encodePool;
+    EntityPayloadCache cache;
+    QCOMPARE(cache.encodeChanges(*tree, encodePool), 1);
+
+    // an entity that doesn't fit in one packet is left to the send threads, and its earlier payload is dropped
+    entity->setUserData(QString(MAX_OCTREE_UNCOMRESSED_PACKET_SIZE, 'u'));
+    auto editSequence = tree->journalEntityChange(entity->getEntityItemID(), EntityPropertyFlags(PROP_USER_DATA));
+    QCOMPARE(cache.encodeChanges(*tree, encodePool), 0);
+    QCOMPARE(cache.getNumPayloads(), 0);
+
+    QByteArray payload;
+    QVERIFY(!cache.getPayload(entity, editSequence, payload));
+    QCOMPARE(cache.getNumEncoded(), (quint64)1);
+}
@@ -0,0 +1,26 @@
+//
+//  EntityPayloadCacheTests.h
+//  tests/octree/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityPayloadCacheTests_h
+#define hifi_EntityPayloadCacheTests_h
+
+#include <QtTest/QtTest>
+
+class EntityPayloadCacheTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void reuseTest();
+    void changedTest();
+    void pruneTest();
+    void oversizedTest();
+};
+
+#endif // hifi_EntityPayloadCacheTests_h
@@ -0,0 +1,151 @@
+//
+//  EntityRecordTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityRecordTests.h"
+
+#include <EntityItemProperties.h>
+#include <OctreePacketData.h>
+
+QTEST_MAIN(EntityRecordTests)
+
+static EntityItemProperties createBoxProperties() {
+    EntityItemProperties properties;
+    properties.setType(EntityTypes::Box);
+    properties.setPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+    properties.setDimensions(glm::vec3(0.5f));
+    properties.setName("box");
+    properties.setCreated((quint64)1234567890);
+    properties.setLastEditedBy(QUuid::createUuid());
+    properties.setSimulationOwner(QUuid::createUuid(), 1);
+    return properties;
+}
+
+void EntityRecordTests::roundTripTest() {
+    EntityItemID id(QUuid::createUuid());
+    auto properties = createBoxProperties();
+
+    QByteArray record;
+    QVERIFY(EntityItemProperties::encodeEntityRecord(id, properties, record));
+
+    EntityItemID decodedID;
+    EntityItemProperties decodedProperties;
+    QVERIFY(EntityItemProperties::decodeEntityRecord(reinterpret_cast<const unsigned char*>(record.constData()),
+                                                     record.size(), decodedID, decodedProperties));
+
+    QCOMPARE(decodedID, id);
+    QCOMPARE(decodedProperties.getType(), EntityTypes::Box);
+    QCOMPARE(decodedProperties.getPosition(), properties.getPosition());
+    QCOMPARE(decodedProperties.getDimensions(), properties.getDimensions());
+    QCOMPARE(decodedProperties.getName(), properties.getName());
+    QCOMPARE(decodedProperties.getCreated(), properties.getCreated());
+    QCOMPARE(decodedProperties.getLastEditedBy(), properties.getLastEditedBy());
+
+    // the simulation owner isn't kept past the session it was bid in
+    QVERIFY(!decodedProperties.simulationOwnerChanged());
+}
+
+void EntityRecordTests::multiplePartsTest() {
+    EntityItemID id(QUuid::createUuid());
+    auto properties = createBoxProperties();
+
+    // each of these fits in an edit packet, but not all of them together
+    const int LONG_PROPERTY_SIZE = MAX_OCTREE_UNCOMRESSED_PACKET_SIZE / 2;
+    properties.setUserData(QString(LONG_PROPERTY_SIZE, 'u'));
+    properties.setDescription(QString(LONG_PROPERTY_SIZE, 'd'));
+    properties.setScript(QString(LONG_PROPERTY_SIZE, 's'));
+
+    QByteArray record;
+    QVERIFY(EntityItemProperties::encodeEntityRecord(id, properties, record));
+    QVERIFY(record.size() > (int)MAX_OCTREE_UNCOMRESSED_PACKET_SIZE);
+
+    EntityItemID decodedID;
+    EntityItemProperties decodedProperties;
+    QVERIFY(EntityItemProperties::decodeEntityRecord(reinterpret_cast<const unsigned char*>(record.constData()),
+                                                     record.size(), decodedID, decodedProperties));
+
+    QCOMPARE(decodedID, id);
+    QCOMPARE(decodedProperties.getUserData(), properties.getUserData());
+    QCOMPARE(decodedProperties.getDescription(), properties.getDescription());
+    QCOMPARE(decodedProperties.getScript(), properties.getScript());
+    QCOMPARE(decodedProperties.getPosition(), properties.getPosition());
+}
+
+void EntityRecordTests::changedPropertiesTest() {
+    EntityItemID id(QUuid::createUuid());
+    auto properties = createBoxProperties();
+
+    EntityPropertyFlags changedProperties;
+    changedProperties += PROP_POSITION;
+    changedProperties += PROP_SIMULATION_OWNER;
+
+    QByteArray record;
+    QVERIFY(EntityItemProperties::encodeEntityRecord(id, properties, changedProperties, record));
+
+    EntityItemID decodedID;
+    EntityItemProperties decodedProperties;
+    QVERIFY(EntityItemProperties::decodeEntityRecord(reinterpret_cast<const unsigned char*>(record.constData()),
+                                                     record.size(), decodedID, decodedProperties));
+
+    QCOMPARE(decodedID, id);
+    QVERIFY(decodedProperties.positionChanged());
+    QCOMPARE(decodedProperties.getPosition(), properties.getPosition());
+    QVERIFY(!decodedProperties.dimensionsChanged());
+    QVERIFY(!decodedProperties.nameChanged());
+    QVERIFY(!decodedProperties.simulationOwnerChanged());
+
+    // an edit of only the simulation owner has nothing to record
+    EntityPropertyFlags simulationOwner;
+    simulationOwner += PROP_SIMULATION_OWNER;
+    QVERIFY(!EntityItemProperties::encodeEntityRecord(id, properties, simulationOwner, record));
+}
+
+void EntityRecordTests::largePropertiesTest() {
+    EntityItemID id(QUuid::createUuid());
+    auto properties = createBoxProperties();
+
+    // these don't fit in an edit packet at all
+    const int LARGE_PROPERTY_SIZE = MAX_OCTREE_UNCOMRESSED_PACKET_SIZE * 4;
+    properties.setUserData(QString(LARGE_PROPERTY_SIZE, 'u'));
+    properties.setActionData(QByteArray(LARGE_PROPERTY_SIZE, 'a'));
+
+    QByteArray record;
+    QVERIFY(EntityItemProperties::encodeEntityRecord(id, properties, record));
+
+    EntityItemID decodedID;
+    EntityItemProperties decodedProperties;
+    QVERIFY(EntityItemProperties::decodeEntityRecord(reinterpret_cast<const unsigned char*>(record.constData()),
+                                                     record.size(), decodedID, decodedProperties));
+
+    QCOMPARE(decodedID, id);
+    QCOMPARE(decodedProperties.getUserData(), properties.getUserData());
+    QCOMPARE(decodedProperties.getActionData(), properties.getActionData());
+    QCOMPARE(decodedProperties.getName(), properties.getName());
+    QCOMPARE(decodedProperties.getPosition(), properties.getPosition());
+
+    // a record cut short in its large properties can't be decoded
+    QVERIFY(!EntityItemProperties::decodeEntityRecord(reinterpret_cast<const unsigned char*>(record.constData()),
+                                                      record.size() - 1, decodedID, decodedProperties));
+}
+
+void EntityRecordTests::truncatedRecordTest() {
+    QByteArray record;
+    QVERIFY(EntityItemProperties::encodeEntityRecord(EntityItemID(QUuid::createUuid()), createBoxProperties(), record));
+
+    // a record without any of its parts can't be decoded
+    const int HEADER_SIZE = sizeof(quint64) + NUM_BYTES_RFC4122_UUID;
+    EntityItemID decodedID;
+    EntityItemProperties decodedProperties;
+    QVERIFY(!EntityItemProperties::decodeEntityRecord(reinterpret_cast<const unsigned char*>(record.constData()),
+                                                      HEADER_SIZE, decodedID, decodedProperties));
+
+    // nor can one whose last part is cut short
+    QVERIFY(!EntityItemProperties::decodeEntityRecord(reinterpret_cast<const unsigned char*>(record.constData()),
+                                                      record.size() - 1, decodedID, decodedProperties));
+}
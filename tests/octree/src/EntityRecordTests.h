@@ -0,0 +1,27 @@
+//
+//  EntityRecordTests.h
+//  tests/octree/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityRecordTests_h
+#define hifi_EntityRecordTests_h
+
+#include <QtTest/QtTest>
+
+class EntityRecordTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void roundTripTest();
+    void multiplePartsTest();
+    void changedPropertiesTest();
+    void largePropertiesTest();
+    void truncatedRecordTest();
+};
+
+#endif // hifi_EntityRecordTests_h
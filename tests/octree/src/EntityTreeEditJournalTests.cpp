@@ -0,0 +1,100 @@
+//
+//  EntityTreeEditJournalTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityTreeEditJournalTests.h"
+
+#include <EntityNodeData.h>
+#include <EntityTree.h>
+
+QTEST_MAIN(EntityTreeEditJournalTests)
+
+void EntityTreeEditJournalTests::changedSinceTest() {
+    EntityTreePointer tree = std::make_shared<EntityTree>();
+
+    EntityItemID first { QUuid::createUuid() };
+    EntityItemID second { QUuid::createUuid() };
+
+    auto firstSequence = tree->journalEntityChange(first);
+    auto secondSequence = tree->journalEntityChange(second);
+    QVERIFY(secondSequence > firstSequence);
+
+    // a change of an entity replaces its earlier one, so it is found once, in the order of its last change
+    auto lastSequence = tree->journalEntityChange(first);
+    QCOMPARE(tree->getEntityEditSequence(first), lastSequence);
+
+    QVector<EntityTree::EntityEditSequence> changedEntities;
+    QCOMPARE(tree->getEntitiesChangedSince(0, changedEntities), lastSequence);
+    QCOMPARE(changedEntities.size(), 2);
+    QCOMPARE(changedEntities[0].first, second);
+    QCOMPARE(changedEntities[1].first, first);
+
+    changedEntities.clear();
+    tree->getEntitiesChangedSince(secondSequence, changedEntities);
+    QCOMPARE(changedEntities.size(), 1);
+    QCOMPARE(changedEntities[0].second, lastSequence);
+
+    changedEntities.clear();
+    tree->getEntitiesChangedSince(lastSequence, changedEntities);
+    QVERIFY(changedEntities.isEmpty());
+}
+
+void EntityTreeEditJournalTests::propertiesChangedSinceTest() {
+    EntityTreePointer tree = std::make_shared<EntityTree>();
+    EntityItemID entityID { QUuid::createUuid() };
+
+    // the properties of an entity that isn't journaled aren't known
+    EntityPropertyFlags changedProperties;
+    QVERIFY(!tree->getEntityPropertiesChangedSince(entityID, 0, changedProperties));
+
+    auto addedSequence = tree->journalEntityChange(entityID);
+    auto colorSequence = tree->journalEntityChange(entityID, EntityPropertyFlags(PROP_COLOR));
+    tree->journalEntityChange(entityID, EntityPropertyFlags(PROP_USER_DATA));
+
+    // the properties changed by every edit since the sequence, with where the entity is
+    QVERIFY(tree->getEntityPropertiesChangedSince(entityID, addedSequence, changedProperties));
+    QVERIFY(changedProperties.getHasProperty(PROP_COLOR));
+    QVERIFY(changedProperties.getHasProperty(PROP_USER_DATA));
+    QVERIFY(changedProperties.getHasProperty(PROP_POSITION));
+    QVERIFY(!changedProperties.getHasProperty(PROP_NAME));
+
+    changedProperties = EntityPropertyFlags();
+    QVERIFY(tree->getEntityPropertiesChangedSince(entityID, colorSequence, changedProperties));
+    QVERIFY(!changedProperties.getHasProperty(PROP_COLOR));
+    QVERIFY(changedProperties.getHasProperty(PROP_USER_DATA));
+
+    // a sequence from before the entity was added needs all of its properties
+    QVERIFY(!tree->getEntityPropertiesChangedSince(entityID, addedSequence - 1, changedProperties));
+
+    // and so does one from before the oldest change that is kept
+    quint64 lastSequence = 0;
+    for (int i = 0; i < 100; i++) {
+        lastSequence = tree->journalEntityChange(entityID, EntityPropertyFlags(PROP_NAME));
+    }
+    QVERIFY(!tree->getEntityPropertiesChangedSince(entityID, colorSequence, changedProperties));
+
+    changedProperties = EntityPropertyFlags();
+    QVERIFY(tree->getEntityPropertiesChangedSince(entityID, lastSequence, changedProperties));
+    QVERIFY(!changedProperties.getHasProperty(PROP_NAME));
+}
+
+void EntityTreeEditJournalTests::sentEntityTest() {
+    EntityNodeData nodeData;
+    QUuid entityID = QUuid::createUuid();
+
+    // an entity that was never sent is sent, even if it hasn't changed since the tree was loaded
+    QVERIFY(!nodeData.hasSentEntity(entityID, 0));
+
+    nodeData.setSentEntity(entityID, 2);
+    QVERIFY(nodeData.hasSentEntity(entityID, 2));
+    QVERIFY(!nodeData.hasSentEntity(entityID, 3));
+
+    nodeData.removeSentEntity(entityID);
+    QVERIFY(!nodeData.hasSentEntity(entityID, 2));
+}
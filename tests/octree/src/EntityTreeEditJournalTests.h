@@ -0,0 +1,25 @@
+//
+//  EntityTreeEditJournalTests.h
+//  tests/octree/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityTreeEditJournalTests_h
+#define hifi_EntityTreeEditJournalTests_h
+
+#include <QtTest/QtTest>
+
+class EntityTreeEditJournalTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void changedSinceTest();
+    void propertiesChangedSinceTest();
+    void sentEntityTest();
+};
+
+#endif // hifi_EntityTreeEditJournalTests_h
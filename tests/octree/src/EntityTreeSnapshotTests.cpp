@@ -0,0 +1,67 @@
+//
+//  EntityTreeSnapshotTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityTreeSnapshotTests.h"
+
+#include <EntityTreeSnapshot.h>
+#include <EntityTypes.h>
+
+QTEST_MAIN(EntityTreeSnapshotTests)
+
+static EntityItemPointer createBox(const QString& name) {
+    EntityItemProperties properties;
+    properties.setType(EntityTypes::Box);
+    properties.setName(name);
+    return EntityTypes::constructEntityItem(EntityTypes::Box, EntityItemID(QUuid::createUuid()), properties);
+}
+
+static QStringList readNames(EntityTreeSnapshot& snapshot) {
+    QStringList names;
+    snapshot.forEachEntity([&](const EntityItemPointer& entity, const EntityItemProperties& properties) {
+        names << properties.getName();
+    });
+    return names;
+}
+
+void EntityTreeSnapshotTests::readTest() {
+    auto first = createBox("first");
+    auto second = createBox("second");
+    QVERIFY(first && second);
+
+    EntityTreeSnapshot snapshot({ first, second });
+    QCOMPARE(snapshot.getNumEntities(), (size_t)2);
+    QCOMPARE(readNames(snapshot), QStringList({ "first", "second" }));
+    QCOMPARE(snapshot.getNumPreserved(), 0);
+}
+
+void EntityTreeSnapshotTests::preserveBeforeReadTest() {
+    auto entity = createBox("before");
+    EntityTreeSnapshot snapshot({ entity });
+
+    // the tree preserves the entity before it edits it, so the snapshot still has it as it was
+    snapshot.preserve(entity);
+    entity->setName("after");
+
+    QCOMPARE(readNames(snapshot), QStringList({ "before" }));
+    QCOMPARE(snapshot.getNumPreserved(), 1);
+}
+
+void EntityTreeSnapshotTests::preserveAfterReadTest() {
+    auto entity = createBox("before");
+    auto other = createBox("other");
+    EntityTreeSnapshot snapshot({ entity });
+
+    QCOMPARE(readNames(snapshot), QStringList({ "before" }));
+
+    // the entity has already been read, and entities that aren't in the snapshot are left alone
+    snapshot.preserve(entity);
+    snapshot.preserve(other);
+    QCOMPARE(snapshot.getNumPreserved(), 0);
+}
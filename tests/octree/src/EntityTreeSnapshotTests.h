@@ -0,0 +1,25 @@
+//
+//  EntityTreeSnapshotTests.h
+//  tests/octree/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityTreeSnapshotTests_h
+#define hifi_EntityTreeSnapshotTests_h
+
+#include <QtTest/QtTest>
+
+class EntityTreeSnapshotTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void readTest();
+    void preserveBeforeReadTest();
+    void preserveAfterReadTest();
+};
+
+#endif // hifi_EntityTreeSnapshotTests_h
@@ -0,0 +1,159 @@
+//
+//  OctreeEditLogTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeEditLogTests.h"
+
+#include <QtCore/QTemporaryDir>
+
+#include <OctreeEditLog.h>
+
+QTEST_MAIN(OctreeEditLogTests)
+
+static QList<QByteArray> replayRecords(const QString& fileName) {
+    QList<QByteArray> records;
+    OctreeEditLog editLog(fileName, PacketType::EntityEdit);
+    editLog.replay([&](const char* data, int size) {
+        records << QByteArray(data, size);
+    });
+    return records;
+}
+
+void OctreeEditLogTests::replayTest() {
+    QTemporaryDir directory;
+    auto fileName = directory.filePath("models.edits");
+
+    {
+        OctreeEditLog editLog(fileName, PacketType::EntityEdit);
+        QVERIFY(editLog.open());
+        QVERIFY(editLog.append("first"));
+        QVERIFY(editLog.append("second"));
+        QVERIFY(editLog.append(QByteArray(1000, 'x')));
+        QCOMPARE(editLog.getNumAppends(), 3);
+    }
+
+    auto records = replayRecords(fileName);
+    QCOMPARE(records.size(), 3);
+    QCOMPARE(records[0], QByteArray("first"));
+    QCOMPARE(records[1], QByteArray("second"));
+    QCOMPARE(records[2], QByteArray(1000, 'x'));
+}
+
+void OctreeEditLogTests::truncatedRecordTest() {
+    QTemporaryDir directory;
+    auto fileName = directory.filePath("models.edits");
+
+    {
+        OctreeEditLog editLog(fileName, PacketType::EntityEdit);
+        QVERIFY(editLog.open());
+        QVERIFY(editLog.append("first"));
+        QVERIFY(editLog.append("second"));
+    }
+
+    // cut the last record short, as a crash while it was written would
+    {
+        QFile file(fileName);
+        QVERIFY(file.resize(file.size() - 2));
+    }
+
+    QCOMPARE(replayRecords(fileName).size(), 1);
+
+    // the partial record is dropped, so that the records appended after it are replayed
+    {
+        OctreeEditLog editLog(fileName, PacketType::EntityEdit);
+        QVERIFY(editLog.open());
+        QVERIFY(editLog.append("third"));
+    }
+
+    auto records = replayRecords(fileName);
+    QCOMPARE(records.size(), 2);
+    QCOMPARE(records[0], QByteArray("first"));
+    QCOMPARE(records[1], QByteArray("third"));
+}
+
+void OctreeEditLogTests::checkpointTest() {
+    QTemporaryDir directory;
+    auto fileName = directory.filePath("models.edits");
+
+    OctreeEditLog editLog(fileName, PacketType::EntityEdit);
+    QVERIFY(editLog.open());
+    QVERIFY(editLog.append("before"));
+    QVERIFY(editLog.beginCheckpoint());
+    QVERIFY(editLog.append("during"));
+
+    // until the checkpoint ends, the records before it are replayed first
+    auto records = replayRecords(fileName);
+    QCOMPARE(records.size(), 2);
+    QCOMPARE(records[0], QByteArray("before"));
+    QCOMPARE(records[1], QByteArray("during"));
+
+    editLog.endCheckpoint();
+    QCOMPARE(editLog.getNumCheckpoints(), 1);
+    QVERIFY(!QFile::exists(editLog.getCheckpointFileName()));
+
+    records = replayRecords(fileName);
+    QCOMPARE(records.size(), 1);
+    QCOMPARE(records[0], QByteArray("during"));
+}
+
+void OctreeEditLogTests::unfinishedCheckpointTest() {
+    QTemporaryDir directory;
+    auto fileName = directory.filePath("models.edits");
+
+    OctreeEditLog editLog(fileName, PacketType::EntityEdit);
+    QVERIFY(editLog.open());
+    QVERIFY(editLog.append("first"));
+    QVERIFY(editLog.beginCheckpoint());
+    QVERIFY(editLog.append("second"));
+
+    // the first checkpoint never ended, so the next one keeps its records ahead of the new ones
+    QVERIFY(editLog.beginCheckpoint());
+    QVERIFY(editLog.append("third"));
+
+    auto records = replayRecords(fileName);
+    QCOMPARE(records.size(), 3);
+    QCOMPARE(records[0], QByteArray("first"));
+    QCOMPARE(records[1], QByteArray("second"));
+    QCOMPARE(records[2], QByteArray("third"));
+
+    editLog.clear();
+    QVERIFY(replayRecords(fileName).isEmpty());
+    QCOMPARE(editLog.getSize(), (qint64)0);
+}
+
+void OctreeEditLogTests::otherVersionTest() {
+    QTemporaryDir directory;
+    auto fileName = directory.filePath("models.edits");
+
+    // a log of packets of another type stands in for one written by another version
+    {
+        OctreeEditLog editLog(fileName, PacketType::AvatarData);
+        QVERIFY(editLog.open());
+        QVERIFY(editLog.append("first"));
+        QVERIFY(editLog.beginCheckpoint());
+        QVERIFY(editLog.append("second"));
+    }
+
+    // its records aren't replayed, and its files are kept aside rather than replaced
+    QVERIFY(replayRecords(fileName).isEmpty());
+    QVERIFY(!QFile::exists(fileName));
+    QVERIFY(!QFile::exists(fileName + ".checkpoint"));
+    QCOMPARE(QDir(directory.path()).entryList(QDir::Files).size(), 2);
+
+    {
+        OctreeEditLog editLog(fileName, PacketType::EntityEdit);
+        QVERIFY(editLog.open());
+        QCOMPARE(editLog.getSize(), (qint64)0);
+        QVERIFY(editLog.append("third"));
+    }
+
+    auto records = replayRecords(fileName);
+    QCOMPARE(records.size(), 1);
+    QCOMPARE(records[0], QByteArray("third"));
+}
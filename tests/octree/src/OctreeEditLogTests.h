@@ -0,0 +1,27 @@
+//
+//  OctreeEditLogTests.h
+//  tests/octree/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeEditLogTests_h
+#define hifi_OctreeEditLogTests_h
+
+#include <QtTest/QtTest>
+
+class OctreeEditLogTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void replayTest();
+    void truncatedRecordTest();
+    void checkpointTest();
+    void unfinishedCheckpointTest();
+    void otherVersionTest();
+};
+
+#endif // hifi_OctreeEditLogTests_h
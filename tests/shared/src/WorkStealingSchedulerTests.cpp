@@ -0,0 +1,117 @@
+//
+//  WorkStealingSchedulerTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "WorkStealingSchedulerTests.h"
+
+#include <atomic>
+#include <thread>
+
+#include <WorkStealingScheduler.h>
+
+QTEST_MAIN(WorkStealingSchedulerTests)
+
+static const int NUM_TASKS = 1000;
+static const int NUM_BATCHES = 10;
+static const int NUM_WORKERS = 4;
+
+void WorkStealingSchedulerTests::testRunsEachTaskOnce() {
+    WorkStealingScheduler<int> scheduler;
+    std::vector<QUuid> keys;
+    for (int i = 0; i < NUM_TASKS; ++i) {
+        keys.push_back(QUuid::createUuid());
+    }
+
+    for (int batch = 0; batch < NUM_BATCHES; ++batch) {
+        std::vector<std::atomic<int>> runs(NUM_TASKS);
+        for (int i = 0; i < NUM_TASKS; ++i) {
+            runs[i] = 0;
+            scheduler.add(i, keys[i]);
+        }
+        scheduler.schedule(NUM_WORKERS);
+
+        std::vector<std::thread> workers;
+        for (int i = 0; i < NUM_WORKERS; ++i) {
+            workers.emplace_back([&, i] {
+                scheduler.run(i, [&](const int& task) { ++runs[task]; });
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        scheduler.finish();
+
+        for (int i = 0; i < NUM_TASKS; ++i) {
+            QCOMPARE(runs[i].load(), 1);
+        }
+    }
+
+    QJsonObject stats = scheduler.takeStats();
+    QCOMPARE(stats.size(), NUM_WORKERS);
+    int numTasks = 0;
+    for (auto worker : stats) {
+        numTasks += worker.toObject()["tasks"].toInt();
+    }
+    QCOMPARE(numTasks, NUM_TASKS * NUM_BATCHES);
+}
+
+void WorkStealingSchedulerTests::testStealsFromIdleWorker() {
+    WorkStealingScheduler<int> scheduler;
+    for (int i = 0; i < NUM_TASKS; ++i) {
+        scheduler.add(i, QUuid::createUuid());
+    }
+    scheduler.schedule(2);
+
+    // the second worker never runs, so the first must steal all of its tasks
+    int numRun = 0;
+    scheduler.run(0, [&](const int& task) { ++numRun; });
+    scheduler.finish();
+
+    QCOMPARE(numRun, NUM_TASKS);
+
+    QJsonObject stats = scheduler.takeStats();
+    QCOMPARE(stats["1"].toObject()["tasks"].toInt(), NUM_TASKS);
+    QCOMPARE(stats["1"].toObject()["steals"].toInt(), NUM_TASKS / 2);
+    QCOMPARE(stats["2"].toObject()["tasks"].toInt(), 0);
+}
+
+void WorkStealingSchedulerTests::testBalancesByCost() {
+    WorkStealingScheduler<int> scheduler;
+
+    // one long task, and a few short ones
+    static const int NUM_SHORT_TASKS = 8;
+    static const auto LONG_TASK_TIME = std::chrono::milliseconds(20);
+    std::vector<QUuid> keys;
+    for (int i = 0; i <= NUM_SHORT_TASKS; ++i) {
+        keys.push_back(QUuid::createUuid());
+    }
+
+    // run a single worker, so that the tasks it steals are exactly those dealt to the other
+    auto runBatch = [&] {
+        for (int i = 0; i <= NUM_SHORT_TASKS; ++i) {
+            scheduler.add(i, keys[i]);
+        }
+        scheduler.schedule(2);
+        scheduler.run(0, [&](const int& task) {
+            if (task == 0) {
+                std::this_thread::sleep_for(LONG_TASK_TIME);
+            }
+        });
+        scheduler.finish();
+        return scheduler.takeStats()["1"].toObject()["steals"].toInt();
+    };
+
+    // without estimates, the tasks are split evenly
+    int numSteals = runBatch();
+    QVERIFY(numSteals == NUM_SHORT_TASKS / 2 || numSteals == NUM_SHORT_TASKS / 2 + 1);
+
+    // with estimates, the long task is dealt alone
+    numSteals = runBatch();
+    QVERIFY(numSteals == 1 || numSteals == NUM_SHORT_TASKS);
+}
@@ -0,0 +1,60 @@
+//
+//  LinkSimulator.cpp
+//  tools/udt-test/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LinkSimulator.h"
+
+#include <QtCore/QDebug>
+
+LinkSimulator::LinkSimulator(quint16 port, const HifiSockAddr& target, const Profile& profile, QObject* parent) :
+    QObject(parent),
+    _target(target),
+    _linkImpairment([this](const QByteArray& datagram, const HifiSockAddr& sockAddr) {
+        return _socket.writeDatagram(datagram, sockAddr.getAddress(), sockAddr.getPort());
+    })
+{
+    _socket.bind(QHostAddress::AnyIPv4, port);
+    connect(&_socket, &QUdpSocket::readyRead, this, &LinkSimulator::readPendingDatagrams);
+
+    // the profile of the null address applies to both directions, and each direction gets its own bottleneck
+    _linkImpairment.setProfile(HifiSockAddr(), profile);
+
+    qDebug() << "Link simulator is relaying port" << _socket.localPort() << "to" << _target
+        << "with" << profile.toString();
+}
+
+void LinkSimulator::readPendingDatagrams() {
+    while (_socket.hasPendingDatagrams()) {
+        QByteArray datagram;
+        datagram.resize(_socket.pendingDatagramSize());
+
+        HifiSockAddr senderSockAddr;
+        _socket.readDatagram(datagram.data(), datagram.size(),
+                             senderSockAddr.getAddressPointer(), senderSockAddr.getPortPointer());
+
+        if (senderSockAddr == _target) {
+            if (!_client.isNull()) {
+                _linkImpairment.write(datagram, _client);
+            }
+        } else {
+            _client = senderSockAddr;
+            _linkImpairment.write(datagram, _target);
+        }
+    }
+}
+
+void LinkSimulator::sampleStats() {
+    auto outputStats = [](const char* name, const udt::LinkImpairment::Stats& stats) {
+        qDebug() << name << "forwarded" << stats.written << "lost" << stats.lost << "burst lost" << stats.burstLost
+            << "queue drops" << stats.queueDrops << "re-ordered" << stats.reordered;
+    };
+
+    outputStats("To target:", _linkImpairment.takeStats(_target));
+    outputStats("To client:", _linkImpairment.takeStats(_client));
+}
@@ -0,0 +1,49 @@
+//
+//  LinkSimulator.h
+//  tools/udt-test/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_LinkSimulator_h
+#define hifi_LinkSimulator_h
+
+#include <QtCore/QObject>
+#include <QtNetwork/QUdpSocket>
+
+#include <HifiSockAddr.h>
+#include <udt/LinkImpairment.h>
+
+// Relays datagrams between a client and a target through an impaired link, in the manner of netem
+//   Datagrams from the target go back to the last client heard from. Each direction has its own bottleneck,
+//   which queues datagrams at its bandwidth and drops them once its queue is full, so that controllers that
+//   fill queues (bufferbloat) see their RTT inflate.
+class LinkSimulator : public QObject {
+    Q_OBJECT
+public:
+    using Profile = udt::LinkImpairment::Profile;
+
+    LinkSimulator(quint16 port, const HifiSockAddr& target, const Profile& profile, QObject* parent = nullptr);
+
+    quint16 localPort() const { return _socket.localPort(); }
+
+public slots:
+    void sampleStats(); // outputs the datagrams forwarded and dropped in each direction since the last sample
+
+private slots:
+    void readPendingDatagrams();
+
+private:
+    QUdpSocket _socket { this };
+    HifiSockAddr _target;
+    HifiSockAddr _client;
+
+    udt::LinkImpairment _linkImpairment;
+};
+
+#endif // hifi_LinkSimulator_h
@@ -12,7 +12,9 @@
 #include "UDTTest.h"
 
 #include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
 
+#include <udt/BBRCC.h>
 #include <udt/Constants.h>
 #include <udt/Packet.h>
 #include <udt/PacketList.h>
@@ -55,9 +57,27 @@ const QCommandLineOption MESSAGE_SEED {
 const QCommandLineOption STATS_INTERVAL {
     "stats-interval", "stats output interval (default is 100ms)", "milliseconds"
 };
+const QCommandLineOption BATCHED_IO {
+    "batched", "read and write batches of datagrams with one system call (Linux only, default is one per datagram)"
+};
+const QCommandLineOption CONGESTION_CONTROL {
+    "congestion-control", "congestion control for reliable packets - vegas, bbr or udt (default is vegas)", "name"
+};
+const QCommandLineOption RELAY {
+    "relay", "relay packets to this target through a simulated link instead of testing (use -p for the listening port)",
+    "IP:PORT"
+};
+const QCommandLineOption IMPAIR {
+    "impair", "impair the link with comma separated settings, with rates in percent, times in milliseconds and "
+    "bandwidth in Mb/s - loss=1,burst=0.1:20,reorder=1:10,latency=50,jitter=10,bandwidth=20,queue=100 "
+    "(impairs the relay in each direction, or what this socket sends)", "profile"
+};
+
+// the number of unreliable packets written together when using batched I/O
+const int UNRELIABLE_BATCH_SIZE = 64;
 
 const QStringList CLIENT_STATS_TABLE_HEADERS {
-    "Send (Mb/s)", "Est. Max (Mb/s)", "RTT (ms)", "CW (P)", "Period (us)",
+    "Send (Mb/s)", "Goodput (Mb/s)", "Est. Max (Mb/s)", "RTT (ms)", "RTT Infl.", "CW (P)", "Period (us)",
     "Recv ACK", "Procd ACK", "Recv LACK", "Recv NAK", "Recv TNAK",
     "Sent ACK2", "Sent Packets", "Re-sent Packets"
 };
@@ -74,30 +94,66 @@ UDTTest::UDTTest(int& argc, char** argv) :
     qInstallMessageHandler(LogHandler::verboseMessageHandler);
     
     parseArguments();
+
+    if (_argumentParser.isSet(RELAY)) {
+        // this is a relay through a simulated link, for the tests that run on either side of it
+        setupLinkSimulator();
+        return;
+    }
     
     // randomize the seed for packet size randomization
     srand(time(NULL));
 
+    if (_argumentParser.isSet(BATCHED_IO)) {
+        if (udt::Socket::isBatchedIOSupported()) {
+            _socket.setBatchedIOEnabled(true);
+        } else {
+            qCritical() << "Batched I/O is not supported on this platform.";
+            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        }
+    }
+
+    if (_argumentParser.isSet(CONGESTION_CONTROL)) {
+        QString congestionControl = _argumentParser.value(CONGESTION_CONTROL);
+
+        if (congestionControl == "bbr") {
+            _socket.setCongestionControlFactory(std::unique_ptr<udt::CongestionControlVirtualFactory>(
+                new udt::CongestionControlFactory<udt::BBRCC>()));
+        } else if (congestionControl == "udt") {
+            _socket.setCongestionControlFactory(std::unique_ptr<udt::CongestionControlVirtualFactory>(
+                new udt::CongestionControlFactory<udt::DefaultCC>()));
+        } else if (congestionControl != "vegas") {
+            qCritical() << "Unknown congestion control" << congestionControl << "- expected vegas, bbr or udt.";
+            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        }
+
+        qDebug() << "Reliable packets use" << congestionControl << "congestion control";
+    }
+
     _socket.bind(QHostAddress::AnyIPv4, _argumentParser.value(PORT_OPTION).toUInt());
     qDebug() << "Test socket is listening on" << _socket.localPort();
     
     if (_argumentParser.isSet(TARGET_OPTION)) {
-        // parse the IP and port combination for this target
-        QString hostnamePortString = _argumentParser.value(TARGET_OPTION);
-        
-        QHostAddress address { hostnamePortString.left(hostnamePortString.indexOf(':')) };
-        quint16 port { (quint16) hostnamePortString.mid(hostnamePortString.indexOf(':') + 1).toUInt() };
-        
-        if (address.isNull() || port == 0) {
-            qCritical() << "Could not parse an IP address and port combination from" << hostnamePortString << "-" <<
-                "The parsed IP was" << address.toString() << "and the parsed port was" << port;
-            
-            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
-        } else {
-            _target = HifiSockAddr(address, port);
+        _target = parseSockAddr(_argumentParser.value(TARGET_OPTION));
+
+        if (!_target.isNull()) {
             qDebug() << "Packets will be sent to" << _target;
         }
     }
+
+    if (_argumentParser.isSet(IMPAIR)) {
+#ifdef UDT_LINK_IMPAIRMENT
+        // impair what this socket sends to the target, or to everyone when only listening
+        udt::LinkImpairment::Profile profile;
+        if (parseLinkProfile(profile)) {
+            _socket.getLinkImpairment().setProfile(_target, profile);
+            qDebug() << "Sent packets are impaired with" << profile.toString();
+        }
+#else
+        qCritical() << "Link impairment is only available in PR and dev builds - use --relay to impair a link.";
+        QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+#endif
+    }
     
     if (_argumentParser.isSet(PACKET_SIZE)) {
         // parse the desired packet size
@@ -174,6 +230,13 @@ UDTTest::UDTTest(int& argc, char** argv) :
     if (!_target.isNull()) {
         sendInitialPackets();
     } else {
+        _socket.setPacketHandler(
+            [this](std::unique_ptr<udt::Packet> packet) {
+                // unreliable packets are only counted, to compare receive throughput with and without batched I/O
+                ++_receivedUnreliablePackets;
+                _receivedUnreliableBytes += packet->getDataSize();
+        });
+
         // this is a receiver - in case there are ordered packets (messages) being sent to us make sure that we handle them
         // so that they can be verified
         _socket.setMessageHandler(
@@ -218,6 +281,56 @@ UDTTest::UDTTest(int& argc, char** argv) :
     statsTimer->start(_statsInterval);
 }
 
+HifiSockAddr UDTTest::parseSockAddr(const QString& hostnamePortString) {
+    // parse the IP and port combination
+    QHostAddress address { hostnamePortString.left(hostnamePortString.indexOf(':')) };
+    quint16 port { (quint16) hostnamePortString.mid(hostnamePortString.indexOf(':') + 1).toUInt() };
+    
+    if (address.isNull() || port == 0) {
+        qCritical() << "Could not parse an IP address and port combination from" << hostnamePortString << "-" <<
+            "The parsed IP was" << address.toString() << "and the parsed port was" << port;
+        
+        QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        return HifiSockAddr();
+    }
+
+    return HifiSockAddr(address, port);
+}
+
+bool UDTTest::parseLinkProfile(udt::LinkImpairment::Profile& profile) {
+    if (_argumentParser.isSet(IMPAIR)
+        && !udt::LinkImpairment::Profile::fromString(_argumentParser.value(IMPAIR), profile)) {
+        qCritical() << "Could not parse a link impairment profile from" << _argumentParser.value(IMPAIR);
+
+        QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        return false;
+    }
+
+    return true;
+}
+
+void UDTTest::setupLinkSimulator() {
+    HifiSockAddr target = parseSockAddr(_argumentParser.value(RELAY));
+    if (target.isNull()) {
+        return;
+    }
+
+    LinkSimulator::Profile profile;
+    if (!parseLinkProfile(profile)) {
+        return;
+    }
+
+    _linkSimulator.reset(new LinkSimulator(_argumentParser.value(PORT_OPTION).toUInt(), target, profile));
+
+    // the relay reports what it forwarded and dropped once a second, unless passed a custom interval
+    static const int LINK_STATS_INTERVAL_MSECS = 1000;
+
+    QTimer* statsTimer = new QTimer(this);
+    connect(statsTimer, &QTimer::timeout, _linkSimulator.get(), &LinkSimulator::sampleStats);
+    statsTimer->start(_argumentParser.isSet(STATS_INTERVAL) ?
+                      _argumentParser.value(STATS_INTERVAL).toInt() : LINK_STATS_INTERVAL_MSECS);
+}
+
 void UDTTest::parseArguments() {
     // use a QCommandLineParser to setup command line arguments and give helpful output
     _argumentParser.setApplicationDescription("High Fidelity UDT Protocol Test Client");
@@ -228,7 +341,8 @@ void UDTTest::parseArguments() {
     _argumentParser.addOptions({
         PORT_OPTION, TARGET_OPTION, PACKET_SIZE, MIN_PACKET_SIZE, MAX_PACKET_SIZE,
         MAX_SEND_BYTES, MAX_SEND_PACKETS, UNRELIABLE_PACKETS, ORDERED_PACKETS,
-        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL
+        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL, BATCHED_IO, CONGESTION_CONTROL,
+        RELAY, IMPAIR
     });
     
     if (!_argumentParser.parse(arguments())) {
@@ -247,10 +361,23 @@ void UDTTest::sendInitialPackets() {
     static const int NUM_INITIAL_PACKETS = 500;
     
     int numPackets = std::max(NUM_INITIAL_PACKETS, _maxSendPackets);
+
+    QElapsedTimer sendTimer;
+    sendTimer.start();
     
     for (int i = 0; i < numPackets; ++i) {
         sendPacket();
     }
+
+    if (!_sendReliable && !_sendOrdered) {
+        sendUnreliablePacketList();
+
+        // unreliable packets are all written here, so report the send throughput to compare with and without batched I/O
+        double elapsedMsecs = std::max(sendTimer.nsecsElapsed() / 1000000.0, 0.001);
+        qDebug() << "Sent" << _totalQueuedPackets << "unreliable packets in" << elapsedMsecs << "ms -"
+            << (int)(_totalQueuedPackets * 1000.0 / elapsedMsecs) << "packets/s"
+            << (_socket.isBatchedIOEnabled() ? "(batched I/O)" : "");
+    }
     
     if (numPackets == NUM_INITIAL_PACKETS) {
         // we've put 500 initial packets in the queue, everytime we hear one has gone out we should add a new one
@@ -326,6 +453,18 @@ void UDTTest::sendPacket() {
         // queue or send this packet by calling write packet on the socket for our target
         if (_sendReliable) {
             _socket.writePacket(std::move(newPacket), _target);
+        } else if (_socket.isBatchedIOEnabled()) {
+            // gather unreliable packets in a packet list, which the socket writes as a batch
+            if (!_unreliablePacketList) {
+                _unreliablePacketList = udt::PacketList::create(PacketType::BulkAvatarData);
+            }
+
+            _unreliablePacketList->write(newPacket->getPayload(), packetPayloadSize);
+            _unreliablePacketList->closeCurrentPacket();
+
+            if ((int)_unreliablePacketList->getNumPackets() == UNRELIABLE_BATCH_SIZE) {
+                sendUnreliablePacketList();
+            }
         } else {
             _socket.writePacket(*newPacket, _target);
         }
@@ -335,6 +474,12 @@ void UDTTest::sendPacket() {
     
 }
 
+void UDTTest::sendUnreliablePacketList() {
+    if (_unreliablePacketList) {
+        _socket.writePacketList(std::move(_unreliablePacketList), _target);
+    }
+}
+
 void UDTTest::handleMessage(std::unique_ptr<Message> message) {
     // generate the byte array that should match this message - using the same seed the sender did
     
@@ -377,14 +522,24 @@ void UDTTest::sampleStats() {
         }
         
         udt::ConnectionStats::Stats stats = _socket.sampleStatsForConnection(_target);
+
+        // goodput only counts the first send of each packet, and the RTT inflation is relative to the lowest RTT seen
+        double goodput = (stats.sentUtilBytes * MEGABITS_PER_BYTE * MS_PER_SECOND) / _statsInterval;
+
+        if (stats.rtt > 0 && (_minRTT == 0 || stats.rtt < _minRTT)) {
+            _minRTT = stats.rtt;
+        }
+        double rttInflation = (_minRTT > 0) ? (double)stats.rtt / _minRTT : 0.0;
         
         int headerIndex = -1;
         
         // setup a list of left justified values
         QStringList values {
             QString::number(stats.sendRate * PPS_TO_MBPS).rightJustified(CLIENT_STATS_TABLE_HEADERS[++headerIndex].size()),
+            QString::number(goodput, 'f', 2).rightJustified(CLIENT_STATS_TABLE_HEADERS[++headerIndex].size()),
             QString::number(stats.estimatedBandwith * PPS_TO_MBPS).rightJustified(CLIENT_STATS_TABLE_HEADERS[++headerIndex].size()),
             QString::number(stats.rtt / USECS_PER_MSEC, 'f', 2).rightJustified(CLIENT_STATS_TABLE_HEADERS[++headerIndex].size()),
+            QString::number(rttInflation, 'f', 2).rightJustified(CLIENT_STATS_TABLE_HEADERS[++headerIndex].size()),
             QString::number(stats.congestionWindowSize).rightJustified(CLIENT_STATS_TABLE_HEADERS[++headerIndex].size()),
             QString::number(stats.packetSendPeriod).rightJustified(CLIENT_STATS_TABLE_HEADERS[++headerIndex].size()),
             QString::number(stats.events[udt::ConnectionStats::Stats::ReceivedACK]).rightJustified(CLIENT_STATS_TABLE_HEADERS[++headerIndex].size()),
@@ -406,6 +561,17 @@ void UDTTest::sampleStats() {
             first = false;
         }
         
+        if (_receivedUnreliablePackets > 0) {
+            double packetsPerSecond = (_receivedUnreliablePackets * MS_PER_SECOND) / _statsInterval;
+            double megabitsPerSecond = (_receivedUnreliableBytes * MEGABITS_PER_BYTE * MS_PER_SECOND) / _statsInterval;
+
+            qDebug() << "Received" << _receivedUnreliablePackets << "unreliable packets -"
+                << (int)packetsPerSecond << "packets/s," << QString::number(megabitsPerSecond, 'f', 2) << "Mb/s";
+
+            _receivedUnreliablePackets = 0;
+            _receivedUnreliableBytes = 0;
+        }
+
         auto sockets = _socket.getConnectionSockAddrs();
         if (sockets.size() > 0) {
             udt::ConnectionStats::Stats stats = _socket.sampleStatsForConnection(sockets.front());
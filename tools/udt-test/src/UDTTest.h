@@ -21,10 +21,13 @@
 #include <QtCore/QCommandLineParser>
 
 #include <udt/Constants.h>
+#include <udt/PacketList.h>
 #include <udt/Socket.h>
 
 #include <ReceivedMessage.h>
 
+#include "LinkSimulator.h"
+
 struct Message {
     udt::MessageNumber messageNumber;
     QByteArray data;
@@ -41,10 +44,14 @@ public slots:
     
 private:
     void parseArguments();
+    HifiSockAddr parseSockAddr(const QString& hostnamePortString);
+    bool parseLinkProfile(udt::LinkImpairment::Profile& profile); // returns false and quits if the profile is invalid
+    void setupLinkSimulator();
     void handleMessage(std::unique_ptr<Message> message);
     
     void sendInitialPackets(); // fills the queue with packets to start
     void sendPacket(); // constructs and sends a packet according to the test parameters
+    void sendUnreliablePacketList(); // sends the packets batched into _unreliablePacketList
     
     QCommandLineParser _argumentParser;
     udt::Socket _socket;
@@ -71,6 +78,15 @@ private:
     int _totalQueuedBytes { 0 }; // keeps track of the number of bytes we have already queued
     
     int _statsInterval { 100 }; // recording interval for stats in milliseconds
+
+    std::unique_ptr<udt::PacketList> _unreliablePacketList; // unreliable packets waiting to be sent as one batch
+    
+    int _receivedUnreliablePackets { 0 }; // unreliable packets received since the last stats sample
+    qint64 _receivedUnreliableBytes { 0 }; // unreliable bytes received since the last stats sample
+
+    int _minRTT { 0 }; // lowest RTT sampled for the target, in microseconds, to report RTT inflation
+
+    std::unique_ptr<LinkSimulator> _linkSimulator; // relays through a simulated link instead of testing, if set
 };
 
 #endif // hifi_UDTTest_h